@@ -1,6 +1,7 @@
 #pragma once
 
 #define QUEUE_ITEM std::uint32_t
+#define STACK_ITEM std::uint32_t
 
 // Many configuration paramters are compile time parameters. Therefore, every
 // additional configuration increases compile time. In order to keep compile
@@ -10,14 +11,27 @@
 // defines which data structures shall be included
 #define WITH_MICHAEL_SCOTT_QUEUE
 #define WITH_RAMALHETE_QUEUE
+#define WITH_LCRQ_QUEUE
 #define WITH_VYUKOV_BOUNDED_QUEUE
 #define WITH_KIRSCH_BOUNDED_KFIFO_QUEUE
 #define WITH_KIRSCH_KFIFO_QUEUE
 #define WITH_NIKOLAEV_BOUNDED_QUEUE
+#define WITH_NIKOLAEV_QUEUE
+#define WITH_SPSC_BOUNDED_QUEUE
+#define WITH_VYUKOV_MPSC_QUEUE
 #define WITH_LOCK_FREE_730_QUEUE
 
 #define WITH_VYUKOV_HASH_MAP
 #define WITH_HARRIS_MICHAEL_HASH_MAP
+#define WITH_CUCKOO_HASH_MAP
+#define WITH_FELDMAN_HASH_MAP
+#define WITH_HARRIS_MICHAEL_LIST_BASED_SET
+#define WITH_FRASER_SKIP_LIST_MAP
+#define WITH_NATARAJAN_MITTAL_TREE
+#define WITH_OLC_BTREE_MAP
+#define WITH_ART_MAP
+
+#define WITH_TREIBER_STACK
 
 // defines which reclamation schemes shall be included
 #define WITH_HAZARD_POINTER
@@ -3,7 +3,11 @@
 #include "execution.hpp"
 #include "hash_maps.hpp"
 
+#include <algorithm>
+#include <chrono>
 #include <iostream>
+#include <random>
+#include <thread>
 #include <vector>
 
 using config_t = tao::config::value;
@@ -67,6 +71,52 @@ private:
   std::uint64_t _scale_insert = 0;
 };
 
+// Builds a new hash-map from a fixed dataset in every run, either via bulk construction or by
+// inserting the elements one by one.
+template <class T>
+struct build_thread : execution_thread {
+  build_thread(hash_map_benchmark<T>& benchmark, std::uint32_t id, const execution& exec) :
+      execution_thread(id, exec),
+      _benchmark(benchmark) {}
+  void setup(const config_t& config) override {
+    execution_thread::setup(config);
+
+    _size = config.optional<std::uint64_t>("size").value_or(_benchmark.key_range);
+    auto mode = config.optional<std::string>("mode").value_or("bulk");
+    if (mode != "bulk" && mode != "incremental") {
+      throw std::runtime_error("mode must be either \"bulk\" or \"incremental\"");
+    }
+    _bulk = mode == "bulk";
+    _build_threads = config.optional<std::uint32_t>("build_threads").value_or(1);
+    if (_build_threads == 0) {
+      throw std::runtime_error("build_threads must be greater than zero");
+    }
+  }
+  void initialize(std::uint32_t num_threads) override;
+  void run() override;
+  [[nodiscard]] thread_report report() const override {
+    tao::json::value data{
+      {"runtime", _runtime.count()},
+      {"build_time", _build_time.count()},
+      {"insert", insert_operations},
+    };
+    return {data, insert_operations};
+  }
+
+protected:
+  std::uint64_t insert_operations = 0;
+
+private:
+  void insert_incrementally(T& hash_map);
+
+  hash_map_benchmark<T>& _benchmark;
+  std::vector<std::pair<QUEUE_ITEM, QUEUE_ITEM>> _data;
+  std::chrono::duration<double, std::milli> _build_time{};
+  std::uint64_t _size = 0;
+  std::uint32_t _build_threads = 1;
+  bool _bulk = true;
+};
+
 template <class T>
 struct hash_map_benchmark : benchmark {
   void setup(const config_t& config) override;
@@ -76,11 +126,15 @@ struct hash_map_benchmark : benchmark {
     if (type == "mixed") {
       return std::make_unique<benchmark_thread<T>>(*this, id, exec);
     }
+    if (type == "build") {
+      return std::make_unique<build_thread<T>>(*this, id, exec);
+    }
 
     throw std::runtime_error("Invalid thread type: " + type);
   }
 
   std::unique_ptr<T> hash_map;
+  config_t ds_config;
   std::uint32_t batch_size = 0;
   std::uint64_t key_range = 0;
   std::uint64_t key_offset = 0;
@@ -89,7 +143,8 @@ struct hash_map_benchmark : benchmark {
 
 template <class T>
 void hash_map_benchmark<T>::setup(const tao::config::value& config) {
-  hash_map = hash_map_builder<T>::create(config.at("ds"));
+  ds_config = config.at("ds");
+  hash_map = hash_map_builder<T>::create(ds_config);
   batch_size = config.optional<std::uint32_t>("batch_size").value_or(100);
   key_range = config.optional<std::uint64_t>("key_range").value_or(2048);
   key_offset = config.optional<std::uint64_t>("key_offset").value_or(0);
@@ -108,9 +163,14 @@ void benchmark_thread<T>::initialize(std::uint32_t num_threads) {
 
   [[maybe_unused]] region_guard_t<T> guard{};
   auto step_size = _benchmark.key_range / _benchmark.prefill.count;
-  std::uint64_t key = id * step_size + _benchmark.key_offset;
-  step_size *= num_threads;
-  for (std::uint64_t i = 0; i < cnt; ++i, key += step_size) {
+  // Insert the keys in random order - ascending keys would degenerate unbalanced search trees into a list.
+  std::vector<std::uint64_t> indexes(cnt);
+  for (std::uint64_t i = 0; i < cnt; ++i) {
+    indexes[i] = i;
+  }
+  std::shuffle(indexes.begin(), indexes.end(), std::mt19937_64(id));
+  for (auto i : indexes) {
+    std::uint64_t key = (i * num_threads + id) * step_size + _benchmark.key_offset;
     if (!try_emplace(*_benchmark.hash_map, static_cast<unsigned>(key))) {
       throw initialization_failure();
     }
@@ -154,6 +214,56 @@ void benchmark_thread<T>::run() {
   get_operations += get;
 }
 
+template <class T>
+void build_thread<T>::initialize(std::uint32_t /*num_threads*/) {
+  if (_data.size() == _size) {
+    return;
+  }
+  _data.clear();
+  _data.reserve(_size);
+  for (std::uint64_t i = 0; i < _size; ++i) {
+    auto key = static_cast<QUEUE_ITEM>(i + _benchmark.key_offset);
+    _data.emplace_back(key, key);
+  }
+  std::shuffle(_data.begin(), _data.end(), _randomizer);
+}
+
+template <class T>
+void build_thread<T>::insert_incrementally(T& hash_map) {
+  auto insert_range = [this, &hash_map](std::size_t begin, std::size_t end) {
+    [[maybe_unused]] region_guard_t<T> guard{};
+    for (std::size_t i = begin; i < end; ++i) {
+      try_emplace(hash_map, _data[i].first);
+    }
+  };
+
+  std::vector<std::thread> threads;
+  for (std::uint32_t t = 1; t < _build_threads; ++t) {
+    threads.emplace_back(insert_range, _data.size() * t / _build_threads, _data.size() * (t + 1) / _build_threads);
+  }
+  insert_range(0, _data.size() / _build_threads);
+  for (auto& thread : threads) {
+    thread.join();
+  }
+}
+
+template <class T>
+void build_thread<T>::run() {
+  auto hash_map = hash_map_builder<T>::create(_benchmark.ds_config);
+
+  auto start = std::chrono::high_resolution_clock::now();
+  if (_bulk) {
+    if (!try_bulk_build(*hash_map, _data.begin(), _data.end(), _build_threads)) {
+      throw std::runtime_error("bulk construction is not supported by this hash-map");
+    }
+  } else {
+    insert_incrementally(*hash_map);
+  }
+  _build_time += std::chrono::high_resolution_clock::now() - start;
+
+  insert_operations += _data.size();
+}
+
 namespace {
 template <class T>
 inline std::shared_ptr<benchmark_builder> make_benchmark_builder() {
@@ -215,6 +325,136 @@ auto benchmark_variations() {
   #endif
 #endif
 
+#ifdef WITH_CUCKOO_HASH_MAP
+  #ifdef WITH_GENERIC_EPOCH_BASED
+    make_benchmark_builder<
+      cuckoo_hash_map<QUEUE_ITEM, QUEUE_ITEM, policy::reclaimer<reclamation::epoch_based<>>>>(),
+    make_benchmark_builder<cuckoo_hash_map<QUEUE_ITEM,
+                                           QUEUE_ITEM,
+                                           policy::reclaimer<reclamation::epoch_based<>>,
+                                           policy::slots_per_bucket<8>>>(),
+  #endif
+  #ifdef WITH_QUIESCENT_STATE_BASED
+    make_benchmark_builder<
+      cuckoo_hash_map<QUEUE_ITEM, QUEUE_ITEM, policy::reclaimer<reclamation::quiescent_state_based>>>(),
+  #endif
+  #ifdef WITH_HAZARD_POINTER
+    make_benchmark_builder<
+      cuckoo_hash_map<QUEUE_ITEM,
+                      QUEUE_ITEM,
+                      policy::reclaimer<reclamation::hazard_pointer<>::with<
+                        policy::allocation_strategy<reclamation::hp_allocation::static_strategy<3>>>>>>(),
+  #endif
+#endif
+
+#ifdef WITH_FELDMAN_HASH_MAP
+  #ifdef WITH_GENERIC_EPOCH_BASED
+    make_benchmark_builder<
+      feldman_hash_map<QUEUE_ITEM, QUEUE_ITEM, policy::reclaimer<reclamation::epoch_based<>>>>(),
+    make_benchmark_builder<feldman_hash_map<QUEUE_ITEM,
+                                            QUEUE_ITEM,
+                                            policy::reclaimer<reclamation::epoch_based<>>,
+                                            policy::head_bits<16>>>(),
+  #endif
+  #ifdef WITH_QUIESCENT_STATE_BASED
+    make_benchmark_builder<
+      feldman_hash_map<QUEUE_ITEM, QUEUE_ITEM, policy::reclaimer<reclamation::quiescent_state_based>>>(),
+  #endif
+  #ifdef WITH_HAZARD_POINTER
+    make_benchmark_builder<
+      feldman_hash_map<QUEUE_ITEM,
+                       QUEUE_ITEM,
+                       policy::reclaimer<reclamation::hazard_pointer<>::with<
+                         policy::allocation_strategy<reclamation::hp_allocation::static_strategy<3>>>>>>(),
+  #endif
+#endif
+
+#ifdef WITH_HARRIS_MICHAEL_LIST_BASED_SET
+  #ifdef WITH_GENERIC_EPOCH_BASED
+    make_benchmark_builder<harris_michael_list_based_set<QUEUE_ITEM, policy::reclaimer<reclamation::epoch_based<>>>>(),
+  #endif
+  #ifdef WITH_QUIESCENT_STATE_BASED
+    make_benchmark_builder<
+      harris_michael_list_based_set<QUEUE_ITEM, policy::reclaimer<reclamation::quiescent_state_based>>>(),
+  #endif
+  #ifdef WITH_HAZARD_POINTER
+    make_benchmark_builder<harris_michael_list_based_set<
+      QUEUE_ITEM,
+      policy::reclaimer<reclamation::hazard_pointer<>::with<
+        policy::allocation_strategy<reclamation::hp_allocation::static_strategy<3>>>>>>(),
+  #endif
+#endif
+
+#ifdef WITH_FRASER_SKIP_LIST_MAP
+  #ifdef WITH_GENERIC_EPOCH_BASED
+    make_benchmark_builder<
+      fraser_skip_list_map<QUEUE_ITEM, QUEUE_ITEM, policy::reclaimer<reclamation::epoch_based<>>>>(),
+    make_benchmark_builder<
+      fraser_skip_list_map<QUEUE_ITEM, QUEUE_ITEM, policy::reclaimer<reclamation::new_epoch_based<>>>>(),
+    make_benchmark_builder<fraser_skip_list_map<QUEUE_ITEM, QUEUE_ITEM, policy::reclaimer<reclamation::debra<>>>>(),
+  #endif
+  #ifdef WITH_QUIESCENT_STATE_BASED
+    make_benchmark_builder<
+      fraser_skip_list_map<QUEUE_ITEM, QUEUE_ITEM, policy::reclaimer<reclamation::quiescent_state_based>>>(),
+  #endif
+  #ifdef WITH_HAZARD_POINTER
+    make_benchmark_builder<
+      fraser_skip_list_map<QUEUE_ITEM,
+                           QUEUE_ITEM,
+                           policy::reclaimer<reclamation::hazard_pointer<>::with<
+                             policy::allocation_strategy<reclamation::hp_allocation::dynamic_strategy<3>>>>>>(),
+  #endif
+#endif
+
+#ifdef WITH_NATARAJAN_MITTAL_TREE
+  // the tree traverses removed nodes, so it only supports region-based reclamation schemes
+  #ifdef WITH_GENERIC_EPOCH_BASED
+    make_benchmark_builder<
+      natarajan_mittal_tree_map<QUEUE_ITEM, QUEUE_ITEM, policy::reclaimer<reclamation::epoch_based<>>>>(),
+    make_benchmark_builder<
+      natarajan_mittal_tree_map<QUEUE_ITEM, QUEUE_ITEM, policy::reclaimer<reclamation::new_epoch_based<>>>>(),
+    make_benchmark_builder<
+      natarajan_mittal_tree_map<QUEUE_ITEM, QUEUE_ITEM, policy::reclaimer<reclamation::debra<>>>>(),
+  #endif
+  #ifdef WITH_QUIESCENT_STATE_BASED
+    make_benchmark_builder<
+      natarajan_mittal_tree_map<QUEUE_ITEM, QUEUE_ITEM, policy::reclaimer<reclamation::quiescent_state_based>>>(),
+  #endif
+#endif
+
+#ifdef WITH_OLC_BTREE_MAP
+  #ifdef WITH_GENERIC_EPOCH_BASED
+    make_benchmark_builder<olc_btree_map<QUEUE_ITEM, QUEUE_ITEM, policy::reclaimer<reclamation::epoch_based<>>>>(),
+    make_benchmark_builder<olc_btree_map<QUEUE_ITEM,
+                                         QUEUE_ITEM,
+                                         policy::reclaimer<reclamation::epoch_based<>>,
+                                         policy::node_capacity<16>>>(),
+    make_benchmark_builder<olc_btree_map<QUEUE_ITEM,
+                                         QUEUE_ITEM,
+                                         policy::reclaimer<reclamation::epoch_based<>>,
+                                         policy::node_capacity<256>>>(),
+  #endif
+  #ifdef WITH_QUIESCENT_STATE_BASED
+    make_benchmark_builder<
+      olc_btree_map<QUEUE_ITEM, QUEUE_ITEM, policy::reclaimer<reclamation::quiescent_state_based>>>(),
+  #endif
+  #ifdef WITH_HAZARD_POINTER
+    make_benchmark_builder<olc_btree_map<QUEUE_ITEM,
+                                         QUEUE_ITEM,
+                                         policy::reclaimer<reclamation::hazard_pointer<>::with<
+                                           policy::allocation_strategy<reclamation::hp_allocation::static_strategy<3>>>>>>(),
+  #endif
+#endif
+
+#ifdef WITH_ART_MAP
+  #ifdef WITH_GENERIC_EPOCH_BASED
+    make_benchmark_builder<art_map<QUEUE_ITEM, QUEUE_ITEM, policy::reclaimer<reclamation::epoch_based<>>>>(),
+  #endif
+  #ifdef WITH_QUIESCENT_STATE_BASED
+    make_benchmark_builder<art_map<QUEUE_ITEM, QUEUE_ITEM, policy::reclaimer<reclamation::quiescent_state_based>>>(),
+  #endif
+#endif
+
 #ifdef WITH_CDS_MICHAEL_HASHMAP
     make_benchmark_builder<
       cds::container::MichaelHashMap<cds::gc::HP,
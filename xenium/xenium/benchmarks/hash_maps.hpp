@@ -7,6 +7,14 @@ struct hash_map_builder {
   static auto create(const tao::config::value&) { return std::make_unique<T>(); }
 };
 
+namespace { // NOLINT
+// fallback for hash-maps that do not support bulk construction
+template <class T, class Iterator>
+bool try_bulk_build(T& /*hash_map*/, Iterator /*first*/, Iterator /*last*/, std::uint32_t /*num_threads*/) {
+  return false;
+}
+} // namespace
+
 #ifdef WITH_VYUKOV_HASH_MAP
   #include <xenium/vyukov_hash_map.hpp>
 
@@ -44,6 +52,15 @@ bool try_get(xenium::vyukov_hash_map<Key, Value, Policies...>& hash_map, Key key
   typename xenium::vyukov_hash_map<Key, Value, Policies...>::accessor acc;
   return hash_map.try_get_value(key, acc);
 }
+
+template <class Key, class Value, class... Policies, class Iterator>
+bool try_bulk_build(xenium::vyukov_hash_map<Key, Value, Policies...>& hash_map,
+                    Iterator first,
+                    Iterator last,
+                    std::uint32_t num_threads) {
+  hash_map.bulk_build(first, last, num_threads);
+  return true;
+}
 } // namespace
 #endif
 
@@ -76,6 +93,236 @@ bool try_get(xenium::harris_michael_hash_map<Key, Value, Policies...>& hash_map,
   auto it = hash_map.find(key);
   return it != hash_map.end();
 }
+
+template <class Key, class Value, class... Policies, class Iterator>
+bool try_bulk_build(xenium::harris_michael_hash_map<Key, Value, Policies...>& hash_map,
+                    Iterator first,
+                    Iterator last,
+                    std::uint32_t num_threads) {
+  hash_map.bulk_build(first, last, num_threads);
+  return true;
+}
+} // namespace
+#endif
+
+#ifdef WITH_CUCKOO_HASH_MAP
+  #include <xenium/cuckoo_hash_map.hpp>
+
+template <class Key, class Value, class... Policies>
+struct descriptor<xenium::cuckoo_hash_map<Key, Value, Policies...>> {
+  static tao::json::value generate() {
+    using hash_map = xenium::cuckoo_hash_map<Key, Value, Policies...>;
+    return {{"type", "cuckoo_hash_map"},
+            {"initial_capacity", DYNAMIC_PARAM},
+            {"slots_per_bucket", hash_map::slots_per_bucket},
+            {"reclaimer", descriptor<typename hash_map::reclaimer>::generate()}};
+  }
+};
+
+template <class Key, class Value, class... Policies>
+struct hash_map_builder<xenium::cuckoo_hash_map<Key, Value, Policies...>> {
+  static auto create(const tao::config::value& config) {
+    auto initial_capacity = config.optional<size_t>("initial_capacity").value_or(128);
+    return std::make_unique<xenium::cuckoo_hash_map<Key, Value, Policies...>>(initial_capacity);
+  }
+};
+
+namespace { // NOLINT
+template <class Key, class Value, class... Policies>
+bool try_emplace(xenium::cuckoo_hash_map<Key, Value, Policies...>& hash_map, Key key) {
+  return hash_map.emplace(key, key);
+}
+
+template <class Key, class Value, class... Policies>
+bool try_remove(xenium::cuckoo_hash_map<Key, Value, Policies...>& hash_map, Key key) {
+  return hash_map.erase(key);
+}
+
+template <class Key, class Value, class... Policies>
+bool try_get(xenium::cuckoo_hash_map<Key, Value, Policies...>& hash_map, Key key) {
+  return hash_map.contains(key);
+}
+} // namespace
+#endif
+
+#ifdef WITH_FELDMAN_HASH_MAP
+  #include <xenium/feldman_hash_map.hpp>
+
+template <class Key, class Value, class... Policies>
+struct descriptor<xenium::feldman_hash_map<Key, Value, Policies...>> {
+  static tao::json::value generate() {
+    using hash_map = xenium::feldman_hash_map<Key, Value, Policies...>;
+    return {{"type", "feldman_hash_map"},
+            {"head_bits", hash_map::head_bits},
+            {"array_bits", hash_map::array_bits},
+            {"reclaimer", descriptor<typename hash_map::reclaimer>::generate()}};
+  }
+};
+
+namespace { // NOLINT
+template <class Key, class Value, class... Policies>
+bool try_emplace(xenium::feldman_hash_map<Key, Value, Policies...>& hash_map, Key key) {
+  return hash_map.emplace(key, key);
+}
+
+template <class Key, class Value, class... Policies>
+bool try_remove(xenium::feldman_hash_map<Key, Value, Policies...>& hash_map, Key key) {
+  return hash_map.erase(key);
+}
+
+template <class Key, class Value, class... Policies>
+bool try_get(xenium::feldman_hash_map<Key, Value, Policies...>& hash_map, Key key) {
+  auto it = hash_map.find(key);
+  return it != hash_map.end();
+}
+} // namespace
+#endif
+
+#ifdef WITH_HARRIS_MICHAEL_LIST_BASED_SET
+  #include <xenium/harris_michael_list_based_set.hpp>
+
+template <class Key, class... Policies>
+struct descriptor<xenium::harris_michael_list_based_set<Key, Policies...>> {
+  static tao::json::value generate() {
+    using set = xenium::harris_michael_list_based_set<Key, Policies...>;
+    return {{"type", "harris_michael_list_based_set"},
+            {"reclaimer", descriptor<typename set::reclaimer>::generate()}};
+  }
+};
+
+namespace { // NOLINT
+template <class Key, class... Policies>
+bool try_emplace(xenium::harris_michael_list_based_set<Key, Policies...>& set, Key key) {
+  return set.emplace(key);
+}
+
+template <class Key, class... Policies>
+bool try_remove(xenium::harris_michael_list_based_set<Key, Policies...>& set, Key key) {
+  return set.erase(key);
+}
+
+template <class Key, class... Policies>
+bool try_get(xenium::harris_michael_list_based_set<Key, Policies...>& set, Key key) {
+  return set.contains(key);
+}
+} // namespace
+#endif
+
+#ifdef WITH_FRASER_SKIP_LIST_MAP
+  #include <xenium/fraser_skip_list_map.hpp>
+
+template <class Key, class Value, class... Policies>
+struct descriptor<xenium::fraser_skip_list_map<Key, Value, Policies...>> {
+  static tao::json::value generate() {
+    using map = xenium::fraser_skip_list_map<Key, Value, Policies...>;
+    return {{"type", "fraser_skip_list_map"}, {"reclaimer", descriptor<typename map::reclaimer>::generate()}};
+  }
+};
+
+namespace { // NOLINT
+template <class Key, class Value, class... Policies>
+bool try_emplace(xenium::fraser_skip_list_map<Key, Value, Policies...>& map, Key key) {
+  return map.emplace(key, key);
+}
+
+template <class Key, class Value, class... Policies>
+bool try_remove(xenium::fraser_skip_list_map<Key, Value, Policies...>& map, Key key) {
+  return map.erase(key);
+}
+
+template <class Key, class Value, class... Policies>
+bool try_get(xenium::fraser_skip_list_map<Key, Value, Policies...>& map, Key key) {
+  return map.contains(key);
+}
+} // namespace
+#endif
+
+#ifdef WITH_NATARAJAN_MITTAL_TREE
+  #include <xenium/natarajan_mittal_tree.hpp>
+
+template <class Key, class Value, class... Policies>
+struct descriptor<xenium::natarajan_mittal_tree_map<Key, Value, Policies...>> {
+  static tao::json::value generate() {
+    using map = xenium::natarajan_mittal_tree_map<Key, Value, Policies...>;
+    return {{"type", "natarajan_mittal_tree_map"}, {"reclaimer", descriptor<typename map::reclaimer>::generate()}};
+  }
+};
+
+namespace { // NOLINT
+template <class Key, class Value, class... Policies>
+bool try_emplace(xenium::natarajan_mittal_tree_map<Key, Value, Policies...>& map, Key key) {
+  return map.emplace(key, key);
+}
+
+template <class Key, class Value, class... Policies>
+bool try_remove(xenium::natarajan_mittal_tree_map<Key, Value, Policies...>& map, Key key) {
+  return map.erase(key);
+}
+
+template <class Key, class Value, class... Policies>
+bool try_get(xenium::natarajan_mittal_tree_map<Key, Value, Policies...>& map, Key key) {
+  return map.contains(key);
+}
+} // namespace
+#endif
+
+#ifdef WITH_OLC_BTREE_MAP
+  #include <xenium/olc_btree_map.hpp>
+
+template <class Key, class Value, class... Policies>
+struct descriptor<xenium::olc_btree_map<Key, Value, Policies...>> {
+  static tao::json::value generate() {
+    using map = xenium::olc_btree_map<Key, Value, Policies...>;
+    return {{"type", "olc_btree_map"},
+            {"reclaimer", descriptor<typename map::reclaimer>::generate()},
+            {"node_capacity", map::node_capacity}};
+  }
+};
+
+namespace { // NOLINT
+template <class Key, class Value, class... Policies>
+bool try_emplace(xenium::olc_btree_map<Key, Value, Policies...>& map, Key key) {
+  return map.emplace(key, key);
+}
+
+template <class Key, class Value, class... Policies>
+bool try_remove(xenium::olc_btree_map<Key, Value, Policies...>& map, Key key) {
+  return map.erase(key);
+}
+
+template <class Key, class Value, class... Policies>
+bool try_get(xenium::olc_btree_map<Key, Value, Policies...>& map, Key key) {
+  return map.contains(key);
+}
+} // namespace
+#endif
+
+#ifdef WITH_ART_MAP
+  #include <xenium/art_map.hpp>
+
+template <class Key, class Value, class... Policies>
+struct descriptor<xenium::art_map<Key, Value, Policies...>> {
+  static tao::json::value generate() {
+    using map = xenium::art_map<Key, Value, Policies...>;
+    return {{"type", "art_map"}, {"reclaimer", descriptor<typename map::reclaimer>::generate()}};
+  }
+};
+
+namespace { // NOLINT
+template <class Key, class Value, class... Policies>
+bool try_emplace(xenium::art_map<Key, Value, Policies...>& map, Key key) {
+  return map.emplace(key, key);
+}
+
+template <class Key, class Value, class... Policies>
+bool try_remove(xenium::art_map<Key, Value, Policies...>& map, Key key) {
+  return map.erase(key);
+}
+
+template <class Key, class Value, class... Policies>
+bool try_get(xenium::art_map<Key, Value, Policies...>& map, Key key) {
+  return map.contains(key);
+}
 } // namespace
 #endif
 
@@ -0,0 +1,73 @@
+#pragma once
+
+#include <xenium/utils.hpp>
+
+#include <tao/json/value.hpp>
+
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+
+// A log-linear histogram of operation latencies in nanoseconds. Values below
+// 2^(sub_bucket_bits + 1) are recorded exactly; larger values are recorded with
+// a relative error of at most 2^-sub_bucket_bits (~3%).
+struct latency_histogram {
+  void record(std::chrono::steady_clock::duration latency) {
+    auto ns = static_cast<std::uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(latency).count());
+    ++_counts[bucket_index(ns)];
+    ++_count;
+    _max = std::max(_max, ns);
+  }
+
+  // returns the (upper bound of the) latency in ns below which the given fraction of operations lies
+  [[nodiscard]] std::uint64_t percentile(double p) const {
+    auto target = static_cast<std::uint64_t>(std::ceil(p * static_cast<double>(_count)));
+    std::uint64_t cumulative = 0;
+    for (std::size_t i = 0; i < num_buckets; ++i) {
+      cumulative += _counts[i];
+      if (cumulative >= target && cumulative > 0) {
+        return std::min(bucket_upper_bound(i), _max);
+      }
+    }
+    return _max;
+  }
+
+  [[nodiscard]] tao::json::value as_json() const {
+    return {
+      {"p50", percentile(0.5)},
+      {"p99", percentile(0.99)},
+      {"p99.9", percentile(0.999)},
+      {"p99.99", percentile(0.9999)},
+      {"max", _max},
+    };
+  }
+
+private:
+  static constexpr unsigned sub_bucket_bits = 5;
+  static constexpr std::uint64_t sub_buckets = static_cast<std::uint64_t>(1) << sub_bucket_bits;
+  static constexpr std::size_t num_buckets = (64 - sub_bucket_bits + 1) * sub_buckets;
+
+  static std::size_t bucket_index(std::uint64_t value) {
+    if (value < 2 * sub_buckets) {
+      return value;
+    }
+    // keep the (sub_bucket_bits + 1) most significant bits
+    const unsigned shift = xenium::utils::find_last_bit_set(value) - sub_bucket_bits - 1;
+    return shift * sub_buckets + (value >> shift);
+  }
+
+  static std::uint64_t bucket_upper_bound(std::size_t index) {
+    if (index < 2 * sub_buckets) {
+      return index;
+    }
+    const auto shift = index / sub_buckets - 1;
+    const auto mantissa = index - shift * sub_buckets;
+    return ((mantissa + 1) << shift) - 1;
+  }
+
+  std::array<std::uint64_t, num_buckets> _counts{};
+  std::uint64_t _count = 0;
+  std::uint64_t _max = 0;
+};
@@ -1,5 +1,6 @@
 #include <fstream>
 #include <iostream>
+#include <iterator>
 #include <numeric>
 
 #ifdef _MSC_VER
@@ -25,6 +26,7 @@
 
 extern void register_queue_benchmark(registered_benchmarks&);
 extern void register_hash_map_benchmark(registered_benchmarks&);
+extern void register_stack_benchmark(registered_benchmarks&);
 
 namespace {
 
@@ -68,6 +70,37 @@ void print_summary(const report& report) {
             << "  stddev: " << sqrt(var) << std::endl;
 }
 
+// prints the worst latency percentiles over all threads and rounds (if the benchmark reports latencies)
+void print_latency_summary(const report& report) {
+  constexpr const char* percentiles[] = {"p50", "p99", "p99.9", "p99.99", "max"};
+  std::uint64_t worst[std::size(percentiles)] = {};
+  bool has_latency = false;
+  for (const auto& round : report.rounds) {
+    for (const auto& thread : round.threads) {
+      if (!thread.data.is_object()) {
+        continue;
+      }
+      const auto* latency = thread.data.find("latency");
+      if (latency == nullptr) {
+        continue;
+      }
+      has_latency = true;
+      for (std::size_t i = 0; i < std::size(percentiles); ++i) {
+        worst[i] = std::max(worst[i], latency->at(percentiles[i]).as<std::uint64_t>());
+      }
+    }
+  }
+
+  if (!has_latency) {
+    return;
+  }
+  std::cout << "Latency (worst thread):\n";
+  for (std::size_t i = 0; i < std::size(percentiles); ++i) {
+    std::cout << "  " << percentiles[i] << ": " << worst[i] << " ns\n";
+  }
+  std::cout << std::flush;
+}
+
 bool configs_match(const tao::config::value& config, const tao::json::value& descriptor);
 
 bool objects_match(const tao::config::value::object_t& config, const tao::json::value::object_t& descriptor) {
@@ -222,6 +255,7 @@ void runner::run() {
   warmup();
   auto report = run_benchmark();
   print_summary(report);
+  print_latency_summary(report);
   write_report(report);
 }
 
@@ -331,6 +365,7 @@ void parse_args(int argc, char* argv[], options& opts) {
 int main(int argc, char* argv[]) {
   register_queue_benchmark(benchmarks);
   register_hash_map_benchmark(benchmarks);
+  register_stack_benchmark(benchmarks);
 
 #if !defined(NDEBUG)
   std::cout << "==============================\n"
@@ -2,7 +2,9 @@
 #include "benchmark.hpp"
 #include "config.hpp"
 #include "execution.hpp"
+#include "latency_histogram.hpp"
 #include "queues.hpp"
+#include "stacks.hpp"
 
 #include <iostream>
 #include <vector>
@@ -10,12 +12,21 @@
 
 using config_t = tao::config::value;
 
+// The queue and stack benchmarks only differ in how the data structure is created, so both
+// use push_pop_benchmark; the operations are performed via the try_push/try_pop overloads
+// from queues.hpp and stacks.hpp.
+template <class T, template <class> class Builder>
+struct push_pop_benchmark;
+
 template <class T>
-struct queue_benchmark;
+using queue_benchmark = push_pop_benchmark<T, queue_builder>;
 
 template <class T>
+using stack_benchmark = push_pop_benchmark<T, stack_builder>;
+
+template <class T, template <class> class Builder>
 struct benchmark_thread : execution_thread {
-  benchmark_thread(queue_benchmark<T>& benchmark, std::uint32_t id, const execution& exec) :
+  benchmark_thread(push_pop_benchmark<T, Builder>& benchmark, std::uint32_t id, const execution& exec) :
       execution_thread(id, exec),
       _benchmark(benchmark) {}
   void initialize(std::uint32_t num_threads) override;
@@ -26,6 +37,9 @@ struct benchmark_thread : execution_thread {
       {"push", push_operations},
       {"pop", pop_operations},
     };
+    if (_benchmark.measure_latency) {
+      data.try_emplace("latency", _latency.as_json());
+    }
     return {data, push_operations + pop_operations};
   }
 
@@ -38,18 +52,21 @@ protected:
   std::size_t pop_operations = 0;
 
 private:
-  queue_benchmark<T>& _benchmark;
+  bool execute_operation(T& queue, bool is_pop, std::uint32_t key);
+
+  push_pop_benchmark<T, Builder>& _benchmark;
+  latency_histogram _latency;
   static constexpr unsigned ratio_bits = 8;
   unsigned _pop_ratio; // multiple of 2^ratio_bits;
 	//std::atomic_uint counter1;
 };
 
-template <class T>
-struct push_thread : benchmark_thread<T> {
-  push_thread(queue_benchmark<T>& benchmark, std::uint32_t id, const execution& exec) :
-      benchmark_thread<T>(benchmark, id, exec) {}
+template <class T, template <class> class Builder>
+struct push_thread : benchmark_thread<T, Builder> {
+  push_thread(push_pop_benchmark<T, Builder>& benchmark, std::uint32_t id, const execution& exec) :
+      benchmark_thread<T, Builder>(benchmark, id, exec) {}
   void setup(const config_t& config) override {
-    benchmark_thread<T>::setup(config);
+    benchmark_thread<T, Builder>::setup(config);
     auto ratio = config.optional<double>("pop_ratio").value_or(0.0);
     if (ratio > 1.0 || ratio < 0.0) {
       throw std::runtime_error("Invalid pop_ratio value");
@@ -58,12 +75,12 @@ struct push_thread : benchmark_thread<T> {
   }
 };
 
-template <class T>
-struct pop_thread : benchmark_thread<T> {
-  pop_thread(queue_benchmark<T>& benchmark, std::uint32_t id, const execution& exec) :
-      benchmark_thread<T>(benchmark, id, exec) {}
+template <class T, template <class> class Builder>
+struct pop_thread : benchmark_thread<T, Builder> {
+  pop_thread(push_pop_benchmark<T, Builder>& benchmark, std::uint32_t id, const execution& exec) :
+      benchmark_thread<T, Builder>(benchmark, id, exec) {}
   void setup(const config_t& config) override {
-    benchmark_thread<T>::setup(config);
+    benchmark_thread<T, Builder>::setup(config);
     auto ratio = config.optional<double>("push_ratio").value_or(0.0);
     if (ratio > 1.0 || ratio < 0.0) {
       throw std::runtime_error("Invalid push_ratio value");
@@ -72,17 +89,17 @@ struct pop_thread : benchmark_thread<T> {
   }
 };
 
-template <class T>
-struct queue_benchmark : benchmark {
+template <class T, template <class> class Builder>
+struct push_pop_benchmark : benchmark {
   void setup(const config_t& config) override;
 
   std::unique_ptr<execution_thread>
     create_thread(std::uint32_t id, const execution& exec, const std::string& type) override {
     if (type == "producer") {
-      return std::make_unique<push_thread<T>>(*this, id, exec);
+      return std::make_unique<push_thread<T, Builder>>(*this, id, exec);
     }
     if (type == "consumer") {
-      return std::make_unique<pop_thread<T>>(*this, id, exec);
+      return std::make_unique<pop_thread<T, Builder>>(*this, id, exec);
     }
     throw std::runtime_error("Invalid thread type: " + type);
   }
@@ -90,18 +107,20 @@ struct queue_benchmark : benchmark {
   std::unique_ptr<T> queue;
   std::uint32_t number_of_elements = 100;
   std::uint32_t batch_size;
+  bool measure_latency = false;
   config::prefill prefill;
 };
 
-template <class T>
-void queue_benchmark<T>::setup(const config_t& config) {
-  queue = queue_builder<T>::create(config.at("ds"));
+template <class T, template <class> class Builder>
+void push_pop_benchmark<T, Builder>::setup(const config_t& config) {
+  queue = Builder<T>::create(config.at("ds"));
   batch_size = config.optional<std::uint32_t>("batch_size").value_or(100);
+  measure_latency = config.optional<bool>("latency").value_or(false);
   prefill.setup(config, 100);
 }
 
-template <class T>
-void benchmark_thread<T>::initialize(std::uint32_t num_threads) {
+template <class T, template <class> class Builder>
+void benchmark_thread<T, Builder>::initialize(std::uint32_t num_threads) {
   auto id = this->id() & execution::thread_id_mask;
   std::uint64_t cnt = _benchmark.prefill.get_thread_quota(id, num_threads);
 	
@@ -118,8 +137,8 @@ void benchmark_thread<T>::initialize(std::uint32_t num_threads) {
 	
 }
 
-template <class T>
-void benchmark_thread<T>::run() {
+template <class T, template <class> class Builder>
+void benchmark_thread<T, Builder>::run() {
   T& queue = *_benchmark.queue;
 	
   const std::uint32_t n = _benchmark.batch_size;
@@ -134,16 +153,17 @@ void benchmark_thread<T>::run() {
     auto action = r & ((1 << ratio_bits) - 1);
     std::uint32_t key = (r >> ratio_bits) % number_of_keys;
 		
-
-    if (action < _pop_ratio) {
-      //unsigned value;
-      if (try_pop(queue, key)) {
-        ++pop;
-      }
+    const bool is_pop = action < _pop_ratio;
+    bool success;
+    if (_benchmark.measure_latency) {
+      const auto start = std::chrono::steady_clock::now();
+      success = execute_operation(queue, is_pop, key);
+      _latency.record(std::chrono::steady_clock::now() - start);
     } else {
-			//auto key1 = ++counter1;
-			if (try_push(queue, key)) 
-				++push;
+      success = execute_operation(queue, is_pop, key);
+    }
+    if (success) {
+      ++(is_pop ? pop : push);
     }
     simulate_workload();
   }
@@ -153,10 +173,18 @@ void benchmark_thread<T>::run() {
 	
 }
 
+template <class T, template <class> class Builder>
+bool benchmark_thread<T, Builder>::execute_operation(T& queue, bool is_pop, std::uint32_t key) {
+  if (is_pop) {
+    return try_pop(queue, key);
+  }
+  return try_push(queue, key);
+}
+
 namespace {
-template <class T>
+template <class T, template <class> class Benchmark = queue_benchmark>
 inline std::shared_ptr<benchmark_builder> make_benchmark_builder() {
-  return std::make_shared<typed_benchmark_builder<T, queue_benchmark>>();
+  return std::make_shared<typed_benchmark_builder<T, Benchmark>>();
 }
 
 auto benchmark_variations() {
@@ -183,6 +211,25 @@ auto benchmark_variations() {
   #endif
 #endif
 
+#ifdef WITH_LCRQ_QUEUE
+  #ifdef WITH_GENERIC_EPOCH_BASED
+    make_benchmark_builder<lcrq_queue<QUEUE_ITEM*, policy::reclaimer<reclamation::epoch_based<>>>>(),
+    make_benchmark_builder<
+      lcrq_queue<QUEUE_ITEM*, policy::reclaimer<reclamation::epoch_based<>>, policy::entries_per_node<4096>>>(),
+    make_benchmark_builder<lcrq_queue<QUEUE_ITEM*, policy::reclaimer<reclamation::new_epoch_based<>>>>(),
+    make_benchmark_builder<lcrq_queue<QUEUE_ITEM*, policy::reclaimer<reclamation::debra<>>>>(),
+  #endif
+  #ifdef WITH_QUIESCENT_STATE_BASED
+    make_benchmark_builder<lcrq_queue<QUEUE_ITEM*, policy::reclaimer<reclamation::quiescent_state_based>>>(),
+  #endif
+  #ifdef WITH_HAZARD_POINTER
+    make_benchmark_builder<
+      lcrq_queue<QUEUE_ITEM*,
+                 policy::reclaimer<reclamation::hazard_pointer<>::with<
+                   policy::allocation_strategy<reclamation::hp_allocation::static_strategy<3>>>>>>(),
+  #endif
+#endif
+
 #ifdef WITH_LOCK_FREE_730_QUEUE
   #ifdef WITH_GENERIC_EPOCH_BASED
     make_benchmark_builder<lock_free_730<QUEUE_ITEM, policy::reclaimer<reclamation::epoch_based<>>>>(),
@@ -228,6 +275,10 @@ auto benchmark_variations() {
 #ifdef WITH_VYUKOV_BOUNDED_QUEUE
     make_benchmark_builder<vyukov_bounded_queue<QUEUE_ITEM, policy::default_to_weak<true>>>(),
     make_benchmark_builder<vyukov_bounded_queue<QUEUE_ITEM, policy::default_to_weak<false>>>(),
+    // variants with a false-sharing-free cell layout
+    make_benchmark_builder<
+      vyukov_bounded_queue<QUEUE_ITEM, policy::default_to_weak<false>, policy::padding_bytes<48>>>(),
+    make_benchmark_builder<vyukov_bounded_queue<QUEUE_ITEM, policy::default_to_weak<false>, policy::remap_index<true>>>(),
 #endif
 
 #ifdef WITH_KIRSCH_KFIFO_QUEUE
@@ -257,6 +308,28 @@ auto benchmark_variations() {
 
 #ifdef WITH_NIKOLAEV_BOUNDED_QUEUE
     make_benchmark_builder<nikolaev_bounded_queue<QUEUE_ITEM>>(),
+    make_benchmark_builder<nikolaev_bounded_queue<QUEUE_ITEM, policy::ring<nikolaev_wcq_ring>>>(),
+#endif
+
+#ifdef WITH_NIKOLAEV_QUEUE
+  #ifdef WITH_GENERIC_EPOCH_BASED
+    make_benchmark_builder<nikolaev_queue<QUEUE_ITEM, policy::reclaimer<reclamation::epoch_based<>>>>(),
+    make_benchmark_builder<
+      nikolaev_queue<QUEUE_ITEM, policy::ring<nikolaev_wcq_ring>, policy::reclaimer<reclamation::epoch_based<>>>>(),
+  #endif
+  #ifdef WITH_QUIESCENT_STATE_BASED
+    make_benchmark_builder<nikolaev_queue<QUEUE_ITEM, policy::reclaimer<reclamation::quiescent_state_based>>>(),
+    make_benchmark_builder<nikolaev_queue<QUEUE_ITEM,
+                                          policy::ring<nikolaev_wcq_ring>,
+                                          policy::reclaimer<reclamation::quiescent_state_based>>>(),
+  #endif
+#endif
+
+#ifdef WITH_VYUKOV_MPSC_QUEUE
+    make_benchmark_builder<mpsc_mailbox<>>(),
+#endif
+#ifdef WITH_SPSC_BOUNDED_QUEUE
+    make_benchmark_builder<spsc_bounded_queue<QUEUE_ITEM>>(),
 #endif
 
 #ifdef WITH_CDS_MSQUEUE
@@ -276,8 +349,46 @@ auto benchmark_variations() {
 #endif
   };
 }
+
+auto stack_benchmark_variations() {
+  using namespace xenium; // NOLINT
+  return benchmark_builders{
+#ifdef WITH_TREIBER_STACK
+  #ifdef WITH_GENERIC_EPOCH_BASED
+    make_benchmark_builder<treiber_stack<STACK_ITEM, policy::reclaimer<reclamation::epoch_based<>>>, stack_benchmark>(),
+    make_benchmark_builder<
+      treiber_stack<STACK_ITEM, policy::reclaimer<reclamation::epoch_based<>>, policy::elimination_slots<4>>, stack_benchmark>(),
+    make_benchmark_builder<
+      treiber_stack<STACK_ITEM, policy::reclaimer<reclamation::epoch_based<>>, policy::elimination_slots<16>>, stack_benchmark>(),
+    make_benchmark_builder<treiber_stack<STACK_ITEM, policy::reclaimer<reclamation::new_epoch_based<>>>, stack_benchmark>(),
+    make_benchmark_builder<treiber_stack<STACK_ITEM, policy::reclaimer<reclamation::debra<>>>, stack_benchmark>(),
+  #endif
+  #ifdef WITH_QUIESCENT_STATE_BASED
+    make_benchmark_builder<treiber_stack<STACK_ITEM, policy::reclaimer<reclamation::quiescent_state_based>>, stack_benchmark>(),
+    make_benchmark_builder<treiber_stack<STACK_ITEM,
+                                         policy::reclaimer<reclamation::quiescent_state_based>,
+                                         policy::elimination_slots<4>>, stack_benchmark>(),
+  #endif
+  #ifdef WITH_HAZARD_POINTER
+    make_benchmark_builder<
+      treiber_stack<STACK_ITEM,
+                    policy::reclaimer<reclamation::hazard_pointer<>::with<
+                      policy::allocation_strategy<reclamation::hp_allocation::static_strategy<1>>>>>, stack_benchmark>(),
+    make_benchmark_builder<
+      treiber_stack<STACK_ITEM,
+                    policy::reclaimer<reclamation::hazard_pointer<>::with<
+                      policy::allocation_strategy<reclamation::hp_allocation::static_strategy<1>>>>,
+                    policy::elimination_slots<4>>, stack_benchmark>(),
+  #endif
+#endif
+  };
+}
 } // namespace
 
 void register_queue_benchmark(registered_benchmarks& benchmarks) {
   benchmarks.emplace("queue", benchmark_variations());
 }
+
+void register_stack_benchmark(registered_benchmarks& benchmarks) {
+  benchmarks.emplace("stack", stack_benchmark_variations());
+}
@@ -1,3 +1,5 @@
+#pragma once
+
 #include "benchmark.hpp"
 #include "descriptor.hpp"
 #include "reclaimers.hpp"
@@ -68,6 +70,39 @@ bool try_pop(xenium::ramalhete_queue<T*, Policies...>& queue, T& item) {
 } // namespace
 #endif
 
+#ifdef WITH_LCRQ_QUEUE
+  #include <xenium/lcrq_queue.hpp>
+
+template <class T, class... Policies>
+struct descriptor<xenium::lcrq_queue<T, Policies...>> {
+  static tao::json::value generate() {
+    using queue = xenium::lcrq_queue<T, Policies...>;
+    return {{"type", "lcrq_queue"},
+            {"entries_per_node", queue::entries_per_node},
+            {"reclaimer", descriptor<typename queue::reclaimer>::generate()}};
+  }
+};
+
+namespace { // NOLINT
+template <class T, class... Policies>
+bool try_push(xenium::lcrq_queue<T*, Policies...>& queue, T item) {
+  queue.push(new T(item));
+  return true;
+}
+
+template <class T, class... Policies>
+bool try_pop(xenium::lcrq_queue<T*, Policies...>& queue, T& item) {
+  T* value;
+  auto result = queue.try_pop(value);
+  if (result) {
+    item = *value;
+    delete value;
+  }
+  return result;
+}
+} // namespace
+#endif
+
 #ifdef WITH_MICHAEL_SCOTT_QUEUE
   #include <xenium/michael_scott_queue.hpp>
 
@@ -100,7 +135,11 @@ template <class T, class... Policies>
 struct descriptor<xenium::vyukov_bounded_queue<T, Policies...>> {
   static tao::json::value generate() {
     using queue = xenium::vyukov_bounded_queue<T, Policies...>;
-    return {{"type", "vyukov_bounded_queue"}, {"weak", queue::default_to_weak}, {"size", DYNAMIC_PARAM}};
+    return {{"type", "vyukov_bounded_queue"},
+            {"weak", queue::default_to_weak},
+            {"padding_bytes", queue::padding_bytes},
+            {"remap_index", queue::remap_index},
+            {"size", DYNAMIC_PARAM}};
   }
 };
 
@@ -223,12 +262,33 @@ bool try_pop(xenium::kirsch_bounded_kfifo_queue<T*, Policies...>& queue, T& item
 } // namespace
 #endif
 
+#if defined(WITH_NIKOLAEV_BOUNDED_QUEUE) || defined(WITH_NIKOLAEV_QUEUE)
+  #include <xenium/detail/nikolaev_ring.hpp>
+
+namespace { // NOLINT
+// adds the ring configuration of a nikolaev_queue or nikolaev_bounded_queue to its descriptor
+template <class Queue>
+tao::json::value with_nikolaev_ring(tao::json::value descriptor) {
+  if constexpr (std::is_same_v<typename Queue::ring_type, xenium::nikolaev_wcq_ring>) {
+    descriptor.try_emplace("ring", "wcq");
+    descriptor.try_emplace("patience", Queue::patience);
+  } else {
+    descriptor.try_emplace("ring", "scq");
+  }
+  return descriptor;
+}
+} // namespace
+#endif
+
 #ifdef WITH_NIKOLAEV_BOUNDED_QUEUE
   #include <xenium/nikolaev_bounded_queue.hpp>
 
 template <class T, class... Policies>
 struct descriptor<xenium::nikolaev_bounded_queue<T, Policies...>> {
-  static tao::json::value generate() { return {{"type", "nikolaev_bounded_queue"}, {"capacity", DYNAMIC_PARAM}}; }
+  static tao::json::value generate() {
+    using queue = xenium::nikolaev_bounded_queue<T, Policies...>;
+    return with_nikolaev_ring<queue>({{"type", "nikolaev_bounded_queue"}, {"capacity", DYNAMIC_PARAM}});
+  }
 };
 
 template <class T, class... Policies>
@@ -259,6 +319,124 @@ bool try_pop(xenium::nikolaev_bounded_queue<T, Policies...>& queue, T& item) {
 } // namespace
 #endif
 
+#ifdef WITH_NIKOLAEV_QUEUE
+  #include <xenium/nikolaev_queue.hpp>
+
+template <class T, class... Policies>
+struct descriptor<xenium::nikolaev_queue<T, Policies...>> {
+  static tao::json::value generate() {
+    using queue = xenium::nikolaev_queue<T, Policies...>;
+    return with_nikolaev_ring<queue>(
+      {{"type", "nikolaev_queue"}, {"reclaimer", descriptor<typename queue::reclaimer>::generate()}});
+  }
+};
+
+namespace { // NOLINT
+template <class T, class... Policies>
+bool try_push(xenium::nikolaev_queue<T, Policies...>& queue, T item) {
+  queue.push(std::move(item));
+  return true;
+}
+
+template <class T, class... Policies>
+bool try_pop(xenium::nikolaev_queue<T, Policies...>& queue, T& item) {
+  return queue.try_pop(item);
+}
+} // namespace
+#endif
+
+#ifdef WITH_VYUKOV_MPSC_QUEUE
+  #include <xenium/vyukov_mpsc_queue.hpp>
+
+struct mpsc_message : xenium::vyukov_mpsc_queue_hook {
+  explicit mpsc_message(QUEUE_ITEM value) : value(value) {}
+  QUEUE_ITEM value;
+};
+
+// vyukov_mpsc_queue is intrusive and does not own its elements, so every pushed
+// message is allocated by the producer and deleted by the consumer. This wrapper
+// deletes the messages that are still in the queue at the end of a round.
+template <class... Policies>
+struct mpsc_mailbox : xenium::vyukov_mpsc_queue<mpsc_message, Policies...> {
+  ~mpsc_mailbox() {
+    mpsc_message* msg;
+    while (this->try_pop(msg)) {
+      delete msg;
+    }
+  }
+};
+
+template <class... Policies>
+struct descriptor<mpsc_mailbox<Policies...>> {
+  static tao::json::value generate() { return {{"type", "vyukov_mpsc_queue"}}; }
+};
+
+template <class... Policies>
+struct region_guard<mpsc_mailbox<Policies...>> {
+  // vyukov_mpsc_queue does not have a reclaimer, so we define an
+  // empty dummy type as region_guard placeholder.
+  struct type {};
+};
+
+namespace { // NOLINT
+template <class... Policies>
+bool try_push(mpsc_mailbox<Policies...>& queue, QUEUE_ITEM item) {
+  queue.push(new mpsc_message(item));
+  return true;
+}
+
+template <class... Policies>
+bool try_pop(mpsc_mailbox<Policies...>& queue, QUEUE_ITEM& item) {
+  mpsc_message* msg;
+  if (queue.try_pop(msg)) {
+    item = msg->value;
+    delete msg;
+    return true;
+  }
+  return false;
+}
+} // namespace
+#endif
+
+#ifdef WITH_SPSC_BOUNDED_QUEUE
+  #include <xenium/spsc_bounded_queue.hpp>
+
+template <class T>
+struct descriptor<xenium::spsc_bounded_queue<T>> {
+  static tao::json::value generate() { return {{"type", "spsc_bounded_queue"}, {"capacity", DYNAMIC_PARAM}}; }
+};
+
+template <class T>
+struct queue_builder<xenium::spsc_bounded_queue<T>> {
+  static auto create(const tao::config::value& config) {
+    auto capacity = config.as<size_t>("capacity");
+    if (capacity < 2 || !xenium::utils::is_power_of_two(capacity)) {
+      throw std::runtime_error("spsc_bounded_queue capacity must be a power of two greater one");
+    }
+    return std::make_unique<xenium::spsc_bounded_queue<T>>(capacity);
+  }
+};
+
+template <class T>
+struct region_guard<xenium::spsc_bounded_queue<T>> {
+  // spsc_bounded_queue does not have a reclaimer, so we define an
+  // empty dummy type as region_guard placeholder.
+  struct type {};
+};
+
+namespace { // NOLINT
+template <class T>
+bool try_push(xenium::spsc_bounded_queue<T>& queue, T item) {
+  return queue.try_push(std::move(item));
+}
+
+template <class T>
+bool try_pop(xenium::spsc_bounded_queue<T>& queue, T& item) {
+  return queue.try_pop(item);
+}
+} // namespace
+#endif
+
 #ifdef WITH_LIBCDS
   #include <cds/gc/dhp.h>
   #include <cds/gc/hp.h>
@@ -1,3 +1,5 @@
+#pragma once
+
 #include "descriptor.hpp"
 
 #ifdef WITH_GENERIC_EPOCH_BASED
@@ -0,0 +1,37 @@
+#pragma once
+
+#include "benchmark.hpp"
+#include "descriptor.hpp"
+#include "reclaimers.hpp"
+
+template <class T>
+struct stack_builder {
+  static auto create(const tao::config::value&) { return std::make_unique<T>(); }
+};
+
+#ifdef WITH_TREIBER_STACK
+  #include <xenium/treiber_stack.hpp>
+
+template <class T, class... Policies>
+struct descriptor<xenium::treiber_stack<T, Policies...>> {
+  static tao::json::value generate() {
+    using stack = xenium::treiber_stack<T, Policies...>;
+    return {{"type", "treiber_stack"},
+            {"elimination_slots", stack::elimination_slots},
+            {"reclaimer", descriptor<typename stack::reclaimer>::generate()}};
+  }
+};
+
+namespace { // NOLINT
+template <class T, class... Policies>
+bool try_push(xenium::treiber_stack<T, Policies...>& stack, T item) {
+  stack.push(std::move(item));
+  return true;
+}
+
+template <class T, class... Policies>
+bool try_pop(xenium::treiber_stack<T, Policies...>& stack, T& item) {
+  return stack.try_pop(item);
+}
+} // namespace
+#endif
@@ -0,0 +1,296 @@
+#include <xenium/art_map.hpp>
+#include <xenium/reclamation/generic_epoch_based.hpp>
+#include <xenium/reclamation/hazard_pointer.hpp>
+#include <xenium/reclamation/quiescent_state_based.hpp>
+#include <xenium/reclamation/stamp_it.hpp>
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <cstdint>
+#include <random>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace {
+
+template <typename Reclaimer>
+struct ArtMap : ::testing::Test {
+  using map_t = xenium::art_map<int, int, xenium::policy::reclaimer<Reclaimer>>;
+  map_t map;
+};
+
+using Reclaimers =
+  ::testing::Types<xenium::reclamation::hazard_pointer<>::with<
+                     xenium::policy::allocation_strategy<xenium::reclamation::hp_allocation::static_strategy<3>>>,
+                   xenium::reclamation::quiescent_state_based,
+                   xenium::reclamation::stamp_it,
+                   xenium::reclamation::epoch_based<>::with<xenium::policy::scan_frequency<10>>,
+                   xenium::reclamation::new_epoch_based<>::with<xenium::policy::scan_frequency<10>>,
+                   xenium::reclamation::debra<>::with<xenium::policy::scan_frequency<10>>>;
+TYPED_TEST_SUITE(ArtMap, Reclaimers);
+
+TYPED_TEST(ArtMap, emplace_same_key_twice_fails_second_time) {
+  EXPECT_TRUE(this->map.emplace(42, 43));
+  EXPECT_FALSE(this->map.emplace(42, 44));
+  int value;
+  ASSERT_TRUE(this->map.try_get_value(42, value));
+  EXPECT_EQ(43, value);
+}
+
+TYPED_TEST(ArtMap, try_get_value_returns_false_for_non_existing_element) {
+  this->map.emplace(43, 44);
+  int value;
+  EXPECT_FALSE(this->map.try_get_value(42, value));
+}
+
+TYPED_TEST(ArtMap, contains_returns_false_for_non_existing_element) {
+  this->map.emplace(42, 43);
+  EXPECT_FALSE(this->map.contains(41));
+  EXPECT_FALSE(this->map.contains(43));
+}
+
+TYPED_TEST(ArtMap, contains_returns_true_for_existing_element) {
+  this->map.emplace(42, 43);
+  EXPECT_TRUE(this->map.contains(42));
+}
+
+TYPED_TEST(ArtMap, erase_existing_element_succeeds) {
+  this->map.emplace(42, 43);
+  EXPECT_TRUE(this->map.erase(42));
+  EXPECT_FALSE(this->map.contains(42));
+}
+
+TYPED_TEST(ArtMap, erase_nonexisting_element_fails) {
+  EXPECT_FALSE(this->map.erase(42));
+}
+
+TYPED_TEST(ArtMap, erase_existing_element_twice_fails_the_second_time) {
+  this->map.emplace(42, 43);
+  EXPECT_TRUE(this->map.erase(42));
+  EXPECT_FALSE(this->map.erase(42));
+}
+
+TYPED_TEST(ArtMap, negative_and_positive_keys_are_distinct) {
+  EXPECT_TRUE(this->map.emplace(-1, 1));
+  EXPECT_TRUE(this->map.emplace(1, 2));
+  EXPECT_TRUE(this->map.emplace(0, 3));
+  int value;
+  ASSERT_TRUE(this->map.try_get_value(-1, value));
+  EXPECT_EQ(1, value);
+  ASSERT_TRUE(this->map.try_get_value(1, value));
+  EXPECT_EQ(2, value);
+  ASSERT_TRUE(this->map.try_get_value(0, value));
+  EXPECT_EQ(3, value);
+}
+
+TYPED_TEST(ArtMap, elements_remain_accessible_after_nodes_grow) {
+  // 256 consecutive keys share a 3 byte prefix, so the last inner node
+  // has to grow from Node4 to Node16, Node48 and finally Node256
+  std::vector<int> keys(1000);
+  for (int i = 0; i < 1000; ++i) {
+    keys[i] = i * 7;
+  }
+  std::shuffle(keys.begin(), keys.end(), std::mt19937(42));
+  for (int k : keys) {
+    EXPECT_TRUE(this->map.emplace(k, k * 10));
+  }
+  for (int i = 0; i < 1000; ++i) {
+    int value;
+    ASSERT_TRUE(this->map.try_get_value(i * 7, value));
+    EXPECT_EQ(i * 70, value);
+    EXPECT_FALSE(this->map.contains(i * 7 + 1));
+  }
+}
+
+TYPED_TEST(ArtMap, keys_with_diverging_prefixes_are_found) {
+  // these keys force splits of compressed paths at different levels
+  const std::vector<int> keys{0x01020304, 0x01020305, 0x01020404, 0x01030404, 0x02020304, 0x7fffffff, -0x01020304};
+  for (int k : keys) {
+    EXPECT_TRUE(this->map.emplace(k, k));
+  }
+  for (int k : keys) {
+    int value;
+    ASSERT_TRUE(this->map.try_get_value(k, value));
+    EXPECT_EQ(k, value);
+  }
+  EXPECT_FALSE(this->map.contains(0x01020306));
+  EXPECT_FALSE(this->map.contains(0x01020300));
+  EXPECT_FALSE(this->map.contains(0x01000304));
+}
+
+TYPED_TEST(ArtMap, erase_all_elements_and_reinsert_them) {
+  std::vector<int> keys(1000);
+  for (int i = 0; i < 1000; ++i) {
+    keys[i] = i * 3;
+  }
+  std::shuffle(keys.begin(), keys.end(), std::mt19937(1));
+  for (int k : keys) {
+    EXPECT_TRUE(this->map.emplace(k, k));
+  }
+  std::shuffle(keys.begin(), keys.end(), std::mt19937(2));
+  for (int k : keys) {
+    EXPECT_TRUE(this->map.erase(k));
+    EXPECT_FALSE(this->map.contains(k));
+  }
+  for (int k : keys) {
+    EXPECT_FALSE(this->map.contains(k));
+    EXPECT_TRUE(this->map.emplace(k, k));
+  }
+  for (int k : keys) {
+    EXPECT_TRUE(this->map.contains(k));
+  }
+}
+
+TYPED_TEST(ArtMap, supports_string_keys) {
+  using Reclaimer = TypeParam;
+  xenium::art_map<std::string, int, xenium::policy::reclaimer<Reclaimer>> map;
+  // "a", "ab", ... are prefixes of each other; the long common prefix
+  // exceeds the prefix length that can be stored in a single node
+  const std::vector<std::string> keys{
+    "", "a", "ab", "abc", "b", "common_prefix_longer_than_eight_bytes_1", "common_prefix_longer_than_eight_bytes_2"};
+  for (std::size_t i = 0; i < keys.size(); ++i) {
+    EXPECT_TRUE(map.emplace(keys[i], static_cast<int>(i)));
+  }
+  EXPECT_FALSE(map.emplace("ab", 42));
+  for (std::size_t i = 0; i < keys.size(); ++i) {
+    int value;
+    ASSERT_TRUE(map.try_get_value(keys[i], value));
+    EXPECT_EQ(static_cast<int>(i), value);
+  }
+  EXPECT_FALSE(map.contains("abcd"));
+  EXPECT_FALSE(map.contains("common_prefix_longer_than_eight_bytes_"));
+  EXPECT_FALSE(map.contains("common_prefix"));
+
+  EXPECT_TRUE(map.erase("ab"));
+  EXPECT_TRUE(map.erase("common_prefix_longer_than_eight_bytes_1"));
+  EXPECT_FALSE(map.contains("ab"));
+  EXPECT_TRUE(map.contains("abc"));
+  EXPECT_TRUE(map.contains("common_prefix_longer_than_eight_bytes_2"));
+}
+
+TYPED_TEST(ArtMap, supports_64bit_keys) {
+  using Reclaimer = TypeParam;
+  xenium::art_map<std::uint64_t, std::uint64_t, xenium::policy::reclaimer<Reclaimer>> map;
+  std::mt19937_64 rand(7);
+  std::vector<std::uint64_t> keys;
+  for (int i = 0; i < 500; ++i) {
+    keys.push_back(rand());
+  }
+  for (auto k : keys) {
+    map.emplace(k, ~k);
+  }
+  for (auto k : keys) {
+    std::uint64_t value;
+    ASSERT_TRUE(map.try_get_value(k, value));
+    EXPECT_EQ(~k, value);
+  }
+  for (auto k : keys) {
+    EXPECT_TRUE(map.erase(k));
+  }
+  for (auto k : keys) {
+    EXPECT_FALSE(map.contains(k));
+  }
+}
+
+namespace {
+#ifdef DEBUG
+  const int MaxIterations = 1000;
+#else
+  const int MaxIterations = 10000;
+#endif
+} // namespace
+
+TYPED_TEST(ArtMap, parallel_usage) {
+  using Reclaimer = TypeParam;
+  auto& map = this->map;
+
+  std::vector<std::thread> threads;
+  for (int i = 0; i < 8; ++i) {
+    threads.push_back(std::thread([i, &map] {
+      for (int j = 0; j < MaxIterations; ++j) {
+        [[maybe_unused]] typename Reclaimer::region_guard guard{};
+        int key = i + 8 * (j % 64);
+        EXPECT_FALSE(map.contains(key));
+        EXPECT_TRUE(map.emplace(key, j));
+        int value;
+        ASSERT_TRUE(map.try_get_value(key, value));
+        EXPECT_EQ(j, value);
+        EXPECT_TRUE(map.erase(key));
+        EXPECT_FALSE(map.contains(key));
+      }
+    }));
+  }
+
+  for (auto& thread : threads) {
+    thread.join();
+  }
+  for (int key = 0; key < 512; ++key) {
+    EXPECT_FALSE(map.contains(key));
+  }
+}
+
+TYPED_TEST(ArtMap, parallel_usage_with_same_values) {
+  using Reclaimer = TypeParam;
+  auto& map = this->map;
+
+  std::vector<std::thread> threads;
+  for (int i = 0; i < 8; ++i) {
+    threads.push_back(std::thread([&map] {
+      for (int j = 0; j < MaxIterations / 10; ++j) {
+        for (int k = 0; k < 10; ++k) {
+          [[maybe_unused]] typename Reclaimer::region_guard guard{};
+          map.contains(k);
+          map.emplace(k, k);
+          int value;
+          if (map.try_get_value(k, value)) {
+            EXPECT_EQ(k, value);
+          }
+          map.erase(k);
+        }
+      }
+    }));
+  }
+
+  for (auto& thread : threads) {
+    thread.join();
+  }
+}
+
+TYPED_TEST(ArtMap, parallel_usage_with_growing_nodes) {
+  using Reclaimer = TypeParam;
+  auto& map = this->map;
+  // keys that are never removed must remain visible while other threads
+  // cause the shared inner nodes to grow, split and collapse
+  for (int i = 0; i < 1024; i += 4) {
+    map.emplace(i, i);
+  }
+
+  std::vector<std::thread> threads;
+  for (int i = 0; i < 8; ++i) {
+    threads.push_back(std::thread([i, &map] {
+      std::mt19937 rand(i);
+      for (int j = 0; j < MaxIterations / 10; ++j) {
+        [[maybe_unused]] typename Reclaimer::region_guard guard{};
+        int key = static_cast<int>(rand() % 1024);
+        if (key % 4 == 0) {
+          int value;
+          ASSERT_TRUE(map.try_get_value(key, value));
+          EXPECT_EQ(key, value);
+        } else {
+          map.emplace(key, key);
+          map.erase(key);
+        }
+      }
+    }));
+  }
+
+  for (auto& thread : threads) {
+    thread.join();
+  }
+  for (int i = 0; i < 1024; ++i) {
+    EXPECT_EQ(i % 4 == 0, map.contains(i));
+  }
+}
+} // namespace
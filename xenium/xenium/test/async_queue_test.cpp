@@ -0,0 +1,235 @@
+// async_queue requires C++20 coroutine support; the test is skipped for older language modes.
+#if defined(__cpp_impl_coroutine) && __has_include(<coroutine>)
+
+  #include <xenium/async_queue.hpp>
+  #include <xenium/michael_scott_queue.hpp>
+  #include <xenium/ramalhete_queue.hpp>
+  #include <xenium/reclamation/generic_epoch_based.hpp>
+  #include <xenium/vyukov_bounded_queue.hpp>
+
+  #include "queue_adapter_factory.hpp"
+
+  #include <gtest/gtest.h>
+
+  #include <algorithm>
+  #include <atomic>
+  #include <coroutine>
+  #include <cstdint>
+  #include <exception>
+  #include <limits>
+  #include <memory>
+  #include <thread>
+  #include <vector>
+
+namespace {
+
+// a minimal eagerly started coroutine type that destroys itself on completion
+struct detached_task {
+  struct promise_type {
+    detached_task get_return_object() noexcept { return {}; }
+    std::suspend_never initial_suspend() noexcept { return {}; }
+    std::suspend_never final_suspend() noexcept { return {}; }
+    void return_void() noexcept {}
+    void unhandled_exception() noexcept { std::terminate(); }
+  };
+};
+
+using reclaimer = xenium::reclamation::epoch_based<>::with<xenium::policy::scan_frequency<10>>;
+
+template <typename Queue>
+struct AsyncQueue : testing::Test {
+  std::unique_ptr<xenium::async_queue<Queue>> queue = queue_adapter_factory<xenium::async_queue, Queue>::create();
+};
+
+using Queues = ::testing::Types<xenium::michael_scott_queue<int, xenium::policy::reclaimer<reclaimer>>,
+                                xenium::ramalhete_queue<int, xenium::policy::reclaimer<reclaimer>>,
+                                xenium::vyukov_bounded_queue<int>>;
+TYPED_TEST_SUITE(AsyncQueue, Queues);
+
+template <class Queue>
+detached_task pop_into(xenium::async_queue<Queue>& queue, int& result, bool& done) {
+  result = co_await xenium::async_pop(queue);
+  done = true;
+}
+
+template <class Queue>
+detached_task push_value(xenium::async_queue<Queue>& queue, int value, bool& done) {
+  co_await xenium::async_push(queue, value);
+  done = true;
+}
+
+TYPED_TEST(AsyncQueue, async_pop_completes_immediately_if_queue_is_not_empty) {
+  ASSERT_TRUE(this->queue->try_push(42));
+  int result = 0;
+  bool done = false;
+  pop_into(*this->queue, result, done);
+  EXPECT_TRUE(done);
+  EXPECT_EQ(42, result);
+}
+
+TYPED_TEST(AsyncQueue, async_pop_is_resumed_by_try_push) {
+  int result = 0;
+  bool done = false;
+  pop_into(*this->queue, result, done);
+  EXPECT_FALSE(done);
+
+  ASSERT_TRUE(this->queue->try_push(42));
+  EXPECT_TRUE(done);
+  EXPECT_EQ(42, result);
+
+  int elem = 0;
+  EXPECT_FALSE(this->queue->try_pop(elem));
+}
+
+TYPED_TEST(AsyncQueue, multiple_waiting_consumers_are_resumed_in_turn) {
+  int results[3] = {};
+  bool done[3] = {};
+  for (int i = 0; i < 3; ++i) {
+    pop_into(*this->queue, results[i], done[i]);
+  }
+
+  for (int i = 0; i < 3; ++i) {
+    ASSERT_TRUE(this->queue->try_push(i + 1));
+    int completed = 0;
+    for (bool d : done) {
+      completed += d ? 1 : 0;
+    }
+    EXPECT_EQ(i + 1, completed);
+  }
+  EXPECT_EQ(6, results[0] + results[1] + results[2]);
+}
+
+TEST(AsyncQueue, async_push_is_resumed_by_try_pop_when_bounded_queue_is_full) {
+  xenium::async_queue<xenium::vyukov_bounded_queue<int>> queue(2);
+  static_assert(decltype(queue)::is_bounded);
+  bool done[3] = {};
+  for (int i = 0; i < 3; ++i) {
+    push_value(queue, i + 1, done[i]);
+  }
+  EXPECT_TRUE(done[0]);
+  EXPECT_TRUE(done[1]);
+  EXPECT_FALSE(done[2]);
+
+  int elem = 0;
+  ASSERT_TRUE(queue.try_pop(elem));
+  EXPECT_EQ(1, elem);
+  EXPECT_TRUE(done[2]);
+  ASSERT_TRUE(queue.try_pop(elem));
+  EXPECT_EQ(2, elem);
+  ASSERT_TRUE(queue.try_pop(elem));
+  EXPECT_EQ(3, elem);
+}
+
+detached_task push_unique(xenium::async_queue<xenium::vyukov_bounded_queue<std::unique_ptr<int>>>& queue,
+                          int value,
+                          bool& done) {
+  co_await xenium::async_push(queue, std::make_unique<int>(value));
+  done = true;
+}
+
+TEST(AsyncQueue, suspended_async_push_retries_with_the_original_value) {
+  xenium::async_queue<xenium::vyukov_bounded_queue<std::unique_ptr<int>>> queue(2);
+  bool done[3] = {};
+  for (int i = 0; i < 3; ++i) {
+    push_unique(queue, i + 1, done[i]);
+  }
+  EXPECT_FALSE(done[2]);
+
+  for (int i = 0; i < 3; ++i) {
+    std::unique_ptr<int> elem;
+    ASSERT_TRUE(queue.try_pop(elem));
+    ASSERT_NE(nullptr, elem);
+    EXPECT_EQ(i + 1, *elem);
+  }
+  EXPECT_TRUE(done[2]);
+}
+
+std::uintptr_t stack_position() {
+  int marker = 0;
+  return reinterpret_cast<std::uintptr_t>(&marker);
+}
+
+using relay_queue = xenium::async_queue<xenium::vyukov_bounded_queue<int>>;
+
+detached_task relay(relay_queue& from, relay_queue& to, std::uintptr_t& min_position, std::uintptr_t& max_position) {
+  int value = co_await xenium::async_pop(from);
+  auto position = stack_position();
+  min_position = std::min(min_position, position);
+  max_position = std::max(max_position, position);
+  EXPECT_TRUE(to.try_push(value + 1));
+}
+
+TEST(AsyncQueue, coroutines_resumed_by_resumed_coroutines_do_not_grow_the_stack) {
+  constexpr int num_relays = 1000;
+  std::vector<std::unique_ptr<relay_queue>> queues;
+  for (int i = 0; i <= num_relays; ++i) {
+    queues.push_back(std::make_unique<relay_queue>(2));
+  }
+  std::uintptr_t min_position = std::numeric_limits<std::uintptr_t>::max();
+  std::uintptr_t max_position = 0;
+  for (int i = 0; i < num_relays; ++i) {
+    relay(*queues[i], *queues[i + 1], min_position, max_position);
+  }
+
+  // each relay is resumed by the push of its predecessor; if they were resumed recursively,
+  // the last one would run more than a hundred kilobytes further down the stack than the first.
+  ASSERT_TRUE(queues.front()->try_push(0));
+  EXPECT_LT(max_position - min_position, 16 * 1024u);
+
+  int elem = 0;
+  ASSERT_TRUE(queues.back()->try_pop(elem));
+  EXPECT_EQ(num_relays, elem);
+}
+
+  #ifdef DEBUG
+const int MaxIterations = 2000;
+  #else
+const int MaxIterations = 20000;
+  #endif
+
+template <class Queue>
+detached_task consume(xenium::async_queue<Queue>& queue, std::atomic<long>& sum, std::atomic<int>& finished) {
+  long local_sum = 0;
+  for (int i = 0; i < MaxIterations; ++i) {
+    local_sum += co_await xenium::async_pop(queue);
+  }
+  sum.fetch_add(local_sum);
+  finished.fetch_add(1);
+}
+
+template <class Queue>
+detached_task produce(xenium::async_queue<Queue>& queue, std::atomic<int>& finished) {
+  for (int i = 1; i <= MaxIterations; ++i) {
+    co_await xenium::async_push(queue, i);
+  }
+  finished.fetch_add(1);
+}
+
+TYPED_TEST(AsyncQueue, parallel_usage) {
+  auto& queue = *this->queue;
+  constexpr int num_threads = 3;
+
+  std::atomic<long> sum{0};
+  std::atomic<int> finished{0};
+  std::vector<std::thread> threads;
+  for (int i = 0; i < num_threads; ++i) {
+    // consumers and producers are started on different threads, but are resumed
+    // by whichever thread completes their operation
+    threads.emplace_back([&queue, &sum, &finished] { consume(queue, sum, finished); });
+    threads.emplace_back([&queue, &finished] { produce(queue, finished); });
+  }
+  for (auto& thread : threads) {
+    thread.join();
+  }
+
+  // all coroutines have completed once the last operation has been performed,
+  // since suspended coroutines are resumed inline by the notifying thread
+  EXPECT_EQ(2 * num_threads, finished.load());
+  EXPECT_EQ(num_threads * (long(MaxIterations) * (MaxIterations + 1) / 2), sum.load());
+  int elem = 0;
+  EXPECT_FALSE(queue.try_pop(elem));
+}
+
+} // namespace
+
+#endif
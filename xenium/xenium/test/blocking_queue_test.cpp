@@ -0,0 +1,191 @@
+#include <xenium/blocking_queue.hpp>
+#include <xenium/kirsch_bounded_kfifo_queue.hpp>
+#include <xenium/nikolaev_bounded_queue.hpp>
+#include <xenium/nikolaev_queue.hpp>
+#include <xenium/ramalhete_queue.hpp>
+#include <xenium/reclamation/generic_epoch_based.hpp>
+#include <xenium/vyukov_bounded_queue.hpp>
+
+#include "queue_adapter_factory.hpp"
+
+#include <gtest/gtest.h>
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <memory>
+#include <thread>
+#include <vector>
+
+namespace {
+
+using reclaimer = xenium::reclamation::epoch_based<>::with<xenium::policy::scan_frequency<10>>;
+
+template <typename Queue>
+struct BlockingQueue : testing::Test {
+  std::unique_ptr<xenium::blocking_queue<Queue>> queue = queue_adapter_factory<xenium::blocking_queue, Queue>::create();
+};
+
+// kirsch_bounded_kfifo_queue can only store pointers, so all queues store pointers
+// to the entries of this table
+#ifdef DEBUG
+const std::uint32_t MaxIterations = 2000;
+#else
+const std::uint32_t MaxIterations = 20000;
+#endif
+
+std::uint32_t* value(std::uint32_t v) {
+  static const std::unique_ptr<std::uint32_t[]> values = [] {
+    std::unique_ptr<std::uint32_t[]> result(new std::uint32_t[MaxIterations + 1]);
+    for (std::uint32_t i = 0; i <= MaxIterations; ++i) {
+      result[i] = i;
+    }
+    return result;
+  }();
+  return &values[v];
+}
+
+using Queues = ::testing::Types<xenium::ramalhete_queue<std::uint32_t*, xenium::policy::reclaimer<reclaimer>>,
+                                xenium::nikolaev_queue<std::uint32_t*, xenium::policy::reclaimer<reclaimer>>,
+                                xenium::vyukov_bounded_queue<std::uint32_t*>,
+                                xenium::kirsch_bounded_kfifo_queue<std::uint32_t*>>;
+TYPED_TEST_SUITE(BlockingQueue, Queues);
+
+TYPED_TEST(BlockingQueue, pop_returns_pushed_element) {
+  this->queue->push(value(42));
+  EXPECT_EQ(value(42), this->queue->pop());
+}
+
+TYPED_TEST(BlockingQueue, try_pop_returns_false_when_queue_is_empty) {
+  std::uint32_t* elem = nullptr;
+  EXPECT_FALSE(this->queue->try_pop(elem));
+}
+
+TYPED_TEST(BlockingQueue, pop_for_returns_false_after_timeout_when_queue_is_empty) {
+  std::uint32_t* elem = nullptr;
+  const auto start = std::chrono::steady_clock::now();
+  EXPECT_FALSE(this->queue->pop_for(elem, std::chrono::milliseconds(20)));
+  EXPECT_GE(std::chrono::steady_clock::now() - start, std::chrono::milliseconds(20));
+}
+
+TYPED_TEST(BlockingQueue, pop_for_returns_pushed_element) {
+  this->queue->push(value(42));
+  std::uint32_t* elem = nullptr;
+  ASSERT_TRUE(this->queue->pop_for(elem, std::chrono::milliseconds(20)));
+  EXPECT_EQ(value(42), elem);
+}
+
+TYPED_TEST(BlockingQueue, pop_blocks_until_an_element_is_pushed) {
+  auto& queue = *this->queue;
+  std::atomic<bool> pushed{false};
+  std::thread producer([&] {
+    std::this_thread::sleep_for(std::chrono::milliseconds(20));
+    pushed.store(true);
+    queue.push(value(42));
+  });
+  EXPECT_EQ(value(42), queue.pop());
+  EXPECT_TRUE(pushed.load());
+  producer.join();
+}
+
+TYPED_TEST(BlockingQueue, pop_for_is_woken_up_by_push) {
+  auto& queue = *this->queue;
+  std::thread producer([&] {
+    std::this_thread::sleep_for(std::chrono::milliseconds(20));
+    queue.push(value(42));
+  });
+  std::uint32_t* elem = nullptr;
+  ASSERT_TRUE(queue.pop_for(elem, std::chrono::seconds(10)));
+  EXPECT_EQ(value(42), elem);
+  producer.join();
+}
+
+TEST(BlockingQueue, push_blocks_while_bounded_queue_is_full) {
+  xenium::blocking_queue<xenium::vyukov_bounded_queue<std::uint32_t*>> queue(2);
+  static_assert(decltype(queue)::is_bounded);
+  queue.push(value(1));
+  queue.push(value(2));
+  EXPECT_FALSE(queue.try_push(value(3)));
+
+  std::atomic<bool> pushed{false};
+  std::thread producer([&] {
+    queue.push(value(3));
+    pushed.store(true);
+  });
+  std::this_thread::sleep_for(std::chrono::milliseconds(20));
+  EXPECT_FALSE(pushed.load());
+  EXPECT_EQ(value(1), queue.pop());
+  producer.join();
+  EXPECT_TRUE(pushed.load());
+  EXPECT_EQ(value(2), queue.pop());
+  EXPECT_EQ(value(3), queue.pop());
+}
+
+TEST(BlockingQueue, push_retries_try_push_with_the_original_value) {
+  xenium::blocking_queue<xenium::vyukov_bounded_queue<std::unique_ptr<int>>> queue(2);
+  queue.push(std::make_unique<int>(1));
+  queue.push(std::make_unique<int>(2));
+
+  std::thread producer([&] { queue.push(std::make_unique<int>(3)); });
+  std::this_thread::sleep_for(std::chrono::milliseconds(20));
+  EXPECT_EQ(1, *queue.pop());
+  producer.join();
+  EXPECT_EQ(2, *queue.pop());
+  auto elem = queue.pop();
+  ASSERT_NE(nullptr, elem);
+  EXPECT_EQ(3, *elem);
+}
+
+// queues whose try_push takes its argument by value destroy the value if the operation fails
+static_assert(xenium::detail::is_try_push_retryable<xenium::vyukov_bounded_queue<std::unique_ptr<int>>>);
+static_assert(xenium::detail::is_try_push_retryable<xenium::nikolaev_bounded_queue<int>>);
+static_assert(!xenium::detail::is_try_push_retryable<xenium::nikolaev_bounded_queue<std::unique_ptr<int>>>);
+
+namespace overloaded {
+// if try_push is overloaded we cannot tell whether an overload takes its argument by value
+struct queue {
+  using value_type = std::unique_ptr<int>;
+  bool try_push(value_type&& value);
+  bool try_push(value_type value, int);
+};
+static_assert(!xenium::detail::is_try_push_retryable<queue>);
+} // namespace overloaded
+
+TYPED_TEST(BlockingQueue, parallel_usage) {
+  auto& queue = *this->queue;
+  constexpr int num_threads = 3;
+
+  std::atomic<std::uint64_t> sum{0};
+  std::vector<std::thread> threads;
+  for (int i = 0; i < num_threads; ++i) {
+    threads.emplace_back([&queue] {
+      for (std::uint32_t j = 1; j <= MaxIterations; ++j) {
+        queue.push(value(j));
+      }
+    });
+    threads.emplace_back([&queue, &sum] {
+      std::uint64_t local_sum = 0;
+      for (std::uint32_t j = 0; j < MaxIterations; ++j) {
+        if (j % 2 == 0) {
+          local_sum += *queue.pop();
+        } else {
+          std::uint32_t* elem = nullptr;
+          while (!queue.pop_for(elem, std::chrono::milliseconds(1))) {
+          }
+          local_sum += *elem;
+        }
+      }
+      sum.fetch_add(local_sum);
+    });
+  }
+
+  for (auto& thread : threads) {
+    thread.join();
+  }
+  const std::uint64_t expected = num_threads * (std::uint64_t(MaxIterations) * (MaxIterations + 1) / 2);
+  EXPECT_EQ(expected, sum.load());
+  std::uint32_t* elem = nullptr;
+  EXPECT_FALSE(queue.try_pop(elem));
+}
+
+} // namespace
@@ -0,0 +1,223 @@
+#include <xenium/cuckoo_hash_map.hpp>
+#include <xenium/reclamation/generic_epoch_based.hpp>
+#include <xenium/reclamation/hazard_pointer.hpp>
+#include <xenium/reclamation/quiescent_state_based.hpp>
+#include <xenium/reclamation/stamp_it.hpp>
+
+#include <gtest/gtest.h>
+
+#include <cstdint>
+#include <random>
+#include <thread>
+#include <vector>
+
+namespace {
+
+template <typename Reclaimer>
+struct CuckooHashMap : ::testing::Test {
+  // start with a small table, so that the tests exercise cuckoo paths and growing
+  using map_t = xenium::cuckoo_hash_map<int, int, xenium::policy::reclaimer<Reclaimer>>;
+  map_t map{8};
+};
+
+using Reclaimers =
+  ::testing::Types<xenium::reclamation::hazard_pointer<>::with<
+                     xenium::policy::allocation_strategy<xenium::reclamation::hp_allocation::static_strategy<3>>>,
+                   xenium::reclamation::quiescent_state_based,
+                   xenium::reclamation::stamp_it,
+                   xenium::reclamation::epoch_based<>::with<xenium::policy::scan_frequency<10>>,
+                   xenium::reclamation::new_epoch_based<>::with<xenium::policy::scan_frequency<10>>,
+                   xenium::reclamation::debra<>::with<xenium::policy::scan_frequency<10>>>;
+TYPED_TEST_SUITE(CuckooHashMap, Reclaimers);
+
+TYPED_TEST(CuckooHashMap, emplace_same_key_twice_fails_second_time) {
+  EXPECT_TRUE(this->map.emplace(42, 43));
+  EXPECT_FALSE(this->map.emplace(42, 44));
+  int value;
+  ASSERT_TRUE(this->map.try_get_value(42, value));
+  EXPECT_EQ(43, value);
+}
+
+TYPED_TEST(CuckooHashMap, try_get_value_returns_false_for_non_existing_element) {
+  this->map.emplace(43, 44);
+  int value;
+  EXPECT_FALSE(this->map.try_get_value(42, value));
+}
+
+TYPED_TEST(CuckooHashMap, contains_returns_false_for_non_existing_element) {
+  this->map.emplace(42, 43);
+  EXPECT_FALSE(this->map.contains(41));
+  EXPECT_FALSE(this->map.contains(43));
+}
+
+TYPED_TEST(CuckooHashMap, contains_returns_true_for_existing_element) {
+  this->map.emplace(42, 43);
+  EXPECT_TRUE(this->map.contains(42));
+}
+
+TYPED_TEST(CuckooHashMap, erase_existing_element_succeeds) {
+  this->map.emplace(42, 43);
+  EXPECT_TRUE(this->map.erase(42));
+  EXPECT_FALSE(this->map.contains(42));
+}
+
+TYPED_TEST(CuckooHashMap, erase_nonexisting_element_fails) {
+  EXPECT_FALSE(this->map.erase(42));
+}
+
+TYPED_TEST(CuckooHashMap, erase_existing_element_twice_fails_the_second_time) {
+  this->map.emplace(42, 43);
+  EXPECT_TRUE(this->map.erase(42));
+  EXPECT_FALSE(this->map.erase(42));
+}
+
+TYPED_TEST(CuckooHashMap, elements_remain_accessible_after_growing) {
+  for (int i = 0; i < 1000; ++i) {
+    EXPECT_TRUE(this->map.emplace(i, i * 10));
+  }
+  EXPECT_GE(this->map.capacity(), 1000u);
+  for (int i = 0; i < 1000; ++i) {
+    int value;
+    ASSERT_TRUE(this->map.try_get_value(i, value));
+    EXPECT_EQ(i * 10, value);
+  }
+  EXPECT_FALSE(this->map.contains(1000));
+}
+
+TYPED_TEST(CuckooHashMap, elements_can_be_removed_while_migration_is_pending) {
+  for (int i = 0; i < 1000; ++i) {
+    this->map.emplace(i, i);
+  }
+  // a single additional element triggers at most one more grow, leaving
+  // most of the stripes unmigrated until they are locked the next time
+  for (int i = 0; i < 1000; i += 2) {
+    EXPECT_TRUE(this->map.erase(i));
+  }
+  for (int i = 0; i < 1000; ++i) {
+    EXPECT_EQ(i % 2 != 0, this->map.contains(i));
+  }
+}
+
+TYPED_TEST(CuckooHashMap, supports_load_factors_above_90_percent) {
+  using Reclaimer = TypeParam;
+  xenium::cuckoo_hash_map<std::uint64_t, std::uint64_t, xenium::policy::reclaimer<Reclaimer>> map(1 << 14);
+  const auto capacity = map.capacity();
+  std::mt19937_64 rand(42);
+  std::size_t count = 0;
+  while (map.capacity() == capacity) {
+    if (map.emplace(rand(), 0)) {
+      ++count;
+    }
+  }
+  // the last insert caused the table to grow
+  EXPECT_GT(static_cast<double>(count - 1) / static_cast<double>(capacity), 0.9);
+}
+
+TYPED_TEST(CuckooHashMap, supports_eight_slots_per_bucket) {
+  using Reclaimer = TypeParam;
+  xenium::cuckoo_hash_map<int, int, xenium::policy::reclaimer<Reclaimer>, xenium::policy::slots_per_bucket<8>> map(8);
+  for (int i = 0; i < 1000; ++i) {
+    EXPECT_TRUE(map.emplace(i, -i));
+  }
+  for (int i = 0; i < 1000; ++i) {
+    int value;
+    ASSERT_TRUE(map.try_get_value(i, value));
+    EXPECT_EQ(-i, value);
+    EXPECT_TRUE(map.erase(i));
+  }
+}
+
+namespace {
+#ifdef DEBUG
+  const int MaxIterations = 1000;
+#else
+  const int MaxIterations = 10000;
+#endif
+} // namespace
+
+TYPED_TEST(CuckooHashMap, parallel_usage) {
+  using Reclaimer = TypeParam;
+  auto& map = this->map;
+
+  std::vector<std::thread> threads;
+  for (int i = 0; i < 8; ++i) {
+    threads.push_back(std::thread([i, &map] {
+      for (int j = 0; j < MaxIterations; ++j) {
+        [[maybe_unused]] typename Reclaimer::region_guard guard{};
+        int key = i + 8 * (j % 64);
+        EXPECT_FALSE(map.contains(key));
+        EXPECT_TRUE(map.emplace(key, j));
+        int value;
+        ASSERT_TRUE(map.try_get_value(key, value));
+        EXPECT_EQ(j, value);
+        EXPECT_TRUE(map.erase(key));
+        EXPECT_FALSE(map.contains(key));
+      }
+    }));
+  }
+
+  for (auto& thread : threads) {
+    thread.join();
+  }
+  for (int key = 0; key < 512; ++key) {
+    EXPECT_FALSE(map.contains(key));
+  }
+}
+
+TYPED_TEST(CuckooHashMap, parallel_usage_with_same_values) {
+  using Reclaimer = TypeParam;
+  auto& map = this->map;
+
+  std::vector<std::thread> threads;
+  for (int i = 0; i < 8; ++i) {
+    threads.push_back(std::thread([&map] {
+      for (int j = 0; j < MaxIterations / 10; ++j) {
+        for (int k = 0; k < 10; ++k) {
+          [[maybe_unused]] typename Reclaimer::region_guard guard{};
+          map.contains(k);
+          map.emplace(k, k);
+          int value;
+          if (map.try_get_value(k, value)) {
+            EXPECT_EQ(k, value);
+          }
+          map.erase(k);
+        }
+      }
+    }));
+  }
+
+  for (auto& thread : threads) {
+    thread.join();
+  }
+}
+
+TYPED_TEST(CuckooHashMap, parallel_usage_while_growing) {
+  using Reclaimer = TypeParam;
+  auto& map = this->map;
+
+  // every thread inserts its own keys and checks that all previously inserted
+  // keys remain visible while the table is grown and migrated concurrently
+  std::vector<std::thread> threads;
+  for (int i = 0; i < 8; ++i) {
+    threads.push_back(std::thread([i, &map] {
+      const int count = MaxIterations / 10;
+      for (int j = 0; j < count; ++j) {
+        [[maybe_unused]] typename Reclaimer::region_guard guard{};
+        const int key = i * count + j;
+        EXPECT_TRUE(map.emplace(key, key));
+        const int probe = i * count + j / 2;
+        int value;
+        ASSERT_TRUE(map.try_get_value(probe, value));
+        EXPECT_EQ(probe, value);
+      }
+    }));
+  }
+
+  for (auto& thread : threads) {
+    thread.join();
+  }
+  for (int key = 0; key < 8 * (MaxIterations / 10); ++key) {
+    EXPECT_TRUE(map.contains(key));
+  }
+}
+} // namespace
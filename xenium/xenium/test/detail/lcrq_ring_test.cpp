@@ -0,0 +1,73 @@
+#include <xenium/backoff.hpp>
+#include <xenium/detail/lcrq_ring.hpp>
+
+#include <gtest/gtest.h>
+
+#include <memory>
+
+namespace {
+
+constexpr unsigned capacity = 8;
+using ring = xenium::detail::lcrq_ring<capacity, xenium::no_backoff>;
+
+TEST(LcrqRing, construct_empty) {
+  auto queue = std::make_unique<ring>(ring::empty_value);
+  std::uint64_t v;
+  EXPECT_FALSE(queue->try_pop(v));
+  EXPECT_FALSE(queue->is_closed());
+}
+
+TEST(LcrqRing, construct_with_first_value) {
+  auto queue = std::make_unique<ring>(42);
+  std::uint64_t v;
+  ASSERT_TRUE(queue->try_pop(v));
+  EXPECT_EQ(42u, v);
+  EXPECT_FALSE(queue->try_pop(v));
+}
+
+TEST(LcrqRing, push_pop_in_fifo_order) {
+  auto queue = std::make_unique<ring>(ring::empty_value);
+  for (std::uint64_t i = 1; i <= capacity; ++i) {
+    ASSERT_TRUE(queue->try_push(i));
+  }
+  std::uint64_t v;
+  for (std::uint64_t i = 1; i <= capacity; ++i) {
+    ASSERT_TRUE(queue->try_pop(v));
+    EXPECT_EQ(i, v);
+  }
+  EXPECT_FALSE(queue->try_pop(v));
+  EXPECT_FALSE(queue->is_closed());
+}
+
+TEST(LcrqRing, push_closes_full_ring) {
+  auto queue = std::make_unique<ring>(ring::empty_value);
+  for (std::uint64_t i = 1; i <= capacity; ++i) {
+    ASSERT_TRUE(queue->try_push(i));
+  }
+  EXPECT_FALSE(queue->try_push(capacity + 1));
+  EXPECT_TRUE(queue->is_closed());
+  EXPECT_FALSE(queue->try_push(capacity + 2));
+
+  std::uint64_t v;
+  for (std::uint64_t i = 1; i <= capacity; ++i) {
+    ASSERT_TRUE(queue->try_pop(v));
+    EXPECT_EQ(i, v);
+  }
+}
+
+TEST(LcrqRing, push_does_not_close_empty_ring_while_pop_has_overtaken_tail) {
+  auto queue = std::make_unique<ring>(ring::empty_value);
+  // simulate a pop operation on the empty ring that has incremented head and moved the
+  // cell to the next round, but has not yet called fix_state
+  const auto h = queue->head.fetch_add(1);
+  queue->cells[ring::remap_index(h)].first.store(ring::safe_bit | (h + capacity));
+  ASSERT_GT(queue->head.load(), queue->tail.load());
+
+  EXPECT_TRUE(queue->try_push(42));
+  EXPECT_FALSE(queue->is_closed());
+
+  std::uint64_t v;
+  ASSERT_TRUE(queue->try_pop(v));
+  EXPECT_EQ(42u, v);
+}
+} // namespace
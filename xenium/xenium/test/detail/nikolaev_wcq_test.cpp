@@ -0,0 +1,136 @@
+#include <xenium/detail/nikolaev_wcq.hpp>
+
+#include <gtest/gtest.h>
+
+#include <atomic>
+#include <thread>
+#include <vector>
+
+namespace {
+
+template <unsigned Patience, unsigned HelpDelay>
+struct traits {
+  static constexpr std::size_t max_threads = 8;
+  static constexpr unsigned patience = Patience;
+  static constexpr unsigned help_delay = HelpDelay;
+  static constexpr unsigned pop_retries = 2;
+};
+
+using ring = xenium::detail::nikolaev_wcq<traits<16, 8>>;
+// forces (almost) every operation into the slow path and every operation to help
+using slow_ring = xenium::detail::nikolaev_wcq<traits<1, 1>>;
+
+namespace {
+  constexpr std::size_t capacity = 8;
+} // namespace
+
+TEST(NikolaevWCQ, construct_empty) {
+  ring queue(capacity, ring::empty_tag{});
+  std::uint64_t v;
+  auto res = queue.dequeue(v);
+  ASSERT_FALSE(res);
+  for (std::size_t i = 0; i < 2 * capacity; ++i) {
+    res = queue.enqueue(i / 2);
+    ASSERT_TRUE(res);
+  }
+}
+
+TEST(NikolaevWCQ, construct_full) {
+  ring queue(capacity, ring::full_tag{});
+  std::uint64_t v;
+  for (std::size_t i = 0; i < capacity; ++i) {
+    auto res = queue.dequeue(v);
+    ASSERT_TRUE(res);
+    EXPECT_EQ(i, v);
+  }
+  auto res = queue.dequeue(v);
+  ASSERT_FALSE(res);
+}
+
+TEST(NikolaevWCQ, construct_first_used) {
+  ring queue(capacity, ring::first_used_tag{});
+  std::uint64_t v;
+  auto res = queue.dequeue(v);
+  ASSERT_TRUE(res);
+  ASSERT_EQ(0, v);
+  res = queue.dequeue(v);
+  ASSERT_FALSE(res);
+}
+
+TEST(NikolaevWCQ, construct_first_empty) {
+  ring queue(capacity, ring::first_empty_tag{});
+  auto res = queue.enqueue(0);
+  ASSERT_TRUE(res);
+  std::uint64_t v;
+  for (std::size_t i = 0; i < capacity; ++i) {
+    res = queue.dequeue(v);
+    ASSERT_TRUE(res);
+    auto expected = (i + 1) % capacity;
+    EXPECT_EQ(expected, v);
+  }
+}
+
+TEST(NikolaevWCQ, enqueue_fails_after_finalize) {
+  ring queue(capacity, ring::first_used_tag{});
+  queue.finalize();
+  ASSERT_FALSE(queue.enqueue(1));
+  std::uint64_t v;
+  ASSERT_TRUE(queue.dequeue(v));
+  EXPECT_EQ(0, v);
+}
+
+#ifdef DEBUG
+const int MaxIterations = 4000;
+#else
+const int MaxIterations = 40000;
+#endif
+
+template <class Ring>
+void move_indexes_between_rings() {
+  // all indexes are initially in the free ring; each thread repeatedly moves an index from
+  // one ring to the other, so every index must be owned by at most one thread at any time.
+  Ring free_ring(capacity, typename Ring::full_tag{});
+  Ring used_ring(capacity, typename Ring::empty_tag{});
+  std::atomic<bool> owned[capacity] = {};
+
+  std::vector<std::thread> threads;
+  for (int i = 0; i < 4; ++i) {
+    threads.emplace_back([&, i] {
+      for (int j = 0; j < MaxIterations; ++j) {
+        auto& from = (i + j) % 2 == 0 ? free_ring : used_ring;
+        auto& to = (i + j) % 2 == 0 ? used_ring : free_ring;
+        std::uint64_t idx;
+        if (from.dequeue(idx)) {
+          ASSERT_LT(idx, capacity);
+          EXPECT_FALSE(owned[idx].exchange(true));
+          owned[idx].store(false);
+          EXPECT_TRUE(to.enqueue(idx));
+        }
+      }
+    });
+  }
+  for (auto& thread : threads) {
+    thread.join();
+  }
+
+  std::size_t count = 0;
+  std::uint64_t idx;
+  bool seen[capacity] = {};
+  while (free_ring.dequeue(idx)) {
+    EXPECT_FALSE(seen[idx]);
+    seen[idx] = true;
+    ++count;
+  }
+  while (used_ring.dequeue(idx)) {
+    EXPECT_FALSE(seen[idx]);
+    seen[idx] = true;
+    ++count;
+  }
+  EXPECT_EQ(capacity, count);
+}
+
+TEST(NikolaevWCQ, parallel_usage) { move_indexes_between_rings<ring>(); }
+
+TEST(NikolaevWCQ, parallel_usage_in_slow_path) { move_indexes_between_rings<slow_ring>(); }
+
+} // namespace
@@ -0,0 +1,62 @@
+#include <xenium/detail/striped_counter.hpp>
+
+#include <gtest/gtest.h>
+
+#include <atomic>
+#include <thread>
+#include <vector>
+
+namespace {
+
+TEST(StripedCounter, value_returns_sum_of_all_updates) {
+  xenium::detail::striped_counter counter;
+  EXPECT_EQ(0u, counter.value());
+  counter.increment(5);
+  counter.decrement();
+  EXPECT_EQ(4u, counter.value());
+  EXPECT_EQ(4u, counter.approximate_value());
+}
+
+TEST(StripedCounter, value_combines_updates_of_different_threads) {
+  xenium::detail::striped_counter counter;
+  std::vector<std::thread> threads;
+  for (int i = 0; i < 4; ++i) {
+    threads.emplace_back([&counter] {
+      for (int j = 0; j < 1000; ++j) {
+        counter.increment();
+      }
+      for (int j = 0; j < 500; ++j) {
+        counter.decrement();
+      }
+    });
+  }
+  for (auto& thread : threads) {
+    thread.join();
+  }
+  EXPECT_EQ(2000u, counter.value());
+}
+
+TEST(StripedCounter, value_does_not_starve_while_counter_is_constantly_updated) {
+  xenium::detail::striped_counter counter;
+  std::atomic<bool> stop{false};
+  std::vector<std::thread> threads;
+  for (int i = 0; i < 2; ++i) {
+    threads.emplace_back([&counter, &stop] {
+      while (!stop.load(std::memory_order_relaxed)) {
+        counter.increment();
+      }
+    });
+  }
+
+  std::size_t last = 0;
+  for (int i = 0; i < 1000; ++i) {
+    auto v = counter.value();
+    EXPECT_GE(v, last);
+    last = v;
+  }
+  stop.store(true);
+  for (auto& thread : threads) {
+    thread.join();
+  }
+}
+} // namespace
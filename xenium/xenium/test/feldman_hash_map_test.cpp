@@ -0,0 +1,316 @@
+#include <xenium/feldman_hash_map.hpp>
+#include <xenium/reclamation/generic_epoch_based.hpp>
+#include <xenium/reclamation/hazard_eras.hpp>
+#include <xenium/reclamation/hazard_pointer.hpp>
+#include <xenium/reclamation/quiescent_state_based.hpp>
+#include <xenium/reclamation/stamp_it.hpp>
+
+#include <gtest/gtest.h>
+
+#include <map>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace {
+
+// moves the key bits into the upper part of the hash value, so that all keys share the same
+// slots on the first levels and the trie has to be expanded down to the last level
+struct upper_bits_hash {
+  xenium::hash_t operator()(int key) const noexcept { return static_cast<xenium::hash_t>(key) << 48; }
+};
+
+struct constant_hash {
+  xenium::hash_t operator()(int /*key*/) const noexcept { return 42; }
+};
+
+template <typename Reclaimer>
+struct FeldmanHashMap : ::testing::Test {
+  using hash_map = xenium::feldman_hash_map<int, int, xenium::policy::reclaimer<Reclaimer>>;
+  hash_map map;
+};
+
+using Reclaimers =
+  ::testing::Types<xenium::reclamation::hazard_pointer<>::with<
+                     xenium::policy::allocation_strategy<xenium::reclamation::hp_allocation::static_strategy<3>>>,
+                   xenium::reclamation::hazard_eras<>::with<
+                     xenium::policy::allocation_strategy<xenium::reclamation::he_allocation::static_strategy<3>>>,
+                   xenium::reclamation::quiescent_state_based,
+                   xenium::reclamation::stamp_it,
+                   xenium::reclamation::epoch_based<>::with<xenium::policy::scan_frequency<10>>,
+                   xenium::reclamation::new_epoch_based<>::with<xenium::policy::scan_frequency<10>>,
+                   xenium::reclamation::debra<>::with<xenium::policy::scan_frequency<10>>>;
+TYPED_TEST_SUITE(FeldmanHashMap, Reclaimers);
+
+TYPED_TEST(FeldmanHashMap, emplace_or_get_returns_an_iterator_and_true_when_successful) {
+  auto result = this->map.emplace_or_get(42, 43);
+  EXPECT_TRUE(result.second);
+  ASSERT_NE(this->map.end(), result.first);
+  EXPECT_EQ(42, result.first->first);
+  EXPECT_EQ(43, result.first->second);
+}
+
+TYPED_TEST(FeldmanHashMap, emplace_or_get_for_an_existing_element_returns_an_iterator_to_that_element_and_false) {
+  EXPECT_TRUE(this->map.emplace(42, 43));
+
+  auto result = this->map.emplace_or_get(42, 44);
+  EXPECT_FALSE(result.second);
+  ASSERT_NE(this->map.end(), result.first);
+  EXPECT_EQ(42, result.first->first);
+  EXPECT_EQ(43, result.first->second);
+}
+
+TYPED_TEST(FeldmanHashMap, emplace_same_key_twice_fails_second_time) {
+  EXPECT_TRUE(this->map.emplace(42, 43));
+  EXPECT_FALSE(this->map.emplace(42, 44));
+}
+
+TYPED_TEST(FeldmanHashMap, contains_returns_false_for_non_existing_element) {
+  this->map.emplace(42, 43);
+  EXPECT_FALSE(this->map.contains(41));
+  EXPECT_FALSE(this->map.contains(43));
+}
+
+TYPED_TEST(FeldmanHashMap, contains_returns_true_for_existing_element) {
+  this->map.emplace(42, 43);
+  EXPECT_TRUE(this->map.contains(42));
+}
+
+TYPED_TEST(FeldmanHashMap, find_returns_iterator_to_existing_element) {
+  this->map.emplace(42, 43);
+  auto it = this->map.find(42);
+  ASSERT_NE(this->map.end(), it);
+  EXPECT_EQ(42, it->first);
+  EXPECT_EQ(43, it->second);
+}
+
+TYPED_TEST(FeldmanHashMap, find_returns_end_iterator_for_non_existing_element) {
+  this->map.emplace(43, 44);
+  EXPECT_EQ(this->map.end(), this->map.find(42));
+}
+
+TYPED_TEST(FeldmanHashMap, erase_nonexisting_element_returns_false) {
+  EXPECT_FALSE(this->map.erase(42));
+}
+
+TYPED_TEST(FeldmanHashMap, erase_existing_element_returns_true_and_removes_element) {
+  this->map.emplace(42, 43);
+  EXPECT_TRUE(this->map.erase(42));
+  EXPECT_FALSE(this->map.contains(42));
+}
+
+TYPED_TEST(FeldmanHashMap, erase_existing_element_twice_fails_the_second_time) {
+  this->map.emplace(42, 43);
+  EXPECT_TRUE(this->map.erase(42));
+  EXPECT_FALSE(this->map.erase(42));
+}
+
+TYPED_TEST(FeldmanHashMap, begin_returns_end_iterator_for_empty_map) {
+  auto it = this->map.begin();
+  ASSERT_EQ(this->map.end(), it);
+}
+
+TYPED_TEST(FeldmanHashMap, begin_returns_iterator_to_first_entry) {
+  this->map.emplace(42, 43);
+  auto it = this->map.begin();
+  ASSERT_NE(this->map.end(), it);
+  EXPECT_EQ(42, it->first);
+  EXPECT_EQ(43, it->second);
+}
+
+TYPED_TEST(FeldmanHashMap, iterator_covers_all_entries_in_densely_populated_map) {
+  std::map<int, bool> values;
+  for (int i = 0; i < 2000; ++i) {
+    values[i] = false;
+    this->map.emplace(i, i);
+  }
+  for (auto& v : this->map) {
+    EXPECT_FALSE(values[v.first]) << v.first << " was visited twice";
+    values[v.first] = true;
+  }
+
+  for (auto& v : values) {
+    EXPECT_TRUE(v.second) << v.first << " was not visited";
+  }
+}
+
+TYPED_TEST(FeldmanHashMap, drain_densely_populated_map_using_erase) {
+  for (int i = 0; i < 2000; ++i) {
+    this->map.emplace(i, i);
+  }
+
+  auto it = this->map.begin();
+  while (it != this->map.end()) {
+    it = this->map.erase(std::move(it));
+  }
+
+  EXPECT_EQ(this->map.end(), this->map.begin());
+  for (int i = 0; i < 2000; ++i) {
+    EXPECT_FALSE(this->map.contains(i));
+  }
+}
+
+TYPED_TEST(FeldmanHashMap, elements_remain_accessible_after_expanding_slots_down_to_the_last_level) {
+  using Reclaimer = TypeParam;
+  xenium::feldman_hash_map<int, int, xenium::policy::reclaimer<Reclaimer>, xenium::policy::hash<upper_bits_hash>> map;
+  for (int i = 0; i < 1000; ++i) {
+    EXPECT_TRUE(map.emplace(i, i * 10));
+  }
+  for (int i = 0; i < 1000; ++i) {
+    auto it = map.find(i);
+    ASSERT_NE(map.end(), it);
+    EXPECT_EQ(i * 10, it->second);
+  }
+  int count = 0;
+  for (auto& v : map) {
+    (void)v;
+    ++count;
+  }
+  EXPECT_EQ(1000, count);
+  for (int i = 0; i < 1000; i += 2) {
+    EXPECT_TRUE(map.erase(i));
+  }
+  for (int i = 0; i < 1000; ++i) {
+    EXPECT_EQ(i % 2 != 0, map.contains(i));
+  }
+}
+
+TYPED_TEST(FeldmanHashMap, supports_custom_array_sizes) {
+  using Reclaimer = TypeParam;
+  xenium::feldman_hash_map<int,
+                           std::string,
+                           xenium::policy::reclaimer<Reclaimer>,
+                           xenium::policy::head_bits<2>,
+                           xenium::policy::array_bits<1>>
+    map;
+  for (int i = 0; i < 500; ++i) {
+    EXPECT_TRUE(map.emplace(i, std::to_string(i)));
+  }
+  for (int i = 0; i < 500; ++i) {
+    auto it = map.find(i);
+    ASSERT_NE(map.end(), it);
+    EXPECT_EQ(std::to_string(i), it->second);
+  }
+}
+
+TYPED_TEST(FeldmanHashMap, emplace_of_different_key_with_same_hash_value_throws) {
+  using Reclaimer = TypeParam;
+  xenium::feldman_hash_map<int, int, xenium::policy::reclaimer<Reclaimer>, xenium::policy::hash<constant_hash>> map;
+  EXPECT_TRUE(map.emplace(1, 1));
+  EXPECT_FALSE(map.emplace(1, 2));
+  EXPECT_THROW(map.emplace(2, 2), std::invalid_argument);
+  EXPECT_TRUE(map.contains(1));
+}
+
+namespace {
+#ifdef DEBUG
+  const int MaxIterations = 1000;
+#else
+  const int MaxIterations = 10000;
+#endif
+} // namespace
+
+TYPED_TEST(FeldmanHashMap, parallel_usage) {
+  using Reclaimer = TypeParam;
+  auto& map = this->map;
+
+  std::vector<std::thread> threads;
+  for (int i = 0; i < 8; ++i) {
+    threads.push_back(std::thread([i, &map] {
+      for (int j = 0; j < MaxIterations; ++j) {
+        [[maybe_unused]] typename Reclaimer::region_guard guard{};
+        const int key = i + 8 * (j % 512);
+        EXPECT_EQ(map.end(), map.find(key));
+        EXPECT_TRUE(map.emplace(key, j));
+        auto it = map.find(key);
+        ASSERT_NE(map.end(), it);
+        EXPECT_EQ(key, it->first);
+        EXPECT_EQ(j, it->second);
+        it.reset();
+        EXPECT_TRUE(map.erase(key));
+        EXPECT_FALSE(map.contains(key));
+        auto result = map.emplace_or_get(key, j);
+        EXPECT_TRUE(result.second);
+        it = map.erase(std::move(result.first));
+        it.reset();
+        EXPECT_FALSE(map.contains(key));
+
+        if (j % 64 == 0) {
+          for (auto& v : map) {
+            (void)v;
+          }
+        }
+      }
+    }));
+  }
+
+  for (auto& thread : threads) {
+    thread.join();
+  }
+  EXPECT_EQ(map.end(), map.begin());
+}
+
+TYPED_TEST(FeldmanHashMap, parallel_usage_with_same_values) {
+  using Reclaimer = TypeParam;
+  auto& map = this->map;
+
+  std::vector<std::thread> threads;
+  for (int i = 0; i < 8; ++i) {
+    threads.push_back(std::thread([&map] {
+      for (int j = 0; j < MaxIterations / 10; ++j) {
+        for (int k = 0; k < 10; ++k) {
+          [[maybe_unused]] typename Reclaimer::region_guard guard{};
+          map.contains(k);
+          map.emplace(k, k);
+          auto it = map.find(k);
+          if (it != map.end()) {
+            EXPECT_EQ(k, it->second);
+          }
+          it.reset();
+          map.erase(k);
+        }
+      }
+    }));
+  }
+
+  for (auto& thread : threads) {
+    thread.join();
+  }
+}
+
+TYPED_TEST(FeldmanHashMap, parallel_usage_while_expanding_slots) {
+  using Reclaimer = TypeParam;
+  xenium::feldman_hash_map<int, int, xenium::policy::reclaimer<Reclaimer>, xenium::policy::hash<upper_bits_hash>> map;
+
+  // all keys collide on the first levels, so concurrent inserts keep expanding the same slots
+  // while other threads remove elements that are being moved to the next level
+  std::vector<std::thread> threads;
+  for (int i = 0; i < 8; ++i) {
+    threads.push_back(std::thread([i, &map] {
+      const int count = MaxIterations / 10;
+      for (int j = 0; j < count; ++j) {
+        [[maybe_unused]] typename Reclaimer::region_guard guard{};
+        const int key = i * count + j;
+        EXPECT_TRUE(map.emplace(key, key));
+        const int probe = i * count + j / 2;
+        if (probe % 2 == 0) {
+          auto it = map.find(probe);
+          ASSERT_NE(map.end(), it);
+          EXPECT_EQ(probe, it->second);
+        }
+        if (j % 2 != 0) {
+          EXPECT_TRUE(map.erase(key));
+        }
+      }
+    }));
+  }
+
+  for (auto& thread : threads) {
+    thread.join();
+  }
+  for (int key = 0; key < 8 * (MaxIterations / 10); ++key) {
+    EXPECT_EQ(key % 2 == 0, map.contains(key));
+  }
+}
+} // namespace
@@ -0,0 +1,288 @@
+#include <xenium/fraser_skip_list_map.hpp>
+#include <xenium/reclamation/generic_epoch_based.hpp>
+#include <xenium/reclamation/hazard_eras.hpp>
+#include <xenium/reclamation/hazard_pointer.hpp>
+#include <xenium/reclamation/quiescent_state_based.hpp>
+#include <xenium/reclamation/stamp_it.hpp>
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <random>
+#include <thread>
+#include <vector>
+
+namespace {
+
+template <typename Reclaimer>
+struct FraserSkipListMap : ::testing::Test {
+  using map_t = xenium::fraser_skip_list_map<int, int, xenium::policy::reclaimer<Reclaimer>>;
+  map_t map;
+};
+
+using Reclaimers =
+  ::testing::Types<xenium::reclamation::hazard_pointer<>::with<
+                     xenium::policy::allocation_strategy<xenium::reclamation::hp_allocation::dynamic_strategy<3>>>,
+                   xenium::reclamation::hazard_eras<>::with<
+                     xenium::policy::allocation_strategy<xenium::reclamation::he_allocation::dynamic_strategy<3>>>,
+                   xenium::reclamation::quiescent_state_based,
+                   xenium::reclamation::stamp_it,
+                   xenium::reclamation::epoch_based<>::with<xenium::policy::scan_frequency<10>>,
+                   xenium::reclamation::new_epoch_based<>::with<xenium::policy::scan_frequency<10>>,
+                   xenium::reclamation::debra<>::with<xenium::policy::scan_frequency<10>>>;
+TYPED_TEST_SUITE(FraserSkipListMap, Reclaimers);
+
+TYPED_TEST(FraserSkipListMap, emplace_same_key_twice_fails_second_time) {
+  EXPECT_TRUE(this->map.emplace(42, 43));
+  EXPECT_FALSE(this->map.emplace(42, 44));
+  auto it = this->map.find(42);
+  ASSERT_NE(this->map.end(), it);
+  EXPECT_EQ(43, it->second);
+}
+
+TYPED_TEST(FraserSkipListMap, emplace_or_get_inserts_new_element_and_returns_iterator_to_it) {
+  auto result = this->map.emplace_or_get(42, 43);
+  EXPECT_TRUE(result.second);
+  EXPECT_EQ(this->map.begin(), result.first);
+  EXPECT_EQ(42, result.first->first);
+  EXPECT_EQ(43, result.first->second);
+}
+
+TYPED_TEST(FraserSkipListMap, emplace_or_get_does_not_insert_anything_and_returns_iterator_to_existing_element) {
+  this->map.emplace(42, 43);
+  auto result = this->map.emplace_or_get(42, 44);
+  EXPECT_FALSE(result.second);
+  EXPECT_EQ(this->map.begin(), result.first);
+  EXPECT_EQ(42, result.first->first);
+  EXPECT_EQ(43, result.first->second);
+}
+
+TYPED_TEST(FraserSkipListMap, contains_returns_false_for_non_existing_element) {
+  this->map.emplace(42, 43);
+  EXPECT_FALSE(this->map.contains(41));
+  EXPECT_FALSE(this->map.contains(43));
+}
+
+TYPED_TEST(FraserSkipListMap, contains_returns_true_for_existing_element) {
+  this->map.emplace(42, 43);
+  EXPECT_TRUE(this->map.contains(42));
+}
+
+TYPED_TEST(FraserSkipListMap, find_returns_end_iterator_for_non_existing_element) {
+  this->map.emplace(43, 44);
+  EXPECT_EQ(this->map.end(), this->map.find(42));
+}
+
+TYPED_TEST(FraserSkipListMap, find_returns_matching_iterator_for_existing_element) {
+  this->map.emplace(42, 43);
+  auto it = this->map.find(42);
+  EXPECT_EQ(this->map.begin(), it);
+  EXPECT_EQ(42, it->first);
+  EXPECT_EQ(43, it->second);
+  EXPECT_EQ(this->map.end(), ++it);
+}
+
+TYPED_TEST(FraserSkipListMap, erase_existing_element_succeeds) {
+  this->map.emplace(42, 43);
+  EXPECT_TRUE(this->map.erase(42));
+  EXPECT_FALSE(this->map.contains(42));
+}
+
+TYPED_TEST(FraserSkipListMap, erase_nonexisting_element_fails) {
+  EXPECT_FALSE(this->map.erase(42));
+}
+
+TYPED_TEST(FraserSkipListMap, erase_existing_element_twice_fails_the_second_time) {
+  this->map.emplace(42, 43);
+  EXPECT_TRUE(this->map.erase(42));
+  EXPECT_FALSE(this->map.erase(42));
+}
+
+TYPED_TEST(FraserSkipListMap, lower_bound_returns_first_element_not_less_than_key) {
+  this->map.emplace(2, 2);
+  this->map.emplace(4, 4);
+  this->map.emplace(6, 6);
+  EXPECT_EQ(2, this->map.lower_bound(1)->first);
+  EXPECT_EQ(4, this->map.lower_bound(4)->first);
+  EXPECT_EQ(6, this->map.lower_bound(5)->first);
+  EXPECT_EQ(this->map.end(), this->map.lower_bound(7));
+}
+
+TYPED_TEST(FraserSkipListMap, iterate_range) {
+  for (int i = 0; i < 20; i += 2) {
+    this->map.emplace(i, i * 10);
+  }
+  std::vector<int> keys;
+  for (auto it = this->map.lower_bound(5); it != this->map.end() && it->first < 13; ++it) {
+    EXPECT_EQ(it->first * 10, it->second);
+    keys.push_back(it->first);
+  }
+  EXPECT_EQ((std::vector<int>{6, 8, 10, 12}), keys);
+}
+
+TYPED_TEST(FraserSkipListMap, iterator_skips_removed_elements) {
+  this->map.emplace(1, 1);
+  this->map.emplace(2, 2);
+  this->map.emplace(3, 3);
+  auto it = this->map.find(2);
+  EXPECT_TRUE(this->map.erase(2));
+  EXPECT_TRUE(this->map.erase(3));
+  this->map.emplace(4, 4);
+  ++it;
+  ASSERT_NE(this->map.end(), it);
+  EXPECT_EQ(4, it->first);
+}
+
+TYPED_TEST(FraserSkipListMap, iterates_elements_in_ascending_order) {
+  std::vector<int> keys(1000);
+  for (int i = 0; i < 1000; ++i) {
+    keys[i] = i;
+  }
+  std::shuffle(keys.begin(), keys.end(), std::mt19937(42));
+  for (int k : keys) {
+    EXPECT_TRUE(this->map.emplace(k, k));
+  }
+  for (int k = 0; k < 1000; k += 3) {
+    EXPECT_TRUE(this->map.erase(k));
+  }
+
+  int expected = 1;
+  for (auto& v : this->map) {
+    EXPECT_EQ(expected, v.first);
+    ++expected;
+    if (expected % 3 == 0) {
+      ++expected;
+    }
+  }
+  EXPECT_EQ(1000, expected);
+}
+
+TYPED_TEST(FraserSkipListMap, compare_policy_defines_order_of_entries) {
+  using Reclaimer = TypeParam;
+  xenium::fraser_skip_list_map<int,
+                               int,
+                               xenium::policy::reclaimer<Reclaimer>,
+                               xenium::policy::compare<std::greater<int>>>
+    map;
+  map.emplace(1, 1);
+  map.emplace(3, 3);
+  map.emplace(2, 2);
+  auto it = map.begin();
+  EXPECT_EQ(3, it->first);
+  ++it;
+  EXPECT_EQ(2, it->first);
+  ++it;
+  EXPECT_EQ(1, it->first);
+  ++it;
+  EXPECT_EQ(map.end(), it);
+  EXPECT_EQ(2, map.lower_bound(2)->first);
+}
+
+namespace {
+#ifdef DEBUG
+  const int MaxIterations = 1000;
+#else
+  const int MaxIterations = 10000;
+#endif
+} // namespace
+
+TYPED_TEST(FraserSkipListMap, parallel_usage) {
+  using Reclaimer = TypeParam;
+  auto& map = this->map;
+
+  std::vector<std::thread> threads;
+  for (int i = 0; i < 8; ++i) {
+    threads.push_back(std::thread([i, &map] {
+      for (int j = 0; j < MaxIterations; ++j) {
+        [[maybe_unused]] typename Reclaimer::region_guard guard{};
+        int key = i + 8 * (j % 64);
+        EXPECT_EQ(map.end(), map.find(key));
+        EXPECT_TRUE(map.emplace(key, j));
+        auto it = map.find(key);
+        ASSERT_NE(map.end(), it);
+        EXPECT_EQ(j, it->second);
+        it.reset();
+        EXPECT_TRUE(map.erase(key));
+        EXPECT_FALSE(map.contains(key));
+      }
+    }));
+  }
+
+  for (auto& thread : threads) {
+    thread.join();
+  }
+  EXPECT_EQ(map.end(), map.begin());
+}
+
+TYPED_TEST(FraserSkipListMap, parallel_usage_with_same_values) {
+  using Reclaimer = TypeParam;
+  auto& map = this->map;
+
+  std::vector<std::thread> threads;
+  for (int i = 0; i < 8; ++i) {
+    threads.push_back(std::thread([&map] {
+      for (int j = 0; j < MaxIterations / 10; ++j) {
+        for (int k = 0; k < 10; ++k) {
+          [[maybe_unused]] typename Reclaimer::region_guard guard{};
+          map.contains(k);
+          map.emplace(k, k);
+          auto it = map.find(k);
+          it.reset();
+          map.erase(k);
+          auto result = map.emplace_or_get(k, k);
+          result.first.reset();
+
+          int last = -1;
+          for (auto& v : map) {
+            EXPECT_TRUE(v.first >= 0 && v.first < 10);
+            EXPECT_LT(last, v.first);
+            last = v.first;
+          }
+        }
+      }
+    }));
+  }
+
+  for (auto& thread : threads) {
+    thread.join();
+  }
+}
+
+TYPED_TEST(FraserSkipListMap, parallel_range_scans) {
+  using Reclaimer = TypeParam;
+  auto& map = this->map;
+  for (int i = 0; i < 200; i += 2) {
+    map.emplace(i, i);
+  }
+
+  std::vector<std::thread> threads;
+  for (int i = 0; i < 8; ++i) {
+    threads.push_back(std::thread([i, &map] {
+      for (int j = 0; j < MaxIterations / 10; ++j) {
+        [[maybe_unused]] typename Reclaimer::region_guard guard{};
+        if (i % 2 == 0) {
+          // writers insert and remove odd keys
+          int key = 2 * ((i * 7 + j) % 100) + 1;
+          map.emplace(key, key);
+          map.erase(key);
+        } else {
+          // the even keys are never removed, so we must see all of them
+          int last = -1;
+          int count = 0;
+          for (auto it = map.lower_bound(50); it != map.end() && it->first < 150; ++it) {
+            EXPECT_LT(last, it->first);
+            EXPECT_EQ(it->first, it->second);
+            last = it->first;
+            count += (it->first % 2 == 0) ? 1 : 0;
+          }
+          EXPECT_EQ(50, count);
+        }
+      }
+    }));
+  }
+
+  for (auto& thread : threads) {
+    thread.join();
+  }
+}
+} // namespace
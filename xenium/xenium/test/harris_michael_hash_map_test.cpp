@@ -209,6 +209,195 @@ TYPED_TEST(HarrisMichaelHashMap, iterator_covers_all_entries_in_sparsely_populat
   }
 }
 
+TYPED_TEST(HarrisMichaelHashMap, size_reflects_insertions_and_removals) {
+  EXPECT_EQ(0u, this->map.size());
+  for (int i = 0; i < 200; ++i) {
+    this->map.emplace(i, i);
+  }
+  this->map.emplace(42, 42);
+  EXPECT_EQ(200u, this->map.size());
+  EXPECT_EQ(200u, this->map.approximate_size());
+
+  for (int i = 0; i < 200; i += 2) {
+    this->map.erase(i);
+  }
+  this->map.erase(0);
+  EXPECT_EQ(100u, this->map.size());
+
+  auto it = this->map.begin();
+  while (it != this->map.end()) {
+    it = this->map.erase(std::move(it));
+  }
+  EXPECT_EQ(0u, this->map.size());
+  EXPECT_EQ(0u, this->map.approximate_size());
+}
+
+TYPED_TEST(HarrisMichaelHashMap, resizable_map_grows_and_retains_all_elements) {
+  using hash_map = xenium::harris_michael_hash_map<int,
+                                                   int,
+                                                   xenium::policy::reclaimer<TypeParam>,
+                                                   xenium::policy::buckets<4>,
+                                                   xenium::policy::resizable<true>>;
+  hash_map map;
+  EXPECT_EQ(4u, map.bucket_count());
+
+  for (int i = 0; i < 1000; ++i) {
+    EXPECT_TRUE(map.emplace(i, i));
+  }
+  EXPECT_GT(map.bucket_count(), 4u);
+  EXPECT_FALSE(map.emplace(42, 43));
+
+  for (int i = 0; i < 1000; ++i) {
+    auto it = map.find(i);
+    ASSERT_NE(map.end(), it);
+    EXPECT_EQ(i, it->second);
+  }
+  EXPECT_EQ(map.end(), map.find(1000));
+
+  for (int i = 0; i < 1000; i += 2) {
+    EXPECT_TRUE(map.erase(i));
+  }
+  for (int i = 0; i < 1000; ++i) {
+    EXPECT_EQ(i % 2 != 0, map.contains(i));
+  }
+}
+
+TYPED_TEST(HarrisMichaelHashMap, resizable_map_growth_is_not_affected_by_inserts_into_other_maps) {
+  using hash_map = xenium::harris_michael_hash_map<int,
+                                                   int,
+                                                   xenium::policy::reclaimer<TypeParam>,
+                                                   xenium::policy::buckets<4>,
+                                                   xenium::policy::resizable<true>>;
+  hash_map map1;
+  hash_map map2;
+  for (int i = 0; i < 15; ++i) {
+    EXPECT_TRUE(map1.emplace(i, i));
+  }
+  EXPECT_TRUE(map2.emplace(0, 0));
+  EXPECT_TRUE(map1.emplace(15, 15));
+  // the 16th insert into map1 must trigger a load factor check on map1, regardless
+  // of the insert into map2 in between.
+  EXPECT_GT(map1.bucket_count(), 4u);
+  EXPECT_EQ(4u, map2.bucket_count());
+}
+
+TYPED_TEST(HarrisMichaelHashMap, resizable_map_iterator_covers_all_entries_exactly_once) {
+  using hash_map = xenium::harris_michael_hash_map<int,
+                                                   int,
+                                                   xenium::policy::reclaimer<TypeParam>,
+                                                   xenium::policy::buckets<4>,
+                                                   xenium::policy::resizable<true>>;
+  hash_map map;
+  EXPECT_EQ(map.end(), map.begin());
+
+  std::map<int, int> visited;
+  for (int i = 0; i < 500; ++i) {
+    map.emplace(i * 7, i);
+  }
+  for (auto& v : map) {
+    EXPECT_EQ(v.first, v.second * 7);
+    ++visited[v.first];
+  }
+  ASSERT_EQ(500u, visited.size());
+  for (auto& v : visited) {
+    EXPECT_EQ(1, v.second) << v.first << " was not visited exactly once";
+  }
+
+  auto it = map.begin();
+  while (it != map.end()) {
+    it = map.erase(std::move(it));
+  }
+  EXPECT_EQ(map.end(), map.begin());
+  EXPECT_EQ(0u, map.size());
+}
+
+TYPED_TEST(HarrisMichaelHashMap, bulk_build_inserts_all_elements) {
+  std::vector<std::pair<int, int>> data;
+  for (int i = 0; i < 10000; ++i) {
+    data.emplace_back(i * 3, i);
+  }
+  // only the first of several equivalent keys is inserted
+  for (int i = 0; i < 10000; i += 7) {
+    data.emplace_back(i * 3, -1);
+  }
+
+  for (std::size_t threads : {1, 4}) {
+    typename TestFixture::hash_map map;
+    map.bulk_build(data.begin(), data.end(), threads);
+    EXPECT_EQ(10000u, map.size());
+    for (int i = 0; i < 10000; ++i) {
+      auto it = map.find(i * 3);
+      ASSERT_NE(map.end(), it) << i;
+      EXPECT_EQ(i, it->second);
+    }
+    EXPECT_FALSE(map.contains(1));
+
+    std::size_t visited = 0;
+    for ([[maybe_unused]] auto& v : map) {
+      ++visited;
+    }
+    EXPECT_EQ(10000u, visited);
+
+    // the map must be fully functional after the bulk build
+    EXPECT_FALSE(map.emplace(42, 0));
+    EXPECT_TRUE(map.emplace(1, 1));
+    EXPECT_TRUE(map.erase(42));
+    EXPECT_FALSE(map.contains(42));
+  }
+}
+
+TYPED_TEST(HarrisMichaelHashMap, bulk_build_presizes_resizable_map) {
+  using hash_map = xenium::harris_michael_hash_map<int,
+                                                   int,
+                                                   xenium::policy::reclaimer<TypeParam>,
+                                                   xenium::policy::buckets<4>,
+                                                   xenium::policy::resizable<true>>;
+  hash_map map;
+  // initialize some buckets and leave the map empty again
+  for (int i = 0; i < 100; ++i) {
+    map.emplace(i, i);
+  }
+  for (int i = 0; i < 100; ++i) {
+    map.erase(i);
+  }
+
+  std::vector<std::pair<int, int>> data;
+  for (int i = 0; i < 10000; ++i) {
+    data.emplace_back(i * 3, i);
+  }
+  map.bulk_build(data.begin(), data.end(), 4);
+  EXPECT_EQ(10000u, map.size());
+  EXPECT_GE(map.bucket_count() * 2, 10000u);
+
+  for (int i = 0; i < 10000; ++i) {
+    auto it = map.find(i * 3);
+    ASSERT_NE(map.end(), it) << i;
+    EXPECT_EQ(i, it->second);
+  }
+
+  std::map<int, int> visited;
+  for (auto& v : map) {
+    ++visited[v.first];
+  }
+  ASSERT_EQ(10000u, visited.size());
+  for (auto& v : visited) {
+    EXPECT_EQ(1, v.second) << v.first << " was not visited exactly once";
+  }
+
+  for (int i = 0; i < 1000; ++i) {
+    EXPECT_TRUE(map.emplace(i * 3 + 1, i));
+    EXPECT_TRUE(map.erase(i * 3));
+  }
+  EXPECT_EQ(10000u, map.size());
+}
+
+TYPED_TEST(HarrisMichaelHashMap, bulk_build_rejects_non_empty_map) {
+  std::vector<std::pair<int, int>> data{{1, 1}, {2, 2}};
+  this->map.emplace(1, 1);
+  EXPECT_THROW(this->map.bulk_build(data.begin(), data.end()), std::logic_error);
+  EXPECT_EQ(1u, this->map.size());
+}
+
 TYPED_TEST(HarrisMichaelHashMap, operator_at_returns_accessor_to_existing_element) {
   using Reclaimer = TypeParam;
   using hash_map = xenium::
@@ -279,6 +468,83 @@ TYPED_TEST(HarrisMichaelHashMap, parallel_usage) {
   }
 }
 
+TYPED_TEST(HarrisMichaelHashMap, parallel_size) {
+  using Reclaimer = TypeParam;
+
+  using hash_map = xenium::
+    harris_michael_hash_map<int, int, xenium::policy::reclaimer<Reclaimer>, xenium::policy::buckets<10>>;
+  hash_map map;
+
+  std::vector<std::thread> threads;
+  for (int i = 0; i < 8; ++i) {
+    threads.push_back(std::thread([i, &map] {
+      for (int j = 0; j < MaxIterations / 8; ++j) {
+        [[maybe_unused]] typename Reclaimer::region_guard guard{};
+        const int key = i * MaxIterations + j;
+        EXPECT_TRUE(map.emplace(key, j));
+        if (j % 2 == 0) {
+          EXPECT_TRUE(map.erase(key));
+        }
+        EXPECT_LE(map.approximate_size(), static_cast<std::size_t>(8 * MaxIterations));
+      }
+    }));
+  }
+
+  for (auto& thread : threads) {
+    thread.join();
+  }
+
+  const std::size_t expected = 8 * (MaxIterations / 8 - (MaxIterations / 8 + 1) / 2);
+  EXPECT_EQ(expected, map.size());
+  EXPECT_EQ(expected, map.approximate_size());
+}
+
+TYPED_TEST(HarrisMichaelHashMap, parallel_usage_of_resizable_map) {
+  using Reclaimer = TypeParam;
+
+  using hash_map = xenium::harris_michael_hash_map<int,
+                                                   int,
+                                                   xenium::policy::reclaimer<Reclaimer>,
+                                                   xenium::policy::buckets<2>,
+                                                   xenium::policy::resizable<true>>;
+  hash_map map;
+
+  std::vector<std::thread> threads;
+  for (int i = 0; i < 8; ++i) {
+    threads.push_back(std::thread([i, &map] {
+      for (int j = 0; j < MaxIterations / 10; ++j) {
+        const int k = i * MaxIterations + j;
+        [[maybe_unused]] typename Reclaimer::region_guard guard{};
+        EXPECT_TRUE(map.emplace(k, j));
+        auto it = map.find(k);
+        EXPECT_NE(map.end(), it);
+        EXPECT_EQ(j, it->second);
+        it.reset();
+        if (j % 2 == 0) {
+          EXPECT_TRUE(map.erase(k));
+          EXPECT_FALSE(map.contains(k));
+        }
+        if (j % 100 == 0) {
+          for (auto& v : map) {
+            EXPECT_EQ(v.first % MaxIterations, v.second);
+          }
+        }
+      }
+    }));
+  }
+
+  for (auto& thread : threads) {
+    thread.join();
+  }
+
+  EXPECT_GT(map.bucket_count(), 2u);
+  for (int i = 0; i < 8; ++i) {
+    for (int j = 0; j < MaxIterations / 10; ++j) {
+      EXPECT_EQ(j % 2 != 0, map.contains(i * MaxIterations + j));
+    }
+  }
+}
+
 TYPED_TEST(HarrisMichaelHashMap, parallel_usage_with_same_values) {
   using Reclaimer = TypeParam;
 
@@ -143,6 +143,102 @@ TYPED_TEST(HarrisMichaelListBasedSet, iterate_list) {
   EXPECT_EQ(list.end(), it);
 }
 
+TYPED_TEST(HarrisMichaelListBasedSet, lower_bound_returns_first_element_not_less_than_key) {
+  xenium::harris_michael_list_based_set<int, xenium::policy::reclaimer<TypeParam>> list;
+  list.emplace(2);
+  list.emplace(4);
+  list.emplace(6);
+  EXPECT_EQ(2, *list.lower_bound(1));
+  EXPECT_EQ(4, *list.lower_bound(4));
+  EXPECT_EQ(6, *list.lower_bound(5));
+  EXPECT_EQ(list.end(), list.lower_bound(7));
+}
+
+TYPED_TEST(HarrisMichaelListBasedSet, upper_bound_returns_first_element_greater_than_key) {
+  xenium::harris_michael_list_based_set<int, xenium::policy::reclaimer<TypeParam>> list;
+  list.emplace(2);
+  list.emplace(4);
+  list.emplace(6);
+  EXPECT_EQ(2, *list.upper_bound(1));
+  EXPECT_EQ(6, *list.upper_bound(4));
+  EXPECT_EQ(6, *list.upper_bound(5));
+  EXPECT_EQ(list.end(), list.upper_bound(6));
+}
+
+TYPED_TEST(HarrisMichaelListBasedSet, for_each_in_range_visits_all_elements_in_half_open_range) {
+  xenium::harris_michael_list_based_set<int, xenium::policy::reclaimer<TypeParam>> list;
+  for (int i = 0; i < 20; i += 2) {
+    list.emplace(i);
+  }
+  std::vector<int> visited;
+  list.for_each_in_range(3, 12, [&visited](const int& v) { visited.push_back(v); });
+  EXPECT_EQ((std::vector<int>{4, 6, 8, 10}), visited);
+
+  visited.clear();
+  list.for_each_in_range(4, 4, [&visited](const int& v) { visited.push_back(v); });
+  EXPECT_TRUE(visited.empty());
+
+  list.for_each_in_range(15, 100, [&visited](const int& v) { visited.push_back(v); });
+  EXPECT_EQ((std::vector<int>{16, 18}), visited);
+}
+
+TYPED_TEST(HarrisMichaelListBasedSet, operations_with_search_finger) {
+  using list_t = xenium::harris_michael_list_based_set<int, xenium::policy::reclaimer<TypeParam>>;
+  list_t list;
+  typename list_t::search_finger finger;
+  for (int i = 0; i < 100; ++i) {
+    EXPECT_TRUE(list.emplace_hint(finger, i));
+  }
+  EXPECT_FALSE(list.emplace_hint(finger, 99));
+  EXPECT_FALSE(list.emplace_hint(finger, 0));
+  for (int i = 0; i < 100; ++i) {
+    EXPECT_TRUE(list.contains(i, finger));
+  }
+  EXPECT_FALSE(list.contains(100, finger));
+  for (int i = 0; i < 100; i += 2) {
+    EXPECT_TRUE(list.erase(i, finger));
+  }
+  EXPECT_FALSE(list.erase(50, finger));
+  finger.reset();
+
+  int expected = 1;
+  for (int v : list) {
+    EXPECT_EQ(expected, v);
+    expected += 2;
+  }
+  EXPECT_EQ(101, expected);
+}
+
+TYPED_TEST(HarrisMichaelListBasedSet, search_finger_falls_back_to_head_if_remembered_node_was_removed) {
+  using list_t = xenium::harris_michael_list_based_set<int, xenium::policy::reclaimer<TypeParam>>;
+  list_t list;
+  typename list_t::search_finger finger;
+  list.emplace_hint(finger, 1);
+  list.emplace_hint(finger, 2);
+  list.emplace_hint(finger, 3); // finger now remembers the node with key 2
+  EXPECT_TRUE(list.erase(2));
+  EXPECT_TRUE(list.emplace_hint(finger, 4));
+  EXPECT_TRUE(list.contains(3, finger));
+  EXPECT_TRUE(list.contains(4, finger));
+  EXPECT_FALSE(list.contains(2, finger));
+  EXPECT_TRUE(list.contains(1, finger));
+  finger.reset();
+}
+
+TYPED_TEST(HarrisMichaelListBasedSet, search_finger_can_be_used_with_different_lists) {
+  using list_t = xenium::harris_michael_list_based_set<int, xenium::policy::reclaimer<TypeParam>>;
+  list_t list1;
+  list_t list2;
+  typename list_t::search_finger finger;
+  list1.emplace_hint(finger, 1);
+  list1.emplace_hint(finger, 2);
+  EXPECT_FALSE(list2.contains(3, finger));
+  EXPECT_TRUE(list2.emplace_hint(finger, 3));
+  EXPECT_TRUE(list1.contains(2, finger));
+  EXPECT_FALSE(list1.contains(3, finger));
+  finger.reset();
+}
+
 namespace {
 #ifdef DEBUG
   const int MaxIterations = 1000;
@@ -184,6 +280,80 @@ TYPED_TEST(HarrisMichaelListBasedSet, parallel_usage) {
   }
 }
 
+TYPED_TEST(HarrisMichaelListBasedSet, parallel_usage_with_search_finger) {
+  using Reclaimer = TypeParam;
+  using list_t = xenium::harris_michael_list_based_set<int, xenium::policy::reclaimer<Reclaimer>>;
+  list_t list;
+
+  std::vector<std::thread> threads;
+  for (int i = 0; i < 8; ++i) {
+    threads.push_back(std::thread([i, &list] {
+      typename list_t::search_finger finger;
+      for (int j = 0; j < MaxIterations / 10; ++j) {
+        [[maybe_unused]] typename Reclaimer::region_guard guard{};
+        for (int k = 0; k < 10; ++k) {
+          EXPECT_TRUE(list.emplace_hint(finger, i + 8 * k));
+        }
+        for (int k = 0; k < 10; ++k) {
+          EXPECT_TRUE(list.contains(i + 8 * k, finger));
+        }
+        for (int k = 0; k < 10; ++k) {
+          EXPECT_TRUE(list.erase(i + 8 * k, finger));
+        }
+        EXPECT_FALSE(list.contains(i, finger));
+      }
+      finger.reset();
+    }));
+  }
+
+  for (auto& thread : threads) {
+    thread.join();
+  }
+  EXPECT_EQ(list.end(), list.begin());
+}
+
+TYPED_TEST(HarrisMichaelListBasedSet, parallel_range_scans) {
+  using Reclaimer = TypeParam;
+  xenium::harris_michael_list_based_set<int, xenium::policy::reclaimer<Reclaimer>> list;
+  for (int i = 0; i < 100; i += 2) {
+    list.emplace(i);
+  }
+
+  std::vector<std::thread> threads;
+  for (int i = 0; i < 8; ++i) {
+    threads.push_back(std::thread([i, &list] {
+      for (int j = 0; j < MaxIterations / 10; ++j) {
+        [[maybe_unused]] typename Reclaimer::region_guard guard{};
+        if (i % 2 == 0) {
+          // writers insert and remove odd keys
+          int key = 2 * ((i + j) % 50) + 1;
+          list.emplace(key);
+          list.erase(key);
+        } else {
+          int last = -1;
+          int count = 0;
+          list.for_each_in_range(10, 90, [&](const int& v) {
+            EXPECT_LT(last, v);
+            EXPECT_TRUE(v >= 10 && v < 90);
+            last = v;
+            count += (v % 2 == 0) ? 1 : 0;
+          });
+          // the even keys are never removed, so we must see all of them
+          EXPECT_EQ(40, count);
+          auto it = list.lower_bound(50);
+          ASSERT_NE(list.end(), it);
+          EXPECT_LE(50, *it);
+          it.reset();
+        }
+      }
+    }));
+  }
+
+  for (auto& thread : threads) {
+    thread.join();
+  }
+}
+
 TYPED_TEST(HarrisMichaelListBasedSet, parallel_usage_with_same_values) {
   using Reclaimer = TypeParam;
   xenium::harris_michael_list_based_set<int, xenium::policy::reclaimer<Reclaimer>> list;
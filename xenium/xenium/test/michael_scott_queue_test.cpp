@@ -8,6 +8,9 @@
 
 #include <gtest/gtest.h>
 
+#include <atomic>
+#include <iterator>
+#include <memory>
 #include <thread>
 #include <vector>
 
@@ -84,4 +87,142 @@ TYPED_TEST(MichaelScottQueue, parallel_usage) {
     thread.join();
   }
 }
+
+template <typename Reclaimer>
+struct MichaelScottQueueBatch : testing::Test {};
+
+// try_pop_n requires three guards
+using BatchReclaimers =
+  ::testing::Types<xenium::reclamation::lock_free_ref_count<>,
+                   xenium::reclamation::hazard_pointer<>::with<
+                     xenium::policy::allocation_strategy<xenium::reclamation::hp_allocation::static_strategy<3>>>,
+                   xenium::reclamation::hazard_eras<>::with<
+                     xenium::policy::allocation_strategy<xenium::reclamation::he_allocation::static_strategy<3>>>,
+                   xenium::reclamation::quiescent_state_based,
+                   xenium::reclamation::stamp_it,
+                   xenium::reclamation::epoch_based<>::with<xenium::policy::scan_frequency<10>>,
+                   xenium::reclamation::new_epoch_based<>::with<xenium::policy::scan_frequency<10>>,
+                   xenium::reclamation::debra<>::with<xenium::policy::scan_frequency<10>>>;
+TYPED_TEST_SUITE(MichaelScottQueueBatch, BatchReclaimers);
+
+TYPED_TEST(MichaelScottQueueBatch, push_range_pushes_all_elements_in_FIFO_order) {
+  xenium::michael_scott_queue<int, xenium::policy::reclaimer<TypeParam>> queue;
+  std::vector<int> values{1, 2, 3, 4, 5};
+  queue.push(0);
+  queue.push_range(values.begin(), values.end());
+  queue.push(6);
+  for (int i = 0; i <= 6; ++i) {
+    int elem = -1;
+    ASSERT_TRUE(queue.try_pop(elem));
+    EXPECT_EQ(i, elem);
+  }
+  int elem;
+  EXPECT_FALSE(queue.try_pop(elem));
+}
+
+TYPED_TEST(MichaelScottQueueBatch, push_range_with_empty_range_does_nothing) {
+  xenium::michael_scott_queue<int, xenium::policy::reclaimer<TypeParam>> queue;
+  std::vector<int> values;
+  queue.push_range(values.begin(), values.end());
+  int elem;
+  EXPECT_FALSE(queue.try_pop(elem));
+}
+
+TYPED_TEST(MichaelScottQueueBatch, try_pop_n_returns_zero_for_empty_queue) {
+  xenium::michael_scott_queue<int, xenium::policy::reclaimer<TypeParam>> queue;
+  std::vector<int> result;
+  EXPECT_EQ(0u, queue.try_pop_n(std::back_inserter(result), 10));
+  EXPECT_TRUE(result.empty());
+}
+
+TYPED_TEST(MichaelScottQueueBatch, try_pop_n_pops_at_most_max_elements_in_FIFO_order) {
+  xenium::michael_scott_queue<int, xenium::policy::reclaimer<TypeParam>> queue;
+  for (int i = 0; i < 10; ++i) {
+    queue.push(i);
+  }
+  std::vector<int> result;
+  EXPECT_EQ(4u, queue.try_pop_n(std::back_inserter(result), 4));
+  EXPECT_EQ((std::vector<int>{0, 1, 2, 3}), result);
+
+  result.clear();
+  EXPECT_EQ(6u, queue.try_pop_n(std::back_inserter(result), 100));
+  EXPECT_EQ((std::vector<int>{4, 5, 6, 7, 8, 9}), result);
+
+  EXPECT_EQ(0u, queue.try_pop_n(std::back_inserter(result), 100));
+}
+
+TYPED_TEST(MichaelScottQueueBatch, try_pop_n_pops_elements_pushed_via_push_range) {
+  xenium::michael_scott_queue<int, xenium::policy::reclaimer<TypeParam>> queue;
+  std::vector<int> values(100);
+  for (int i = 0; i < 100; ++i) {
+    values[i] = i;
+  }
+  queue.push_range(values.begin(), values.end());
+  std::vector<int> result;
+  while (queue.try_pop_n(std::back_inserter(result), 32) > 0) {
+  }
+  EXPECT_EQ(values, result);
+}
+
+TYPED_TEST(MichaelScottQueueBatch, supports_move_only_types) {
+  xenium::michael_scott_queue<std::unique_ptr<int>, xenium::policy::reclaimer<TypeParam>> queue;
+  std::vector<std::unique_ptr<int>> values;
+  values.push_back(std::make_unique<int>(42));
+  values.push_back(std::make_unique<int>(43));
+  queue.push_range(std::make_move_iterator(values.begin()), std::make_move_iterator(values.end()));
+
+  std::vector<std::unique_ptr<int>> result;
+  ASSERT_EQ(2u, queue.try_pop_n(std::back_inserter(result), 2));
+  ASSERT_NE(nullptr, result[0]);
+  ASSERT_NE(nullptr, result[1]);
+  EXPECT_EQ(42, *result[0]);
+  EXPECT_EQ(43, *result[1]);
+}
+
+TYPED_TEST(MichaelScottQueueBatch, parallel_usage) {
+  using Reclaimer = TypeParam;
+  xenium::michael_scott_queue<int, xenium::policy::reclaimer<Reclaimer>> queue;
+  constexpr int BatchSize = 32;
+  constexpr int Threads = 4;
+#ifdef DEBUG
+  const int MaxIterations = 100;
+#else
+  const int MaxIterations = 1000;
+#endif
+
+  std::atomic<int> popped{0};
+  std::vector<std::thread> threads;
+  for (int i = 0; i < Threads; ++i) {
+    threads.push_back(std::thread([i, &queue, &popped, MaxIterations] {
+      std::vector<int> last_seen(Threads, -1);
+      std::vector<int> values(BatchSize);
+      std::vector<int> result;
+      for (int j = 0; j < MaxIterations; ++j) {
+        [[maybe_unused]] typename Reclaimer::region_guard guard{};
+        for (int k = 0; k < BatchSize; ++k) {
+          values[k] = (j * BatchSize + k) * Threads + i;
+        }
+        queue.push_range(values.begin(), values.end());
+
+        result.clear();
+        popped += static_cast<int>(queue.try_pop_n(std::back_inserter(result), BatchSize));
+        // the elements of each producer must be popped in the order in which they have been pushed
+        for (int v : result) {
+          const int producer = v % Threads;
+          EXPECT_LT(last_seen[producer], v);
+          last_seen[producer] = v;
+        }
+      }
+    }));
+  }
+
+  for (auto& thread : threads) {
+    thread.join();
+  }
+
+  std::vector<int> result;
+  while (queue.try_pop_n(std::back_inserter(result), BatchSize) > 0) {
+  }
+  EXPECT_EQ(Threads * MaxIterations * BatchSize, popped.load() + static_cast<int>(result.size()));
+}
 } // namespace
\ No newline at end of file
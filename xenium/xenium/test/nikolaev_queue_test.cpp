@@ -8,6 +8,7 @@
 
 #include <gtest/gtest.h>
 
+#include <atomic>
 #include <random>
 #include <thread>
 #include <vector>
@@ -209,4 +210,41 @@ TYPED_TEST(NikolaevQueue, parallel_usage_mostly_empty) {
     thread.join();
   }
 }
+
+TYPED_TEST(NikolaevQueue, parallel_usage_does_not_lose_elements_when_switching_nodes) {
+  using Reclaimer = TypeParam;
+  xenium::nikolaev_queue<int, xenium::policy::reclaimer<TypeParam>, xenium::policy::entries_per_node<8>> queue;
+
+  constexpr int num_threads = 3;
+  std::atomic<int> popped{0};
+  std::vector<std::thread> threads;
+  for (int i = 0; i < num_threads; ++i) {
+    threads.push_back(std::thread([&queue] {
+      for (int j = 0; j < MaxIterations; ++j) {
+        [[maybe_unused]] typename Reclaimer::region_guard guard{};
+        queue.push(j);
+      }
+    }));
+    threads.push_back(std::thread([&queue, &popped] {
+      for (int j = 0; j < MaxIterations / 2; ++j) {
+        [[maybe_unused]] typename Reclaimer::region_guard guard{};
+        int elem;
+        while (!queue.try_pop(elem)) {
+        }
+        popped.fetch_add(1, std::memory_order_relaxed);
+      }
+    }));
+  }
+
+  for (auto& thread : threads) {
+    thread.join();
+  }
+
+  int remaining = 0;
+  int elem;
+  while (queue.try_pop(elem)) {
+    ++remaining;
+  }
+  EXPECT_EQ(num_threads * MaxIterations, popped.load() + remaining);
+}
 } // namespace
\ No newline at end of file
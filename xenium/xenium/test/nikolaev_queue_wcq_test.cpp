@@ -0,0 +1,268 @@
+#include <xenium/nikolaev_queue.hpp>
+#include <xenium/reclamation/generic_epoch_based.hpp>
+#include <xenium/reclamation/hazard_eras.hpp>
+#include <xenium/reclamation/hazard_pointer.hpp>
+#include <xenium/reclamation/lock_free_ref_count.hpp>
+#include <xenium/reclamation/quiescent_state_based.hpp>
+#include <xenium/reclamation/stamp_it.hpp>
+
+#include <gtest/gtest.h>
+
+#include <atomic>
+#include <random>
+#include <thread>
+#include <vector>
+
+namespace {
+
+template <class T, class... Policies>
+using wait_free_queue = xenium::nikolaev_queue<T, xenium::policy::ring<xenium::nikolaev_wcq_ring>, Policies...>;
+
+template <typename Reclaimer>
+struct NikolaevWaitFreeQueue : testing::Test {};
+
+struct non_default_constructible {
+  explicit non_default_constructible(int x) : x(x) {}
+  int x;
+};
+
+using Reclaimers =
+  ::testing::Types<xenium::reclamation::lock_free_ref_count<>,
+                   xenium::reclamation::hazard_pointer<>::with<
+                     xenium::policy::allocation_strategy<xenium::reclamation::hp_allocation::static_strategy<2>>>,
+                   xenium::reclamation::hazard_eras<>::with<
+                     xenium::policy::allocation_strategy<xenium::reclamation::he_allocation::static_strategy<2>>>,
+                   xenium::reclamation::quiescent_state_based,
+                   xenium::reclamation::stamp_it,
+                   xenium::reclamation::epoch_based<>::with<xenium::policy::scan_frequency<10>>,
+                   xenium::reclamation::new_epoch_based<>::with<xenium::policy::scan_frequency<10>>,
+                   xenium::reclamation::debra<>::with<xenium::policy::scan_frequency<10>>>;
+TYPED_TEST_SUITE(NikolaevWaitFreeQueue, Reclaimers);
+
+TYPED_TEST(NikolaevWaitFreeQueue, push_try_pop_returns_pushed_element) {
+  wait_free_queue<int, xenium::policy::reclaimer<TypeParam>> queue;
+  queue.push(42);
+  int elem = 0;
+  ASSERT_TRUE(queue.try_pop(elem));
+  EXPECT_EQ(42, elem);
+}
+
+TYPED_TEST(NikolaevWaitFreeQueue, push_two_items_pop_them_in_FIFO_order) {
+  wait_free_queue<int, xenium::policy::reclaimer<TypeParam>> queue;
+  queue.push(42);
+  queue.push(43);
+  int elem1 = 0;
+  int elem2 = 0;
+  EXPECT_TRUE(queue.try_pop(elem1));
+  ASSERT_TRUE(queue.try_pop(elem2));
+  EXPECT_EQ(42, elem1);
+  EXPECT_EQ(43, elem2);
+}
+
+TYPED_TEST(NikolaevWaitFreeQueue, try_pop_returns_false_when_queue_is_empty) {
+  wait_free_queue<int, xenium::policy::reclaimer<TypeParam>> queue;
+  int elem;
+  EXPECT_FALSE(queue.try_pop(elem));
+}
+
+TYPED_TEST(NikolaevWaitFreeQueue, supports_move_only_types) {
+  wait_free_queue<std::pair<int, std::unique_ptr<int>>, xenium::policy::reclaimer<TypeParam>> queue;
+  queue.push({41, std::make_unique<int>(42)});
+
+  std::pair<int, std::unique_ptr<int>> elem;
+  ASSERT_TRUE(queue.try_pop(elem));
+  EXPECT_EQ(41, elem.first);
+  ASSERT_NE(nullptr, elem.second);
+  EXPECT_EQ(42, *elem.second);
+}
+
+TYPED_TEST(NikolaevWaitFreeQueue, supports_non_default_constructible_types) {
+  wait_free_queue<non_default_constructible, xenium::policy::reclaimer<TypeParam>> queue;
+  queue.push(non_default_constructible(42));
+
+  non_default_constructible elem(0);
+  ASSERT_TRUE(queue.try_pop(elem));
+  EXPECT_EQ(42, elem.x);
+}
+
+TYPED_TEST(NikolaevWaitFreeQueue, deletes_remaining_entries) {
+  unsigned delete_count = 0;
+  struct dummy {
+    unsigned& delete_count;
+    explicit dummy(unsigned& delete_count) : delete_count(delete_count) {}
+    ~dummy() { ++delete_count; }
+  };
+  {
+    wait_free_queue<std::unique_ptr<dummy>, xenium::policy::reclaimer<TypeParam>> queue;
+    queue.push(std::make_unique<dummy>(delete_count));
+  }
+  EXPECT_EQ(1u, delete_count);
+}
+
+TYPED_TEST(NikolaevWaitFreeQueue, push_pop_in_fifo_order_with_remapped_indexes) {
+  constexpr int capacity = 11;
+  wait_free_queue<int, xenium::policy::entries_per_node<8>, xenium::policy::reclaimer<TypeParam>> queue;
+  for (int i = 0; i < capacity; ++i) {
+    queue.push(i);
+  }
+
+  for (int i = 0; i < capacity; ++i) {
+    int value;
+    ASSERT_TRUE(queue.try_pop(value)) << "iteration " << i;
+    EXPECT_EQ(i, value);
+  }
+}
+
+#ifdef DEBUG
+const int MaxIterations = 10000;
+#else
+const int MaxIterations = 50000;
+#endif
+
+TYPED_TEST(NikolaevWaitFreeQueue, parallel_usage) {
+  using Reclaimer = TypeParam;
+  wait_free_queue<int, xenium::policy::reclaimer<TypeParam>, xenium::policy::entries_per_node<8>> queue;
+
+  constexpr int num_threads = 4;
+  constexpr int thread_mask = num_threads - 1;
+
+  std::vector<std::thread> threads;
+  for (int i = 0; i < num_threads; ++i) {
+    threads.push_back(std::thread([i, &queue, num_threads, thread_mask] {
+      // oh my... MSVC complains if these variables are NOT captured; clang complains if they ARE captured.
+      (void)num_threads;
+      (void)thread_mask;
+
+      std::vector<int> last_seen(num_threads);
+      int counter = 0;
+      for (int j = 0; j < MaxIterations; ++j) {
+        [[maybe_unused]] typename Reclaimer::region_guard guard{};
+        queue.push((++counter << 8) | i);
+        int elem = 0;
+        ASSERT_TRUE(queue.try_pop(elem));
+        int thread = elem & thread_mask;
+        elem >>= 8;
+        EXPECT_GT(elem, last_seen[thread]);
+        last_seen[thread] = elem;
+      }
+    }));
+  }
+
+  for (auto& thread : threads) {
+    thread.join();
+  }
+}
+
+TYPED_TEST(NikolaevWaitFreeQueue, parallel_usage_mostly_full) {
+  using Reclaimer = TypeParam;
+  wait_free_queue<int, xenium::policy::reclaimer<TypeParam>, xenium::policy::entries_per_node<8>> queue;
+  for (int i = 0; i < 8; ++i) {
+    queue.push(1);
+  }
+
+  std::vector<std::thread> threads;
+  for (int i = 0; i < 4; ++i) {
+    threads.push_back(std::thread([i, &queue] {
+      std::mt19937_64 rand;
+      rand.seed(i);
+
+      for (int j = 0; j < MaxIterations; ++j) {
+        [[maybe_unused]] typename Reclaimer::region_guard guard{};
+        if (rand() % 128 < 64) {
+          queue.push(i);
+        } else {
+          int elem;
+          if (queue.try_pop(elem)) {
+            EXPECT_TRUE(elem >= 0 && elem <= 4);
+          }
+        }
+      }
+    }));
+  }
+
+  for (auto& thread : threads) {
+    thread.join();
+  }
+}
+
+TYPED_TEST(NikolaevWaitFreeQueue, parallel_usage_mostly_empty) {
+  using Reclaimer = TypeParam;
+  wait_free_queue<int, xenium::policy::reclaimer<TypeParam>, xenium::policy::entries_per_node<8>> queue;
+
+  std::vector<std::thread> threads;
+  for (int i = 0; i < 4; ++i) {
+    threads.push_back(std::thread([i, &queue] {
+      std::mt19937_64 rand;
+      rand.seed(i);
+
+      for (int j = 0; j < MaxIterations; ++j) {
+        [[maybe_unused]] typename Reclaimer::region_guard guard{};
+        if (rand() % 128 < 16) {
+          queue.push(i);
+        } else {
+          int elem;
+          if (queue.try_pop(elem)) {
+            EXPECT_TRUE(elem >= 0 && elem <= 4);
+          }
+        }
+      }
+    }));
+  }
+
+  for (auto& thread : threads) {
+    thread.join();
+  }
+}
+
+template <class Reclaimer, class Queue>
+void run_parallel_usage_does_not_lose_elements(Queue& queue) {
+  constexpr int num_threads = 3;
+  std::atomic<int> popped{0};
+  std::vector<std::thread> threads;
+  for (int i = 0; i < num_threads; ++i) {
+    threads.push_back(std::thread([&queue] {
+      for (int j = 0; j < MaxIterations; ++j) {
+        [[maybe_unused]] typename Reclaimer::region_guard guard{};
+        queue.push(j);
+      }
+    }));
+    threads.push_back(std::thread([&queue, &popped] {
+      for (int j = 0; j < MaxIterations / 2; ++j) {
+        [[maybe_unused]] typename Reclaimer::region_guard guard{};
+        int elem;
+        while (!queue.try_pop(elem)) {
+          std::this_thread::yield();
+        }
+        popped.fetch_add(1, std::memory_order_relaxed);
+      }
+    }));
+  }
+
+  for (auto& thread : threads) {
+    thread.join();
+  }
+
+  int remaining = 0;
+  int elem;
+  while (queue.try_pop(elem)) {
+    ++remaining;
+  }
+  EXPECT_EQ(num_threads * MaxIterations, popped.load() + remaining);
+}
+
+TYPED_TEST(NikolaevWaitFreeQueue, parallel_usage_does_not_lose_elements_when_switching_nodes) {
+  wait_free_queue<int, xenium::policy::reclaimer<TypeParam>, xenium::policy::entries_per_node<8>> queue;
+  run_parallel_usage_does_not_lose_elements<TypeParam>(queue);
+}
+
+TYPED_TEST(NikolaevWaitFreeQueue, parallel_usage_in_slow_path_does_not_lose_elements) {
+  // forces operations into the slow path as soon as the first fast path attempt fails
+  wait_free_queue<int,
+                  xenium::policy::reclaimer<TypeParam>,
+                  xenium::policy::entries_per_node<8>,
+                  xenium::policy::patience<1>,
+                  xenium::policy::help_delay<1>>
+    queue;
+  run_parallel_usage_does_not_lose_elements<TypeParam>(queue);
+}
+} // namespace
\ No newline at end of file
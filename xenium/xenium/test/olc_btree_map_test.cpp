@@ -0,0 +1,269 @@
+#include <xenium/olc_btree_map.hpp>
+#include <xenium/reclamation/generic_epoch_based.hpp>
+#include <xenium/reclamation/hazard_eras.hpp>
+#include <xenium/reclamation/hazard_pointer.hpp>
+#include <xenium/reclamation/quiescent_state_based.hpp>
+#include <xenium/reclamation/stamp_it.hpp>
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <random>
+#include <thread>
+#include <vector>
+
+namespace {
+
+template <typename Reclaimer>
+struct OlcBtreeMap : ::testing::Test {
+  // use a small node capacity so that the tests exercise splits of inner nodes
+  using map_t = xenium::olc_btree_map<int, int, xenium::policy::reclaimer<Reclaimer>, xenium::policy::node_capacity<4>>;
+  map_t map;
+};
+
+using Reclaimers =
+  ::testing::Types<xenium::reclamation::hazard_pointer<>::with<
+                     xenium::policy::allocation_strategy<xenium::reclamation::hp_allocation::static_strategy<3>>>,
+                   xenium::reclamation::hazard_eras<>::with<
+                     xenium::policy::allocation_strategy<xenium::reclamation::he_allocation::static_strategy<3>>>,
+                   xenium::reclamation::quiescent_state_based,
+                   xenium::reclamation::stamp_it,
+                   xenium::reclamation::epoch_based<>::with<xenium::policy::scan_frequency<10>>,
+                   xenium::reclamation::new_epoch_based<>::with<xenium::policy::scan_frequency<10>>,
+                   xenium::reclamation::debra<>::with<xenium::policy::scan_frequency<10>>>;
+TYPED_TEST_SUITE(OlcBtreeMap, Reclaimers);
+
+TYPED_TEST(OlcBtreeMap, emplace_same_key_twice_fails_second_time) {
+  EXPECT_TRUE(this->map.emplace(42, 43));
+  EXPECT_FALSE(this->map.emplace(42, 44));
+  int value;
+  ASSERT_TRUE(this->map.try_get_value(42, value));
+  EXPECT_EQ(43, value);
+}
+
+TYPED_TEST(OlcBtreeMap, try_get_value_returns_false_for_non_existing_element) {
+  this->map.emplace(43, 44);
+  int value;
+  EXPECT_FALSE(this->map.try_get_value(42, value));
+}
+
+TYPED_TEST(OlcBtreeMap, contains_returns_false_for_non_existing_element) {
+  this->map.emplace(42, 43);
+  EXPECT_FALSE(this->map.contains(41));
+  EXPECT_FALSE(this->map.contains(43));
+}
+
+TYPED_TEST(OlcBtreeMap, contains_returns_true_for_existing_element) {
+  this->map.emplace(42, 43);
+  EXPECT_TRUE(this->map.contains(42));
+}
+
+TYPED_TEST(OlcBtreeMap, erase_existing_element_succeeds) {
+  this->map.emplace(42, 43);
+  EXPECT_TRUE(this->map.erase(42));
+  EXPECT_FALSE(this->map.contains(42));
+}
+
+TYPED_TEST(OlcBtreeMap, erase_nonexisting_element_fails) {
+  EXPECT_FALSE(this->map.erase(42));
+}
+
+TYPED_TEST(OlcBtreeMap, erase_existing_element_twice_fails_the_second_time) {
+  this->map.emplace(42, 43);
+  EXPECT_TRUE(this->map.erase(42));
+  EXPECT_FALSE(this->map.erase(42));
+}
+
+TYPED_TEST(OlcBtreeMap, elements_remain_accessible_after_node_splits) {
+  std::vector<int> keys(1000);
+  for (int i = 0; i < 1000; ++i) {
+    keys[i] = i;
+  }
+  std::shuffle(keys.begin(), keys.end(), std::mt19937(42));
+  for (int k : keys) {
+    EXPECT_TRUE(this->map.emplace(k, k * 10));
+  }
+  for (int k = 0; k < 1000; ++k) {
+    int value;
+    ASSERT_TRUE(this->map.try_get_value(k, value));
+    EXPECT_EQ(k * 10, value);
+  }
+  EXPECT_FALSE(this->map.contains(1000));
+}
+
+TYPED_TEST(OlcBtreeMap, erase_all_elements_and_reinsert_them) {
+  std::vector<int> keys(500);
+  for (int i = 0; i < 500; ++i) {
+    keys[i] = i;
+  }
+  std::shuffle(keys.begin(), keys.end(), std::mt19937(1));
+  for (int k : keys) {
+    EXPECT_TRUE(this->map.emplace(k, k));
+  }
+  std::shuffle(keys.begin(), keys.end(), std::mt19937(2));
+  for (int k : keys) {
+    EXPECT_TRUE(this->map.erase(k));
+    EXPECT_FALSE(this->map.contains(k));
+  }
+  int visited = 0;
+  this->map.for_each_in_range(0, 500, [&visited](int, int) { ++visited; });
+  EXPECT_EQ(0, visited);
+
+  for (int k : keys) {
+    EXPECT_TRUE(this->map.emplace(k, k));
+  }
+  for (int k : keys) {
+    EXPECT_TRUE(this->map.contains(k));
+  }
+}
+
+TYPED_TEST(OlcBtreeMap, for_each_in_range_visits_all_elements_in_half_open_range) {
+  for (int i = 0; i < 200; i += 2) {
+    this->map.emplace(i, i * 10);
+  }
+  std::vector<int> keys;
+  this->map.for_each_in_range(51, 150, [&keys](int key, int value) {
+    EXPECT_EQ(key * 10, value);
+    keys.push_back(key);
+  });
+  ASSERT_EQ(49u, keys.size());
+  for (std::size_t i = 0; i < keys.size(); ++i) {
+    EXPECT_EQ(52 + 2 * static_cast<int>(i), keys[i]);
+  }
+}
+
+TYPED_TEST(OlcBtreeMap, for_each_in_range_with_empty_range_visits_nothing) {
+  for (int i = 0; i < 20; ++i) {
+    this->map.emplace(i, i);
+  }
+  int visited = 0;
+  this->map.for_each_in_range(5, 5, [&visited](int, int) { ++visited; });
+  this->map.for_each_in_range(30, 40, [&visited](int, int) { ++visited; });
+  EXPECT_EQ(0, visited);
+}
+
+TYPED_TEST(OlcBtreeMap, compare_policy_defines_order_of_entries) {
+  using Reclaimer = TypeParam;
+  xenium::olc_btree_map<int,
+                        int,
+                        xenium::policy::reclaimer<Reclaimer>,
+                        xenium::policy::compare<std::greater<int>>,
+                        xenium::policy::node_capacity<4>>
+    map;
+  for (int i = 0; i < 20; ++i) {
+    map.emplace(i, i);
+  }
+  std::vector<int> keys;
+  map.for_each_in_range(15, 10, [&keys](int key, int) { keys.push_back(key); });
+  EXPECT_EQ((std::vector<int>{15, 14, 13, 12, 11}), keys);
+}
+
+namespace {
+#ifdef DEBUG
+  const int MaxIterations = 1000;
+#else
+  const int MaxIterations = 10000;
+#endif
+} // namespace
+
+TYPED_TEST(OlcBtreeMap, parallel_usage) {
+  using Reclaimer = TypeParam;
+  auto& map = this->map;
+
+  std::vector<std::thread> threads;
+  for (int i = 0; i < 8; ++i) {
+    threads.push_back(std::thread([i, &map] {
+      for (int j = 0; j < MaxIterations; ++j) {
+        [[maybe_unused]] typename Reclaimer::region_guard guard{};
+        int key = i + 8 * (j % 64);
+        EXPECT_FALSE(map.contains(key));
+        EXPECT_TRUE(map.emplace(key, j));
+        int value;
+        ASSERT_TRUE(map.try_get_value(key, value));
+        EXPECT_EQ(j, value);
+        EXPECT_TRUE(map.erase(key));
+        EXPECT_FALSE(map.contains(key));
+      }
+    }));
+  }
+
+  for (auto& thread : threads) {
+    thread.join();
+  }
+  int visited = 0;
+  map.for_each_in_range(0, 1000, [&visited](int, int) { ++visited; });
+  EXPECT_EQ(0, visited);
+}
+
+TYPED_TEST(OlcBtreeMap, parallel_usage_with_same_values) {
+  using Reclaimer = TypeParam;
+  auto& map = this->map;
+
+  std::vector<std::thread> threads;
+  for (int i = 0; i < 8; ++i) {
+    threads.push_back(std::thread([&map] {
+      for (int j = 0; j < MaxIterations / 10; ++j) {
+        for (int k = 0; k < 10; ++k) {
+          [[maybe_unused]] typename Reclaimer::region_guard guard{};
+          map.contains(k);
+          map.emplace(k, k);
+          int value;
+          if (map.try_get_value(k, value)) {
+            EXPECT_EQ(k, value);
+          }
+          map.erase(k);
+
+          int last = -1;
+          map.for_each_in_range(0, 10, [&last](int key, int value) {
+            EXPECT_EQ(key, value);
+            EXPECT_LT(last, key);
+            last = key;
+          });
+        }
+      }
+    }));
+  }
+
+  for (auto& thread : threads) {
+    thread.join();
+  }
+}
+
+TYPED_TEST(OlcBtreeMap, parallel_range_scans) {
+  using Reclaimer = TypeParam;
+  auto& map = this->map;
+  for (int i = 0; i < 200; i += 2) {
+    map.emplace(i, i);
+  }
+
+  std::vector<std::thread> threads;
+  for (int i = 0; i < 8; ++i) {
+    threads.push_back(std::thread([i, &map] {
+      for (int j = 0; j < MaxIterations / 10; ++j) {
+        [[maybe_unused]] typename Reclaimer::region_guard guard{};
+        if (i % 2 == 0) {
+          // writers insert and remove odd keys
+          int key = 2 * ((i * 7 + j) % 100) + 1;
+          map.emplace(key, key);
+          map.erase(key);
+        } else {
+          // the even keys are never removed, so we must see all of them
+          int last = -1;
+          int count = 0;
+          map.for_each_in_range(50, 150, [&](int key, int value) {
+            EXPECT_LT(last, key);
+            EXPECT_EQ(key, value);
+            last = key;
+            count += (key % 2 == 0) ? 1 : 0;
+          });
+          EXPECT_EQ(50, count);
+        }
+      }
+    }));
+  }
+
+  for (auto& thread : threads) {
+    thread.join();
+  }
+}
+} // namespace
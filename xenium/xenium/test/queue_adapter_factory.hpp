@@ -0,0 +1,26 @@
+#ifndef XENIUM_TEST_QUEUE_ADAPTER_FACTORY_HPP
+#define XENIUM_TEST_QUEUE_ADAPTER_FACTORY_HPP
+
+#include <xenium/kirsch_bounded_kfifo_queue.hpp>
+#include <xenium/vyukov_bounded_queue.hpp>
+
+#include <memory>
+
+// Creates a queue adapter like `blocking_queue` or `async_queue` for the typed tests.
+// Bounded queues are created with a small capacity, so the tests also cover full queues.
+template <template <class> class Adapter, class Queue>
+struct queue_adapter_factory {
+  static auto create() { return std::make_unique<Adapter<Queue>>(); }
+};
+
+template <template <class> class Adapter, class T, class... Policies>
+struct queue_adapter_factory<Adapter, xenium::vyukov_bounded_queue<T, Policies...>> {
+  static auto create() { return std::make_unique<Adapter<xenium::vyukov_bounded_queue<T, Policies...>>>(4); }
+};
+
+template <template <class> class Adapter, class T, class... Policies>
+struct queue_adapter_factory<Adapter, xenium::kirsch_bounded_kfifo_queue<T, Policies...>> {
+  static auto create() { return std::make_unique<Adapter<xenium::kirsch_bounded_kfifo_queue<T, Policies...>>>(1, 4); }
+};
+
+#endif
@@ -0,0 +1,182 @@
+#include <xenium/spsc_bounded_queue.hpp>
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <iterator>
+#include <memory>
+#include <numeric>
+#include <thread>
+#include <vector>
+
+namespace {
+
+TEST(SpscBoundedQueue, push_try_pop_returns_pushed_element) {
+  xenium::spsc_bounded_queue<int> queue(2);
+  EXPECT_TRUE(queue.try_push(42));
+  int elem = 0;
+  ASSERT_TRUE(queue.try_pop(elem));
+  EXPECT_EQ(42, elem);
+}
+
+TEST(SpscBoundedQueue, push_two_items_pop_them_in_FIFO_order) {
+  xenium::spsc_bounded_queue<int> queue(2);
+  EXPECT_TRUE(queue.try_push(42));
+  EXPECT_TRUE(queue.try_push(43));
+  int elem1 = 0;
+  int elem2 = 0;
+  EXPECT_TRUE(queue.try_pop(elem1));
+  ASSERT_TRUE(queue.try_pop(elem2));
+  EXPECT_EQ(42, elem1);
+  EXPECT_EQ(43, elem2);
+}
+
+TEST(SpscBoundedQueue, try_pop_returns_false_when_queue_is_empty) {
+  xenium::spsc_bounded_queue<int> queue(2);
+  int elem = 0;
+  EXPECT_FALSE(queue.try_pop(elem));
+}
+
+TEST(SpscBoundedQueue, try_push_returns_false_when_queue_is_full) {
+  xenium::spsc_bounded_queue<int> queue(2);
+  EXPECT_EQ(2u, queue.capacity());
+  EXPECT_TRUE(queue.try_push(42));
+  EXPECT_TRUE(queue.try_push(43));
+  EXPECT_FALSE(queue.try_push(44));
+}
+
+TEST(SpscBoundedQueue, supports_move_only_types) {
+  xenium::spsc_bounded_queue<std::pair<int, std::unique_ptr<int>>> queue(2);
+  queue.try_push({41, std::make_unique<int>(42)});
+
+  std::pair<int, std::unique_ptr<int>> elem;
+  ASSERT_TRUE(queue.try_pop(elem));
+  EXPECT_EQ(41, elem.first);
+  ASSERT_NE(nullptr, elem.second);
+  EXPECT_EQ(42, *elem.second);
+}
+
+TEST(SpscBoundedQueue, push_pop_in_FIFO_order_across_wrap_around) {
+  xenium::spsc_bounded_queue<int> queue(4);
+  int next_push = 0;
+  int next_pop = 0;
+  for (int round = 0; round < 10; ++round) {
+    while (queue.try_push(next_push)) {
+      ++next_push;
+    }
+    for (int i = 0; i < 3; ++i) {
+      int elem = -1;
+      ASSERT_TRUE(queue.try_pop(elem));
+      EXPECT_EQ(next_pop++, elem);
+    }
+  }
+}
+
+TEST(SpscBoundedQueue, push_n_pushes_only_as_many_elements_as_there_is_space) {
+  xenium::spsc_bounded_queue<int> queue(4);
+  std::vector<int> values{1, 2, 3, 4, 5, 6};
+  EXPECT_EQ(4u, queue.push_n(values.begin(), values.end()));
+  EXPECT_EQ(0u, queue.push_n(values.begin() + 4, values.end()));
+
+  int elem = 0;
+  ASSERT_TRUE(queue.try_pop(elem));
+  EXPECT_EQ(1, elem);
+  EXPECT_EQ(1u, queue.push_n(values.begin() + 4, values.end()));
+}
+
+TEST(SpscBoundedQueue, pop_n_pops_at_most_max_elements_in_FIFO_order) {
+  xenium::spsc_bounded_queue<int> queue(8);
+  std::vector<int> values{1, 2, 3, 4, 5};
+  ASSERT_EQ(5u, queue.push_n(values.begin(), values.end()));
+
+  std::vector<int> result;
+  EXPECT_EQ(3u, queue.pop_n(std::back_inserter(result), 3));
+  EXPECT_EQ(2u, queue.pop_n(std::back_inserter(result), 10));
+  EXPECT_EQ(values, result);
+}
+
+TEST(SpscBoundedQueue, pop_n_returns_zero_when_queue_is_empty) {
+  xenium::spsc_bounded_queue<int> queue(2);
+  std::vector<int> result;
+  EXPECT_EQ(0u, queue.pop_n(std::back_inserter(result), 2));
+  EXPECT_TRUE(result.empty());
+}
+
+TEST(SpscBoundedQueue, batch_operations_wrap_around_the_end_of_the_buffer) {
+  xenium::spsc_bounded_queue<int> queue(4);
+  std::vector<int> values{1, 2, 3};
+  std::vector<int> result;
+  for (int i = 0; i < 5; ++i) {
+    ASSERT_EQ(3u, queue.push_n(values.begin(), values.end()));
+    result.clear();
+    ASSERT_EQ(3u, queue.pop_n(std::back_inserter(result), 4));
+    EXPECT_EQ(values, result);
+  }
+}
+
+#ifdef DEBUG
+const int MaxIterations = 40000;
+#else
+const int MaxIterations = 400000;
+#endif
+
+TEST(SpscBoundedQueue, parallel_usage) {
+  xenium::spsc_bounded_queue<int> queue(8);
+
+  std::thread producer([&queue] {
+    for (int i = 0; i < MaxIterations; ++i) {
+      while (!queue.try_push(i)) {
+        std::this_thread::yield();
+      }
+    }
+  });
+
+  int expected = 0;
+  while (expected < MaxIterations) {
+    int elem = -1;
+    if (queue.try_pop(elem)) {
+      ASSERT_EQ(expected, elem);
+      ++expected;
+    } else {
+      std::this_thread::yield();
+    }
+  }
+  producer.join();
+
+  int elem = 0;
+  EXPECT_FALSE(queue.try_pop(elem));
+}
+
+TEST(SpscBoundedQueue, parallel_usage_of_batch_operations) {
+  xenium::spsc_bounded_queue<int> queue(16);
+
+  std::thread producer([&queue] {
+    std::vector<int> batch(5);
+    for (int i = 0; i < MaxIterations; i += 5) {
+      std::iota(batch.begin(), batch.end(), i);
+      auto it = batch.begin();
+      while (it != batch.end()) {
+        auto n = queue.push_n(it, batch.end());
+        if (n == 0) {
+          std::this_thread::yield();
+        }
+        it += static_cast<std::ptrdiff_t>(n);
+      }
+    }
+  });
+
+  std::vector<int> result;
+  result.reserve(MaxIterations);
+  while (result.size() < static_cast<std::size_t>(MaxIterations)) {
+    if (queue.pop_n(std::back_inserter(result), 7) == 0) {
+      std::this_thread::yield();
+    }
+  }
+  producer.join();
+
+  for (int i = 0; i < MaxIterations; ++i) {
+    ASSERT_EQ(i, result[i]);
+  }
+}
+
+} // namespace
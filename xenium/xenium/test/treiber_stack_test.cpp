@@ -0,0 +1,168 @@
+#include <xenium/reclamation/generic_epoch_based.hpp>
+#include <xenium/reclamation/hazard_eras.hpp>
+#include <xenium/reclamation/hazard_pointer.hpp>
+#include <xenium/reclamation/lock_free_ref_count.hpp>
+#include <xenium/reclamation/quiescent_state_based.hpp>
+#include <xenium/reclamation/stamp_it.hpp>
+#include <xenium/treiber_stack.hpp>
+
+#include <gtest/gtest.h>
+
+#include <atomic>
+#include <memory>
+#include <thread>
+#include <vector>
+
+namespace {
+
+template <typename Reclaimer>
+struct TreiberStack : testing::Test {};
+
+using Reclaimers =
+  ::testing::Types<xenium::reclamation::lock_free_ref_count<>,
+                   xenium::reclamation::hazard_pointer<>::with<
+                     xenium::policy::allocation_strategy<xenium::reclamation::hp_allocation::static_strategy<1>>>,
+                   xenium::reclamation::hazard_eras<>::with<
+                     xenium::policy::allocation_strategy<xenium::reclamation::he_allocation::static_strategy<1>>>,
+                   xenium::reclamation::quiescent_state_based,
+                   xenium::reclamation::stamp_it,
+                   xenium::reclamation::epoch_based<>::with<xenium::policy::scan_frequency<10>>,
+                   xenium::reclamation::new_epoch_based<>::with<xenium::policy::scan_frequency<10>>,
+                   xenium::reclamation::debra<>::with<xenium::policy::scan_frequency<10>>>;
+TYPED_TEST_SUITE(TreiberStack, Reclaimers);
+
+TYPED_TEST(TreiberStack, try_pop_on_empty_stack_returns_false) {
+  xenium::treiber_stack<int, xenium::policy::reclaimer<TypeParam>> stack;
+  int elem = 0;
+  EXPECT_FALSE(stack.try_pop(elem));
+}
+
+TYPED_TEST(TreiberStack, push_try_pop_returns_pushed_element) {
+  xenium::treiber_stack<int, xenium::policy::reclaimer<TypeParam>> stack;
+  stack.push(42);
+  int elem = 0;
+  ASSERT_TRUE(stack.try_pop(elem));
+  EXPECT_EQ(42, elem);
+}
+
+TYPED_TEST(TreiberStack, push_two_items_pop_them_in_LIFO_order) {
+  xenium::treiber_stack<int, xenium::policy::reclaimer<TypeParam>> stack;
+  stack.push(42);
+  stack.push(43);
+  int elem1 = 0;
+  int elem2 = 0;
+  EXPECT_TRUE(stack.try_pop(elem1));
+  EXPECT_TRUE(stack.try_pop(elem2));
+  EXPECT_EQ(43, elem1);
+  EXPECT_EQ(42, elem2);
+}
+
+TYPED_TEST(TreiberStack, supports_move_only_types) {
+  xenium::treiber_stack<std::unique_ptr<int>, xenium::policy::reclaimer<TypeParam>> stack;
+  stack.push(std::make_unique<int>(42));
+
+  std::unique_ptr<int> elem;
+  ASSERT_TRUE(stack.try_pop(elem));
+  ASSERT_NE(nullptr, elem);
+  EXPECT_EQ(42, *elem);
+}
+
+TYPED_TEST(TreiberStack, deletes_remaining_entries) {
+  unsigned delete_count = 0;
+  struct dummy {
+    unsigned& delete_count;
+    explicit dummy(unsigned& delete_count) : delete_count(delete_count) {}
+    ~dummy() { ++delete_count; }
+  };
+  {
+    xenium::treiber_stack<std::unique_ptr<dummy>, xenium::policy::reclaimer<TypeParam>> stack;
+    stack.push(std::make_unique<dummy>(delete_count));
+    stack.push(std::make_unique<dummy>(delete_count));
+  }
+  EXPECT_EQ(2u, delete_count);
+}
+
+#ifdef DEBUG
+const int MaxIterations = 1000;
+#else
+const int MaxIterations = 10000;
+#endif
+
+template <class Stack, class Reclaimer>
+void run_parallel_usage(Stack& stack) {
+  std::vector<std::thread> threads;
+  for (int i = 0; i < 4; ++i) {
+    threads.push_back(std::thread([i, &stack] {
+      for (int j = 0; j < MaxIterations; ++j) {
+        [[maybe_unused]] typename Reclaimer::region_guard guard{};
+        stack.push(std::make_unique<int>(i));
+        std::unique_ptr<int> elem;
+        EXPECT_TRUE(stack.try_pop(elem));
+        ASSERT_NE(nullptr, elem);
+        EXPECT_TRUE(*elem >= 0 && *elem < 4);
+      }
+    }));
+  }
+
+  for (auto& thread : threads) {
+    thread.join();
+  }
+
+  std::unique_ptr<int> elem;
+  EXPECT_FALSE(stack.try_pop(elem));
+}
+
+TYPED_TEST(TreiberStack, parallel_usage) {
+  using Reclaimer = TypeParam;
+  xenium::treiber_stack<std::unique_ptr<int>, xenium::policy::reclaimer<Reclaimer>> stack;
+  run_parallel_usage<decltype(stack), Reclaimer>(stack);
+}
+
+TYPED_TEST(TreiberStack, parallel_usage_with_elimination) {
+  using Reclaimer = TypeParam;
+  xenium::treiber_stack<std::unique_ptr<int>,
+                        xenium::policy::reclaimer<Reclaimer>,
+                        xenium::policy::elimination_slots<2>,
+                        xenium::policy::backoff<xenium::exponential_backoff<16>>>
+    stack;
+  run_parallel_usage<decltype(stack), Reclaimer>(stack);
+}
+
+TYPED_TEST(TreiberStack, parallel_usage_with_elimination_does_not_lose_elements) {
+  // Every thread alternates between push and pop, so most operations collide in the single
+  // elimination slot, and nodes that are deleted by an eliminating pop are likely to be reused
+  // at the same address by the next push that is published in this slot. Since every pop
+  // follows a completed push of the same thread, the stack can never be empty for a pop.
+  using Reclaimer = TypeParam;
+  xenium::treiber_stack<std::unique_ptr<int>, xenium::policy::reclaimer<Reclaimer>, xenium::policy::elimination_slots<1>>
+    stack;
+
+  constexpr int num_threads = 4;
+  std::atomic<long> popped_sum{0};
+  std::vector<std::thread> threads;
+  for (int i = 0; i < num_threads; ++i) {
+    threads.push_back(std::thread([i, &stack, &popped_sum] {
+      long sum = 0;
+      for (int j = 0; j < MaxIterations; ++j) {
+        [[maybe_unused]] typename Reclaimer::region_guard guard{};
+        stack.push(std::make_unique<int>(i * MaxIterations + j));
+        std::unique_ptr<int> elem;
+        EXPECT_TRUE(stack.try_pop(elem));
+        if (elem) {
+          sum += *elem % MaxIterations;
+        }
+      }
+      popped_sum.fetch_add(sum);
+    }));
+  }
+
+  for (auto& thread : threads) {
+    thread.join();
+  }
+
+  std::unique_ptr<int> elem;
+  EXPECT_FALSE(stack.try_pop(elem));
+  const long expected_sum = num_threads * (static_cast<long>(MaxIterations) * (MaxIterations - 1) / 2);
+  EXPECT_EQ(expected_sum, popped_sum.load());
+}
+} // namespace
@@ -1,118 +1,335 @@
-#include <xenium/vyukov_bounded_queue.hpp>
-
-#include <gtest/gtest.h>
-
-#include <thread>
-#include <vector>
-
-namespace {
-
-struct VyukovBoundedQueue : testing::Test {};
-
-TEST(VyukovBoundedQueue, push_try_pop_returns_pushed_element) {
-  xenium::vyukov_bounded_queue<int> queue(2);
-  static_assert(!xenium::vyukov_bounded_queue<int>::default_to_weak);
-  EXPECT_TRUE(queue.try_push(42));
-  int elem;
-  EXPECT_TRUE(queue.try_pop(elem));
-  EXPECT_EQ(42, elem);
-}
-
-TEST(VyukovBoundedQueue, push_try_pop_weak_returns_pushed_element) {
-  xenium::vyukov_bounded_queue<int> queue(2);
-  EXPECT_TRUE(queue.try_push(42));
-  int elem;
-  EXPECT_TRUE(queue.try_pop_weak(elem));
-  EXPECT_EQ(42, elem);
-}
-
-TEST(VyukovBoundedQueue, push_two_items_pop_them_in_FIFO_order) {
-  xenium::vyukov_bounded_queue<int> queue(2);
-  EXPECT_TRUE(queue.try_push(42));
-  EXPECT_TRUE(queue.try_push(43));
-  int elem1;
-  int elem2;
-  EXPECT_TRUE(queue.try_pop(elem1));
-  EXPECT_TRUE(queue.try_pop(elem2));
-  EXPECT_EQ(42, elem1);
-  EXPECT_EQ(43, elem2);
-}
-
-TEST(VyukovBoundedQueue, try_pop_returns_false_when_queue_is_empty) {
-  xenium::vyukov_bounded_queue<int> queue(2);
-  int elem;
-  EXPECT_FALSE(queue.try_pop(elem));
-  EXPECT_FALSE(queue.try_pop_weak(elem));
-}
-
-TEST(VyukovBoundedQueue, try_push_returns_false_when_queue_is_full) {
-  xenium::vyukov_bounded_queue<int> queue(2);
-  EXPECT_TRUE(queue.try_push(42));
-  EXPECT_TRUE(queue.try_push(43));
-  EXPECT_FALSE(queue.try_push(44));
-  EXPECT_FALSE(queue.try_push_weak(44));
-}
-
-TEST(VyukovBoundedQueue, supports_move_only_types) {
-  xenium::vyukov_bounded_queue<std::pair<int, std::unique_ptr<int>>> queue(2);
-  queue.try_push(41, std::make_unique<int>(42));
-
-  std::pair<int, std::unique_ptr<int>> elem;
-  ASSERT_TRUE(queue.try_pop(elem));
-  EXPECT_EQ(41, elem.first);
-  ASSERT_NE(nullptr, elem.second);
-  EXPECT_EQ(42, *elem.second);
-}
-
-TEST(VyukovBoundedQueue, parallel_usage) {
-  xenium::vyukov_bounded_queue<int> queue(8);
-
-  std::vector<std::thread> threads;
-  for (int i = 0; i < 4; ++i) {
-    threads.emplace_back([i, &queue] {
-#ifdef DEBUG
-      const int MaxIterations = 40000;
-#else
-      const int MaxIterations = 400000;
-#endif
-      for (int j = 0; j < MaxIterations; ++j) {
-        EXPECT_TRUE(queue.try_push(i));
-        int elem = 0;
-        EXPECT_TRUE(queue.try_pop(elem));
-        EXPECT_TRUE(elem >= 0 && elem <= 4);
-      }
-    });
-  }
-
-  for (auto& thread : threads) {
-    thread.join();
-  }
-}
-
-TEST(VyukovBoundedQueue, parallel_usage_of_weak_operations) {
-  xenium::vyukov_bounded_queue<int> queue(8);
-
-  std::vector<std::thread> threads;
-  for (int i = 0; i < 4; ++i) {
-    threads.emplace_back([i, &queue] {
-#ifdef DEBUG
-      const int MaxIterations = 40000;
-#else
-      const int MaxIterations = 400000;
-#endif
-      for (int j = 0; j < MaxIterations; ++j) {
-        queue.try_push_weak(i);
-        int elem;
-        if (queue.try_pop_weak(elem)) {
-          EXPECT_TRUE(elem >= 0 && elem <= 4);
-        }
-      }
-    });
-  }
-
-  for (auto& thread : threads) {
-    thread.join();
-  }
-}
-
+#include <xenium/vyukov_bounded_queue.hpp>
+
+#include <gtest/gtest.h>
+
+#include <atomic>
+#include <cstdint>
+#include <iterator>
+#include <memory>
+#include <thread>
+#include <utility>
+#include <vector>
+
+namespace {
+
+struct VyukovBoundedQueue : testing::Test {};
+
+TEST(VyukovBoundedQueue, push_try_pop_returns_pushed_element) {
+  xenium::vyukov_bounded_queue<int> queue(2);
+  static_assert(!xenium::vyukov_bounded_queue<int>::default_to_weak);
+  EXPECT_TRUE(queue.try_push(42));
+  int elem;
+  EXPECT_TRUE(queue.try_pop(elem));
+  EXPECT_EQ(42, elem);
+}
+
+TEST(VyukovBoundedQueue, push_try_pop_weak_returns_pushed_element) {
+  xenium::vyukov_bounded_queue<int> queue(2);
+  EXPECT_TRUE(queue.try_push(42));
+  int elem;
+  EXPECT_TRUE(queue.try_pop_weak(elem));
+  EXPECT_EQ(42, elem);
+}
+
+TEST(VyukovBoundedQueue, push_two_items_pop_them_in_FIFO_order) {
+  xenium::vyukov_bounded_queue<int> queue(2);
+  EXPECT_TRUE(queue.try_push(42));
+  EXPECT_TRUE(queue.try_push(43));
+  int elem1;
+  int elem2;
+  EXPECT_TRUE(queue.try_pop(elem1));
+  EXPECT_TRUE(queue.try_pop(elem2));
+  EXPECT_EQ(42, elem1);
+  EXPECT_EQ(43, elem2);
+}
+
+TEST(VyukovBoundedQueue, try_pop_returns_false_when_queue_is_empty) {
+  xenium::vyukov_bounded_queue<int> queue(2);
+  int elem;
+  EXPECT_FALSE(queue.try_pop(elem));
+  EXPECT_FALSE(queue.try_pop_weak(elem));
+}
+
+TEST(VyukovBoundedQueue, try_push_returns_false_when_queue_is_full) {
+  xenium::vyukov_bounded_queue<int> queue(2);
+  EXPECT_TRUE(queue.try_push(42));
+  EXPECT_TRUE(queue.try_push(43));
+  EXPECT_FALSE(queue.try_push(44));
+  EXPECT_FALSE(queue.try_push_weak(44));
+}
+
+TEST(VyukovBoundedQueue, supports_move_only_types) {
+  xenium::vyukov_bounded_queue<std::pair<int, std::unique_ptr<int>>> queue(2);
+  queue.try_push(41, std::make_unique<int>(42));
+
+  std::pair<int, std::unique_ptr<int>> elem;
+  ASSERT_TRUE(queue.try_pop(elem));
+  EXPECT_EQ(41, elem.first);
+  ASSERT_NE(nullptr, elem.second);
+  EXPECT_EQ(42, *elem.second);
+}
+
+TEST(VyukovBoundedQueue, try_push_n_pushes_all_elements_if_there_is_enough_space) {
+  xenium::vyukov_bounded_queue<int> queue(8);
+  std::vector<int> values{1, 2, 3, 4, 5};
+  EXPECT_EQ(5u, queue.try_push_n(values.begin(), values.end()));
+  for (int v : values) {
+    int elem;
+    ASSERT_TRUE(queue.try_pop(elem));
+    EXPECT_EQ(v, elem);
+  }
+  int elem;
+  EXPECT_FALSE(queue.try_pop(elem));
+}
+
+TEST(VyukovBoundedQueue, try_push_n_pushes_only_as_many_elements_as_fit) {
+  xenium::vyukov_bounded_queue<int> queue(4);
+  EXPECT_TRUE(queue.try_push(0));
+  std::vector<int> values{1, 2, 3, 4, 5};
+  EXPECT_EQ(3u, queue.try_push_n(values.begin(), values.end()));
+  EXPECT_EQ(0u, queue.try_push_n(values.begin() + 3, values.end()));
+  std::vector<int> result;
+  EXPECT_EQ(4u, queue.try_pop_n(std::back_inserter(result), 10));
+  EXPECT_EQ((std::vector<int>{0, 1, 2, 3}), result);
+}
+
+TEST(VyukovBoundedQueue, try_pop_n_pops_at_most_max_elements_in_FIFO_order) {
+  xenium::vyukov_bounded_queue<int> queue(8);
+  for (int i = 0; i < 6; ++i) {
+    EXPECT_TRUE(queue.try_push(i));
+  }
+  std::vector<int> result;
+  EXPECT_EQ(4u, queue.try_pop_n(std::back_inserter(result), 4));
+  EXPECT_EQ((std::vector<int>{0, 1, 2, 3}), result);
+  result.clear();
+  EXPECT_EQ(2u, queue.try_pop_n(std::back_inserter(result), 4));
+  EXPECT_EQ((std::vector<int>{4, 5}), result);
+}
+
+TEST(VyukovBoundedQueue, try_pop_n_returns_zero_when_queue_is_empty) {
+  xenium::vyukov_bounded_queue<int> queue(2);
+  std::vector<int> result;
+  EXPECT_EQ(0u, queue.try_pop_n(std::back_inserter(result), 4));
+  EXPECT_TRUE(result.empty());
+}
+
+TEST(VyukovBoundedQueue, batch_operations_wrap_around_the_end_of_the_buffer) {
+  xenium::vyukov_bounded_queue<int, xenium::policy::default_to_weak<true>> queue(4);
+  std::vector<int> values{1, 2, 3};
+  std::vector<int> result;
+  for (int i = 0; i < 10; ++i) {
+    ASSERT_EQ(3u, queue.try_push_n(values.begin(), values.end()));
+    result.clear();
+    ASSERT_EQ(3u, queue.try_pop_n(std::back_inserter(result), 8));
+    EXPECT_EQ(values, result);
+  }
+}
+
+TEST(VyukovBoundedQueue, batch_operations_support_move_only_types) {
+  xenium::vyukov_bounded_queue<std::unique_ptr<int>> queue(4);
+  std::vector<std::unique_ptr<int>> values;
+  values.push_back(std::make_unique<int>(42));
+  values.push_back(std::make_unique<int>(43));
+  EXPECT_EQ(2u, queue.try_push_n(std::make_move_iterator(values.begin()), std::make_move_iterator(values.end())));
+
+  std::vector<std::unique_ptr<int>> result;
+  ASSERT_EQ(2u, queue.try_pop_n(std::back_inserter(result), 2));
+  ASSERT_NE(nullptr, result[0]);
+  ASSERT_NE(nullptr, result[1]);
+  EXPECT_EQ(42, *result[0]);
+  EXPECT_EQ(43, *result[1]);
+}
+
+TEST(VyukovBoundedQueue, padding_bytes_increase_the_cell_size) {
+  using queue_t = xenium::vyukov_bounded_queue<std::uint32_t, xenium::policy::padding_bytes<48>>;
+  static_assert(queue_t::cell_size >= 64);
+  static_assert(xenium::vyukov_bounded_queue<std::uint32_t>::cell_size < 64);
+  queue_t queue(4);
+  EXPECT_TRUE(queue.try_push(42u));
+  std::uint32_t elem;
+  EXPECT_TRUE(queue.try_pop(elem));
+  EXPECT_EQ(42u, elem);
+}
+
+TEST(VyukovBoundedQueue, remapped_queue_preserves_FIFO_order) {
+  xenium::vyukov_bounded_queue<int, xenium::policy::remap_index<true>> queue(64);
+  int next_push = 0;
+  int next_pop = 0;
+  // push and pop in chunks of varying size, so that the positions wrap around several times
+  for (int round = 0; round < 50; ++round) {
+    for (int i = 0; i < round % 64 + 1; ++i) {
+      ASSERT_TRUE(queue.try_push(next_push++));
+    }
+    while (next_pop < next_push) {
+      int elem;
+      ASSERT_TRUE(queue.try_pop(elem));
+      EXPECT_EQ(next_pop++, elem);
+    }
+  }
+  std::vector<int> values(64);
+  for (int i = 0; i < 64; ++i) {
+    values[i] = i;
+  }
+  EXPECT_EQ(64u, queue.try_push_n(values.begin(), values.end()));
+  EXPECT_FALSE(queue.try_push(0));
+  std::vector<int> result;
+  EXPECT_EQ(64u, queue.try_pop_n(std::back_inserter(result), 100));
+  EXPECT_EQ(values, result);
+}
+
+TEST(VyukovBoundedQueue, remapped_queue_with_cell_size_that_is_no_power_of_two) {
+  // a cell consists of the sequence counter and the value, i.e., 24 bytes
+  using value_t = std::pair<std::uint64_t, std::uint64_t>;
+  using queue_t = xenium::vyukov_bounded_queue<value_t, xenium::policy::remap_index<true>>;
+  static_assert(queue_t::cell_size == 24);
+  queue_t queue(32);
+  for (int round = 0; round < 3; ++round) {
+    for (std::uint64_t i = 0; i < 32; ++i) {
+      ASSERT_TRUE(queue.try_push(value_t{i, round}));
+    }
+    for (std::uint64_t i = 0; i < 32; ++i) {
+      value_t elem;
+      ASSERT_TRUE(queue.try_pop(elem));
+      EXPECT_EQ(i, elem.first);
+      EXPECT_EQ(static_cast<std::uint64_t>(round), elem.second);
+    }
+  }
+}
+
+TEST(VyukovBoundedQueue, remaining_elements_are_destroyed) {
+  auto value = std::make_shared<int>(42);
+  {
+    xenium::vyukov_bounded_queue<std::shared_ptr<int>, xenium::policy::remap_index<true>> queue(8);
+    EXPECT_TRUE(queue.try_push(value));
+    EXPECT_TRUE(queue.try_push(value));
+    EXPECT_EQ(3, value.use_count());
+  }
+  EXPECT_EQ(1, value.use_count());
+}
+
+TEST(VyukovBoundedQueue, parallel_usage) {
+  xenium::vyukov_bounded_queue<int> queue(8);
+
+  std::vector<std::thread> threads;
+  for (int i = 0; i < 4; ++i) {
+    threads.emplace_back([i, &queue] {
+#ifdef DEBUG
+      const int MaxIterations = 40000;
+#else
+      const int MaxIterations = 400000;
+#endif
+      for (int j = 0; j < MaxIterations; ++j) {
+        EXPECT_TRUE(queue.try_push(i));
+        int elem = 0;
+        EXPECT_TRUE(queue.try_pop(elem));
+        EXPECT_TRUE(elem >= 0 && elem <= 4);
+      }
+    });
+  }
+
+  for (auto& thread : threads) {
+    thread.join();
+  }
+}
+
+TEST(VyukovBoundedQueue, parallel_usage_of_weak_operations) {
+  xenium::vyukov_bounded_queue<int> queue(8);
+
+  std::vector<std::thread> threads;
+  for (int i = 0; i < 4; ++i) {
+    threads.emplace_back([i, &queue] {
+#ifdef DEBUG
+      const int MaxIterations = 40000;
+#else
+      const int MaxIterations = 400000;
+#endif
+      for (int j = 0; j < MaxIterations; ++j) {
+        queue.try_push_weak(i);
+        int elem;
+        if (queue.try_pop_weak(elem)) {
+          EXPECT_TRUE(elem >= 0 && elem <= 4);
+        }
+      }
+    });
+  }
+
+  for (auto& thread : threads) {
+    thread.join();
+  }
+}
+
+TEST(VyukovBoundedQueue, parallel_usage_of_batch_operations) {
+  constexpr int Threads = 4;
+  constexpr int BatchSize = 4;
+  xenium::vyukov_bounded_queue<int> queue(Threads * BatchSize);
+
+  std::atomic<int> popped{0};
+  std::vector<std::thread> threads;
+  for (int i = 0; i < Threads; ++i) {
+    threads.emplace_back([i, &queue, &popped] {
+#ifdef DEBUG
+      const int MaxIterations = 10000;
+#else
+      const int MaxIterations = 100000;
+#endif
+      std::vector<int> last_seen(Threads, -1);
+      std::vector<int> values(BatchSize);
+      std::vector<int> result;
+      for (int j = 0; j < MaxIterations; ++j) {
+        for (int k = 0; k < BatchSize; ++k) {
+          values[k] = (j * BatchSize + k) * Threads + i;
+        }
+        // every thread pops as many elements as it pushes, so there is always enough space, but a
+        // push can still succeed only partially if a concurrent pop has not yet released its cells
+        auto it = values.begin();
+        while (it != values.end()) {
+          it += static_cast<std::ptrdiff_t>(queue.try_push_n(it, values.end()));
+        }
+        result.clear();
+        while (result.size() < BatchSize) {
+          queue.try_pop_n(std::back_inserter(result), BatchSize - result.size());
+        }
+        popped += static_cast<int>(result.size());
+        // the elements of each producer must be popped in the order in which they have been pushed
+        for (int v : result) {
+          const int producer = v % Threads;
+          EXPECT_LT(last_seen[producer], v);
+          last_seen[producer] = v;
+        }
+      }
+    });
+  }
+
+  for (auto& thread : threads) {
+    thread.join();
+  }
+  int elem;
+  EXPECT_FALSE(queue.try_pop(elem));
+}
+
+TEST(VyukovBoundedQueue, parallel_usage_of_remapped_and_padded_queue) {
+  xenium::vyukov_bounded_queue<int, xenium::policy::remap_index<true>, xenium::policy::padding_bytes<8>> queue(64);
+
+  std::vector<std::thread> threads;
+  for (int i = 0; i < 4; ++i) {
+    threads.emplace_back([i, &queue] {
+#ifdef DEBUG
+      const int MaxIterations = 40000;
+#else
+      const int MaxIterations = 400000;
+#endif
+      for (int j = 0; j < MaxIterations; ++j) {
+        EXPECT_TRUE(queue.try_push(i));
+        int elem = 0;
+        EXPECT_TRUE(queue.try_pop(elem));
+        EXPECT_TRUE(elem >= 0 && elem <= 4);
+      }
+    });
+  }
+
+  for (auto& thread : threads) {
+    thread.join();
+  }
+}
+
 } // namespace
\ No newline at end of file
@@ -7,6 +7,9 @@
 
 #include <gtest/gtest.h>
 
+#include <cstdint>
+#include <filesystem>
+#include <fstream>
 #include <thread>
 #include <vector>
 
@@ -147,12 +150,174 @@ TYPED_TEST(VyukovHashMap, extract_existing_element_returns_true_and_removes_elem
   EXPECT_FALSE(this->map.erase(42));
 }
 
+TYPED_TEST(VyukovHashMap, update_nonexisting_element_returns_false) {
+  bool called = false;
+  EXPECT_FALSE(this->map.update(42, [&](int&) { called = true; }));
+  EXPECT_FALSE(called);
+}
+
+TYPED_TEST(VyukovHashMap, update_existing_element_returns_true_and_updates_value) {
+  this->map.emplace(42, 43);
+  EXPECT_TRUE(this->map.update(42, [](int& v) { v *= 2; }));
+  typename VyukovHashMap<TypeParam>::hash_map::accessor acc;
+  EXPECT_TRUE(this->map.try_get_value(42, acc));
+  EXPECT_EQ(86, *acc);
+}
+
+TYPED_TEST(VyukovHashMap, update_element_in_overfull_bucket) {
+  for (int i = 0; i < 5; ++i) {
+    this->map.emplace(i * 8, i);
+  }
+  EXPECT_TRUE(this->map.update(32, [](int& v) { v += 10; }));
+  typename VyukovHashMap<TypeParam>::hash_map::accessor acc;
+  EXPECT_TRUE(this->map.try_get_value(32, acc));
+  EXPECT_EQ(14, *acc);
+}
+
+TYPED_TEST(VyukovHashMap, upsert_inserts_new_element_without_calling_func) {
+  bool called = false;
+  EXPECT_TRUE(this->map.upsert(
+    42, [] { return 43; }, [&](int&) { called = true; }));
+  EXPECT_FALSE(called);
+  typename VyukovHashMap<TypeParam>::hash_map::accessor acc;
+  EXPECT_TRUE(this->map.try_get_value(42, acc));
+  EXPECT_EQ(43, *acc);
+}
+
+TYPED_TEST(VyukovHashMap, upsert_updates_existing_element_without_calling_factory) {
+  this->map.emplace(42, 43);
+  bool called = false;
+  EXPECT_FALSE(this->map.upsert(
+    42,
+    [&] {
+      called = true;
+      return 0;
+    },
+    [](int& v) { ++v; }));
+  EXPECT_FALSE(called);
+  typename VyukovHashMap<TypeParam>::hash_map::accessor acc;
+  EXPECT_TRUE(this->map.try_get_value(42, acc));
+  EXPECT_EQ(44, *acc);
+}
+
+TYPED_TEST(VyukovHashMap, fetch_add_inserts_delta_and_returns_previous_value) {
+  EXPECT_EQ(0, this->map.fetch_add(42, 5));
+  EXPECT_EQ(5, this->map.fetch_add(42, 3));
+  typename VyukovHashMap<TypeParam>::hash_map::accessor acc;
+  EXPECT_TRUE(this->map.try_get_value(42, acc));
+  EXPECT_EQ(8, *acc);
+}
+
+TYPED_TEST(VyukovHashMap, update_unlocks_bucket_in_case_of_exception) {
+  this->map.emplace(42, 42);
+  EXPECT_THROW(this->map.update(42, [](int&) { throw std::runtime_error("test exception"); }), std::runtime_error);
+  EXPECT_TRUE(this->map.erase(42));
+}
+
+TYPED_TEST(VyukovHashMap, update_with_string_key_and_value_keeps_old_accessor_valid) {
+  using hash_map = xenium::vyukov_hash_map<std::string, std::string, xenium::policy::reclaimer<TypeParam>>;
+  hash_map map;
+
+  map.emplace("foo", "bar");
+  typename hash_map::accessor old_acc;
+  EXPECT_TRUE(map.try_get_value("foo", old_acc));
+  EXPECT_TRUE(map.update("foo", [](std::string& v) { v += "baz"; }));
+  EXPECT_EQ("bar", *old_acc);
+  old_acc.reset();
+
+  typename hash_map::accessor acc;
+  EXPECT_TRUE(map.try_get_value("foo", acc));
+  EXPECT_EQ("barbaz", *acc);
+  acc.reset();
+
+  EXPECT_FALSE(map.upsert(
+    "foo", [] { return std::string(); }, [](std::string& v) { v = "xyz"; }));
+  auto it = map.begin();
+  EXPECT_EQ("foo", it->first);
+  EXPECT_EQ("xyz", it->second);
+}
+
+TYPED_TEST(VyukovHashMap, update_with_managed_pointer_value_reclaims_replaced_object) {
+  struct node : TypeParam::template enable_concurrent_ptr<node> {
+    explicit node(int v) : v(v) {}
+    int v;
+  };
+
+  using hash_map =
+    xenium::vyukov_hash_map<int, xenium::managed_ptr<node, TypeParam>, xenium::policy::reclaimer<TypeParam>>;
+  hash_map map;
+
+  map.emplace(42, new node(43));
+  EXPECT_TRUE(map.update(42, [](node*& v) { v = new node(v->v + 1); }));
+  typename hash_map::accessor acc;
+  EXPECT_TRUE(map.try_get_value(42, acc));
+  EXPECT_EQ(44, acc->v);
+}
+
 TYPED_TEST(VyukovHashMap, map_grows_if_needed) {
   for (int i = 0; i < 10000; ++i) {
     EXPECT_TRUE(this->map.emplace(i, i));
   }
 }
 
+TYPED_TEST(VyukovHashMap, handles_skewed_hash_distribution) {
+  struct skewed_hash {
+    std::size_t operator()(int v) const { return v % 4 == 0 ? 0 : v; }
+  };
+  using hash_map =
+    xenium::vyukov_hash_map<int, int, xenium::policy::reclaimer<TypeParam>, xenium::policy::hash<skewed_hash>>;
+  hash_map map(8);
+
+  // every fourth key ends up in the same bucket
+  for (int i = 0; i < 1000; ++i) {
+    EXPECT_TRUE(map.emplace(i, i));
+  }
+  for (int i = 0; i < 1000; ++i) {
+    typename hash_map::accessor acc;
+    ASSERT_TRUE(map.try_get_value(i, acc)) << i;
+    EXPECT_EQ(i, *acc);
+  }
+  for (int i = 0; i < 1000; i += 2) {
+    EXPECT_TRUE(map.erase(i));
+  }
+  for (int i = 0; i < 1000; ++i) {
+    typename hash_map::accessor acc;
+    EXPECT_EQ(i % 2 != 0, map.try_get_value(i, acc)) << i;
+  }
+}
+
+TYPED_TEST(VyukovHashMap, allocates_extension_items_on_demand_instead_of_growing) {
+  struct constant_hash {
+    std::size_t operator()(int) const { return 0; }
+  };
+  using hash_map =
+    xenium::vyukov_hash_map<int, int, xenium::policy::reclaimer<TypeParam>, xenium::policy::hash<constant_hash>>;
+  hash_map map(1024);
+  ASSERT_EQ(1024u, map.bucket_count());
+
+  // All keys end up in the same bucket, so this needs far more extension items than a block
+  // with 1024 buckets provides. But the load factor stays low, so the map must allocate
+  // additional extension items instead of growing the table.
+  constexpr int count = 500;
+  for (int i = 0; i < count; ++i) {
+    EXPECT_TRUE(map.emplace(i, i));
+  }
+  EXPECT_EQ(1024u, map.bucket_count());
+  for (int i = 0; i < count; ++i) {
+    typename hash_map::accessor acc;
+    ASSERT_TRUE(map.try_get_value(i, acc)) << i;
+    EXPECT_EQ(i, *acc);
+  }
+}
+
+TYPED_TEST(VyukovHashMap, grows_if_load_factor_is_exceeded) {
+  ASSERT_EQ(8u, this->map.bucket_count());
+  for (int i = 0; i < 100; ++i) {
+    EXPECT_TRUE(this->map.emplace(i, i));
+  }
+  EXPECT_GT(this->map.bucket_count(), 8u);
+}
+
 TYPED_TEST(VyukovHashMap, with_managed_pointer_value) {
   struct node : TypeParam::template enable_concurrent_ptr<node> {
     explicit node(int v) : v(v) {}
@@ -412,6 +577,246 @@ TYPED_TEST(VyukovHashMap, iterator_covers_all_entries_in_sparsely_populated_map)
   }
 }
 
+TYPED_TEST(VyukovHashMap, snapshot_begin_returns_snapshot_end_for_empty_map) {
+  EXPECT_EQ(this->map.snapshot_end(), this->map.snapshot_begin());
+}
+
+TYPED_TEST(VyukovHashMap, snapshot_iterator_covers_all_entries) {
+  std::map<int, int> visited;
+  for (int i = 0; i < 200; ++i) {
+    this->map.emplace(i, i * 2);
+  }
+  for (auto it = this->map.snapshot_begin(); it != this->map.snapshot_end(); ++it) {
+    EXPECT_EQ(it->first * 2, it->second);
+    ++visited[it->first];
+  }
+
+  ASSERT_EQ(200u, visited.size());
+  for (auto& v : visited) {
+    EXPECT_EQ(1, v.second) << v.first << " was not visited exactly once";
+  }
+}
+
+TYPED_TEST(VyukovHashMap, snapshot_iterator_does_not_require_bucket_locks) {
+  this->map.emplace(42, 43);
+  auto it = this->map.begin(); // holds the lock on the bucket containing 42
+  ASSERT_NE(this->map.end(), it);
+
+  auto snapshot = this->map.snapshot_begin();
+  ASSERT_NE(this->map.snapshot_end(), snapshot);
+  EXPECT_EQ(42, snapshot->first);
+  EXPECT_EQ(43, snapshot->second);
+  ++snapshot;
+  EXPECT_EQ(this->map.snapshot_end(), snapshot);
+}
+
+TYPED_TEST(VyukovHashMap, snapshot_iterator_continues_in_grown_map) {
+  for (int i = 0; i < 20; ++i) {
+    this->map.emplace(i, i);
+  }
+
+  std::map<int, int> visited;
+  int next_key = 1000;
+  for (auto it = this->map.snapshot_begin(); it != this->map.snapshot_end(); ++it) {
+    ++visited[it->first];
+    // insert enough new entries to force the map to grow while we are iterating
+    for (int i = 0; i < 10; ++i, ++next_key) {
+      this->map.emplace(next_key, next_key);
+    }
+  }
+
+  for (int i = 0; i < 20; ++i) {
+    EXPECT_EQ(1, visited[i]) << i << " was not visited exactly once";
+  }
+  for (auto& v : visited) {
+    EXPECT_EQ(1, v.second) << v.first << " was visited more than once";
+  }
+}
+
+TYPED_TEST(VyukovHashMap, snapshot_iterator_with_string_key_and_value) {
+  using hash_map = xenium::vyukov_hash_map<std::string, std::string, xenium::policy::reclaimer<TypeParam>>;
+  hash_map map;
+  map.emplace("foo", "bar");
+  map.emplace("answer", "42");
+
+  std::map<std::string, std::string> visited;
+  for (auto it = map.snapshot_begin(); it != map.snapshot_end(); ++it) {
+    visited.emplace(it->first, it->second);
+  }
+  map.erase("foo");
+
+  ASSERT_EQ(2u, visited.size());
+  EXPECT_EQ("bar", visited["foo"]);
+  EXPECT_EQ("42", visited["answer"]);
+}
+
+TYPED_TEST(VyukovHashMap, size_reflects_insertions_and_removals) {
+  EXPECT_EQ(0u, this->map.size());
+  for (int i = 0; i < 200; ++i) {
+    this->map.emplace(i, i);
+  }
+  this->map.emplace(42, 42);
+  EXPECT_EQ(200u, this->map.size());
+  EXPECT_EQ(200u, this->map.approximate_size());
+
+  for (int i = 0; i < 200; i += 2) {
+    this->map.erase(i);
+  }
+  this->map.erase(0);
+  EXPECT_EQ(100u, this->map.size());
+
+  auto it = this->map.begin();
+  while (it != this->map.end()) {
+    this->map.erase(it);
+  }
+  EXPECT_EQ(0u, this->map.size());
+  EXPECT_EQ(0u, this->map.approximate_size());
+}
+
+TYPED_TEST(VyukovHashMap, save_and_load_restores_all_entries) {
+  for (int i = 0; i < 5000; ++i) {
+    this->map.emplace(i, i * 2);
+  }
+  const auto path = (std::filesystem::temp_directory_path() / "xenium_vyukov_hash_map_test.bin").string();
+  this->map.save(path);
+
+  typename TestFixture::hash_map loaded{8};
+  loaded.load(path);
+  std::filesystem::remove(path);
+
+  EXPECT_EQ(5000u, loaded.size());
+  for (int i = 0; i < 5000; ++i) {
+    typename TestFixture::hash_map::accessor acc;
+    ASSERT_TRUE(loaded.try_get_value(i, acc)) << i;
+    EXPECT_EQ(i * 2, *acc);
+  }
+
+  // the loaded map must be fully functional
+  EXPECT_FALSE(loaded.emplace(42, 0));
+  EXPECT_TRUE(loaded.erase(42));
+  for (int i = 5000; i < 20000; ++i) {
+    EXPECT_TRUE(loaded.emplace(i, i * 2));
+  }
+  EXPECT_EQ(19999u, loaded.size());
+}
+
+TYPED_TEST(VyukovHashMap, save_and_load_empty_map) {
+  const auto path = (std::filesystem::temp_directory_path() / "xenium_vyukov_hash_map_test.bin").string();
+  this->map.save(path);
+
+  typename TestFixture::hash_map loaded;
+  loaded.load(path);
+  std::filesystem::remove(path);
+
+  EXPECT_EQ(0u, loaded.size());
+  EXPECT_EQ(loaded.snapshot_end(), loaded.snapshot_begin());
+}
+
+TYPED_TEST(VyukovHashMap, save_and_load_with_64bit_key_and_value) {
+  using hash_map = xenium::vyukov_hash_map<std::uint64_t, double, xenium::policy::reclaimer<TypeParam>>;
+  hash_map map;
+  for (std::uint64_t i = 0; i < 1000; ++i) {
+    map.emplace(i << 32, static_cast<double>(i) / 2);
+  }
+  const auto path = (std::filesystem::temp_directory_path() / "xenium_vyukov_hash_map_test.bin").string();
+  map.save(path);
+
+  hash_map loaded;
+  loaded.load(path);
+  std::filesystem::remove(path);
+
+  EXPECT_EQ(1000u, loaded.size());
+  for (std::uint64_t i = 0; i < 1000; ++i) {
+    typename hash_map::accessor acc;
+    ASSERT_TRUE(loaded.try_get_value(i << 32, acc));
+    EXPECT_EQ(static_cast<double>(i) / 2, *acc);
+  }
+}
+
+TYPED_TEST(VyukovHashMap, load_rejects_invalid_files_and_non_empty_maps) {
+  const auto path = (std::filesystem::temp_directory_path() / "xenium_vyukov_hash_map_test.bin").string();
+  EXPECT_THROW(this->map.load(path + ".missing"), std::system_error);
+
+  {
+    std::ofstream out(path, std::ios::binary);
+    out << "this is not a valid file";
+  }
+  EXPECT_THROW(this->map.load(path), std::runtime_error);
+
+  // a file that has been written for a different value type
+  xenium::vyukov_hash_map<int, std::int64_t, xenium::policy::reclaimer<TypeParam>> other;
+  other.emplace(1, 1);
+  other.save(path);
+  EXPECT_THROW(this->map.load(path), std::runtime_error);
+
+  this->map.save(path);
+  this->map.emplace(1, 1);
+  EXPECT_THROW(this->map.load(path), std::logic_error);
+  std::filesystem::remove(path);
+  EXPECT_EQ(1u, this->map.size());
+}
+
+TYPED_TEST(VyukovHashMap, bulk_build_inserts_all_elements) {
+  std::vector<std::pair<int, int>> data;
+  for (int i = 0; i < 20000; ++i) {
+    data.emplace_back(i, i * 2);
+  }
+  for (std::size_t threads : {1, 4}) {
+    typename TestFixture::hash_map map{8};
+    map.bulk_build(data.begin(), data.end(), threads);
+    EXPECT_EQ(data.size(), map.size());
+    for (auto& v : data) {
+      typename TestFixture::hash_map::accessor acc;
+      ASSERT_TRUE(map.try_get_value(v.first, acc)) << v.first;
+      EXPECT_EQ(v.second, *acc);
+    }
+
+    // the map must be fully functional after the bulk build
+    EXPECT_FALSE(map.emplace(42, 0));
+    EXPECT_TRUE(map.erase(42));
+    EXPECT_TRUE(map.emplace(-1, -1));
+    EXPECT_EQ(data.size(), map.size());
+  }
+}
+
+TYPED_TEST(VyukovHashMap, bulk_build_inserts_only_first_of_equivalent_keys) {
+  struct skewed_hash {
+    std::size_t operator()(int v) const { return v % 4 == 0 ? 0 : v; }
+  };
+  using hash_map =
+    xenium::vyukov_hash_map<int, int, xenium::policy::reclaimer<TypeParam>, xenium::policy::hash<skewed_hash>>;
+
+  // every fourth key ends up in the same bucket, so many elements have to be stored in extension items
+  std::vector<std::pair<int, int>> data;
+  for (int i = 0; i < 8000; ++i) {
+    data.emplace_back(i, i);
+  }
+  for (int i = 0; i < 8000; i += 3) {
+    data.emplace_back(i, -i);
+  }
+
+  hash_map map;
+  map.bulk_build(data.begin(), data.end(), 4);
+  EXPECT_EQ(8000u, map.size());
+  for (int i = 0; i < 8000; ++i) {
+    typename hash_map::accessor acc;
+    ASSERT_TRUE(map.try_get_value(i, acc)) << i;
+    EXPECT_EQ(i, *acc);
+  }
+  std::size_t visited = 0;
+  for (auto it = map.begin(); it != map.end(); ++it) {
+    ++visited;
+  }
+  EXPECT_EQ(8000u, visited);
+}
+
+TYPED_TEST(VyukovHashMap, bulk_build_rejects_non_empty_map) {
+  std::vector<std::pair<int, int>> data{{1, 1}, {2, 2}};
+  this->map.emplace(1, 1);
+  EXPECT_THROW(this->map.bulk_build(data.begin(), data.end()), std::logic_error);
+  EXPECT_EQ(1u, this->map.size());
+}
+
 #ifdef DEBUG
 const int MaxIterations = 2000;
 #else
@@ -511,6 +916,151 @@ TYPED_TEST(VyukovHashMap, parallel_usage_with_nontrivial_types) {
   }
 }
 
+TYPED_TEST(VyukovHashMap, parallel_fetch_add) {
+  using Reclaimer = TypeParam;
+
+  using hash_map = xenium::vyukov_hash_map<int, int, xenium::policy::reclaimer<Reclaimer>>;
+  hash_map map(8);
+
+  static constexpr int num_keys = 16;
+
+  std::vector<std::thread> threads;
+  for (int i = 0; i < 8; ++i) {
+    threads.push_back(std::thread([&map] {
+      for (int j = 0; j < MaxIterations; ++j) {
+        [[maybe_unused]] typename Reclaimer::region_guard guard{};
+        map.fetch_add(j % num_keys, 1);
+        typename hash_map::accessor acc;
+        EXPECT_TRUE(map.try_get_value(j % num_keys, acc));
+      }
+    }));
+  }
+
+  for (auto& thread : threads) {
+    thread.join();
+  }
+
+  int total = 0;
+  for (auto v : map) {
+    total += v.second;
+  }
+  EXPECT_EQ(8 * MaxIterations, total);
+}
+
+TYPED_TEST(VyukovHashMap, parallel_size) {
+  using Reclaimer = TypeParam;
+
+  using hash_map = xenium::vyukov_hash_map<int, int, xenium::policy::reclaimer<Reclaimer>>;
+  hash_map map(8);
+
+  std::vector<std::thread> threads;
+  for (int i = 0; i < 8; ++i) {
+    threads.push_back(std::thread([i, &map] {
+      for (int j = 0; j < MaxIterations / 8; ++j) {
+        [[maybe_unused]] typename Reclaimer::region_guard guard{};
+        const int key = i * MaxIterations + j;
+        EXPECT_TRUE(map.emplace(key, j));
+        if (j % 2 == 0) {
+          EXPECT_TRUE(map.erase(key));
+        }
+        EXPECT_LE(map.approximate_size(), static_cast<std::size_t>(8 * MaxIterations));
+      }
+    }));
+  }
+
+  for (auto& thread : threads) {
+    thread.join();
+  }
+
+  const std::size_t expected = 8 * (MaxIterations / 8 - (MaxIterations / 8 + 1) / 2);
+  EXPECT_EQ(expected, map.size());
+  EXPECT_EQ(expected, map.approximate_size());
+}
+
+TYPED_TEST(VyukovHashMap, parallel_snapshot_iteration) {
+  using Reclaimer = TypeParam;
+
+  using hash_map = xenium::vyukov_hash_map<int, std::string, xenium::policy::reclaimer<Reclaimer>>;
+  hash_map map(8);
+
+  // the keys [0, permanent_keys) are never removed, so every scan has to visit them exactly once
+  static constexpr int permanent_keys = 100;
+  for (int i = 0; i < permanent_keys; ++i) {
+    map.emplace(i, std::to_string(i));
+  }
+
+  std::atomic<bool> stop{false};
+  std::vector<std::thread> threads;
+  for (int i = 0; i < 4; ++i) {
+    threads.push_back(std::thread([i, &map] {
+      for (int j = 0; j < MaxIterations; ++j) {
+        [[maybe_unused]] typename Reclaimer::region_guard guard{};
+        const int key = permanent_keys + i * 64 + j % 64;
+        map.emplace(key, std::to_string(key));
+        if (j % 3 == 0) {
+          map.erase(key);
+        }
+      }
+    }));
+  }
+  for (int i = 0; i < 4; ++i) {
+    threads.push_back(std::thread([&map, &stop] {
+      while (!stop.load()) {
+        [[maybe_unused]] typename Reclaimer::region_guard guard{};
+        std::vector<int> visited(permanent_keys, 0);
+        for (auto it = map.snapshot_begin(); it != map.snapshot_end(); ++it) {
+          EXPECT_EQ(std::to_string(it->first), it->second);
+          if (it->first < permanent_keys) {
+            ++visited[it->first];
+          }
+        }
+        for (int k = 0; k < permanent_keys; ++k) {
+          EXPECT_EQ(1, visited[k]) << k;
+        }
+      }
+    }));
+  }
+
+  for (int i = 0; i < 4; ++i) {
+    threads[i].join();
+  }
+  stop.store(true);
+  for (int i = 4; i < 8; ++i) {
+    threads[i].join();
+  }
+}
+
+TYPED_TEST(VyukovHashMap, parallel_update_with_nontrivial_types) {
+  using Reclaimer = TypeParam;
+
+  using hash_map = xenium::vyukov_hash_map<std::string, std::string, xenium::policy::reclaimer<Reclaimer>>;
+  hash_map map(8);
+
+  std::vector<std::thread> threads;
+  for (int i = 0; i < 8; ++i) {
+    threads.push_back(std::thread([&map] {
+      for (int j = 0; j < MaxIterations / 10; ++j) {
+        std::string key = std::to_string(j % 10);
+        [[maybe_unused]] typename Reclaimer::region_guard guard{};
+        map.upsert(
+          key, [] { return std::string("x"); }, [](std::string& v) { v += "x"; });
+        typename hash_map::accessor acc;
+        if (map.try_get_value(key, acc)) {
+          EXPECT_EQ(std::string(acc->size(), 'x'), *acc);
+        }
+        acc.reset();
+        if (j % 16 == 0) {
+          map.erase(key);
+        }
+      }
+    }));
+  }
+
+  for (auto& thread : threads) {
+    thread.join();
+  }
+}
+
 TYPED_TEST(VyukovHashMap, parallel_usage_with_same_values) {
   using Reclaimer = TypeParam;
 
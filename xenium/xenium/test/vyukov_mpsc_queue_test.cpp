@@ -0,0 +1,142 @@
+#include <xenium/vyukov_mpsc_queue.hpp>
+
+#include <gtest/gtest.h>
+
+#include <memory>
+#include <thread>
+#include <vector>
+
+namespace {
+
+struct message : xenium::vyukov_mpsc_queue_hook {
+  explicit message(int value) : value(value) {}
+  int value;
+};
+
+using queue_t = xenium::vyukov_mpsc_queue<message>;
+
+TEST(VyukovMpscQueue, push_try_pop_returns_pushed_element) {
+  queue_t queue;
+  message msg(42);
+  queue.push(&msg);
+  message* result = nullptr;
+  ASSERT_TRUE(queue.try_pop(result));
+  EXPECT_EQ(&msg, result);
+  EXPECT_EQ(42, result->value);
+}
+
+TEST(VyukovMpscQueue, push_two_items_pop_them_in_FIFO_order) {
+  queue_t queue;
+  message msg1(42);
+  message msg2(43);
+  queue.push(&msg1);
+  queue.push(&msg2);
+  message* elem1 = nullptr;
+  message* elem2 = nullptr;
+  EXPECT_TRUE(queue.try_pop(elem1));
+  ASSERT_TRUE(queue.try_pop(elem2));
+  EXPECT_EQ(&msg1, elem1);
+  EXPECT_EQ(&msg2, elem2);
+}
+
+TEST(VyukovMpscQueue, try_pop_returns_false_when_queue_is_empty) {
+  queue_t queue;
+  message* result = nullptr;
+  EXPECT_FALSE(queue.try_pop(result));
+}
+
+TEST(VyukovMpscQueue, try_pop_returns_false_after_all_elements_have_been_popped) {
+  queue_t queue;
+  message msg(42);
+  queue.push(&msg);
+  message* result = nullptr;
+  ASSERT_TRUE(queue.try_pop(result));
+  EXPECT_FALSE(queue.try_pop(result));
+  EXPECT_FALSE(queue.try_pop(result));
+}
+
+TEST(VyukovMpscQueue, popped_elements_can_be_pushed_again) {
+  queue_t queue;
+  message msg1(1);
+  message msg2(2);
+  for (int i = 0; i < 10; ++i) {
+    queue.push(&msg1);
+    queue.push(&msg2);
+    message* result = nullptr;
+    ASSERT_TRUE(queue.try_pop(result));
+    EXPECT_EQ(&msg1, result);
+    ASSERT_TRUE(queue.try_pop(result));
+    EXPECT_EQ(&msg2, result);
+    EXPECT_FALSE(queue.try_pop(result));
+  }
+}
+
+TEST(VyukovMpscQueue, interleaved_push_and_pop_preserve_FIFO_order) {
+  queue_t queue;
+  std::vector<std::unique_ptr<message>> messages;
+  for (int i = 0; i < 100; ++i) {
+    messages.push_back(std::make_unique<message>(i));
+  }
+
+  int next_push = 0;
+  int next_pop = 0;
+  while (next_pop < 100) {
+    for (int i = 0; i < 3 && next_push < 100; ++i) {
+      queue.push(messages[next_push++].get());
+    }
+    message* result = nullptr;
+    ASSERT_TRUE(queue.try_pop(result));
+    EXPECT_EQ(next_pop++, result->value);
+  }
+}
+
+#ifdef DEBUG
+const int MaxIterations = 10000;
+#else
+const int MaxIterations = 100000;
+#endif
+
+TEST(VyukovMpscQueue, parallel_usage) {
+  queue_t queue;
+
+  constexpr int num_producers = 4;
+  std::vector<std::vector<message>> messages(num_producers);
+  for (int i = 0; i < num_producers; ++i) {
+    messages[i].reserve(MaxIterations);
+    for (int j = 0; j < MaxIterations; ++j) {
+      messages[i].emplace_back((j << 8) | i);
+    }
+  }
+
+  std::vector<std::thread> producers;
+  for (int i = 0; i < num_producers; ++i) {
+    producers.emplace_back([i, &queue, &messages] {
+      for (auto& msg : messages[i]) {
+        queue.push(&msg);
+      }
+    });
+  }
+
+  std::vector<int> last_seen(num_producers, -1);
+  int received = 0;
+  while (received < num_producers * MaxIterations) {
+    message* result = nullptr;
+    if (!queue.try_pop(result)) {
+      std::this_thread::yield();
+      continue;
+    }
+    const int producer = result->value & 0xff;
+    const int value = result->value >> 8;
+    ASSERT_EQ(last_seen[producer] + 1, value);
+    last_seen[producer] = value;
+    ++received;
+  }
+
+  for (auto& thread : producers) {
+    thread.join();
+  }
+  message* result = nullptr;
+  EXPECT_FALSE(queue.try_pop(result));
+}
+
+} // namespace
@@ -0,0 +1,954 @@
+//
+// Copyright (c) 2018-2020 Manuel Pöter.
+// Licensed under the MIT License. See LICENSE file in the project root for full license information.
+//
+
+#ifndef XENIUM_ART_MAP_HPP
+#define XENIUM_ART_MAP_HPP
+
+#include <xenium/acquire_guard.hpp>
+#include <xenium/backoff.hpp>
+#include <xenium/detail/optimistic_lock.hpp>
+#include <xenium/detail/port.hpp>
+#include <xenium/parameter.hpp>
+#include <xenium/policy.hpp>
+
+#include <array>
+#include <atomic>
+#include <cassert>
+#include <cstdint>
+#include <string>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#if defined(XENIUM_ARCH_X86)
+  #include <emmintrin.h>
+#endif
+
+namespace xenium {
+
+namespace detail {
+  /**
+   * Transforms keys into binary-comparable byte strings, i.e., the lexicographic order of the
+   * encoded keys is the same as the order of the original keys. The encoding must be prefix free.
+   */
+  template <class Key, class = void>
+  struct art_key_traits {
+    static_assert(sizeof(Key) == 0, "art_map only supports integral keys (except bool) and std::string");
+  };
+
+  template <class Key>
+  struct art_key_traits<Key, std::enable_if_t<std::is_integral_v<Key> && !std::is_same_v<Key, bool>>> {
+    using encoded_key = std::array<std::uint8_t, sizeof(Key)>;
+    static encoded_key encode(Key key) {
+      using unsigned_key = std::make_unsigned_t<Key>;
+      auto value = static_cast<unsigned_key>(key);
+      if constexpr (std::is_signed_v<Key>) {
+        // flip the sign bit so that negative numbers are ordered before positive ones
+        value ^= static_cast<unsigned_key>(unsigned_key(1) << (sizeof(Key) * 8 - 1));
+      }
+      encoded_key result{};
+      for (std::size_t i = 0; i < sizeof(Key); ++i) {
+        result[i] = static_cast<std::uint8_t>(value >> (8 * (sizeof(Key) - 1 - i)));
+      }
+      return result;
+    }
+  };
+
+  template <>
+  struct art_key_traits<std::string> {
+    // The terminating zero makes the encoding prefix free, so keys must not contain zero bytes.
+    using encoded_key = std::string;
+    static encoded_key encode(const std::string& key) {
+      assert(key.find('\0') == std::string::npos);
+      std::string result;
+      result.reserve(key.size() + 1);
+      result.append(key);
+      result.push_back('\0');
+      return result;
+    }
+  };
+} // namespace detail
+
+/**
+ * @brief A concurrent adaptive radix tree (ART) based on optimistic lock coupling.
+ *
+ * This data structure is based on the adaptive radix tree proposed by Leis et al.
+ * \[[LKN13](index.html#ref-leis-2013)\], synchronized with optimistic lock coupling
+ * \[[LSL16](index.html#ref-leis-2016)\]. Keys are transformed into binary-comparable byte strings;
+ * each inner node consumes one byte of the key and uses one of four layouts (Node4, Node16,
+ * Node48, Node256), depending on the number of children. Node16 uses SSE2 to search its keys
+ * on x86. Like in `olc_btree_map`, every inner node carries a version lock: lookups traverse the
+ * tree without acquiring any locks and only validate the node versions, while update operations
+ * lock only the (at most two) nodes they modify.
+ *
+ * Inner nodes store up to 8 bytes of a compressed path; longer common prefixes are split into
+ * multiple nodes. Elements are stored in immutable leaf nodes, and a leaf is placed as soon as
+ * its key is unique in the subtree (lazy expansion). Nodes that are replaced (e.g., when a node
+ * grows into a larger layout) and removed leaves are retired via the configured reclaimer.
+ * Inner nodes are not shrunk when elements are removed.
+ *
+ * Supported key types are all integral types except `bool`, and `std::string` (without embedded zero bytes).
+ *
+ * Supported policies:
+ *  * `xenium::policy::reclaimer`<br>
+ *    Defines the reclamation scheme to be used for internal nodes. (**required**)
+ *  * `xenium::policy::backoff`<br>
+ *    Defines the backoff strategy that is used when an operation has to be restarted.
+ *    (*optional*; defaults to `xenium::no_backoff`)
+ *
+ * @tparam Key
+ * @tparam Value
+ * @tparam Policies list of policies to customize the behaviour
+ */
+template <class Key, class Value, class... Policies>
+class art_map {
+public:
+  using key_type = Key;
+  using value_type = Value;
+  using reclaimer = parameter::type_param_t<policy::reclaimer, parameter::nil, Policies...>;
+  using backoff = parameter::type_param_t<policy::backoff, no_backoff, Policies...>;
+
+  template <class... NewPolicies>
+  using with = art_map<Key, Value, NewPolicies..., Policies...>;
+
+  static_assert(parameter::is_set<reclaimer>::value, "reclaimer policy must be specified");
+
+  art_map();
+  ~art_map();
+
+  art_map(const art_map&) = delete;
+  art_map& operator=(const art_map&) = delete;
+
+  /**
+   * @brief Inserts a new element into the container if the container doesn't already contain an
+   * element with an equivalent key.
+   *
+   * Progress guarantees: blocking
+   *
+   * @param key the key of the element to insert
+   * @param value the value of the element to insert
+   * @return `true` if an element was inserted, otherwise `false`
+   */
+  bool emplace(const key_type& key, value_type value);
+
+  /**
+   * @brief Removes the element with the key equivalent to key (if one exists).
+   *
+   * Progress guarantees: blocking
+   *
+   * @param key key of the element to remove
+   * @return `true` if an element was removed, otherwise `false`
+   */
+  bool erase(const key_type& key);
+
+  /**
+   * @brief Provides a copy of the value of the element with the key equivalent to key.
+   *
+   * Progress guarantees: blocking (read operations only wait for concurrent writers
+   * of the same nodes)
+   *
+   * @param key key of the element to search for
+   * @param value receives the value if the element is found
+   * @return `true` if an element was found, otherwise `false`
+   */
+  bool try_get_value(const key_type& key, value_type& value) const;
+
+  /**
+   * @brief Checks if there is an element with key equivalent to key in the container.
+   *
+   * Progress guarantees: blocking (read operations only wait for concurrent writers
+   * of the same nodes)
+   *
+   * @param key key of the element to search for
+   * @return `true` if there is such an element, otherwise `false`
+   */
+  bool contains(const key_type& key) const;
+
+private:
+  using traits = detail::art_key_traits<Key>;
+  using encoded_key = typename traits::encoded_key;
+  using version_t = detail::optimistic_lock::version_t;
+
+  static constexpr unsigned max_prefix_length = 8;
+
+  enum class node_type : std::uint8_t { leaf, node4, node16, node48, node256 };
+
+  struct node;
+  struct leaf_node;
+  struct inner_node;
+  struct node4;
+  struct node16;
+  struct node48;
+  struct node256;
+
+  using concurrent_ptr = typename reclaimer::template concurrent_ptr<node, 0>;
+  using guard_ptr = typename concurrent_ptr::guard_ptr;
+
+  enum class result { not_found, found, restart };
+
+  result lookup(const encoded_key& encoded, const key_type& key, value_type* value) const;
+  result try_emplace(const encoded_key& encoded, const key_type& key, value_type& value);
+  result try_erase(const encoded_key& encoded, const key_type& key);
+
+  static std::uint8_t byte_at(const encoded_key& key, std::size_t pos) { return static_cast<std::uint8_t>(key[pos]); }
+  static unsigned check_prefix(const inner_node* n, const encoded_key& key, std::size_t level, unsigned& length);
+  static void set_prefix(inner_node* n, const encoded_key& key, std::size_t pos, unsigned length);
+  static node*
+    create_branch(const encoded_key& key1, node* leaf1, const encoded_key& key2, node* leaf2, std::size_t level);
+
+  static unsigned capacity(const inner_node* n);
+  static unsigned load_count(const inner_node* n);
+  static concurrent_ptr* find_child(const inner_node* n, std::uint8_t byte);
+  static void insert_child(inner_node* n, std::uint8_t byte, node* child);
+  static void remove_child(inner_node* n, std::uint8_t byte);
+  static node* other_child(inner_node* n, std::uint8_t byte);
+  static inner_node* grow(inner_node* n);
+  template <class Func>
+  static void for_each_child(inner_node* n, Func&& func);
+  static void destroy(node* n);
+
+  static std::uint8_t node16_key(const node16* n, unsigned idx);
+  static void set_node16_key(node16* n, unsigned idx, std::uint8_t byte);
+
+  // the root is a Node256 without prefix that is never replaced
+  node256* root;
+};
+
+template <class Key, class Value, class... Policies>
+struct art_map<Key, Value, Policies...>::node : reclaimer::template enable_concurrent_ptr<node> {
+  const node_type type;
+  explicit node(node_type type) : type(type) {}
+};
+
+template <class Key, class Value, class... Policies>
+struct art_map<Key, Value, Policies...>::leaf_node : node {
+  const key_type key;
+  const value_type value;
+  leaf_node(const key_type& key, value_type&& value) : node(node_type::leaf), key(key), value(std::move(value)) {}
+};
+
+template <class Key, class Value, class... Policies>
+struct art_map<Key, Value, Policies...>::inner_node : node {
+  detail::optimistic_lock lock;
+  std::atomic<std::uint16_t> count{0};
+  std::atomic<std::uint8_t> prefix_length{0};
+  std::atomic<std::uint8_t> prefix[max_prefix_length];
+  explicit inner_node(node_type type) : node(type) {
+    for (auto& p : prefix) {
+      p.store(0, std::memory_order_relaxed);
+    }
+  }
+};
+
+template <class Key, class Value, class... Policies>
+struct art_map<Key, Value, Policies...>::node4 : inner_node {
+  // keys are kept sorted
+  std::atomic<std::uint8_t> keys[4];
+  concurrent_ptr children[4];
+  node4() : inner_node(node_type::node4) {
+    for (auto& k : keys) {
+      k.store(0, std::memory_order_relaxed);
+    }
+  }
+};
+
+template <class Key, class Value, class... Policies>
+struct art_map<Key, Value, Policies...>::node16 : inner_node {
+  // The 16 sorted key bytes are packed into two words, so they can be read with two atomic
+  // loads and compared with a single SIMD instruction.
+  std::atomic<std::uint64_t> keys[2];
+  concurrent_ptr children[16];
+  node16() : inner_node(node_type::node16) {
+    keys[0].store(0, std::memory_order_relaxed);
+    keys[1].store(0, std::memory_order_relaxed);
+  }
+};
+
+template <class Key, class Value, class... Policies>
+struct art_map<Key, Value, Policies...>::node48 : inner_node {
+  // child_index[byte] is the index of the child + 1, or zero if there is no such child
+  std::atomic<std::uint8_t> child_index[256];
+  concurrent_ptr children[48];
+  node48() : inner_node(node_type::node48) {
+    for (auto& idx : child_index) {
+      idx.store(0, std::memory_order_relaxed);
+    }
+  }
+};
+
+template <class Key, class Value, class... Policies>
+struct art_map<Key, Value, Policies...>::node256 : inner_node {
+  concurrent_ptr children[256];
+  node256() : inner_node(node_type::node256) {}
+};
+
+template <class Key, class Value, class... Policies>
+art_map<Key, Value, Policies...>::art_map() : root(new node256()) {}
+
+template <class Key, class Value, class... Policies>
+art_map<Key, Value, Policies...>::~art_map() {
+  destroy(root);
+}
+
+template <class Key, class Value, class... Policies>
+void art_map<Key, Value, Policies...>::destroy(node* n) {
+  std::vector<node*> stack{n};
+  while (!stack.empty()) {
+    n = stack.back();
+    stack.pop_back();
+    if (n->type != node_type::leaf) {
+      for_each_child(static_cast<inner_node*>(n), [&stack](std::uint8_t, concurrent_ptr& child) {
+        stack.push_back(child.load(std::memory_order_relaxed).get());
+      });
+    }
+    delete n;
+  }
+}
+
+template <class Key, class Value, class... Policies>
+std::uint8_t art_map<Key, Value, Policies...>::node16_key(const node16* n, unsigned idx) {
+  return static_cast<std::uint8_t>(n->keys[idx / 8].load(std::memory_order_relaxed) >> (8 * (idx % 8)));
+}
+
+template <class Key, class Value, class... Policies>
+void art_map<Key, Value, Policies...>::set_node16_key(node16* n, unsigned idx, std::uint8_t byte) {
+  const unsigned shift = 8 * (idx % 8);
+  auto word = n->keys[idx / 8].load(std::memory_order_relaxed);
+  word = (word & ~(std::uint64_t(0xff) << shift)) | (std::uint64_t(byte) << shift);
+  n->keys[idx / 8].store(word, std::memory_order_relaxed);
+}
+
+template <class Key, class Value, class... Policies>
+unsigned art_map<Key, Value, Policies...>::capacity(const inner_node* n) {
+  switch (n->type) {
+    case node_type::node4:
+      return 4;
+    case node_type::node16:
+      return 16;
+    case node_type::node48:
+      return 48;
+    default:
+      return 256;
+  }
+}
+
+template <class Key, class Value, class... Policies>
+unsigned art_map<Key, Value, Policies...>::load_count(const inner_node* n) {
+  // an optimistic reader may observe an intermediate count, but it must never exceed the capacity
+  return std::min<unsigned>(n->count.load(std::memory_order_relaxed), capacity(n));
+}
+
+template <class Key, class Value, class... Policies>
+auto art_map<Key, Value, Policies...>::find_child(const inner_node* n, std::uint8_t byte) -> concurrent_ptr* {
+  const unsigned count = load_count(n);
+  switch (n->type) {
+    case node_type::node4: {
+      auto* n4 = const_cast<node4*>(static_cast<const node4*>(n));
+      for (unsigned i = 0; i < count; ++i) {
+        if (n4->keys[i].load(std::memory_order_relaxed) == byte) {
+          return &n4->children[i];
+        }
+      }
+      return nullptr;
+    }
+    case node_type::node16: {
+      auto* n16 = const_cast<node16*>(static_cast<const node16*>(n));
+#if defined(XENIUM_ARCH_X86)
+      const __m128i keys = _mm_set_epi64x(static_cast<long long>(n16->keys[1].load(std::memory_order_relaxed)),
+                                          static_cast<long long>(n16->keys[0].load(std::memory_order_relaxed)));
+      const __m128i cmp = _mm_cmpeq_epi8(_mm_set1_epi8(static_cast<char>(byte)), keys);
+      unsigned mask = static_cast<unsigned>(_mm_movemask_epi8(cmp)) & ((1u << count) - 1);
+      if (mask == 0) {
+        return nullptr;
+      }
+      unsigned idx = 0;
+      while ((mask & 1) == 0) {
+        mask >>= 1;
+        ++idx;
+      }
+      return &n16->children[idx];
+#else
+      for (unsigned i = 0; i < count; ++i) {
+        if (node16_key(n16, i) == byte) {
+          return &n16->children[i];
+        }
+      }
+      return nullptr;
+#endif
+    }
+    case node_type::node48: {
+      auto* n48 = const_cast<node48*>(static_cast<const node48*>(n));
+      const unsigned idx = n48->child_index[byte].load(std::memory_order_relaxed);
+      if (idx == 0 || idx > 48) {
+        return nullptr;
+      }
+      return &n48->children[idx - 1];
+    }
+    default: {
+      auto* n256 = const_cast<node256*>(static_cast<const node256*>(n));
+      return &n256->children[byte];
+    }
+  }
+}
+
+template <class Key, class Value, class... Policies>
+template <class Func>
+void art_map<Key, Value, Policies...>::for_each_child(inner_node* n, Func&& func) {
+  const unsigned count = load_count(n);
+  switch (n->type) {
+    case node_type::node4: {
+      auto* n4 = static_cast<node4*>(n);
+      for (unsigned i = 0; i < count; ++i) {
+        func(n4->keys[i].load(std::memory_order_relaxed), n4->children[i]);
+      }
+      break;
+    }
+    case node_type::node16: {
+      auto* n16 = static_cast<node16*>(n);
+      for (unsigned i = 0; i < count; ++i) {
+        func(node16_key(n16, i), n16->children[i]);
+      }
+      break;
+    }
+    case node_type::node48: {
+      auto* n48 = static_cast<node48*>(n);
+      for (unsigned b = 0; b < 256; ++b) {
+        const unsigned idx = n48->child_index[b].load(std::memory_order_relaxed);
+        if (idx != 0) {
+          func(static_cast<std::uint8_t>(b), n48->children[idx - 1]);
+        }
+      }
+      break;
+    }
+    default: {
+      auto* n256 = static_cast<node256*>(n);
+      for (unsigned b = 0; b < 256; ++b) {
+        if (n256->children[b].load(std::memory_order_relaxed).get() != nullptr) {
+          func(static_cast<std::uint8_t>(b), n256->children[b]);
+        }
+      }
+      break;
+    }
+  }
+}
+
+template <class Key, class Value, class... Policies>
+void art_map<Key, Value, Policies...>::insert_child(inner_node* n, std::uint8_t byte, node* child) {
+  const unsigned count = load_count(n);
+  assert(count < capacity(n));
+  switch (n->type) {
+    case node_type::node4: {
+      auto* n4 = static_cast<node4*>(n);
+      unsigned pos = count;
+      for (; pos > 0 && n4->keys[pos - 1].load(std::memory_order_relaxed) > byte; --pos) {
+        n4->keys[pos].store(n4->keys[pos - 1].load(std::memory_order_relaxed), std::memory_order_relaxed);
+        // (1) - this release-store synchronizes-with the acquire-load (7, 9, 12)
+        n4->children[pos].store(n4->children[pos - 1].load(std::memory_order_relaxed), std::memory_order_release);
+      }
+      n4->keys[pos].store(byte, std::memory_order_relaxed);
+      // (2) - this release-store synchronizes-with the acquire-load (7, 9, 12)
+      n4->children[pos].store(child, std::memory_order_release);
+      break;
+    }
+    case node_type::node16: {
+      auto* n16 = static_cast<node16*>(n);
+      unsigned pos = count;
+      for (; pos > 0 && node16_key(n16, pos - 1) > byte; --pos) {
+        set_node16_key(n16, pos, node16_key(n16, pos - 1));
+        // (3) - this release-store synchronizes-with the acquire-load (7, 9, 12)
+        n16->children[pos].store(n16->children[pos - 1].load(std::memory_order_relaxed), std::memory_order_release);
+      }
+      set_node16_key(n16, pos, byte);
+      // (4) - this release-store synchronizes-with the acquire-load (7, 9, 12)
+      n16->children[pos].store(child, std::memory_order_release);
+      break;
+    }
+    case node_type::node48: {
+      auto* n48 = static_cast<node48*>(n);
+      unsigned slot = 0;
+      while (n48->children[slot].load(std::memory_order_relaxed).get() != nullptr) {
+        ++slot;
+      }
+      // (5) - this release-store synchronizes-with the acquire-load (7, 9, 12)
+      n48->children[slot].store(child, std::memory_order_release);
+      n48->child_index[byte].store(static_cast<std::uint8_t>(slot + 1), std::memory_order_relaxed);
+      break;
+    }
+    default:
+      // (6) - this release-store synchronizes-with the acquire-load (7, 9, 12)
+      static_cast<node256*>(n)->children[byte].store(child, std::memory_order_release);
+      break;
+  }
+  n->count.store(static_cast<std::uint16_t>(count + 1), std::memory_order_relaxed);
+}
+
+template <class Key, class Value, class... Policies>
+void art_map<Key, Value, Policies...>::remove_child(inner_node* n, std::uint8_t byte) {
+  const unsigned count = load_count(n);
+  switch (n->type) {
+    case node_type::node4: {
+      auto* n4 = static_cast<node4*>(n);
+      unsigned pos = 0;
+      while (n4->keys[pos].load(std::memory_order_relaxed) != byte) {
+        ++pos;
+      }
+      for (; pos + 1 < count; ++pos) {
+        n4->keys[pos].store(n4->keys[pos + 1].load(std::memory_order_relaxed), std::memory_order_relaxed);
+        n4->children[pos].store(n4->children[pos + 1].load(std::memory_order_relaxed), std::memory_order_release);
+      }
+      n4->children[count - 1].store(nullptr, std::memory_order_relaxed);
+      break;
+    }
+    case node_type::node16: {
+      auto* n16 = static_cast<node16*>(n);
+      unsigned pos = 0;
+      while (node16_key(n16, pos) != byte) {
+        ++pos;
+      }
+      for (; pos + 1 < count; ++pos) {
+        set_node16_key(n16, pos, node16_key(n16, pos + 1));
+        n16->children[pos].store(n16->children[pos + 1].load(std::memory_order_relaxed), std::memory_order_release);
+      }
+      n16->children[count - 1].store(nullptr, std::memory_order_relaxed);
+      break;
+    }
+    case node_type::node48: {
+      auto* n48 = static_cast<node48*>(n);
+      const unsigned idx = n48->child_index[byte].load(std::memory_order_relaxed);
+      assert(idx != 0);
+      n48->child_index[byte].store(0, std::memory_order_relaxed);
+      n48->children[idx - 1].store(nullptr, std::memory_order_relaxed);
+      break;
+    }
+    default:
+      static_cast<node256*>(n)->children[byte].store(nullptr, std::memory_order_relaxed);
+      break;
+  }
+  n->count.store(static_cast<std::uint16_t>(count - 1), std::memory_order_relaxed);
+}
+
+template <class Key, class Value, class... Policies>
+auto art_map<Key, Value, Policies...>::other_child(inner_node* n, std::uint8_t byte) -> node* {
+  node* result = nullptr;
+  for_each_child(n, [&](std::uint8_t b, concurrent_ptr& child) {
+    if (b != byte) {
+      result = child.load(std::memory_order_relaxed).get();
+    }
+  });
+  return result;
+}
+
+template <class Key, class Value, class... Policies>
+auto art_map<Key, Value, Policies...>::grow(inner_node* n) -> inner_node* {
+  inner_node* result;
+  switch (n->type) {
+    case node_type::node4:
+      result = new node16();
+      break;
+    case node_type::node16:
+      result = new node48();
+      break;
+    default:
+      result = new node256();
+      break;
+  }
+  const unsigned length = n->prefix_length.load(std::memory_order_relaxed);
+  for (unsigned i = 0; i < length; ++i) {
+    result->prefix[i].store(n->prefix[i].load(std::memory_order_relaxed), std::memory_order_relaxed);
+  }
+  result->prefix_length.store(static_cast<std::uint8_t>(length), std::memory_order_relaxed);
+  // the children are visited in ascending order, so the sorted layouts stay sorted
+  for_each_child(n, [result](std::uint8_t byte, concurrent_ptr& child) {
+    insert_child(result, byte, child.load(std::memory_order_relaxed).get());
+  });
+  return result;
+}
+
+template <class Key, class Value, class... Policies>
+unsigned art_map<Key, Value, Policies...>::check_prefix(const inner_node* n,
+                                                        const encoded_key& key,
+                                                        std::size_t level,
+                                                        unsigned& length) {
+  length = std::min<unsigned>(n->prefix_length.load(std::memory_order_relaxed), max_prefix_length);
+  for (unsigned i = 0; i < length; ++i) {
+    if (level + i >= key.size() || n->prefix[i].load(std::memory_order_relaxed) != byte_at(key, level + i)) {
+      return i;
+    }
+  }
+  return length;
+}
+
+template <class Key, class Value, class... Policies>
+void art_map<Key, Value, Policies...>::set_prefix(inner_node* n,
+                                                  const encoded_key& key,
+                                                  std::size_t pos,
+                                                  unsigned length) {
+  assert(length <= max_prefix_length);
+  for (unsigned i = 0; i < length; ++i) {
+    n->prefix[i].store(byte_at(key, pos + i), std::memory_order_relaxed);
+  }
+  n->prefix_length.store(static_cast<std::uint8_t>(length), std::memory_order_relaxed);
+}
+
+template <class Key, class Value, class... Policies>
+auto art_map<Key, Value, Policies...>::create_branch(const encoded_key& key1,
+                                                     node* leaf1,
+                                                     const encoded_key& key2,
+                                                     node* leaf2,
+                                                     std::size_t level) -> node* {
+  // Creates the subtree that replaces leaf2 at the given level. The keys differ at some
+  // position, since the encoding is prefix free.
+  std::size_t common = 0;
+  while (byte_at(key1, level + common) == byte_at(key2, level + common)) {
+    ++common;
+  }
+
+  auto* bottom = new node4();
+  insert_child(bottom, byte_at(key1, level + common), leaf1);
+  insert_child(bottom, byte_at(key2, level + common), leaf2);
+  auto length = static_cast<unsigned>(std::min<std::size_t>(common, max_prefix_length));
+  set_prefix(bottom, key1, level + common - length, length);
+
+  // common prefixes that do not fit into a single node are split into a chain of nodes
+  std::size_t remaining = common - length;
+  inner_node* top = bottom;
+  while (remaining > 0) {
+    auto* n = new node4();
+    insert_child(n, byte_at(key1, level + remaining - 1), top);
+    --remaining;
+    length = static_cast<unsigned>(std::min<std::size_t>(remaining, max_prefix_length));
+    remaining -= length;
+    set_prefix(n, key1, level + remaining, length);
+    top = n;
+  }
+  return top;
+}
+
+template <class Key, class Value, class... Policies>
+auto art_map<Key, Value, Policies...>::lookup(const encoded_key& encoded, const key_type& key, value_type* value) const
+  -> result {
+  guard_ptr cur(root);
+  version_t version;
+  root->lock.read_lock(version);
+  std::size_t level = 0;
+  guard_ptr child;
+  for (;;) {
+    auto* n = static_cast<inner_node*>(cur.get());
+    unsigned length;
+    if (check_prefix(n, encoded, level, length) != length || level + length >= encoded.size()) {
+      return n->lock.validate(version) ? result::not_found : result::restart;
+    }
+    level += length;
+
+    auto* slot = find_child(n, byte_at(encoded, level));
+    if (slot != nullptr) {
+      // (7) - this acquire-load synchronizes-with the release-store (1, 2, 3, 4, 5, 6, 8, 10, 11, 13)
+      child.acquire(*slot, std::memory_order_acquire);
+    } else {
+      child.reset();
+    }
+    if (!n->lock.validate(version)) {
+      return result::restart;
+    }
+    if (!child) {
+      return result::not_found;
+    }
+
+    if (child->type == node_type::leaf) {
+      // leaf nodes are immutable
+      auto* leaf = static_cast<leaf_node*>(child.get());
+      if (!(leaf->key == key)) {
+        return result::not_found;
+      }
+      if (value) {
+        *value = leaf->value;
+      }
+      return result::found;
+    }
+
+    version_t child_version;
+    if (!static_cast<inner_node*>(child.get())->lock.read_lock(child_version) || !n->lock.validate(version)) {
+      return result::restart;
+    }
+    cur = std::move(child);
+    version = child_version;
+    ++level;
+  }
+}
+
+template <class Key, class Value, class... Policies>
+bool art_map<Key, Value, Policies...>::try_get_value(const key_type& key, value_type& value) const {
+  const auto encoded = traits::encode(key);
+  backoff backoff;
+  for (;;) {
+    auto res = lookup(encoded, key, &value);
+    if (res != result::restart) {
+      return res == result::found;
+    }
+    backoff();
+  }
+}
+
+template <class Key, class Value, class... Policies>
+bool art_map<Key, Value, Policies...>::contains(const key_type& key) const {
+  const auto encoded = traits::encode(key);
+  backoff backoff;
+  for (;;) {
+    auto res = lookup(encoded, key, nullptr);
+    if (res != result::restart) {
+      return res == result::found;
+    }
+    backoff();
+  }
+}
+
+template <class Key, class Value, class... Policies>
+bool art_map<Key, Value, Policies...>::emplace(const key_type& key, value_type value) {
+  const auto encoded = traits::encode(key);
+  backoff backoff;
+  for (;;) {
+    auto res = try_emplace(encoded, key, value);
+    if (res != result::restart) {
+      return res == result::not_found;
+    }
+    backoff();
+  }
+}
+
+template <class Key, class Value, class... Policies>
+auto art_map<Key, Value, Policies...>::try_emplace(const encoded_key& encoded, const key_type& key, value_type& value)
+  -> result {
+  guard_ptr parent;
+  version_t parent_version = 0;
+  std::uint8_t parent_byte = 0;
+  guard_ptr cur(root);
+  version_t version;
+  root->lock.read_lock(version);
+  std::size_t level = 0;
+  guard_ptr child;
+  for (;;) {
+    auto* n = static_cast<inner_node*>(cur.get());
+    unsigned length;
+    const unsigned matching = check_prefix(n, encoded, level, length);
+    if (matching != length) {
+      // The key diverges from the compressed path -> insert a new Node4 between the parent and
+      // this node. The root has no prefix, so we always have a parent here.
+      auto* p = static_cast<inner_node*>(parent.get());
+      if (!p->lock.try_upgrade(parent_version)) {
+        return result::restart;
+      }
+      if (!n->lock.try_upgrade(version)) {
+        p->lock.write_unlock();
+        return result::restart;
+      }
+      std::uint8_t old_prefix[max_prefix_length];
+      for (unsigned i = 0; i < length; ++i) {
+        old_prefix[i] = n->prefix[i].load(std::memory_order_relaxed);
+      }
+      auto* new_node = new node4();
+      set_prefix(new_node, encoded, level, matching);
+      insert_child(new_node, byte_at(encoded, level + matching), new leaf_node(key, std::move(value)));
+      insert_child(new_node, old_prefix[matching], n);
+      // (8) - this release-store synchronizes-with the acquire-load (7, 9, 12)
+      find_child(p, parent_byte)->store(new_node, std::memory_order_release);
+      p->lock.write_unlock();
+
+      for (unsigned i = matching + 1; i < length; ++i) {
+        n->prefix[i - matching - 1].store(old_prefix[i], std::memory_order_relaxed);
+      }
+      n->prefix_length.store(static_cast<std::uint8_t>(length - matching - 1), std::memory_order_relaxed);
+      n->lock.write_unlock();
+      return result::not_found;
+    }
+    level += length;
+    if (level >= encoded.size()) {
+      return result::restart;
+    }
+
+    const std::uint8_t byte = byte_at(encoded, level);
+    auto* slot = find_child(n, byte);
+    if (slot != nullptr) {
+      // (9) - this acquire-load synchronizes-with the release-store (1, 2, 3, 4, 5, 6, 8, 10, 11, 13)
+      child.acquire(*slot, std::memory_order_acquire);
+    } else {
+      child.reset();
+    }
+    if (!n->lock.validate(version)) {
+      return result::restart;
+    }
+
+    if (!child) {
+      if (load_count(n) < capacity(n)) {
+        if (!n->lock.try_upgrade(version)) {
+          return result::restart;
+        }
+        if (parent && !static_cast<inner_node*>(parent.get())->lock.validate(parent_version)) {
+          n->lock.write_unlock();
+          return result::restart;
+        }
+        insert_child(n, byte, new leaf_node(key, std::move(value)));
+        n->lock.write_unlock();
+        return result::not_found;
+      }
+
+      // the node is full -> replace it with a larger one
+      auto* p = static_cast<inner_node*>(parent.get());
+      if (!p->lock.try_upgrade(parent_version)) {
+        return result::restart;
+      }
+      if (!n->lock.try_upgrade(version)) {
+        p->lock.write_unlock();
+        return result::restart;
+      }
+      auto* larger = grow(n);
+      insert_child(larger, byte, new leaf_node(key, std::move(value)));
+      // (10) - this release-store synchronizes-with the acquire-load (7, 9, 12)
+      find_child(p, parent_byte)->store(larger, std::memory_order_release);
+      n->lock.write_unlock_obsolete();
+      p->lock.write_unlock();
+      cur.reclaim();
+      return result::not_found;
+    }
+
+    if (parent && !static_cast<inner_node*>(parent.get())->lock.validate(parent_version)) {
+      return result::restart;
+    }
+
+    if (child->type == node_type::leaf) {
+      auto* leaf = static_cast<leaf_node*>(child.get());
+      if (leaf->key == key) {
+        return n->lock.validate(version) ? result::found : result::restart;
+      }
+      // lazy expansion -> replace the leaf with a subtree that contains both leafs
+      if (!n->lock.try_upgrade(version)) {
+        return result::restart;
+      }
+      auto* branch =
+        create_branch(encoded, new leaf_node(key, std::move(value)), traits::encode(leaf->key), leaf, level + 1);
+      // (11) - this release-store synchronizes-with the acquire-load (7, 9, 12)
+      slot->store(branch, std::memory_order_release);
+      n->lock.write_unlock();
+      return result::not_found;
+    }
+
+    version_t child_version;
+    if (!static_cast<inner_node*>(child.get())->lock.read_lock(child_version)) {
+      return result::restart;
+    }
+    parent = std::move(cur);
+    parent_version = version;
+    parent_byte = byte;
+    cur = std::move(child);
+    version = child_version;
+    ++level;
+  }
+}
+
+template <class Key, class Value, class... Policies>
+bool art_map<Key, Value, Policies...>::erase(const key_type& key) {
+  const auto encoded = traits::encode(key);
+  backoff backoff;
+  for (;;) {
+    auto res = try_erase(encoded, key);
+    if (res != result::restart) {
+      return res == result::found;
+    }
+    backoff();
+  }
+}
+
+template <class Key, class Value, class... Policies>
+auto art_map<Key, Value, Policies...>::try_erase(const encoded_key& encoded, const key_type& key) -> result {
+  guard_ptr parent;
+  version_t parent_version = 0;
+  std::uint8_t parent_byte = 0;
+  guard_ptr cur(root);
+  version_t version;
+  root->lock.read_lock(version);
+  std::size_t level = 0;
+  guard_ptr child;
+  for (;;) {
+    auto* n = static_cast<inner_node*>(cur.get());
+    unsigned length;
+    if (check_prefix(n, encoded, level, length) != length || level + length >= encoded.size()) {
+      return n->lock.validate(version) ? result::not_found : result::restart;
+    }
+    level += length;
+
+    const std::uint8_t byte = byte_at(encoded, level);
+    auto* slot = find_child(n, byte);
+    if (slot != nullptr) {
+      // (12) - this acquire-load synchronizes-with the release-store (1, 2, 3, 4, 5, 6, 8, 10, 11, 13)
+      child.acquire(*slot, std::memory_order_acquire);
+    } else {
+      child.reset();
+    }
+    if (!n->lock.validate(version)) {
+      return result::restart;
+    }
+    if (!child) {
+      return result::not_found;
+    }
+
+    if (child->type == node_type::leaf) {
+      if (!(static_cast<leaf_node*>(child.get())->key == key)) {
+        return n->lock.validate(version) ? result::not_found : result::restart;
+      }
+
+      const unsigned count = load_count(n);
+      if (parent && count <= 2) {
+        // The node may become obsolete, so we have to lock the parent as well.
+        auto* p = static_cast<inner_node*>(parent.get());
+        if (!p->lock.try_upgrade(parent_version)) {
+          return result::restart;
+        }
+        if (!n->lock.try_upgrade(version)) {
+          p->lock.write_unlock();
+          return result::restart;
+        }
+        // the children of a locked node cannot be removed, so it is safe to inspect the sibling
+        node* remaining = (count == 2) ? other_child(n, byte) : nullptr;
+        if (count == 1 || remaining->type == node_type::leaf) {
+          // remove the whole node from the parent, or replace it with its remaining leaf
+          if (remaining != nullptr) {
+            // (13) - this release-store synchronizes-with the acquire-load (7, 9, 12)
+            find_child(p, parent_byte)->store(remaining, std::memory_order_release);
+          } else {
+            remove_child(p, parent_byte);
+          }
+          n->lock.write_unlock_obsolete();
+          p->lock.write_unlock();
+          cur.reclaim();
+        } else {
+          remove_child(n, byte);
+          n->lock.write_unlock();
+          p->lock.write_unlock();
+        }
+      } else {
+        if (!n->lock.try_upgrade(version)) {
+          return result::restart;
+        }
+        remove_child(n, byte);
+        n->lock.write_unlock();
+      }
+      child.reclaim();
+      return result::found;
+    }
+
+    version_t child_version;
+    if (!static_cast<inner_node*>(child.get())->lock.read_lock(child_version) || !n->lock.validate(version)) {
+      return result::restart;
+    }
+    parent = std::move(cur);
+    parent_version = version;
+    parent_byte = byte;
+    cur = std::move(child);
+    version = child_version;
+    ++level;
+  }
+}
+} // namespace xenium
+
+#endif
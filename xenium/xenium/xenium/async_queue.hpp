@@ -0,0 +1,429 @@
+//
+// Copyright (c) 2018-2020 Manuel Pöter.
+// Licensed under the MIT License. See LICENSE file in the project root for full license information.
+//
+
+#ifndef XENIUM_ASYNC_QUEUE_HPP
+#define XENIUM_ASYNC_QUEUE_HPP
+
+#if !defined(__cpp_impl_coroutine) || !__has_include(<coroutine>)
+  #error "async_queue requires C++20 coroutine support"
+#endif
+
+#include <xenium/detail/queue_traits.hpp>
+
+#include <atomic>
+#include <cassert>
+#include <coroutine>
+#include <utility>
+
+namespace xenium {
+
+namespace detail {
+  /**
+   * @brief Base class of all awaiters that can be registered in an `async_waiter_list`.
+   */
+  struct async_awaiter {
+    async_awaiter() = default;
+    async_awaiter(const async_awaiter&) = delete;
+    async_awaiter& operator=(const async_awaiter&) = delete;
+
+    /**
+     * @brief Tries to perform the awaited operation.
+     * @return `true` if the operation was successful, otherwise `false`
+     */
+    virtual bool try_complete() = 0;
+
+    std::coroutine_handle<> handle;
+    async_awaiter* next_ready = nullptr;
+
+  protected:
+    ~async_awaiter() = default;
+  };
+
+  /**
+   * @brief A lock-free list of suspended awaiters.
+   *
+   * Awaiters are not stored in the list directly, but via heap allocated, reference counted
+   * records. A record is referenced by the list and by the awaiter that registered it, so
+   * it remains valid even if the awaiting coroutine is resumed (and its frame destroyed)
+   * before a notifier has processed the record. Notifiers detach the whole list with a
+   * single exchange, so records are never removed from the middle of the list and the
+   * list does not suffer from the ABA problem.
+   *
+   * The state of each record determines who is responsible for resuming the awaiter:
+   *  * `waiting` - the awaiter has registered the record and is checking its operation again;
+   *  * `suspended` - the awaiter is suspended; the notifier that processes the record
+   *    takes over the awaiter and resumes it once its operation has been completed;
+   *  * `notified` - a notifier has processed the record while it was still `waiting`;
+   *    the awaiter has to check its operation again;
+   *  * `cancelled` - the awaiter has completed its operation while the record was
+   *    still `waiting`.
+   *
+   * Completed awaiters are not resumed while the list is processed, but collected in a
+   * thread-local ready list. Only the outermost `notify_all` call of a thread resumes them,
+   * so a resumed coroutine that notifies other waiters does not resume them recursively and
+   * the stack depth remains bounded.
+   *
+   * The list must not be destroyed while awaiters are suspended, since these would never
+   * be resumed.
+   */
+  class async_waiter_list {
+  public:
+    async_waiter_list() = default;
+    async_waiter_list(const async_waiter_list&) = delete;
+    async_waiter_list& operator=(const async_waiter_list&) = delete;
+
+    ~async_waiter_list() {
+      auto* r = _head.load(std::memory_order_relaxed);
+      while (r != nullptr) {
+        auto* next = r->next;
+        assert(r->state.load(std::memory_order_relaxed) != suspended &&
+               "async_waiter_list must not be destroyed while awaiters are suspended");
+        r->release();
+        r = next;
+      }
+    }
+
+    /**
+     * @brief Registers the awaiter and checks its operation again.
+     *
+     * @return `true` if the awaiter has been suspended and will be resumed by some
+     * notifier, `false` if the operation has been completed.
+     */
+    bool suspend(async_awaiter& awaiter);
+
+    /**
+     * @brief Resumes all registered awaiters whose operation can be completed, and
+     * registers the remaining ones again.
+     *
+     * Awaiters are resumed on the calling thread after all registered awaiters have been
+     * processed. If this is called (indirectly) by a coroutine that is resumed by another
+     * `notify_all` call on the same thread, the awaiters are resumed by that outer call.
+     */
+    void notify_all();
+
+  private:
+    enum state : unsigned { waiting, suspended, notified, cancelled };
+
+    struct ready_list {
+      void push(async_awaiter& awaiter) noexcept {
+        awaiter.next_ready = nullptr;
+        if (tail == nullptr) {
+          head = &awaiter;
+        } else {
+          tail->next_ready = &awaiter;
+        }
+        tail = &awaiter;
+      }
+
+      async_awaiter* pop() noexcept {
+        auto* result = head;
+        if (result != nullptr) {
+          head = result->next_ready;
+          if (head == nullptr) {
+            tail = nullptr;
+          }
+        }
+        return result;
+      }
+
+      async_awaiter* head = nullptr;
+      async_awaiter* tail = nullptr;
+      bool resuming = false;
+    };
+
+    static ready_list& ready_awaiters() noexcept {
+      static thread_local ready_list list;
+      return list;
+    }
+
+    struct record {
+      explicit record(async_awaiter& awaiter) : awaiter(awaiter) {}
+
+      void release() noexcept {
+        if (refs.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+          delete this;
+        }
+      }
+
+      async_awaiter& awaiter;
+      record* next = nullptr;
+      std::atomic<unsigned> state{waiting};
+      std::atomic<unsigned> refs{2};
+    };
+
+    std::atomic<record*> _head{nullptr};
+  };
+
+  inline bool async_waiter_list::suspend(async_awaiter& awaiter) {
+    for (;;) {
+      auto* r = new record(awaiter);
+      r->next = _head.load(std::memory_order_relaxed);
+      // (1) - this release-CAS synchronizes-with the acquire-exchange (4)
+      while (!_head.compare_exchange_weak(r->next, r, std::memory_order_release, std::memory_order_relaxed)) {
+      }
+
+      // (2) - this seq_cst-fence enforces a total order with the seq_cst-fence (3), so
+      //       either the awaiter observes the notifier's update of the queue, or the
+      //       notifier observes the registered record.
+      std::atomic_thread_fence(std::memory_order_seq_cst);
+      if (awaiter.try_complete()) {
+        // we are done - it does not matter whether the record has already been notified
+        unsigned expected = waiting;
+        r->state.compare_exchange_strong(expected, cancelled, std::memory_order_relaxed);
+        r->release();
+        return false;
+      }
+
+      unsigned expected = waiting;
+      // (5) - this release-CAS synchronizes-with the acquire-CAS (6)
+      if (r->state.compare_exchange_strong(expected, suspended, std::memory_order_release, std::memory_order_relaxed)) {
+        // from now on the awaiter belongs to the notifier that processes the record,
+        // so we must not touch it anymore.
+        r->release();
+        return true;
+      }
+
+      // the record has been notified while we were checking the operation - try again
+      assert(expected == notified);
+      r->release();
+    }
+  }
+
+  inline void async_waiter_list::notify_all() {
+    // (3) - this seq_cst-fence enforces a total order with the seq_cst-fence (2)
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    if (_head.load(std::memory_order_relaxed) == nullptr) {
+      return;
+    }
+
+    auto& ready = ready_awaiters();
+    // (4) - this acquire-exchange synchronizes-with the release-CAS (1)
+    auto* r = _head.exchange(nullptr, std::memory_order_acquire);
+    while (r != nullptr) {
+      auto* next = r->next;
+      unsigned expected = waiting;
+      if (!r->state.compare_exchange_strong(expected, notified, std::memory_order_relaxed)) {
+        // (6) - this acquire-CAS synchronizes-with the release-CAS (5)
+        if (expected == suspended &&
+            r->state.compare_exchange_strong(expected, notified, std::memory_order_acquire)) {
+          // we have taken over the suspended awaiter
+          auto& awaiter = r->awaiter;
+          if (!suspend(awaiter)) {
+            ready.push(awaiter);
+          }
+        }
+      }
+      r->release();
+      r = next;
+    }
+
+    if (ready.resuming) {
+      // we are called by a coroutine that has been resumed further up the call stack
+      return;
+    }
+
+    struct resuming_guard {
+      explicit resuming_guard(ready_list& ready) noexcept : ready(ready) { ready.resuming = true; }
+      ~resuming_guard() { ready.resuming = false; }
+      ready_list& ready;
+    } guard(ready);
+    while (auto* awaiter = ready.pop()) {
+      awaiter->handle.resume();
+    }
+  }
+} // namespace detail
+
+template <class Queue>
+class async_queue;
+
+/**
+ * @brief Returns an awaitable that pops an element from the given queue.
+ *
+ * `co_await async_pop(queue)` suspends the calling coroutine while the queue is empty
+ * and returns the popped element.
+ */
+template <class Queue>
+auto async_pop(async_queue<Queue>& queue);
+
+/**
+ * @brief Returns an awaitable that pushes the given value to the given queue.
+ *
+ * `co_await async_push(queue, value)` suspends the calling coroutine while the (bounded)
+ * queue is full. For unbounded queues it always completes immediately.
+ */
+template <class Queue>
+auto async_push(async_queue<Queue>& queue, typename Queue::value_type value);
+
+/**
+ * @brief An adapter that allows coroutines to await `pop` and `push` operations on a
+ * non-blocking queue.
+ *
+ * A coroutine that awaits `async_pop` on an empty queue (or `async_push` on a full
+ * bounded queue) is registered in a lock-free waiter list and suspended. It is resumed
+ * by the thread that performs the next successful `try_push` (or `try_pop`, respectively)
+ * on this adapter; there is no dedicated thread involved. Before a suspended coroutine is
+ * resumed, the notifying thread completes the awaited operation on its behalf, so the
+ * coroutine is only resumed once it actually has an element (or has pushed its value).
+ * Note that coroutines are resumed inline, i.e., `try_push`/`try_pop` only return once
+ * all resumed coroutines have reached their next suspension point. If a resumed coroutine
+ * itself resumes other coroutines, these are resumed after it has been suspended again,
+ * so chains of coroutines that resume each other do not grow the stack.
+ *
+ * The adapter must not be destroyed while coroutines are suspended on it.
+ *
+ * The adapter can be used with any queue that provides `try_pop(value_type&)` and either
+ * `push(value_type)` (unbounded queues like `michael_scott_queue` or `ramalhete_queue`) or
+ * `try_push(value_type)` (bounded queues like `vyukov_bounded_queue`). As in
+ * `blocking_queue`, a failed `try_push` of the underlying queue must leave its argument
+ * untouched, so queues that take the argument of `try_push` by value are only supported
+ * for trivially copyable value types. `async_pop` requires `value_type` to be default
+ * constructible.
+ *
+ * Notifications are cheap if no coroutine is waiting (a fence and a load). However, if
+ * coroutines are waiting, a notification processes all of them, since any of them might
+ * be able to complete its operation; the ones that cannot are registered again.
+ *
+ * This adapter is only available if the compiler supports C++20 coroutines.
+ *
+ * @tparam Queue the underlying queue type.
+ */
+template <class Queue>
+class async_queue {
+public:
+  using queue_type = Queue;
+  using value_type = typename Queue::value_type;
+
+  static constexpr bool is_bounded = !detail::is_unbounded_queue<Queue>::value;
+
+  static_assert(!is_bounded || detail::is_try_push_retryable<Queue>,
+                "async_queue requires a trivially copyable value_type if the queue's try_push "
+                "takes its argument by value");
+
+  /**
+   * @brief Constructs the underlying queue with the given arguments.
+   */
+  template <class... Args>
+  explicit async_queue(Args&&... args) : _queue(std::forward<Args>(args)...) {}
+
+  async_queue(const async_queue&) = delete;
+  async_queue(async_queue&&) = delete;
+
+  async_queue& operator=(const async_queue&) = delete;
+  async_queue& operator=(async_queue&&) = delete;
+
+  /**
+   * @brief Tries to push the given value to the queue and resumes waiting consumers.
+   *
+   * For unbounded queues this operation always succeeds.
+   *
+   * @param value
+   * @return `true` if the operation was successful, otherwise `false`
+   */
+  bool try_push(value_type value) { return do_try_push(value); }
+
+  /**
+   * @brief Tries to pop an element from the queue and resumes waiting producers.
+   * @param result the popped element if the operation was successful
+   * @return `true` if the operation was successful, otherwise `false`
+   */
+  [[nodiscard]] bool try_pop(value_type& result);
+
+  /**
+   * @brief Provides access to the underlying queue.
+   *
+   * Operations on the underlying queue do not resume any waiting coroutines.
+   */
+  queue_type& underlying_queue() noexcept { return _queue; }
+
+private:
+  class pop_awaitable;
+  class push_awaitable;
+
+  template <class Q>
+  friend auto async_pop(async_queue<Q>& queue);
+  template <class Q>
+  friend auto async_push(async_queue<Q>& queue, typename Q::value_type value);
+
+  bool do_try_push(value_type& value);
+
+  queue_type _queue;
+  detail::async_waiter_list _pop_waiters;
+  detail::async_waiter_list _push_waiters;
+};
+
+template <class Queue>
+class async_queue<Queue>::pop_awaitable final : detail::async_awaiter {
+public:
+  explicit pop_awaitable(async_queue& queue) : _queue(queue) {}
+
+  bool await_ready() { return _queue.try_pop(_result); }
+  bool await_suspend(std::coroutine_handle<> h) {
+    handle = h;
+    return _queue._pop_waiters.suspend(*this);
+  }
+  value_type await_resume() { return std::move(_result); }
+
+private:
+  bool try_complete() override { return _queue.try_pop(_result); }
+
+  async_queue& _queue;
+  value_type _result{};
+};
+
+template <class Queue>
+class async_queue<Queue>::push_awaitable final : detail::async_awaiter {
+public:
+  push_awaitable(async_queue& queue, value_type&& value) : _queue(queue), _value(std::move(value)) {}
+
+  bool await_ready() { return _queue.do_try_push(_value); }
+  bool await_suspend(std::coroutine_handle<> h) {
+    handle = h;
+    return _queue._push_waiters.suspend(*this);
+  }
+  void await_resume() noexcept {}
+
+private:
+  bool try_complete() override { return _queue.do_try_push(_value); }
+
+  async_queue& _queue;
+  value_type _value;
+};
+
+template <class Queue>
+bool async_queue<Queue>::do_try_push(value_type& value) {
+  if constexpr (is_bounded) {
+    if (!_queue.try_push(std::move(value))) {
+      return false;
+    }
+  } else {
+    _queue.push(std::move(value));
+  }
+  _pop_waiters.notify_all();
+  return true;
+}
+
+template <class Queue>
+bool async_queue<Queue>::try_pop(value_type& result) {
+  if (!_queue.try_pop(result)) {
+    return false;
+  }
+  if constexpr (is_bounded) {
+    _push_waiters.notify_all();
+  }
+  return true;
+}
+
+template <class Queue>
+auto async_pop(async_queue<Queue>& queue) {
+  return typename async_queue<Queue>::pop_awaitable(queue);
+}
+
+template <class Queue>
+auto async_push(async_queue<Queue>& queue, typename Queue::value_type value) {
+  return typename async_queue<Queue>::push_awaitable(queue, std::move(value));
+}
+} // namespace xenium
+
+#endif
@@ -0,0 +1,209 @@
+//
+// Copyright (c) 2018-2020 Manuel Pöter.
+// Licensed under the MIT License. See LICENSE file in the project root for full license information.
+//
+
+#ifndef XENIUM_BLOCKING_QUEUE_HPP
+#define XENIUM_BLOCKING_QUEUE_HPP
+
+#include <xenium/detail/eventcount.hpp>
+#include <xenium/detail/queue_traits.hpp>
+
+#include <chrono>
+#include <utility>
+
+namespace xenium {
+
+/**
+ * @brief An adapter that adds blocking operations to a non-blocking queue.
+ *
+ * Consumers that find the queue empty block in `pop`/`pop_for` until some producer has
+ * pushed a new element. For bounded queues (i.e., queues that only provide `try_push`),
+ * producers that find the queue full block in `push` until some consumer has popped an
+ * element.
+ *
+ * Waiting is implemented with an eventcount (a futex on Linux). The fast path of all
+ * operations is the underlying non-blocking operation, and notifications only perform
+ * a system call if some thread is actually waiting.
+ *
+ * The adapter can be used with any queue that provides `try_pop(value_type&)` and either
+ * `push(value_type)` (unbounded queues like `ramalhete_queue`, `nikolaev_queue` or
+ * `michael_scott_queue`) or `try_push(value_type)` (bounded queues like
+ * `vyukov_bounded_queue`, `nikolaev_bounded_queue` or `kirsch_bounded_kfifo_queue`).
+ * For bounded queues, a blocking `push` retries `try_push` with the same value, so the
+ * queue's `try_push` must leave its argument untouched if it fails. This holds for
+ * `vyukov_bounded_queue`, which takes its argument by reference. Queues that take the
+ * argument of `try_push` by value (e.g., `nikolaev_bounded_queue` or
+ * `kirsch_bounded_kfifo_queue`) are only supported for trivially copyable value types.
+ *
+ * Operations on queues that use a reclaimer should not block while the calling thread
+ * holds a `region_guard`, since this would prevent the reclamation of retired nodes.
+ *
+ * @tparam Queue the underlying queue type.
+ */
+template <class Queue>
+class blocking_queue {
+public:
+  using queue_type = Queue;
+  using value_type = typename Queue::value_type;
+
+  static constexpr bool is_bounded = !detail::is_unbounded_queue<Queue>::value;
+
+  static_assert(!is_bounded || detail::is_try_push_retryable<Queue>,
+                "blocking_queue requires a trivially copyable value_type if the queue's try_push "
+                "takes its argument by value");
+
+  /**
+   * @brief Constructs the underlying queue with the given arguments.
+   */
+  template <class... Args>
+  explicit blocking_queue(Args&&... args) : _queue(std::forward<Args>(args)...) {}
+
+  blocking_queue(const blocking_queue&) = delete;
+  blocking_queue(blocking_queue&&) = delete;
+
+  blocking_queue& operator=(const blocking_queue&) = delete;
+  blocking_queue& operator=(blocking_queue&&) = delete;
+
+  /**
+   * @brief Pushes the given value to the queue.
+   *
+   * If the underlying queue is bounded and full, the calling thread blocks until the
+   * value could be pushed. Wakes up one blocked consumer (if any).
+   *
+   * @param value
+   */
+  void push(value_type value);
+
+  /**
+   * @brief Tries to push the given value to the queue without blocking.
+   *
+   * Wakes up one blocked consumer (if any) if the operation was successful.
+   *
+   * @param value
+   * @return `true` if the operation was successful, otherwise `false`
+   */
+  bool try_push(value_type value);
+
+  /**
+   * @brief Pops an element from the queue; blocks while the queue is empty.
+   *
+   * Requires `value_type` to be default constructible.
+   *
+   * @return the popped element
+   */
+  value_type pop();
+
+  /**
+   * @brief Tries to pop an element from the queue; blocks for at most `timeout`
+   * while the queue is empty.
+   *
+   * @param result the popped element if the operation was successful
+   * @param timeout
+   * @return `true` if the operation was successful, `false` if the timeout has expired
+   */
+  template <class Rep, class Period>
+  [[nodiscard]] bool pop_for(value_type& result, const std::chrono::duration<Rep, Period>& timeout);
+
+  /**
+   * @brief Tries to pop an element from the queue without blocking.
+   *
+   * Wakes up one blocked producer (if any) if the operation was successful.
+   *
+   * @param result the popped element if the operation was successful
+   * @return `true` if the operation was successful, otherwise `false`
+   */
+  [[nodiscard]] bool try_pop(value_type& result);
+
+  /**
+   * @brief Provides access to the underlying queue.
+   *
+   * Operations on the underlying queue do not notify any blocked threads.
+   */
+  queue_type& underlying_queue() noexcept { return _queue; }
+
+private:
+  bool do_try_push(value_type& value);
+
+  queue_type _queue;
+  detail::eventcount _not_empty;
+  detail::eventcount _not_full;
+};
+
+template <class Queue>
+bool blocking_queue<Queue>::do_try_push(value_type& value) {
+  if constexpr (is_bounded) {
+    return _queue.try_push(std::move(value));
+  } else {
+    _queue.push(std::move(value));
+    return true;
+  }
+}
+
+template <class Queue>
+void blocking_queue<Queue>::push(value_type value) {
+  while (!do_try_push(value)) {
+    auto key = _not_full.prepare_wait();
+    if (do_try_push(value)) {
+      _not_full.cancel_wait();
+      break;
+    }
+    _not_full.wait(key);
+  }
+  _not_empty.notify_one();
+}
+
+template <class Queue>
+bool blocking_queue<Queue>::try_push(value_type value) {
+  if (!do_try_push(value)) {
+    return false;
+  }
+  _not_empty.notify_one();
+  return true;
+}
+
+template <class Queue>
+bool blocking_queue<Queue>::try_pop(value_type& result) {
+  if (!_queue.try_pop(result)) {
+    return false;
+  }
+  if constexpr (is_bounded) {
+    _not_full.notify_one();
+  }
+  return true;
+}
+
+template <class Queue>
+auto blocking_queue<Queue>::pop() -> value_type {
+  value_type result{};
+  while (!try_pop(result)) {
+    auto key = _not_empty.prepare_wait();
+    if (try_pop(result)) {
+      _not_empty.cancel_wait();
+      break;
+    }
+    _not_empty.wait(key);
+  }
+  return result;
+}
+
+template <class Queue>
+template <class Rep, class Period>
+bool blocking_queue<Queue>::pop_for(value_type& result, const std::chrono::duration<Rep, Period>& timeout) {
+  const auto deadline = std::chrono::steady_clock::now() + timeout;
+  while (!try_pop(result)) {
+    auto key = _not_empty.prepare_wait();
+    if (try_pop(result)) {
+      _not_empty.cancel_wait();
+      break;
+    }
+    if (!_not_empty.wait_for(key, deadline - std::chrono::steady_clock::now())) {
+      // the timeout has expired, but an element might have been pushed in the meantime
+      return try_pop(result);
+    }
+  }
+  return true;
+}
+} // namespace xenium
+
+#endif
@@ -0,0 +1,660 @@
+//
+// Copyright (c) 2018-2020 Manuel Pöter.
+// Licensed under the MIT License. See LICENSE file in the project root for full license information.
+//
+
+#ifndef XENIUM_CUCKOO_HASH_MAP_HPP
+#define XENIUM_CUCKOO_HASH_MAP_HPP
+
+#include <xenium/acquire_guard.hpp>
+#include <xenium/backoff.hpp>
+#include <xenium/detail/optimistic_lock.hpp>
+#include <xenium/detail/port.hpp>
+#include <xenium/hash.hpp>
+#include <xenium/parameter.hpp>
+#include <xenium/policy.hpp>
+#include <xenium/utils.hpp>
+
+#include <array>
+#include <atomic>
+#include <cassert>
+#include <cstdint>
+#include <memory>
+#include <type_traits>
+
+namespace xenium {
+
+namespace policy {
+  /**
+   * @brief Policy to configure the number of slots per bucket in `cuckoo_hash_map`.
+   * @tparam Value
+   */
+  template <unsigned Value>
+  struct slots_per_bucket;
+} // namespace policy
+
+/**
+ * @brief A concurrent cuckoo hash-map with optimistic reads.
+ *
+ * This hash-map follows the design of libcuckoo \[[LAK14](index.html#ref-li-2014)\]. Every key
+ * has two candidate buckets with several slots each. In addition to the key and the value,
+ * every slot stores a one byte tag derived from the key's hash. The tags of a bucket are
+ * packed into a single word and are compared with a few SWAR (SIMD within a register)
+ * instructions, so keys only have to be compared for slots with a matching tag. The second
+ * bucket is derived from the first bucket and the tag (partial-key cuckoo hashing), so a
+ * lookup reads at most two buckets.
+ *
+ * If both buckets of a new key are full, `emplace` uses a breadth-first search to find a
+ * short cuckoo path, i.e., a sequence of entries that can each be moved to their alternate
+ * bucket, ending in a free slot. The path is then executed backwards, so that every single
+ * move leaves the map in a consistent state. Only if no such path exists the table is grown.
+ * With the default of four slots per bucket this allows load factors above 90%.
+ *
+ * The buckets are protected by a fixed number of striped version locks (see
+ * `detail::optimistic_lock`). Update operations lock the (at most two) stripes of the buckets
+ * they modify, while read operations do not acquire any locks. Instead they validate afterwards
+ * that the versions of the stripes did not change.
+ *
+ * Growing the table is done incrementally. The thread that grows the table locks all stripes,
+ * installs a new table with twice the number of buckets and releases the locks again. The
+ * entries of the old table are then migrated lazily, one stripe at a time, by the next update
+ * operation that locks the corresponding stripe. Old tables are retired via the configured
+ * reclaimer once all their entries have been migrated.
+ *
+ * Since readers may read keys and values while they are modified by a concurrent writer, Key and
+ * Value must be trivially copyable types for which `std::atomic` is always lock-free (e.g., integers
+ * or raw pointers). Read operations return copies of the values.
+ *
+ * Supported policies:
+ *  * `xenium::policy::reclaimer`<br>
+ *    Defines the reclamation scheme to be used for the bucket tables. (**required**)
+ *  * `xenium::policy::hash`<br>
+ *    Defines the hash function. (*optional*; defaults to `xenium::hash<Key>`)
+ *  * `xenium::policy::backoff`<br>
+ *    Defines the backoff strategy that is used when an operation has to be restarted.
+ *    (*optional*; defaults to `xenium::no_backoff`)
+ *  * `xenium::policy::slots_per_bucket`<br>
+ *    Defines the number of slots per bucket; must be between 1 and 8. (*optional*; defaults to 4)
+ *
+ * @tparam Key
+ * @tparam Value
+ * @tparam Policies list of policies to customize the behaviour
+ */
+template <class Key, class Value, class... Policies>
+class cuckoo_hash_map {
+public:
+  using key_type = Key;
+  using value_type = Value;
+  using reclaimer = parameter::type_param_t<policy::reclaimer, parameter::nil, Policies...>;
+  using hash = parameter::type_param_t<policy::hash, xenium::hash<Key>, Policies...>;
+  using backoff = parameter::type_param_t<policy::backoff, no_backoff, Policies...>;
+  static constexpr unsigned slots_per_bucket =
+    parameter::value_param_t<unsigned, policy::slots_per_bucket, 4, Policies...>::value;
+
+  template <class... NewPolicies>
+  using with = cuckoo_hash_map<Key, Value, NewPolicies..., Policies...>;
+
+  static_assert(parameter::is_set<reclaimer>::value, "reclaimer policy must be specified");
+  static_assert(slots_per_bucket >= 1 && slots_per_bucket <= 8, "slots_per_bucket must be between 1 and 8");
+  static_assert(std::is_trivially_copyable_v<Key> && std::atomic<Key>::is_always_lock_free,
+                "Key must be trivially copyable and std::atomic<Key> must be lock-free");
+  static_assert(std::is_trivially_copyable_v<Value> && std::atomic<Value>::is_always_lock_free,
+                "Value must be trivially copyable and std::atomic<Value> must be lock-free");
+
+  explicit cuckoo_hash_map(std::size_t initial_capacity = 128);
+  ~cuckoo_hash_map();
+
+  cuckoo_hash_map(const cuckoo_hash_map&) = delete;
+  cuckoo_hash_map& operator=(const cuckoo_hash_map&) = delete;
+
+  /**
+   * @brief Inserts a new element into the container if the container doesn't already contain an
+   * element with an equivalent key.
+   *
+   * Progress guarantees: blocking
+   *
+   * @param key the key of the element to insert
+   * @param value the value of the element to insert
+   * @return `true` if an element was inserted, otherwise `false`
+   */
+  bool emplace(key_type key, value_type value);
+
+  /**
+   * @brief Removes the element with the key equivalent to key (if one exists).
+   *
+   * Progress guarantees: blocking
+   *
+   * @param key key of the element to remove
+   * @return `true` if an element was removed, otherwise `false`
+   */
+  bool erase(const key_type& key);
+
+  /**
+   * @brief Provides a copy of the value of the element with the key equivalent to key.
+   *
+   * Progress guarantees: blocking (read operations only wait for concurrent writers
+   * of the same buckets)
+   *
+   * @param key key of the element to search for
+   * @param value receives the value if the element is found
+   * @return `true` if an element was found, otherwise `false`
+   */
+  bool try_get_value(const key_type& key, value_type& value) const;
+
+  /**
+   * @brief Checks if there is an element with key equivalent to key in the container.
+   *
+   * Progress guarantees: blocking (read operations only wait for concurrent writers
+   * of the same buckets)
+   *
+   * @param key key of the element to search for
+   * @return `true` if there is such an element, otherwise `false`
+   */
+  bool contains(const key_type& key) const;
+
+  /**
+   * @brief Returns the number of slots in the current table.
+   *
+   * Progress guarantees: wait-free
+   */
+  [[nodiscard]] std::size_t capacity() const;
+
+private:
+  struct bucket;
+  struct stripe;
+  struct table;
+
+  using concurrent_ptr = typename reclaimer::template concurrent_ptr<table, 0>;
+  using guard_ptr = typename concurrent_ptr::guard_ptr;
+  using version_t = detail::optimistic_lock::version_t;
+
+  static constexpr std::size_t max_stripes = 4096;
+  static constexpr unsigned max_bfs_depth = 5;
+  static constexpr unsigned max_bfs_entries = 256;
+
+  struct bfs_entry {
+    std::size_t bucket;
+    std::uint16_t parent;
+    std::uint8_t slot;
+    std::uint8_t depth;
+  };
+
+  enum class result { not_found, found, restart };
+
+  result lookup(const key_type& key, value_type* value) const;
+  bool lock_buckets(table* t, std::size_t b1, std::size_t b2);
+  static void unlock_buckets(table* t, std::size_t b1, std::size_t b2);
+  void migrate_stripe(table* t, std::size_t idx);
+  result make_room(table* t, std::size_t b1, std::size_t b2);
+  result execute_path(table* t, const std::array<bfs_entry, max_bfs_entries>& queue, std::size_t idx, unsigned slot);
+  void grow(table* t);
+
+  static std::uint64_t hash_value(const key_type& key);
+  static std::uint8_t tag_of(std::uint64_t hash);
+  static std::size_t alt_index(std::size_t idx, std::uint8_t tag, std::size_t mask);
+  static std::uint8_t get_tag(std::uint64_t tags, unsigned slot) {
+    return static_cast<std::uint8_t>(tags >> (8 * slot));
+  }
+  static std::uint64_t set_tag(std::uint64_t tags, unsigned slot, std::uint8_t tag) {
+    return (tags & ~(std::uint64_t(0xff) << (8 * slot))) | (std::uint64_t(tag) << (8 * slot));
+  }
+  static std::uint64_t match_tags(std::uint64_t tags, std::uint8_t tag);
+  static int find_slot(const bucket& b, const key_type& key, std::uint8_t tag);
+  static int find_free_slot(const bucket& b);
+
+  concurrent_ptr current;
+};
+
+template <class Key, class Value, class... Policies>
+struct alignas(64) cuckoo_hash_map<Key, Value, Policies...>::bucket {
+  // One tag byte per slot; zero marks an empty slot. The values are stored in a separate
+  // array, so that the tags and keys of a bucket usually fit into a single cache line.
+  std::atomic<std::uint64_t> tags{0};
+  std::atomic<key_type> keys[slots_per_bucket];
+};
+
+template <class Key, class Value, class... Policies>
+struct alignas(64) cuckoo_hash_map<Key, Value, Policies...>::stripe {
+  detail::optimistic_lock lock;
+  // false while the entries of this stripe still reside in the previous table
+  std::atomic<bool> migrated{true};
+};
+
+template <class Key, class Value, class... Policies>
+struct cuckoo_hash_map<Key, Value, Policies...>::table : reclaimer::template enable_concurrent_ptr<table> {
+  table(std::size_t bucket_count, std::size_t stripe_count) :
+      bucket_mask(bucket_count - 1),
+      stripe_mask(stripe_count - 1),
+      buckets(new bucket[bucket_count]),
+      values(new std::atomic<value_type>[bucket_count * slots_per_bucket]),
+      stripes(new stripe[stripe_count]) {}
+
+  const std::size_t bucket_mask;
+  const std::size_t stripe_mask;
+  std::unique_ptr<bucket[]> buckets;
+  std::unique_ptr<std::atomic<value_type>[]> values;
+  std::unique_ptr<stripe[]> stripes;
+  // the previous table, as long as it contains entries that have not been migrated yet
+  concurrent_ptr previous;
+  std::atomic<std::size_t> unmigrated_stripes{0};
+
+  stripe& stripe_of(std::size_t bucket_idx) const { return stripes[bucket_idx & stripe_mask]; }
+  std::atomic<value_type>& value(std::size_t bucket_idx, unsigned slot) const {
+    return values[bucket_idx * slots_per_bucket + slot];
+  }
+};
+
+template <class Key, class Value, class... Policies>
+cuckoo_hash_map<Key, Value, Policies...>::cuckoo_hash_map(std::size_t initial_capacity) {
+  auto bucket_count = utils::next_power_of_two((initial_capacity + slots_per_bucket - 1) / slots_per_bucket);
+  if (bucket_count < 2) {
+    bucket_count = 2;
+  }
+  current.store(new table(bucket_count, std::min(bucket_count, max_stripes)), std::memory_order_relaxed);
+}
+
+template <class Key, class Value, class... Policies>
+cuckoo_hash_map<Key, Value, Policies...>::~cuckoo_hash_map() {
+  auto* t = current.load(std::memory_order_relaxed).get();
+  delete t->previous.load(std::memory_order_relaxed).get();
+  delete t;
+}
+
+template <class Key, class Value, class... Policies>
+std::uint64_t cuckoo_hash_map<Key, Value, Policies...>::hash_value(const key_type& key) {
+  // The bucket index is taken from the low bits and the tag from the high bits, so we
+  // apply a finalizer (from MurmurHash3) to make sure that all bits depend on the key.
+  auto h = static_cast<std::uint64_t>(hash{}(key));
+  h ^= h >> 33;
+  h *= 0xff51afd7ed558ccdULL;
+  h ^= h >> 33;
+  h *= 0xc4ceb9fe1a85ec53ULL;
+  h ^= h >> 33;
+  return h;
+}
+
+template <class Key, class Value, class... Policies>
+std::uint8_t cuckoo_hash_map<Key, Value, Policies...>::tag_of(std::uint64_t hash) {
+  auto tag = static_cast<std::uint8_t>(hash >> 56);
+  return tag == 0 ? 1 : tag;
+}
+
+template <class Key, class Value, class... Policies>
+std::size_t cuckoo_hash_map<Key, Value, Policies...>::alt_index(std::size_t idx, std::uint8_t tag, std::size_t mask) {
+  // An xor with a value that depends only on the tag, so alt_index(alt_index(i)) == i. Because
+  // of the mask, an entry's buckets in a table twice the size are either the same or offset by
+  // the old table size, which allows us to migrate the entries stripe by stripe.
+  return (idx ^ static_cast<std::size_t>((std::uint64_t(tag) + 1) * 0xc6a4a7935bd1e995ULL)) & mask;
+}
+
+template <class Key, class Value, class... Policies>
+std::uint64_t cuckoo_hash_map<Key, Value, Policies...>::match_tags(std::uint64_t tags, std::uint8_t tag) {
+  // Sets the high bit of every byte that is equal to tag. The result can contain false positives
+  // (bytes above an actual match), but these are filtered out by the subsequent key comparison.
+  constexpr std::uint64_t low_bits = 0x0101010101010101ULL;
+  constexpr std::uint64_t high_bits = 0x8080808080808080ULL;
+  const std::uint64_t x = tags ^ (low_bits * tag);
+  return (x - low_bits) & ~x & high_bits;
+}
+
+template <class Key, class Value, class... Policies>
+int cuckoo_hash_map<Key, Value, Policies...>::find_slot(const bucket& b, const key_type& key, std::uint8_t tag) {
+  const auto tags = b.tags.load(std::memory_order_relaxed);
+  const auto matches = match_tags(tags, tag);
+  if (matches == 0) {
+    return -1;
+  }
+  for (unsigned i = 0; i < slots_per_bucket; ++i) {
+    if (((matches >> (8 * i + 7)) & 1) != 0 && get_tag(tags, i) == tag &&
+        b.keys[i].load(std::memory_order_relaxed) == key) {
+      return static_cast<int>(i);
+    }
+  }
+  return -1;
+}
+
+template <class Key, class Value, class... Policies>
+int cuckoo_hash_map<Key, Value, Policies...>::find_free_slot(const bucket& b) {
+  const auto tags = b.tags.load(std::memory_order_relaxed);
+  for (unsigned i = 0; i < slots_per_bucket; ++i) {
+    if (get_tag(tags, i) == 0) {
+      return static_cast<int>(i);
+    }
+  }
+  return -1;
+}
+
+template <class Key, class Value, class... Policies>
+std::size_t cuckoo_hash_map<Key, Value, Policies...>::capacity() const {
+  auto t = acquire_guard(current, std::memory_order_acquire);
+  return (t->bucket_mask + 1) * slots_per_bucket;
+}
+
+template <class Key, class Value, class... Policies>
+auto cuckoo_hash_map<Key, Value, Policies...>::lookup(const key_type& key, value_type* value) const -> result {
+  const auto h = hash_value(key);
+  const auto tag = tag_of(h);
+  // (1) - this acquire-load synchronizes-with the release-store (4)
+  guard_ptr t = acquire_guard(current, std::memory_order_acquire);
+  const std::size_t b1 = h & t->bucket_mask;
+  const std::size_t b2 = alt_index(b1, tag, t->bucket_mask);
+  auto& s1 = t->stripe_of(b1);
+  auto& s2 = t->stripe_of(b2);
+  // we will most likely need the second bucket as well, so we start loading it right away
+  XENIUM_PREFETCH(&t->buckets[b2]);
+  XENIUM_PREFETCH(&s2);
+  version_t v1;
+  version_t v2;
+  s1.lock.read_lock(v1);
+  s2.lock.read_lock(v2);
+  // A concurrent grow locks all stripes before it replaces the table, so if the table is still
+  // the current one, the validation below tells us whether it has been replaced in the meantime.
+  if (current.load(std::memory_order_relaxed).get() != t.get()) {
+    return result::restart;
+  }
+
+  guard_ptr previous;
+  auto find = [&](std::size_t idx, stripe& s) -> bool {
+    const table* tbl = t.get();
+    if (!s.migrated.load(std::memory_order_relaxed)) {
+      // the entries of this stripe still reside in the previous table
+      if (!previous) {
+        // (2) - this acquire-load synchronizes-with the release-store (4)
+        previous.acquire(t->previous, std::memory_order_acquire);
+        if (!previous) {
+          return false;
+        }
+      }
+      tbl = previous.get();
+      idx &= tbl->bucket_mask;
+    }
+    const int slot = find_slot(tbl->buckets[idx], key, tag);
+    if (slot < 0) {
+      return false;
+    }
+    if (value) {
+      *value = tbl->value(idx, slot).load(std::memory_order_relaxed);
+    }
+    return true;
+  };
+
+  const bool found = find(b1, s1) || find(b2, s2);
+  if (!s1.lock.validate(v1) || !s2.lock.validate(v2)) {
+    return result::restart;
+  }
+  return found ? result::found : result::not_found;
+}
+
+template <class Key, class Value, class... Policies>
+bool cuckoo_hash_map<Key, Value, Policies...>::try_get_value(const key_type& key, value_type& value) const {
+  backoff backoff;
+  for (;;) {
+    auto res = lookup(key, &value);
+    if (res != result::restart) {
+      return res == result::found;
+    }
+    backoff();
+  }
+}
+
+template <class Key, class Value, class... Policies>
+bool cuckoo_hash_map<Key, Value, Policies...>::contains(const key_type& key) const {
+  backoff backoff;
+  for (;;) {
+    auto res = lookup(key, nullptr);
+    if (res != result::restart) {
+      return res == result::found;
+    }
+    backoff();
+  }
+}
+
+template <class Key, class Value, class... Policies>
+bool cuckoo_hash_map<Key, Value, Policies...>::lock_buckets(table* t, std::size_t b1, std::size_t b2) {
+  std::size_t idx1 = b1 & t->stripe_mask;
+  std::size_t idx2 = b2 & t->stripe_mask;
+  if (idx1 > idx2) {
+    std::swap(idx1, idx2);
+  }
+  // stripes are always locked in ascending order to avoid deadlocks
+  t->stripes[idx1].lock.write_lock();
+  if (idx2 != idx1) {
+    t->stripes[idx2].lock.write_lock();
+  }
+  if (current.load(std::memory_order_relaxed).get() != t) {
+    // the table has been replaced while we were waiting for the locks
+    unlock_buckets(t, b1, b2);
+    return false;
+  }
+  migrate_stripe(t, idx1);
+  if (idx2 != idx1) {
+    migrate_stripe(t, idx2);
+  }
+  return true;
+}
+
+template <class Key, class Value, class... Policies>
+void cuckoo_hash_map<Key, Value, Policies...>::unlock_buckets(table* t, std::size_t b1, std::size_t b2) {
+  const std::size_t idx1 = b1 & t->stripe_mask;
+  const std::size_t idx2 = b2 & t->stripe_mask;
+  t->stripes[idx1].lock.write_unlock();
+  if (idx2 != idx1) {
+    t->stripes[idx2].lock.write_unlock();
+  }
+}
+
+template <class Key, class Value, class... Policies>
+void cuckoo_hash_map<Key, Value, Policies...>::migrate_stripe(table* t, std::size_t idx) {
+  // the caller must hold the lock of this stripe
+  auto& s = t->stripes[idx];
+  if (s.migrated.load(std::memory_order_relaxed)) {
+    return;
+  }
+
+  // The previous table is no longer modified, and it has at least as many buckets as the new one
+  // has stripes. An entry from bucket b is moved into bucket b or b + old_size, which both belong
+  // to this stripe. Both buckets receive only entries from bucket b, so every entry can keep its slot.
+  auto* prev = t->previous.load(std::memory_order_relaxed).get();
+  assert(prev != nullptr);
+  for (std::size_t b = idx; b <= prev->bucket_mask; b += t->stripe_mask + 1) {
+    const bucket& src = prev->buckets[b];
+    const auto tags = src.tags.load(std::memory_order_relaxed);
+    for (unsigned i = 0; i < slots_per_bucket; ++i) {
+      const auto tag = get_tag(tags, i);
+      if (tag == 0) {
+        continue;
+      }
+      const auto key = src.keys[i].load(std::memory_order_relaxed);
+      const auto h = hash_value(key);
+      std::size_t dest_idx = h & t->bucket_mask;
+      if ((h & prev->bucket_mask) != b) {
+        dest_idx = alt_index(dest_idx, tag, t->bucket_mask);
+      }
+      assert((dest_idx & t->stripe_mask) == idx);
+      bucket& dest = t->buckets[dest_idx];
+      dest.keys[i].store(key, std::memory_order_relaxed);
+      t->value(dest_idx, i).store(prev->value(b, i).load(std::memory_order_relaxed), std::memory_order_relaxed);
+      dest.tags.store(set_tag(dest.tags.load(std::memory_order_relaxed), i, tag), std::memory_order_relaxed);
+    }
+  }
+  s.migrated.store(true, std::memory_order_relaxed);
+
+  if (t->unmigrated_stripes.fetch_sub(1, std::memory_order_relaxed) == 1) {
+    // all entries have been migrated, so nobody needs the previous table anymore
+    guard_ptr g = acquire_guard(t->previous, std::memory_order_relaxed);
+    t->previous.store(nullptr, std::memory_order_relaxed);
+    g.reclaim();
+  }
+}
+
+template <class Key, class Value, class... Policies>
+bool cuckoo_hash_map<Key, Value, Policies...>::emplace(key_type key, value_type value) {
+  const auto h = hash_value(key);
+  const auto tag = tag_of(h);
+  backoff backoff;
+  for (;;) {
+    // (3) - this acquire-load synchronizes-with the release-store (4)
+    guard_ptr t = acquire_guard(current, std::memory_order_acquire);
+    const std::size_t b1 = h & t->bucket_mask;
+    const std::size_t b2 = alt_index(b1, tag, t->bucket_mask);
+    if (!lock_buckets(t.get(), b1, b2)) {
+      continue;
+    }
+
+    if (find_slot(t->buckets[b1], key, tag) >= 0 || find_slot(t->buckets[b2], key, tag) >= 0) {
+      unlock_buckets(t.get(), b1, b2);
+      return false;
+    }
+
+    for (auto idx : {b1, b2}) {
+      bucket& b = t->buckets[idx];
+      const int slot = find_free_slot(b);
+      if (slot >= 0) {
+        b.keys[slot].store(key, std::memory_order_relaxed);
+        t->value(idx, slot).store(value, std::memory_order_relaxed);
+        b.tags.store(set_tag(b.tags.load(std::memory_order_relaxed), slot, tag), std::memory_order_relaxed);
+        unlock_buckets(t.get(), b1, b2);
+        return true;
+      }
+    }
+    unlock_buckets(t.get(), b1, b2);
+
+    // both buckets are full -> try to move some entries to their alternate buckets
+    auto res = make_room(t.get(), b1, b2);
+    if (res == result::not_found) {
+      grow(t.get());
+    } else if (res == result::restart) {
+      backoff();
+    }
+  }
+}
+
+template <class Key, class Value, class... Policies>
+auto cuckoo_hash_map<Key, Value, Policies...>::make_room(table* t, std::size_t b1, std::size_t b2) -> result {
+  // Breadth-first search for a cuckoo path that ends in a free slot. The buckets are read without
+  // holding any locks; the path is verified step by step when it is executed.
+  std::array<bfs_entry, max_bfs_entries> queue;
+  constexpr auto no_parent = static_cast<std::uint16_t>(max_bfs_entries);
+  std::size_t head = 0;
+  std::size_t tail = 0;
+  queue[tail++] = {b1, no_parent, 0, 0};
+  queue[tail++] = {b2, no_parent, 0, 0};
+  while (head < tail) {
+    const auto entry = queue[head];
+    const auto idx = head++;
+    const auto tags = t->buckets[entry.bucket].tags.load(std::memory_order_relaxed);
+    for (unsigned i = 0; i < slots_per_bucket; ++i) {
+      if (get_tag(tags, i) == 0) {
+        return entry.depth == 0 ? result::restart : execute_path(t, queue, idx, i);
+      }
+    }
+    if (entry.depth < max_bfs_depth) {
+      for (unsigned i = 0; i < slots_per_bucket && tail < max_bfs_entries; ++i) {
+        queue[tail++] = {alt_index(entry.bucket, get_tag(tags, i), t->bucket_mask),
+                         static_cast<std::uint16_t>(idx),
+                         static_cast<std::uint8_t>(i),
+                         static_cast<std::uint8_t>(entry.depth + 1)};
+      }
+    }
+  }
+  return result::not_found;
+}
+
+template <class Key, class Value, class... Policies>
+auto cuckoo_hash_map<Key, Value, Policies...>::execute_path(table* t,
+                                                            const std::array<bfs_entry, max_bfs_entries>& queue,
+                                                            std::size_t idx,
+                                                            unsigned slot) -> result {
+  // path[0] is the free slot, path[n-1] the slot in one of the key's buckets
+  std::array<std::pair<std::size_t, unsigned>, max_bfs_depth + 1> path;
+  std::size_t n = 0;
+  for (auto i = idx; i != max_bfs_entries; i = queue[i].parent) {
+    path[n++] = {queue[i].bucket, slot};
+    slot = queue[i].slot;
+  }
+
+  // Move the entries backwards, starting at the free slot, so that each entry is always
+  // contained in one of its buckets.
+  for (std::size_t i = 1; i < n; ++i) {
+    const auto [from_idx, from_slot] = path[i];
+    const auto [to_idx, to_slot] = path[i - 1];
+    if (!lock_buckets(t, from_idx, to_idx)) {
+      return result::restart;
+    }
+    bucket& from = t->buckets[from_idx];
+    bucket& to = t->buckets[to_idx];
+    const auto tag = get_tag(from.tags.load(std::memory_order_relaxed), from_slot);
+    if (tag == 0 || get_tag(to.tags.load(std::memory_order_relaxed), to_slot) != 0 ||
+        alt_index(from_idx, tag, t->bucket_mask) != to_idx) {
+      // the path has been invalidated by some concurrent operation
+      unlock_buckets(t, from_idx, to_idx);
+      return result::restart;
+    }
+    to.keys[to_slot].store(from.keys[from_slot].load(std::memory_order_relaxed), std::memory_order_relaxed);
+    t->value(to_idx, to_slot)
+      .store(t->value(from_idx, from_slot).load(std::memory_order_relaxed), std::memory_order_relaxed);
+    to.tags.store(set_tag(to.tags.load(std::memory_order_relaxed), to_slot, tag), std::memory_order_relaxed);
+    from.tags.store(set_tag(from.tags.load(std::memory_order_relaxed), from_slot, 0), std::memory_order_relaxed);
+    unlock_buckets(t, from_idx, to_idx);
+  }
+  return result::found;
+}
+
+template <class Key, class Value, class... Policies>
+void cuckoo_hash_map<Key, Value, Policies...>::grow(table* t) {
+  const std::size_t stripe_count = t->stripe_mask + 1;
+  for (std::size_t i = 0; i < stripe_count; ++i) {
+    t->stripes[i].lock.write_lock();
+  }
+  if (current.load(std::memory_order_relaxed).get() == t) {
+    // the previous table must be fully migrated before we can replace the current one
+    for (std::size_t i = 0; i < stripe_count; ++i) {
+      migrate_stripe(t, i);
+    }
+    assert(t->previous.load(std::memory_order_relaxed) == nullptr);
+
+    const std::size_t bucket_count = 2 * (t->bucket_mask + 1);
+    const std::size_t new_stripe_count = std::min(t->bucket_mask + 1, max_stripes);
+    auto* new_table = new table(bucket_count, new_stripe_count);
+    for (std::size_t i = 0; i < new_stripe_count; ++i) {
+      new_table->stripes[i].migrated.store(false, std::memory_order_relaxed);
+    }
+    new_table->unmigrated_stripes.store(new_stripe_count, std::memory_order_relaxed);
+    new_table->previous.store(t, std::memory_order_relaxed);
+    // (4) - this release-store synchronizes-with the acquire-load (1, 2, 3, 5)
+    current.store(new_table, std::memory_order_release);
+  }
+  for (std::size_t i = 0; i < stripe_count; ++i) {
+    t->stripes[i].lock.write_unlock();
+  }
+}
+
+template <class Key, class Value, class... Policies>
+bool cuckoo_hash_map<Key, Value, Policies...>::erase(const key_type& key) {
+  const auto h = hash_value(key);
+  const auto tag = tag_of(h);
+  for (;;) {
+    // (5) - this acquire-load synchronizes-with the release-store (4)
+    guard_ptr t = acquire_guard(current, std::memory_order_acquire);
+    const std::size_t b1 = h & t->bucket_mask;
+    const std::size_t b2 = alt_index(b1, tag, t->bucket_mask);
+    if (!lock_buckets(t.get(), b1, b2)) {
+      continue;
+    }
+    bool removed = false;
+    for (auto idx : {b1, b2}) {
+      bucket& b = t->buckets[idx];
+      const int slot = find_slot(b, key, tag);
+      if (slot >= 0) {
+        b.tags.store(set_tag(b.tags.load(std::memory_order_relaxed), slot, 0), std::memory_order_relaxed);
+        removed = true;
+        break;
+      }
+    }
+    unlock_buckets(t.get(), b1, b2);
+    return removed;
+  }
+}
+} // namespace xenium
+
+#endif
@@ -0,0 +1,110 @@
+//
+// Copyright (c) 2018-2020 Manuel Pöter.
+// Licensed under the MIT License. See LICENSE file in the project root for full license information.
+//
+
+#ifndef XENIUM_DETAIL_DOUBLE_WIDTH_CAS_HPP
+#define XENIUM_DETAIL_DOUBLE_WIDTH_CAS_HPP
+
+#include <xenium/detail/port.hpp>
+
+#include <atomic>
+#include <cstdint>
+#include <cstring>
+
+#if defined(_MSC_VER) && defined(_M_AMD64)
+  #include <intrin.h>
+#endif
+
+namespace xenium::detail {
+
+/**
+ * @brief A pair of 64 bit words that can be updated atomically with a double-width CAS.
+ *
+ * Each word can be accessed individually via the usual `std::atomic` operations, while
+ * `compare_exchange` compares and replaces both words in a single atomic operation.
+ * On x86-64 this is implemented with `cmpxchg16b` (`_InterlockedCompareExchange128` on
+ * MSVC), which does not require any special compiler flags. On other platforms (and when
+ * compiling with ThreadSanitizer) it falls back to the 16 byte `__atomic` builtins, which
+ * may require linking against libatomic.
+ *
+ * A double-width CAS is always a full memory barrier, i.e., it behaves like a seq_cst
+ * read-modify-write operation on both words. Mixing 64 bit and 128 bit atomic accesses
+ * on the same memory is not covered by the C++ memory model, but it is well defined on
+ * all supported architectures.
+ */
+struct alignas(16) atomic_word_pair {
+  std::atomic<std::uint64_t> first{0};
+  std::atomic<std::uint64_t> second{0};
+
+  /**
+   * @brief Atomically compares both words with the expected values and, if both are equal,
+   * replaces them with the desired values.
+   *
+   * If the operation fails, `expected_first` and `expected_second` are updated with the
+   * values that were read.
+   *
+   * @return `true` if the operation was successful, otherwise `false`
+   */
+  bool compare_exchange(std::uint64_t& expected_first,
+                        std::uint64_t& expected_second,
+                        std::uint64_t desired_first,
+                        std::uint64_t desired_second) noexcept;
+
+  /**
+   * @brief Atomically reads both words.
+   *
+   * This is implemented with a double-width CAS and therefore requires exclusive access
+   * to the cache line.
+   */
+  void load(std::uint64_t& first_value, std::uint64_t& second_value) noexcept {
+    first_value = first.load(std::memory_order_relaxed);
+    second_value = second.load(std::memory_order_relaxed);
+    // if the CAS succeeds it writes back the values we have just read
+    compare_exchange(first_value, second_value, first_value, second_value);
+  }
+};
+
+static_assert(sizeof(atomic_word_pair) == 16, "atomic_word_pair must occupy exactly 16 bytes");
+
+inline bool atomic_word_pair::compare_exchange(std::uint64_t& expected_first,
+                                               std::uint64_t& expected_second,
+                                               std::uint64_t desired_first,
+                                               std::uint64_t desired_second) noexcept {
+#if defined(XENIUM_ARCH_X86) && defined(__GNUC__) && !defined(__SANITIZE_THREAD__)
+  bool result;
+  __asm__ __volatile__("lock cmpxchg16b %1"
+                       : "=@ccz"(result), "+m"(*this), "+a"(expected_first), "+d"(expected_second)
+                       : "b"(desired_first), "c"(desired_second)
+                       : "memory");
+  return result;
+#elif defined(_MSC_VER) && defined(_M_AMD64)
+  __int64 comparand[2] = {static_cast<__int64>(expected_first), static_cast<__int64>(expected_second)};
+  const bool result = _InterlockedCompareExchange128(reinterpret_cast<volatile __int64*>(this),
+                                                     static_cast<__int64>(desired_second),
+                                                     static_cast<__int64>(desired_first),
+                                                     comparand) != 0;
+  expected_first = static_cast<std::uint64_t>(comparand[0]);
+  expected_second = static_cast<std::uint64_t>(comparand[1]);
+  return result;
+#else
+  __extension__ typedef unsigned __int128 uint128_t; // NOLINT
+  // use memcpy to get the same memory layout as the two 64 bit words, regardless of endianness
+  const std::uint64_t expected_words[2] = {expected_first, expected_second};
+  const std::uint64_t desired_words[2] = {desired_first, desired_second};
+  uint128_t expected;
+  uint128_t desired;
+  std::memcpy(&expected, expected_words, sizeof(expected));
+  std::memcpy(&desired, desired_words, sizeof(desired));
+  const bool result = __atomic_compare_exchange_n(
+    reinterpret_cast<uint128_t*>(this), &expected, desired, false, __ATOMIC_SEQ_CST, __ATOMIC_SEQ_CST);
+  std::uint64_t actual_words[2];
+  std::memcpy(actual_words, &expected, sizeof(expected));
+  expected_first = actual_words[0];
+  expected_second = actual_words[1];
+  return result;
+#endif
+}
+} // namespace xenium::detail
+
+#endif
@@ -0,0 +1,175 @@
+//
+// Copyright (c) 2018-2020 Manuel Pöter.
+// Licensed under the MIT License. See LICENSE file in the project root for full license information.
+//
+
+#ifndef XENIUM_DETAIL_EVENTCOUNT_HPP
+#define XENIUM_DETAIL_EVENTCOUNT_HPP
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+
+#if defined(__linux__)
+  #define XENIUM_HAS_FUTEX
+  #include <linux/futex.h>
+  #include <sys/syscall.h>
+  #include <unistd.h>
+
+  #include <climits>
+  #include <ctime>
+#else
+  #include <condition_variable>
+  #include <mutex>
+#endif
+
+namespace xenium::detail {
+
+/**
+ * @brief An eventcount that allows threads to block until some condition becomes true.
+ *
+ * A waiter first announces itself via `prepare_wait`, then re-checks its condition and
+ * either calls `cancel_wait` (if the condition is now true) or blocks in `wait`/`wait_for`
+ * with the key returned by `prepare_wait`. A notifier first makes the condition true and
+ * then calls `notify_one`/`notify_all`. The notification only costs an atomic load if
+ * there are no waiters; the epoch is only incremented and the waiters only woken up if
+ * some thread is actually waiting.
+ *
+ * On Linux waiters block on a futex on the epoch. On other platforms untimed waits use
+ * `std::atomic::wait` if available, and a mutex/condition_variable pair otherwise (timed
+ * waits always use the condition_variable, since `std::atomic::wait` has no timeout).
+ */
+class eventcount {
+public:
+  using key_type = std::uint32_t;
+
+  eventcount() = default;
+  eventcount(const eventcount&) = delete;
+  eventcount& operator=(const eventcount&) = delete;
+
+  /**
+   * @brief Announces that the calling thread is about to wait.
+   *
+   * Must be followed by either `cancel_wait` or `wait`/`wait_for`.
+   * @return the key to pass to `wait`/`wait_for`
+   */
+  key_type prepare_wait() noexcept {
+    _waiters.fetch_add(1, std::memory_order_relaxed);
+    // (1) - this seq_cst-fence enforces a total order with the seq_cst-fence (2), so
+    //       either the waiter observes the notifier's update of the condition, or the
+    //       notifier observes the incremented number of waiters.
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    return _epoch.load(std::memory_order_acquire);
+  }
+
+  void cancel_wait() noexcept { _waiters.fetch_sub(1, std::memory_order_relaxed); }
+
+  /**
+   * @brief Blocks until the eventcount has been notified after the corresponding `prepare_wait`.
+   */
+  void wait(key_type key) noexcept {
+    while (_epoch.load(std::memory_order_acquire) == key) {
+#if defined(XENIUM_HAS_FUTEX)
+      futex_wait(key, nullptr);
+#elif defined(__cpp_lib_atomic_wait)
+      _epoch.wait(key, std::memory_order_acquire);
+#else
+      std::unique_lock<std::mutex> lock(_mutex);
+      _cv.wait(lock, [&] { return _epoch.load(std::memory_order_acquire) != key; });
+#endif
+    }
+    _waiters.fetch_sub(1, std::memory_order_relaxed);
+  }
+
+  /**
+   * @brief Blocks until the eventcount has been notified after the corresponding `prepare_wait`,
+   * or the timeout has expired.
+   * @return `true` if the eventcount has been notified, `false` if the timeout has expired.
+   */
+  template <class Rep, class Period>
+  bool wait_for(key_type key, const std::chrono::duration<Rep, Period>& timeout) noexcept {
+    const auto deadline = std::chrono::steady_clock::now() + timeout;
+    bool notified = true;
+    while (_epoch.load(std::memory_order_acquire) == key) {
+      const auto now = std::chrono::steady_clock::now();
+      if (now >= deadline) {
+        notified = false;
+        break;
+      }
+#if defined(XENIUM_HAS_FUTEX)
+      const auto remaining = std::chrono::duration_cast<std::chrono::nanoseconds>(deadline - now).count();
+      timespec ts{};
+      ts.tv_sec = static_cast<std::time_t>(remaining / 1000000000);
+      ts.tv_nsec = static_cast<long>(remaining % 1000000000);
+      futex_wait(key, &ts);
+#else
+      std::unique_lock<std::mutex> lock(_mutex);
+      _cv.wait_until(lock, deadline, [&] { return _epoch.load(std::memory_order_acquire) != key; });
+#endif
+    }
+    _waiters.fetch_sub(1, std::memory_order_relaxed);
+    return notified;
+  }
+
+  void notify_one() noexcept { notify(false); }
+  void notify_all() noexcept { notify(true); }
+
+private:
+  void notify(bool all) noexcept {
+    // (2) - this seq_cst-fence enforces a total order with the seq_cst-fence (1)
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    if (_waiters.load(std::memory_order_relaxed) == 0) {
+      return;
+    }
+
+    // (3) - this release-RMW synchronizes-with the acquire-loads of the epoch in
+    //       prepare_wait, wait and wait_for.
+    _epoch.fetch_add(1, std::memory_order_release);
+#if defined(XENIUM_HAS_FUTEX)
+    futex_wake(all ? INT_MAX : 1);
+#else
+    {
+      // acquire the mutex so that a waiter cannot miss the notification between
+      // checking the epoch and blocking on the condition_variable.
+      std::lock_guard<std::mutex> lock(_mutex);
+    }
+    if (all) {
+      _cv.notify_all();
+    } else {
+      _cv.notify_one();
+    }
+  #if defined(__cpp_lib_atomic_wait)
+    if (all) {
+      _epoch.notify_all();
+    } else {
+      _epoch.notify_one();
+    }
+  #endif
+#endif
+  }
+
+#if defined(XENIUM_HAS_FUTEX)
+  static_assert(sizeof(std::atomic<std::uint32_t>) == sizeof(std::uint32_t), "futex requires a plain 32 bit word");
+
+  std::uint32_t* futex_word() noexcept { return reinterpret_cast<std::uint32_t*>(&_epoch); }
+
+  void futex_wait(key_type key, const timespec* timeout) noexcept {
+    // spurious wake-ups, EAGAIN (epoch has already changed) and timeouts are all
+    // handled by the caller by re-checking the epoch.
+    syscall(SYS_futex, futex_word(), FUTEX_WAIT_PRIVATE, key, timeout, nullptr, 0);
+  }
+
+  void futex_wake(int count) noexcept {
+    syscall(SYS_futex, futex_word(), FUTEX_WAKE_PRIVATE, count, nullptr, nullptr, 0);
+  }
+#else
+  std::mutex _mutex;
+  std::condition_variable _cv;
+#endif
+
+  std::atomic<key_type> _epoch{0};
+  std::atomic<std::uint32_t> _waiters{0};
+};
+} // namespace xenium::detail
+
+#endif
@@ -0,0 +1,199 @@
+//
+// Copyright (c) 2018-2020 Manuel Pöter.
+// Licensed under the MIT License. See LICENSE file in the project root for full license information.
+//
+
+#ifndef XENIUM_DETAIL_LCRQ_RING_HPP
+#define XENIUM_DETAIL_LCRQ_RING_HPP
+
+#include <xenium/detail/double_width_cas.hpp>
+#include <xenium/utils.hpp>
+
+#include <atomic>
+#include <cstdint>
+
+#ifdef _MSC_VER
+  #pragma warning(push)
+  #pragma warning(disable : 4324) // structure was padded due to alignment specifier
+#endif
+
+namespace xenium::detail {
+
+/**
+ * @brief A ring segment (`CRQ`) of the `lcrq_queue`.
+ *
+ * Values are non-zero 64 bit words. Push and pop operations acquire their slot with a single
+ * fetch-and-add on `tail`/`head` and then update the cell with a double-width CAS. Once the
+ * ring is full (or a push operation fails too often), the ring is closed by setting the
+ * `closed_bit` in `tail`, and all further push operations fail.
+ *
+ * @tparam EntriesPerNode the number of cells; must be a power of two.
+ * @tparam Backoff the backoff strategy.
+ */
+template <unsigned EntriesPerNode, class Backoff>
+struct lcrq_ring {
+  static constexpr unsigned entries_per_node = EntriesPerNode;
+
+  // The first word of a cell holds the safe bit and the index of the round the cell belongs to,
+  // the second word holds the value (zero if the cell is empty).
+  static constexpr std::uint64_t safe_bit = static_cast<std::uint64_t>(1) << 63;
+  static constexpr std::uint64_t index_mask = safe_bit - 1;
+  // The most significant bit of the tail counter marks a closed ring segment.
+  static constexpr std::uint64_t closed_bit = static_cast<std::uint64_t>(1) << 63;
+  static constexpr std::uint64_t empty_value = 0;
+
+  // A push operation that fails this many times on the same ring segment closes the segment.
+  // This prevents a push from starving when it constantly competes with pop operations.
+  static constexpr unsigned max_push_attempts = 16;
+
+  alignas(64) std::atomic<std::uint64_t> head;
+  alignas(64) std::atomic<std::uint64_t> tail;
+  alignas(64) atomic_word_pair cells[entries_per_node];
+
+  // Start with the first entry pre-filled (unless value is empty_value)
+  explicit lcrq_ring(std::uint64_t value) : head{0}, tail{value == empty_value ? 0u : 1u} {
+    for (std::uint64_t i = 0; i < entries_per_node; ++i) {
+      auto& cell = cells[remap_index(i)];
+      cell.first.store(safe_bit | i, std::memory_order_relaxed);
+      cell.second.store(empty_value, std::memory_order_relaxed);
+    }
+    cells[remap_index(0)].second.store(value, std::memory_order_relaxed);
+  }
+
+  bool try_push(std::uint64_t value);
+  bool try_pop(std::uint64_t& value);
+  void fix_state();
+
+  [[nodiscard]] bool is_closed() const { return (tail.load(std::memory_order_relaxed) & closed_bit) != 0; }
+
+  // Consecutive indexes are mapped to different cache lines to avoid false sharing.
+  static constexpr std::size_t cacheline_size = 64;
+  static constexpr std::size_t cells_per_cacheline = cacheline_size / sizeof(atomic_word_pair);
+  static constexpr std::size_t remap_shift =
+    entries_per_node >= cells_per_cacheline ? utils::find_last_bit_set(entries_per_node / cells_per_cacheline) - 1 : 0;
+
+  static constexpr std::size_t remap_index(std::uint64_t idx) {
+    const auto i = static_cast<std::size_t>(idx & (entries_per_node - 1));
+    if constexpr (entries_per_node < cells_per_cacheline) {
+      return i;
+    } else {
+      return (i >> remap_shift) | ((i * cells_per_cacheline) & (entries_per_node - 1));
+    }
+  }
+
+private:
+  // Pop operations that find the ring empty may temporarily move head beyond tail (until
+  // fix_state has been called), so the difference of the counters has to be interpreted as
+  // a signed value.
+  static std::int64_t diff(std::uint64_t a, std::uint64_t b) { return static_cast<std::int64_t>(a - b); }
+};
+
+template <unsigned EntriesPerNode, class Backoff>
+bool lcrq_ring<EntriesPerNode, Backoff>::try_push(std::uint64_t value) {
+  // The head and tail counters are updated with sequentially consistent operations, since the
+  // algorithm relies on a single total order of all counter updates and cell updates (the
+  // double-width CAS is a full barrier). On x86 the fetch-and-add is a full barrier anyway.
+  Backoff backoff;
+  for (unsigned attempts = 1;; ++attempts) {
+    const auto t = tail.fetch_add(1, std::memory_order_seq_cst);
+    if ((t & closed_bit) != 0) {
+      return false;
+    }
+
+    auto& cell = cells[remap_index(t)];
+    auto idx = cell.first.load(std::memory_order_relaxed);
+    auto val = cell.second.load(std::memory_order_relaxed);
+    // We may only use the cell if it is empty and has not yet been used in a later round. If the
+    // cell is unsafe, a pop operation might already have passed it, so we may only use it if no
+    // pop operation has reached index t yet.
+    if (val == empty_value && (idx & index_mask) <= t &&
+        ((idx & safe_bit) != 0 || head.load(std::memory_order_seq_cst) <= t)) {
+      // (1) - this double-width CAS synchronizes-with the double-width CAS (2)
+      if (cell.compare_exchange(idx, val, safe_bit | t, value)) {
+        return true;
+      }
+    }
+
+    const auto h = head.load(std::memory_order_seq_cst);
+    if (diff(t, h) >= static_cast<std::int64_t>(entries_per_node) || attempts >= max_push_attempts) {
+      // the ring segment is full or we are starving -> close it
+      tail.fetch_or(closed_bit, std::memory_order_seq_cst);
+      return false;
+    }
+    backoff();
+  }
+}
+
+template <unsigned EntriesPerNode, class Backoff>
+bool lcrq_ring<EntriesPerNode, Backoff>::try_pop(std::uint64_t& value) {
+  Backoff backoff;
+  for (;;) {
+    const auto h = head.fetch_add(1, std::memory_order_seq_cst);
+    auto& cell = cells[remap_index(h)];
+    auto idx = cell.first.load(std::memory_order_relaxed);
+    auto val = cell.second.load(std::memory_order_relaxed);
+    for (;;) {
+      const auto cell_idx = idx & index_mask;
+      if (cell_idx > h) {
+        // some other pop operation has already moved the cell to a later round
+        break;
+      }
+
+      if (val != empty_value) {
+        if (cell_idx == h) {
+          // (2) - this double-width CAS synchronizes-with the double-width CAS (1)
+          if (cell.compare_exchange(idx, val, (idx & safe_bit) | (h + entries_per_node), empty_value)) {
+            value = val;
+            return true;
+          }
+        } else {
+          // The cell contains a value from an earlier round that has not yet been popped. Mark the
+          // cell as unsafe, so that a push operation for the current round does not use it.
+          if (cell.compare_exchange(idx, val, idx & index_mask, val)) {
+            break;
+          }
+        }
+      } else {
+        // The cell is empty, so the corresponding push operation has not yet stored its value.
+        // Move the cell to the next round so the push operation has to try again.
+        if (cell.compare_exchange(idx, val, (idx & safe_bit) | (h + entries_per_node), empty_value)) {
+          break;
+        }
+      }
+      // the failed CAS has updated idx and val with the current values of the cell
+    }
+
+    const auto t = tail.load(std::memory_order_seq_cst) & ~closed_bit;
+    if (t <= h + 1) {
+      fix_state();
+      return false;
+    }
+    backoff();
+  }
+}
+
+template <unsigned EntriesPerNode, class Backoff>
+void lcrq_ring<EntriesPerNode, Backoff>::fix_state() {
+  // pop operations that found the ring segment empty may have pushed head beyond tail,
+  // so we have to move tail forward again
+  for (;;) {
+    auto t = tail.load(std::memory_order_seq_cst);
+    const auto h = head.load(std::memory_order_seq_cst);
+    if (tail.load(std::memory_order_seq_cst) != t) {
+      continue;
+    }
+    if (h <= t) {
+      return;
+    }
+    if (tail.compare_exchange_strong(t, h, std::memory_order_seq_cst, std::memory_order_relaxed)) {
+      return;
+    }
+  }
+}
+} // namespace xenium::detail
+
+#ifdef _MSC_VER
+  #pragma warning(pop)
+#endif
+
+#endif
@@ -0,0 +1,103 @@
+//
+// Copyright (c) 2018-2020 Manuel Pöter.
+// Licensed under the MIT License. See LICENSE file in the project root for full license information.
+//
+
+#ifndef XENIUM_DETAIL_MAPPED_FILE_HPP
+#define XENIUM_DETAIL_MAPPED_FILE_HPP
+
+#include <cerrno>
+#include <cstddef>
+#include <string>
+#include <system_error>
+
+#if defined(__unix__) || defined(__APPLE__)
+  #define XENIUM_HAS_MMAP
+  #include <fcntl.h>
+  #include <sys/mman.h>
+  #include <sys/stat.h>
+  #include <unistd.h>
+#else
+  #include <fstream>
+  #include <iterator>
+  #include <vector>
+#endif
+
+namespace xenium::detail {
+
+/**
+ * @brief A read-only view of the contents of a file.
+ *
+ * On POSIX systems the file is mapped into memory using `mmap`, so the pages are only
+ * read from disk when they are accessed for the first time. On other platforms the
+ * whole file is read into a buffer.
+ */
+class mapped_file {
+public:
+  explicit mapped_file(const std::string& path) { open(path); }
+  ~mapped_file() { close(); }
+
+  mapped_file(const mapped_file&) = delete;
+  mapped_file& operator=(const mapped_file&) = delete;
+
+  [[nodiscard]] const char* data() const noexcept { return _data; }
+  [[nodiscard]] std::size_t size() const noexcept { return _size; }
+
+private:
+#ifdef XENIUM_HAS_MMAP
+  void open(const std::string& path) {
+    int fd = ::open(path.c_str(), O_RDONLY);
+    if (fd < 0) {
+      throw std::system_error(errno, std::generic_category(), "failed to open " + path);
+    }
+    struct stat st {};
+    if (::fstat(fd, &st) != 0) {
+      auto err = errno;
+      ::close(fd);
+      throw std::system_error(err, std::generic_category(), "failed to stat " + path);
+    }
+    _size = static_cast<std::size_t>(st.st_size);
+    if (_size != 0) {
+      void* addr = ::mmap(nullptr, _size, PROT_READ, MAP_PRIVATE, fd, 0);
+      if (addr == MAP_FAILED) {
+        auto err = errno;
+        ::close(fd);
+        throw std::system_error(err, std::generic_category(), "failed to map " + path);
+      }
+      // we read the file front to back, so tell the kernel to read ahead aggressively
+      ::madvise(addr, _size, MADV_SEQUENTIAL);
+      _data = static_cast<const char*>(addr);
+    }
+    // the mapping remains valid after the file descriptor has been closed
+    ::close(fd);
+  }
+
+  void close() noexcept {
+    if (_data != nullptr) {
+      ::munmap(const_cast<char*>(_data), _size);
+    }
+  }
+#else
+  void open(const std::string& path) {
+    std::ifstream in;
+    in.exceptions(std::ios::failbit | std::ios::badbit);
+    in.open(path, std::ios::binary);
+    in.exceptions(std::ios::badbit);
+    _buffer.assign(std::istreambuf_iterator<char>(in), std::istreambuf_iterator<char>());
+    _data = _buffer.data();
+    _size = _buffer.size();
+  }
+
+  void close() noexcept {}
+
+  std::vector<char> _buffer;
+#endif
+
+  const char* _data = nullptr;
+  std::size_t _size = 0;
+};
+} // namespace xenium::detail
+
+#undef XENIUM_HAS_MMAP
+
+#endif
@@ -0,0 +1,92 @@
+//
+// Copyright (c) 2018-2020 Manuel Pöter.
+// Licensed under the MIT License. See LICENSE file in the project root for full license information.
+//
+
+#ifndef XENIUM_DETAIL_NIKOLAEV_RING_HPP
+#define XENIUM_DETAIL_NIKOLAEV_RING_HPP
+
+#include <xenium/detail/nikolaev_scq.hpp>
+#include <xenium/detail/nikolaev_wcq.hpp>
+
+#include <cstdint>
+
+namespace xenium {
+/**
+ * @brief Selects the lock-free SCQ ring proposed by Nikolaev \[[Nik19](index.html#ref-nikolaev-2019)\]
+ * for the internal queues of `nikolaev_queue` and `nikolaev_bounded_queue`.
+ */
+struct nikolaev_scq_ring {};
+
+/**
+ * @brief Selects the wait-free wCQ ring proposed by Nikolaev and Ravindran
+ * \[[NR22](index.html#ref-nikolaev-2022)\] for the internal queues of `nikolaev_queue` and
+ * `nikolaev_bounded_queue`.
+ *
+ * The wCQ ring requires a double-width CAS (`cmpxchg16b` on x86-64). Each ring reserves a
+ * record of 128 bytes for each of the `max_threads` threads that can use the slow path.
+ */
+struct nikolaev_wcq_ring {};
+
+namespace detail {
+  /**
+   * @brief Provides the common interface of the rings that can be selected for
+   * `nikolaev_queue` and `nikolaev_bounded_queue`.
+   *
+   * @tparam Ring either `nikolaev_scq_ring` or `nikolaev_wcq_ring`.
+   * @tparam Traits must define `max_threads`, `patience`, `help_delay` and `pop_retries`.
+   */
+  template <class Ring, class Traits>
+  class nikolaev_ring;
+
+  template <class Traits>
+  class nikolaev_ring<nikolaev_scq_ring, Traits> {
+  public:
+    using empty_tag = nikolaev_scq::empty_tag;
+    using full_tag = nikolaev_scq::full_tag;
+    using first_used_tag = nikolaev_scq::first_used_tag;
+    using first_empty_tag = nikolaev_scq::first_empty_tag;
+
+    static constexpr bool is_wait_free = false;
+
+    template <class Tag>
+    nikolaev_ring(std::size_t capacity, Tag tag) :
+        _capacity(capacity),
+        _remap_shift(nikolaev_scq::calc_remap_shift(capacity)),
+        _ring(capacity, _remap_shift, tag) {}
+
+    template <bool Finalizable>
+    bool enqueue(std::uint64_t value) {
+      return _ring.template enqueue<false, Finalizable>(value, _capacity, _remap_shift);
+    }
+
+    bool dequeue(std::uint64_t& value) {
+      return _ring.template dequeue<false, Traits::pop_retries>(value, _capacity, _remap_shift);
+    }
+
+    void finalize() { _ring.finalize(); }
+    void set_threshold(std::int64_t v) { _ring.set_threshold(v); }
+
+  private:
+    const std::size_t _capacity;
+    const std::size_t _remap_shift;
+    nikolaev_scq _ring;
+  };
+
+  template <class Traits>
+  class nikolaev_ring<nikolaev_wcq_ring, Traits> : public nikolaev_wcq<Traits> {
+  public:
+    static constexpr bool is_wait_free = true;
+
+    using nikolaev_wcq<Traits>::nikolaev_wcq;
+
+    // the wCQ ring always checks whether it has been finalized
+    template <bool Finalizable>
+    bool enqueue(std::uint64_t value) {
+      return nikolaev_wcq<Traits>::enqueue(value);
+    }
+  };
+} // namespace detail
+} // namespace xenium
+
+#endif
@@ -0,0 +1,781 @@
+//
+// Copyright (c) 2018-2020 Manuel Pöter.
+// Licensed under the MIT License. See LICENSE file in the project root for full license information.
+//
+
+#ifndef XENIUM_DETAIL_NIKOLAEV_WCQ_HPP
+#define XENIUM_DETAIL_NIKOLAEV_WCQ_HPP
+
+#include <xenium/detail/double_width_cas.hpp>
+#include <xenium/detail/thread_index_registry.hpp>
+#include <xenium/utils.hpp>
+
+#include <atomic>
+#include <cassert>
+#include <cstdint>
+#include <memory>
+
+#ifdef _MSC_VER
+  #pragma warning(push)
+  #pragma warning(disable : 4324) // structure was padded due to alignment specifier
+#endif
+
+namespace xenium::detail {
+
+/**
+ * @brief A wait-free ring of indexes in the range `[0, capacity)`.
+ *
+ * This is the wait-free extension (wCQ) of the SCQ ring in `nikolaev_scq`, proposed by
+ * Nikolaev and Ravindran \[[NR22](index.html#ref-nikolaev-2022)\].
+ *
+ * Every operation first runs the lock-free SCQ algorithm (the _fast path_) for at most
+ * `Traits::patience` attempts. If it does not succeed, the thread publishes a request in
+ * its per-thread record and switches to the _slow path_. Every thread periodically (every
+ * `Traits::help_delay` operations) checks the record of another thread and helps to
+ * complete a pending request, so eventually all threads cooperate on a starving request
+ * and stop competing with it on the fast path.
+ *
+ * In the slow path all helpers of a request step through the same sequence of tickets:
+ * the global head/tail counter is incremented cooperatively in two phases (`slow_faa`),
+ * so every increment is applied at most once and the resulting ticket is recorded in the
+ * request. For enqueue requests, a per-entry `note` records that a ticket has been
+ * skipped, so that a lagging helper cannot use an entry for a ticket that the other
+ * helpers have already given up on. A value produced by the slow path is marked with a
+ * cleared `enq` bit until the request has been finalized; a dequeuer that encounters
+ * such an entry first finalizes the corresponding request.
+ *
+ * Entries and the head/tail counters are pairs of 64 bit words that are updated with a
+ * double-width CAS (see `atomic_word_pair`).
+ *
+ * Only threads that have been assigned an index by `thread_index_registry` (i.e., at most
+ * `Traits::max_threads` threads at the same time) have a per-thread record; all other
+ * threads only use the (lock-free) fast path.
+ *
+ * @tparam Traits must define `max_threads`, `patience`, `help_delay` and `pop_retries`.
+ */
+template <class Traits>
+class nikolaev_wcq {
+public:
+  struct empty_tag {};
+  struct full_tag {};
+  struct first_used_tag {};
+  struct first_empty_tag {};
+
+  static_assert(Traits::max_threads > 0, "max_threads must be greater than zero");
+  static_assert(Traits::patience > 0, "patience must be greater than zero");
+  static_assert(Traits::help_delay > 0, "help_delay must be greater than zero");
+
+  nikolaev_wcq(std::size_t capacity, empty_tag);
+  nikolaev_wcq(std::size_t capacity, full_tag);
+  nikolaev_wcq(std::size_t capacity, first_used_tag);
+  nikolaev_wcq(std::size_t capacity, first_empty_tag);
+
+  nikolaev_wcq(const nikolaev_wcq&) = delete;
+  nikolaev_wcq& operator=(const nikolaev_wcq&) = delete;
+
+  /**
+   * @brief Enqueues the given index.
+   * @return `true` if the operation was successful, `false` if the ring has been finalized.
+   */
+  bool enqueue(std::uint64_t value);
+
+  /**
+   * @brief Dequeues an index.
+   * @return `true` if the operation was successful, `false` if the ring is empty.
+   */
+  bool dequeue(std::uint64_t& value);
+
+  void finalize() { _tail.first.fetch_or(finalized, std::memory_order_relaxed); }
+  void set_threshold(std::int64_t v) { _threshold.store(v, std::memory_order_relaxed); }
+
+private:
+  using registry = thread_index_registry<Traits::max_threads>;
+
+  // each entry consists of two words, so four entries share a cacheline
+  static constexpr std::size_t entries_per_cacheline = 4;
+
+  // the LSB of the tail counter is used for finalization
+  static constexpr std::uint64_t finalized = 1;
+  static constexpr std::uint64_t index_inc = 2;
+
+  // flags of the local head/tail counters of a request
+  static constexpr std::uint64_t fin_flag = static_cast<std::uint64_t>(1) << 63;
+  static constexpr std::uint64_t inc_flag = static_cast<std::uint64_t>(1) << 62;
+
+  static constexpr unsigned record_bits = 20;
+  static constexpr std::uint64_t record_mask = (static_cast<std::uint64_t>(1) << record_bits) - 1;
+  static_assert(Traits::max_threads < record_mask, "max_threads is too large");
+
+  struct phase2_record {
+    std::atomic<std::uint64_t> seq1{1};
+    std::atomic<std::atomic<std::uint64_t>*> local{nullptr};
+    std::atomic<std::uint64_t> cnt{0};
+    std::atomic<std::uint64_t> seq2{0};
+  };
+
+  struct alignas(64) thread_record {
+    // private fields - only accessed by the thread that owns this record
+    unsigned next_check = Traits::help_delay;
+    std::size_t next_tid = 0;
+
+    // shared fields
+    std::atomic<std::uint64_t> seq1{1};
+    std::atomic<bool> enqueue{false};
+    std::atomic<bool> pending{false};
+    std::atomic<std::uint64_t> local_tail{fin_flag};
+    std::atomic<std::uint64_t> init_tail{fin_flag};
+    std::atomic<std::uint64_t> local_head{fin_flag};
+    std::atomic<std::uint64_t> init_head{fin_flag};
+    std::atomic<std::uint64_t> index{0};
+    phase2_record phase2;
+    std::atomic<std::uint64_t> seq2{0};
+  };
+
+  enum class dequeue_result { success, empty, retry };
+
+  explicit nikolaev_wcq(std::size_t capacity);
+
+  // entry values are structured as follows
+  // 0..log2(capacity) bits        - index [0..capacity-1, nil (=2*capacity-1)]
+  // 1 bit                         - is_safe flag
+  // 1 bit                         - enq flag (cleared while a slow-path request is not finalized)
+  // log2(capacity) + 3..63 bits   - cycle
+  // The second word of an entry is the note, i.e., the last cycle in which the entry has
+  // been skipped by a slow-path enqueue.
+  [[nodiscard]] std::uint64_t nil() const { return _capacity * 2 - 1; }
+  [[nodiscard]] std::uint64_t safe_bit() const { return _capacity * 2; }
+  [[nodiscard]] std::uint64_t enq_bit() const { return _capacity * 4; }
+  [[nodiscard]] std::uint64_t cycle_mask() const { return ~(_capacity * 8 - 1); }
+  [[nodiscard]] std::uint64_t cycle(std::uint64_t counter) const { return (counter << 1) & cycle_mask(); }
+  [[nodiscard]] std::uint64_t entry_cycle(std::uint64_t entry) const { return entry & cycle_mask(); }
+  [[nodiscard]] bool is_empty(std::uint64_t entry) const { return (entry & nil()) == nil(); }
+  [[nodiscard]] std::int64_t max_threshold() const { return static_cast<std::int64_t>(_capacity) * 3 - 1; }
+
+  [[nodiscard]] std::size_t remap_index(std::uint64_t counter) const {
+    const std::uint64_t n = _capacity * 2;
+    const std::uint64_t idx = counter >> 1;
+    return static_cast<std::size_t>(((idx & (n - 1)) >> _remap_shift) | ((idx * entries_per_cacheline) & (n - 1)));
+  }
+
+  static std::int64_t diff(std::uint64_t a, std::uint64_t b) { return static_cast<std::int64_t>(a - b); }
+
+  thread_record* local_record() {
+    const auto idx = registry::index();
+    return idx == registry::invalid_index ? nullptr : &_records[idx];
+  }
+
+  void reset_threshold() {
+    if (_threshold.load(std::memory_order_relaxed) != max_threshold()) {
+      _threshold.store(max_threshold(), std::memory_order_relaxed);
+    }
+  }
+
+  bool try_enq(std::uint64_t tail, std::uint64_t value);
+  dequeue_result try_deq(std::uint64_t head, std::uint64_t& value);
+  void consume(std::uint64_t head, std::size_t idx, std::uint64_t entry);
+  void catchup(std::uint64_t tail, std::uint64_t head);
+
+  bool enqueue_slow_path(std::uint64_t tail, std::uint64_t value, thread_record& self);
+  bool dequeue_slow_path(std::uint64_t head, std::uint64_t& value, thread_record& self);
+
+  void help_threads(thread_record& self);
+  void enqueue_slow(std::uint64_t tail, std::uint64_t value, thread_record& r, std::uint64_t seq, thread_record& self);
+  void dequeue_slow(std::uint64_t head, thread_record& r, std::uint64_t seq, thread_record& self);
+  bool try_enq_slow(std::uint64_t tail, std::uint64_t value, thread_record& r);
+  bool finish_enq_slow(std::uint64_t tail, std::size_t idx, std::uint64_t entry, thread_record& r);
+  bool try_deq_slow(std::uint64_t head, thread_record& r);
+  void finalize_request(std::uint64_t tail);
+
+  bool slow_faa(atomic_word_pair& global,
+                std::atomic<std::uint64_t>& local,
+                std::uint64_t& v,
+                const thread_record& r,
+                std::uint64_t seq,
+                thread_record& self,
+                bool is_head);
+  bool load_global_help_phase2(atomic_word_pair& global, std::atomic<std::uint64_t>& local, std::uint64_t& cnt);
+  void help_phase2(atomic_word_pair& global, std::uint64_t cnt, std::uint64_t tag);
+  std::uint64_t prepare_phase2(thread_record& self, std::atomic<std::uint64_t>& local, std::uint64_t cnt);
+
+  // A phase2 tag consists of the (1-based) index of the owner's record and the sequence
+  // number of its phase2 record, so a tag uniquely identifies a single increment.
+  static std::uint64_t make_tag(std::uint64_t record, std::uint64_t seq) { return (seq << record_bits) | record; }
+
+  const std::uint64_t _capacity;
+  const unsigned _remap_shift;
+  // the first word of head/tail is the counter, the second word is the phase2 tag of a
+  // pending slow-path increment (if any)
+  alignas(64) atomic_word_pair _head;
+  alignas(64) std::atomic<std::int64_t> _threshold;
+  alignas(64) atomic_word_pair _tail;
+  alignas(64) std::unique_ptr<atomic_word_pair[]> _entries;
+  std::unique_ptr<thread_record[]> _records;
+};
+
+template <class Traits>
+nikolaev_wcq<Traits>::nikolaev_wcq(std::size_t capacity) :
+    _capacity(capacity),
+    _remap_shift(utils::find_last_bit_set(capacity / entries_per_cacheline)),
+    _threshold(-1),
+    _entries(new atomic_word_pair[capacity * 2]),
+    _records(new thread_record[Traits::max_threads]) {
+  assert(capacity > 0 && utils::is_power_of_two(capacity));
+  for (std::size_t i = 0; i < capacity * 2; ++i) {
+    _entries[i].first.store(static_cast<std::uint64_t>(-1), std::memory_order_relaxed);
+    _entries[i].second.store(cycle_mask(), std::memory_order_relaxed);
+  }
+}
+
+template <class Traits>
+nikolaev_wcq<Traits>::nikolaev_wcq(std::size_t capacity, empty_tag) : nikolaev_wcq(capacity) {}
+
+template <class Traits>
+nikolaev_wcq<Traits>::nikolaev_wcq(std::size_t capacity, full_tag) : nikolaev_wcq(capacity) {
+  for (std::size_t i = 0; i < capacity; ++i) {
+    _entries[remap_index(i << 1)].first.store(enq_bit() | safe_bit() | i, std::memory_order_relaxed);
+  }
+  _tail.first.store(capacity * index_inc, std::memory_order_relaxed);
+  _threshold.store(max_threshold(), std::memory_order_relaxed);
+}
+
+template <class Traits>
+nikolaev_wcq<Traits>::nikolaev_wcq(std::size_t capacity, first_used_tag) : nikolaev_wcq(capacity) {
+  _entries[remap_index(0)].first.store(enq_bit() | safe_bit(), std::memory_order_relaxed);
+  _tail.first.store(index_inc, std::memory_order_relaxed);
+  _threshold.store(max_threshold(), std::memory_order_relaxed);
+}
+
+template <class Traits>
+nikolaev_wcq<Traits>::nikolaev_wcq(std::size_t capacity, first_empty_tag) : nikolaev_wcq(capacity) {
+  for (std::size_t i = 1; i < capacity; ++i) {
+    _entries[remap_index(i << 1)].first.store(enq_bit() | safe_bit() | i, std::memory_order_relaxed);
+  }
+  _head.first.store(index_inc, std::memory_order_relaxed);
+  _tail.first.store(capacity * index_inc, std::memory_order_relaxed);
+  _threshold.store(max_threshold(), std::memory_order_relaxed);
+}
+
+template <class Traits>
+bool nikolaev_wcq<Traits>::enqueue(std::uint64_t value) {
+  assert(value < _capacity);
+  thread_record* self = local_record();
+  if (self != nullptr) {
+    help_threads(*self);
+  }
+
+  for (unsigned attempt = 0;;) {
+    const auto tail = _tail.first.fetch_add(index_inc, std::memory_order_relaxed);
+    if (tail & finalized) {
+      return false;
+    }
+    if (try_enq(tail, value)) {
+      reset_threshold();
+      return true;
+    }
+    if (++attempt >= Traits::patience && self != nullptr) {
+      return enqueue_slow_path(tail, value, *self);
+    }
+  }
+}
+
+template <class Traits>
+bool nikolaev_wcq<Traits>::dequeue(std::uint64_t& value) {
+  if (_threshold.load(std::memory_order_relaxed) < 0) {
+    return false;
+  }
+
+  thread_record* self = local_record();
+  if (self != nullptr) {
+    help_threads(*self);
+  }
+
+  for (unsigned attempt = 0;;) {
+    const auto head = _head.first.fetch_add(index_inc, std::memory_order_relaxed);
+    const auto result = try_deq(head, value);
+    if (result != dequeue_result::retry) {
+      return result == dequeue_result::success;
+    }
+    if (++attempt >= Traits::patience && self != nullptr) {
+      return dequeue_slow_path(head, value, *self);
+    }
+  }
+}
+
+template <class Traits>
+bool nikolaev_wcq<Traits>::try_enq(std::uint64_t tail, std::uint64_t value) {
+  const auto tail_cycle = cycle(tail);
+  auto& entry = _entries[remap_index(tail)].first;
+  // (1) - this acquire-load synchronizes-with the release-fetch_or (4) and the release-CAS (5)
+  auto e = entry.load(std::memory_order_acquire);
+  while (diff(entry_cycle(e), tail_cycle) < 0 && is_empty(e) &&
+         ((e & safe_bit()) != 0 || diff(_head.first.load(std::memory_order_relaxed), tail) <= 0)) {
+    // (2) - this release-CAS synchronizes-with the acquire-load (3) and the acquire-CAS (5)
+    if (entry.compare_exchange_weak(
+          e, tail_cycle | enq_bit() | safe_bit() | value, std::memory_order_release, std::memory_order_relaxed)) {
+      return true;
+    }
+  }
+  return false;
+}
+
+template <class Traits>
+auto nikolaev_wcq<Traits>::try_deq(std::uint64_t head, std::uint64_t& value) -> dequeue_result {
+  const auto head_cycle = cycle(head);
+  const auto idx = remap_index(head);
+  auto& entry = _entries[idx].first;
+  unsigned attempt = 0;
+
+retry:
+  // (3) - this acquire-load synchronizes-with the release-CAS (2) and the double-width CAS
+  //       in try_enq_slow
+  auto e = entry.load(std::memory_order_acquire);
+  while (diff(entry_cycle(e), head_cycle) <= 0) {
+    if (entry_cycle(e) == head_cycle) {
+      // tickets are unique, so the entry must contain the value for our ticket
+      assert(!is_empty(e));
+      consume(head, idx, e);
+      value = e & nil();
+      assert(value < _capacity);
+      return dequeue_result::success;
+    }
+
+    std::uint64_t new_entry;
+    if (!is_empty(e)) {
+      // the entry is still occupied by a value from an older cycle - mark it as unsafe
+      new_entry = e & ~safe_bit();
+      if (new_entry == e) {
+        break;
+      }
+    } else {
+      const auto tail = _tail.first.load(std::memory_order_relaxed);
+      if (diff(tail, head + index_inc) > 0 && ++attempt <= Traits::pop_retries) {
+        // there is a pending enqueue operation that might use this entry
+        goto retry;
+      }
+      new_entry = head_cycle | enq_bit() | safe_bit() | nil();
+    }
+
+    // (5) - in case of success, this release-CAS synchronizes with the acquire-load (1),
+    //       in case of failure, this acquire-CAS synchronizes with the release-CAS (2)
+    // It would be sufficient to use release for the success order, but this triggers a
+    // false positive in TSan (see https://github.com/google/sanitizers/issues/1264)
+    if (entry.compare_exchange_weak(e, new_entry, std::memory_order_acq_rel, std::memory_order_acquire)) {
+      break;
+    }
+  }
+
+  const auto tail = _tail.first.load(std::memory_order_relaxed);
+  if (diff(tail, head + index_inc) <= 0) {
+    catchup(tail, head + index_inc);
+    _threshold.fetch_sub(1, std::memory_order_relaxed);
+    return dequeue_result::empty;
+  }
+
+  if (_threshold.fetch_sub(1, std::memory_order_relaxed) <= 0) {
+    return dequeue_result::empty;
+  }
+  return dequeue_result::retry;
+}
+
+template <class Traits>
+void nikolaev_wcq<Traits>::consume(std::uint64_t head, std::size_t idx, std::uint64_t entry) {
+  if ((entry & enq_bit()) == 0) {
+    // the value has been produced by a slow-path enqueue that has not yet been finalized;
+    // we have to finalize it before we consume the value, otherwise the helpers of that
+    // request would consider this ticket as skipped and produce the value again.
+    finalize_request(head);
+  }
+  // (4) - this release-fetch_or synchronizes-with the acquire-load (1)
+  _entries[idx].first.fetch_or(nil(), std::memory_order_release);
+}
+
+template <class Traits>
+void nikolaev_wcq<Traits>::catchup(std::uint64_t tail, std::uint64_t head) {
+  // the finalized flag must be preserved, otherwise subsequent enqueue operations could
+  // succeed on a ring that has already been abandoned by the dequeuers.
+  while (!_tail.first.compare_exchange_weak(tail, head | (tail & finalized), std::memory_order_relaxed)) {
+    head = _head.first.load(std::memory_order_relaxed);
+    if (diff(tail, head) >= 0) {
+      break;
+    }
+  }
+}
+
+template <class Traits>
+void nikolaev_wcq<Traits>::finalize_request(std::uint64_t tail) {
+  // only the request that has produced the value can have this ticket as local tail
+  for (std::size_t i = 0; i < Traits::max_threads; ++i) {
+    auto& local_tail = _records[i].local_tail;
+    auto expected = tail;
+    if (local_tail.load(std::memory_order_relaxed) == tail &&
+        local_tail.compare_exchange_strong(expected, tail | fin_flag, std::memory_order_relaxed)) {
+      return;
+    }
+  }
+}
+
+template <class Traits>
+bool nikolaev_wcq<Traits>::enqueue_slow_path(std::uint64_t tail, std::uint64_t value, thread_record& self) {
+  const auto seq = self.seq1.load(std::memory_order_relaxed);
+  // order the initialization of the request after the completion of our previous request
+  std::atomic_thread_fence(std::memory_order_release);
+  self.local_tail.store(tail, std::memory_order_relaxed);
+  self.init_tail.store(tail, std::memory_order_relaxed);
+  self.index.store(value, std::memory_order_relaxed);
+  self.enqueue.store(true, std::memory_order_relaxed);
+  self.seq2.store(seq, std::memory_order_release);
+  // (6) - this release-store synchronizes-with the acquire-load (7)
+  self.pending.store(true, std::memory_order_release);
+
+  enqueue_slow(tail, value, self, seq, self);
+
+  self.pending.store(false, std::memory_order_relaxed);
+  self.seq1.store(seq + 1, std::memory_order_release);
+
+  const auto local_tail = self.local_tail.load(std::memory_order_acquire);
+  assert(local_tail & fin_flag);
+  if (local_tail & finalized) {
+    // the request has been aborted because the ring has been finalized
+    return false;
+  }
+  reset_threshold();
+  return true;
+}
+
+template <class Traits>
+bool nikolaev_wcq<Traits>::dequeue_slow_path(std::uint64_t head, std::uint64_t& value, thread_record& self) {
+  const auto seq = self.seq1.load(std::memory_order_relaxed);
+  // order the initialization of the request after the completion of our previous request
+  std::atomic_thread_fence(std::memory_order_release);
+  self.local_head.store(head, std::memory_order_relaxed);
+  self.init_head.store(head, std::memory_order_relaxed);
+  self.enqueue.store(false, std::memory_order_relaxed);
+  self.seq2.store(seq, std::memory_order_release);
+  // (6) - this release-store synchronizes-with the acquire-load (7)
+  self.pending.store(true, std::memory_order_release);
+
+  dequeue_slow(head, self, seq, self);
+
+  self.pending.store(false, std::memory_order_relaxed);
+  self.seq1.store(seq + 1, std::memory_order_release);
+
+  // the helpers have finalized the request either at a ticket that contains a value, or
+  // at a ticket after which the ring was found to be empty.
+  const auto local_head = self.local_head.load(std::memory_order_acquire);
+  assert(local_head & fin_flag);
+  head = local_head & ~fin_flag;
+  const auto idx = remap_index(head);
+  // (8) - this acquire-load synchronizes-with the release-CAS (2) and the double-width CAS
+  //       in try_enq_slow
+  const auto e = _entries[idx].first.load(std::memory_order_acquire);
+  if (entry_cycle(e) == cycle(head) && !is_empty(e)) {
+    consume(head, idx, e);
+    value = e & nil();
+    assert(value < _capacity);
+    return true;
+  }
+  return false;
+}
+
+template <class Traits>
+void nikolaev_wcq<Traits>::help_threads(thread_record& self) {
+  if (--self.next_check != 0) {
+    return;
+  }
+  self.next_check = Traits::help_delay;
+
+  auto& r = _records[self.next_tid];
+  self.next_tid = (self.next_tid + 1) % Traits::max_threads;
+  // (7) - this acquire-load synchronizes-with the release-store (6)
+  if (&r == &self || !r.pending.load(std::memory_order_acquire)) {
+    return;
+  }
+
+  // the request fields are protected by a seqlock - seq1 is incremented when the
+  // request is completed, so if it still matches seq2 we have read a consistent request.
+  const auto seq = r.seq2.load(std::memory_order_acquire);
+  const bool enqueue = r.enqueue.load(std::memory_order_relaxed);
+  const auto index = r.index.load(std::memory_order_relaxed);
+  const auto init_tail = r.init_tail.load(std::memory_order_relaxed);
+  const auto init_head = r.init_head.load(std::memory_order_relaxed);
+  std::atomic_thread_fence(std::memory_order_acquire);
+  if (r.seq1.load(std::memory_order_relaxed) != seq) {
+    return;
+  }
+
+  if (enqueue) {
+    enqueue_slow(init_tail, index, r, seq, self);
+  } else {
+    dequeue_slow(init_head, r, seq, self);
+  }
+}
+
+template <class Traits>
+void nikolaev_wcq<Traits>::enqueue_slow(
+  std::uint64_t tail, std::uint64_t value, thread_record& r, std::uint64_t seq, thread_record& self) {
+  while (slow_faa(_tail, r.local_tail, tail, r, seq, self, false)) {
+    if (try_enq_slow(tail, value, r)) {
+      break;
+    }
+  }
+}
+
+template <class Traits>
+void nikolaev_wcq<Traits>::dequeue_slow(std::uint64_t head, thread_record& r, std::uint64_t seq, thread_record& self) {
+  while (slow_faa(_head, r.local_head, head, r, seq, self, true)) {
+    if (try_deq_slow(head, r)) {
+      break;
+    }
+  }
+}
+
+template <class Traits>
+bool nikolaev_wcq<Traits>::try_enq_slow(std::uint64_t tail, std::uint64_t value, thread_record& r) {
+  const auto tail_cycle = cycle(tail);
+  const auto idx = remap_index(tail);
+  auto& entry = _entries[idx];
+  auto e = entry.first.load(std::memory_order_acquire);
+  auto note = entry.second.load(std::memory_order_relaxed);
+  for (;;) {
+    if (diff(entry_cycle(e), tail_cycle) >= 0) {
+      if (entry_cycle(e) == tail_cycle && !is_empty(e)) {
+        // tickets are unique, so this must be our value that has been produced by some other helper
+        return finish_enq_slow(tail, idx, e, r);
+      }
+      // the entry has already been used for this (or a later) cycle by a dequeuer
+      return false;
+    }
+
+    if (diff(note, tail_cycle) >= 0) {
+      // some other helper has already decided to skip this ticket
+      return false;
+    }
+
+    if (is_empty(e) &&
+        ((e & safe_bit()) != 0 || diff(_head.first.load(std::memory_order_relaxed), tail) <= 0)) {
+      // produce the value, but leave the enq bit cleared until the request is finalized
+      const auto new_entry = tail_cycle | safe_bit() | value;
+      if (entry.compare_exchange(e, note, new_entry, note)) {
+        return finish_enq_slow(tail, idx, new_entry, r);
+      }
+    } else if (entry.compare_exchange(e, note, e, tail_cycle)) {
+      // the entry cannot be used - record in the note that we skip this ticket, so that
+      // lagging helpers do not use the entry for this ticket later on.
+      return false;
+    }
+  }
+}
+
+template <class Traits>
+bool nikolaev_wcq<Traits>::finish_enq_slow(std::uint64_t tail,
+                                           std::size_t idx,
+                                           std::uint64_t entry,
+                                           thread_record& r) {
+  auto expected = tail;
+  if (!r.local_tail.compare_exchange_strong(expected, tail | fin_flag, std::memory_order_relaxed)) {
+    // someone else has finalized the request, or we are a lagging helper of an old request
+    return (expected & fin_flag) != 0;
+  }
+
+  // we have finalized the request, so we can now set the enq bit, unless the value has
+  // already been consumed.
+  auto& e = _entries[idx].first;
+  while (entry_cycle(entry) == cycle(tail) && !is_empty(entry) && (entry & enq_bit()) == 0) {
+    if (e.compare_exchange_weak(entry, entry | enq_bit(), std::memory_order_release, std::memory_order_relaxed)) {
+      break;
+    }
+  }
+  return true;
+}
+
+template <class Traits>
+bool nikolaev_wcq<Traits>::try_deq_slow(std::uint64_t head, thread_record& r) {
+  const auto head_cycle = cycle(head);
+  auto& entry = _entries[remap_index(head)].first;
+  auto e = entry.load(std::memory_order_acquire);
+  bool has_value = false;
+  while (diff(entry_cycle(e), head_cycle) <= 0) {
+    if (entry_cycle(e) == head_cycle) {
+      // either the value for our ticket, or the entry has already been skipped by some other helper
+      has_value = !is_empty(e);
+      break;
+    }
+
+    std::uint64_t new_entry;
+    if (!is_empty(e)) {
+      new_entry = e & ~safe_bit();
+      if (new_entry == e) {
+        break;
+      }
+    } else {
+      new_entry = head_cycle | enq_bit() | safe_bit() | nil();
+    }
+
+    if (entry.compare_exchange_weak(e, new_entry, std::memory_order_acq_rel, std::memory_order_acquire)) {
+      break;
+    }
+  }
+
+  // at this point the entry either contains the value for our ticket, or it can no longer
+  // be used by an enqueue operation with the same ticket.
+  if (!has_value) {
+    const auto tail = _tail.first.load(std::memory_order_relaxed);
+    if (diff(tail, head + index_inc) <= 0) {
+      catchup(tail, head + index_inc);
+    } else if (_threshold.load(std::memory_order_relaxed) >= 0) {
+      // the ring is not empty - continue with the next ticket
+      return false;
+    }
+  }
+
+  // finalize the request - the owner retrieves the value (if any) from the entry
+  auto expected = head;
+  if (r.local_head.compare_exchange_strong(expected, head | fin_flag, std::memory_order_relaxed)) {
+    return true;
+  }
+  return (expected & fin_flag) != 0;
+}
+
+template <class Traits>
+bool nikolaev_wcq<Traits>::slow_faa(atomic_word_pair& global,
+                                    std::atomic<std::uint64_t>& local,
+                                    std::uint64_t& v,
+                                    const thread_record& r,
+                                    std::uint64_t seq,
+                                    thread_record& self,
+                                    bool is_head) {
+  // Increments the global counter cooperatively on behalf of the request with the given
+  // local counter. `v` is the last ticket of the request that has been processed by this
+  // helper. The increment is performed in two phases:
+  //  1. a helper announces a tentative ticket cnt by setting the request's local counter
+  //     to cnt|inc_flag. Then all helpers try to increment the global counter from cnt to
+  //     cnt + index_inc with a double-width CAS that also installs a tag that identifies
+  //     the helper's phase2 record. If the global counter has moved on in the meantime
+  //     (e.g., due to a fast-path operation), the tentative ticket is replaced.
+  //  2. once the global counter has been incremented, the inc_flag is cleared, so the
+  //     ticket is committed. Any thread that finds a phase2 tag in the global counter
+  //     completes phase 2 before it proceeds, so a committed ticket cannot get lost.
+  // Returns false if the request has been finalized.
+  std::uint64_t cnt;
+  if (!load_global_help_phase2(global, local, cnt)) {
+    return false;
+  }
+
+  auto expected = v;
+  if (!is_head && (cnt & finalized)) {
+    // the ring has been finalized - abort the request
+    if (local.compare_exchange_strong(
+          expected, v | fin_flag | finalized, std::memory_order_acquire, std::memory_order_acquire)) {
+      return false;
+    }
+  } else if (local.compare_exchange_strong(
+               expected, cnt | inc_flag, std::memory_order_acq_rel, std::memory_order_acquire)) {
+    expected = cnt | inc_flag;
+  }
+
+  for (;;) {
+    if (expected & fin_flag) {
+      return false;
+    }
+    if ((expected & inc_flag) == 0) {
+      // some other helper has already committed the next ticket - but before we use it,
+      // we have to check that it actually belongs to the request we are helping.
+      if (r.seq1.load(std::memory_order_acquire) != seq) {
+        return false;
+      }
+      v = expected;
+      return true;
+    }
+
+    cnt = expected & ~inc_flag;
+    const auto tag = prepare_phase2(self, local, cnt);
+    std::uint64_t global_cnt = cnt;
+    std::uint64_t global_tag = 0;
+    if (global.compare_exchange(global_cnt, global_tag, cnt + index_inc, tag)) {
+      if (is_head) {
+        _threshold.fetch_sub(1, std::memory_order_relaxed);
+      }
+      auto tentative = cnt | inc_flag;
+      local.compare_exchange_strong(tentative, cnt, std::memory_order_release, std::memory_order_relaxed);
+      // try to remove our tag - if this fails, some other thread has already done it
+      global_cnt = cnt + index_inc;
+      global_tag = tag;
+      global.compare_exchange(global_cnt, global_tag, cnt + index_inc, 0);
+      expected = local.load(std::memory_order_acquire);
+      continue;
+    }
+
+    if (global_tag != 0) {
+      help_phase2(global, global_cnt, global_tag);
+    } else if (!is_head && (global_cnt & finalized)) {
+      // the tentative ticket has not been committed, so it is safe to abort the request
+      local.compare_exchange_strong(
+        expected, cnt | fin_flag | finalized, std::memory_order_acquire, std::memory_order_acquire);
+      continue;
+    } else if (diff(global_cnt, cnt) > 0) {
+      // The global counter has moved on, so no increment from cnt can succeed anymore.
+      // An increment that has succeeded before has also been committed, because a tag is
+      // only removed after phase 2 has been completed.
+      if (local.compare_exchange_strong(
+            expected, global_cnt | inc_flag, std::memory_order_acq_rel, std::memory_order_acquire)) {
+        expected = global_cnt | inc_flag;
+      }
+      continue;
+    }
+    expected = local.load(std::memory_order_acquire);
+  }
+}
+
+template <class Traits>
+bool nikolaev_wcq<Traits>::load_global_help_phase2(atomic_word_pair& global,
+                                                   std::atomic<std::uint64_t>& local,
+                                                   std::uint64_t& cnt) {
+  for (;;) {
+    if (local.load(std::memory_order_relaxed) & fin_flag) {
+      return false;
+    }
+    std::uint64_t tag;
+    global.load(cnt, tag);
+    if (tag == 0) {
+      return true;
+    }
+    help_phase2(global, cnt, tag);
+  }
+}
+
+template <class Traits>
+void nikolaev_wcq<Traits>::help_phase2(atomic_word_pair& global, std::uint64_t cnt, std::uint64_t tag) {
+  auto& phase2 = _records[(tag & record_mask) - 1].phase2;
+  const auto seq = phase2.seq2.load(std::memory_order_acquire);
+  auto* local = phase2.local.load(std::memory_order_relaxed);
+  const auto local_cnt = phase2.cnt.load(std::memory_order_relaxed);
+  std::atomic_thread_fence(std::memory_order_acquire);
+  // The owner can reuse its phase2 record once phase 2 has been completed, so we might
+  // read a newer version of the record than the one identified by the tag. In that case
+  // the increment has already been committed and there is nothing left to do.
+  if (phase2.seq1.load(std::memory_order_relaxed) == seq && make_tag(tag & record_mask, seq) == tag) {
+    auto tentative = local_cnt | inc_flag;
+    local->compare_exchange_strong(tentative, local_cnt, std::memory_order_release, std::memory_order_relaxed);
+  }
+  global.compare_exchange(cnt, tag, cnt, 0);
+}
+
+template <class Traits>
+std::uint64_t
+  nikolaev_wcq<Traits>::prepare_phase2(thread_record& self, std::atomic<std::uint64_t>& local, std::uint64_t cnt) {
+  auto& phase2 = self.phase2;
+  const auto seq = phase2.seq1.load(std::memory_order_relaxed) + 1;
+  phase2.seq1.store(seq, std::memory_order_relaxed);
+  std::atomic_thread_fence(std::memory_order_release);
+  phase2.local.store(&local, std::memory_order_relaxed);
+  phase2.cnt.store(cnt, std::memory_order_relaxed);
+  phase2.seq2.store(seq, std::memory_order_release);
+  return make_tag(static_cast<std::uint64_t>(&self - _records.get()) + 1, seq);
+}
+} // namespace xenium::detail
+
+#ifdef _MSC_VER
+  #pragma warning(pop)
+#endif
+
+#endif
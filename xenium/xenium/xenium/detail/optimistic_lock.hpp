@@ -0,0 +1,114 @@
+//
+// Copyright (c) 2018-2020 Manuel Pöter.
+// Licensed under the MIT License. See LICENSE file in the project root for full license information.
+//
+
+#ifndef XENIUM_DETAIL_OPTIMISTIC_LOCK_HPP
+#define XENIUM_DETAIL_OPTIMISTIC_LOCK_HPP
+
+#include <atomic>
+#include <cassert>
+#include <cstdint>
+
+namespace xenium::detail {
+
+/**
+ * A version lock for optimistic lock coupling.
+ *
+ * Like the sequence counter in `seqlock`, the version is incremented by every write operation, so
+ * readers can read the protected data without acquiring the lock and validate afterwards that the
+ * version has not changed in the meantime. In addition, a node can be marked as obsolete when the
+ * writer releases the lock; readers and writers that encounter an obsolete node have to restart.
+ *
+ * The protected data itself must be stored in atomics that are accessed with relaxed operations;
+ * the required ordering is established by the fences in `validate` and `try_upgrade`.
+ */
+class optimistic_lock {
+public:
+  using version_t = std::uint64_t;
+
+  /**
+   * Waits until the lock is not held by a writer and returns the current version in `version`.
+   * @return `false` if the node is obsolete, otherwise `true`
+   */
+  bool read_lock(version_t& version) const {
+    // (1) - this acquire-load synchronizes-with the release-store (5, 6)
+    version = _version.load(std::memory_order_acquire);
+    while (is_locked(version)) {
+      // (2) - this acquire-load synchronizes-with the release-store (5, 6)
+      version = _version.load(std::memory_order_acquire);
+    }
+    return !is_obsolete(version);
+  }
+
+  /**
+   * Checks whether the version is still the same, i.e., all data read since `read_lock`
+   * returned `version` form a consistent snapshot.
+   */
+  [[nodiscard]] bool validate(version_t version) const {
+    // (3) - this acquire-fence synchronizes-with the release-fence (4)
+    std::atomic_thread_fence(std::memory_order_acquire);
+    // This fence prevents the preceding relaxed-loads of the protected data from being reordered
+    // with the subsequent load of the version (see also `seqlock::read_data`).
+    return _version.load(std::memory_order_relaxed) == version;
+  }
+
+  /**
+   * Tries to acquire the write lock, provided that the version is still the same.
+   */
+  bool try_upgrade(version_t version) {
+    if (!_version.compare_exchange_strong(version, version + locked_bit, std::memory_order_acquire,
+                                          std::memory_order_relaxed)) {
+      return false;
+    }
+    // (4) - this release-fence synchronizes-with the acquire-fence (3)
+    std::atomic_thread_fence(std::memory_order_release);
+    return true;
+  }
+
+  /**
+   * Acquires the write lock; spins while the lock is held by another writer.
+   * @return `false` if the node is obsolete, otherwise `true`
+   */
+  bool write_lock() {
+    for (;;) {
+      version_t version;
+      if (!read_lock(version)) {
+        return false;
+      }
+      if (try_upgrade(version)) {
+        return true;
+      }
+    }
+  }
+
+  void write_unlock() {
+    auto version = _version.load(std::memory_order_relaxed);
+    assert(is_locked(version));
+    // (5) - this release-store synchronizes-with the acquire-load (1, 2)
+    _version.store(version + version_increment - locked_bit, std::memory_order_release);
+  }
+
+  /**
+   * Releases the write lock and marks the node as obsolete.
+   */
+  void write_unlock_obsolete() {
+    auto version = _version.load(std::memory_order_relaxed);
+    assert(is_locked(version));
+    // (6) - this release-store synchronizes-with the acquire-load (1, 2)
+    _version.store(version + version_increment - locked_bit + obsolete_bit, std::memory_order_release);
+  }
+
+private:
+  static constexpr version_t locked_bit = 1;
+  static constexpr version_t obsolete_bit = 2;
+  static constexpr version_t version_increment = 4;
+
+  static bool is_locked(version_t version) { return (version & locked_bit) != 0; }
+  static bool is_obsolete(version_t version) { return (version & obsolete_bit) != 0; }
+
+  std::atomic<version_t> _version{0};
+};
+} // namespace xenium::detail
+
+#endif
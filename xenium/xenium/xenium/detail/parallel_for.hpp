@@ -0,0 +1,60 @@
+//
+// Copyright (c) 2018-2020 Manuel Pöter.
+// Licensed under the MIT License. See LICENSE file in the project root for full license information.
+//
+
+#ifndef XENIUM_DETAIL_PARALLEL_FOR_HPP
+#define XENIUM_DETAIL_PARALLEL_FOR_HPP
+
+#include <cstddef>
+#include <exception>
+#include <thread>
+#include <vector>
+
+namespace xenium::detail {
+
+/**
+ * @brief Calls `func(i)` for every `i` in `[0, num_threads)`, each call in its own thread.
+ *
+ * The call with index 0 is performed by the calling thread. The function returns once all
+ * calls have finished; if any of them threw an exception, the exception of the call with
+ * the lowest index is rethrown.
+ */
+template <class Func>
+void parallel_for(std::size_t num_threads, Func&& func) {
+  std::vector<std::exception_ptr> errors(num_threads);
+  auto run = [&func, &errors](std::size_t idx) {
+    try {
+      func(idx);
+    } catch (...) {
+      errors[idx] = std::current_exception();
+    }
+  };
+
+  std::vector<std::thread> threads;
+  threads.reserve(num_threads);
+  try {
+    for (std::size_t i = 1; i < num_threads; ++i) {
+      threads.emplace_back(run, i);
+    }
+  } catch (...) {
+    for (auto& thread : threads) {
+      thread.join();
+    }
+    throw;
+  }
+
+  run(0);
+  for (auto& thread : threads) {
+    thread.join();
+  }
+
+  for (auto& error : errors) {
+    if (error) {
+      std::rethrow_exception(error);
+    }
+  }
+}
+} // namespace xenium::detail
+
+#endif
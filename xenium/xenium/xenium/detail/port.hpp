@@ -50,6 +50,16 @@
   #define XENIUM_UNLIKELY(x) x
 #endif
 
+#if defined(__has_builtin)
+  #if __has_builtin(__builtin_prefetch)
+    #define XENIUM_PREFETCH(addr) __builtin_prefetch(addr)
+  #endif
+#endif
+
+#if !defined(XENIUM_PREFETCH)
+  #define XENIUM_PREFETCH(addr) ((void)(addr))
+#endif
+
 #if !defined(XENIUM_ARCH_X86) && (defined(__x86_64__) || defined(_M_AMD64))
   #define XENIUM_ARCH_X86
 #endif
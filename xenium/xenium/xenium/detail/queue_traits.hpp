@@ -0,0 +1,59 @@
+//
+// Copyright (c) 2018-2020 Manuel Pöter.
+// Licensed under the MIT License. See LICENSE file in the project root for full license information.
+//
+
+#ifndef XENIUM_DETAIL_QUEUE_TRAITS_HPP
+#define XENIUM_DETAIL_QUEUE_TRAITS_HPP
+
+#include <type_traits>
+#include <utility>
+
+namespace xenium::detail {
+
+template <class Queue, class = void>
+struct is_unbounded_queue : std::false_type {};
+
+// unbounded queues provide an unconditional push, bounded ones only try_push
+template <class Queue>
+using push_result_t = decltype(std::declval<Queue&>().push(std::declval<typename Queue::value_type>()));
+
+template <class Queue>
+struct is_unbounded_queue<Queue, std::void_t<push_result_t<Queue>>> : std::true_type {};
+
+// Some bounded queues take the argument of try_push by value, so the value is moved into the
+// parameter and destroyed if the operation fails. try_push can then not be retried with the
+// same value unless the value type is trivially copyable. We cannot reliably detect a by-value
+// parameter if try_push is overloaded, so this check fails closed: try_push is only considered
+// to take its argument by reference if it is a single function with an rvalue reference
+// parameter, or a function template that is instantiated with one for value_type.
+template <class Queue>
+using try_push_by_reference_t = bool (Queue::*)(typename Queue::value_type&&);
+
+template <class Queue, class = void>
+struct is_try_push_function_by_reference : std::false_type {};
+
+template <class Queue>
+struct is_try_push_function_by_reference<Queue, std::void_t<decltype(&Queue::try_push)>> :
+    std::is_same<decltype(&Queue::try_push), try_push_by_reference_t<Queue>> {};
+
+template <class Queue, class = void>
+struct is_try_push_template_by_reference : std::false_type {};
+
+template <class Queue>
+struct is_try_push_template_by_reference<
+  Queue,
+  std::void_t<decltype(static_cast<try_push_by_reference_t<Queue>>(
+    &Queue::template try_push<typename Queue::value_type>))>> : std::true_type {};
+
+template <class Queue>
+inline constexpr bool is_try_push_by_reference =
+  is_try_push_function_by_reference<Queue>::value || is_try_push_template_by_reference<Queue>::value;
+
+template <class Queue>
+inline constexpr bool is_try_push_retryable =
+  is_try_push_by_reference<Queue> || std::is_trivially_copyable_v<typename Queue::value_type>;
+
+} // namespace xenium::detail
+
+#endif
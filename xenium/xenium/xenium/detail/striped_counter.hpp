@@ -0,0 +1,132 @@
+//
+// Copyright (c) 2018-2020 Manuel Pöter.
+// Licensed under the MIT License. See LICENSE file in the project root for full license information.
+//
+
+#ifndef XENIUM_DETAIL_STRIPED_COUNTER_HPP
+#define XENIUM_DETAIL_STRIPED_COUNTER_HPP
+
+#include <xenium/utils.hpp>
+
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <thread>
+#include <utility>
+
+#ifdef _MSC_VER
+  #pragma warning(push)
+  #pragma warning(disable : 4324) // structure was padded due to alignment specifier
+#endif
+
+namespace xenium::detail {
+
+/**
+ * @brief A scalable counter for tracking the number of elements in a container.
+ *
+ * The counter is split into a number of cacheline-sized stripes and every thread
+ * updates the stripe it has been assigned to, so concurrent updates from different
+ * threads usually do not contend on the same cacheline.
+ * Each stripe consists of two monotonically increasing counters for increments and
+ * decrements, which allows `value` to detect whether a stripe has been modified while
+ * the stripes were summed up.
+ */
+class striped_counter {
+public:
+  striped_counter() :
+      _stripe_mask(utils::next_power_of_two(std::max(1u, std::thread::hardware_concurrency())) - 1),
+      _stripes(new stripe[_stripe_mask + 1]) {}
+
+  /**
+   * @brief Adds `n` to the stripe of the calling thread.
+   *
+   * @return the total number of increments of this stripe including the current one;
+   * this can be used to perform some action only on every n-th increment of a thread.
+   */
+  std::uint64_t increment(std::uint64_t n = 1) noexcept {
+    return local_stripe().inc.fetch_add(n, std::memory_order_relaxed) + n;
+  }
+  void decrement() noexcept { local_stripe().dec.fetch_add(1, std::memory_order_relaxed); }
+
+  /**
+   * @brief Returns the sum of all stripes without any synchronization.
+   *
+   * If the counter is concurrently updated the result does not necessarily correspond to
+   * a value the counter had at any particular point in time.
+   */
+  [[nodiscard]] std::size_t approximate_value() const noexcept {
+    std::uint64_t inc = 0;
+    std::uint64_t dec = 0;
+    for (std::size_t i = 0; i <= _stripe_mask; ++i) {
+      // we have to load dec before inc, otherwise we might see a decrement without
+      // the corresponding increment that was performed by another thread on the same stripe.
+      dec += _stripes[i].dec.load(std::memory_order_relaxed);
+      inc += _stripes[i].inc.load(std::memory_order_relaxed);
+    }
+    return inc > dec ? static_cast<std::size_t>(inc - dec) : 0;
+  }
+
+  /**
+   * @brief Returns the sum of all stripes as it was at some point during the call.
+   *
+   * This is implemented as a double-collect - the stripes are summed up repeatedly until
+   * two subsequent collects return the same sums. Since the per-stripe counters are
+   * monotonic, equal sums imply that no stripe has changed in between, i.e., all values
+   * were valid at the same time.
+   *
+   * If the counter is modified during each of `max_collects` collects, the result of the
+   * last collect is returned; this is the same approximation `approximate_value` provides.
+   * This way the operation cannot starve, even if other threads constantly update the counter.
+   */
+  [[nodiscard]] std::size_t value() const noexcept {
+    auto [inc, dec] = collect();
+    for (unsigned i = 1; i < max_collects; ++i) {
+      const auto [next_inc, next_dec] = collect();
+      if (next_inc == inc && next_dec == dec) {
+        break;
+      }
+      inc = next_inc;
+      dec = next_dec;
+    }
+    return inc > dec ? static_cast<std::size_t>(inc - dec) : 0;
+  }
+
+  // The maximum number of collects performed by `value`.
+  static constexpr unsigned max_collects = 16;
+
+private:
+  struct alignas(64) stripe {
+    std::atomic<std::uint64_t> inc{0};
+    std::atomic<std::uint64_t> dec{0};
+  };
+
+  std::pair<std::uint64_t, std::uint64_t> collect() const noexcept {
+    std::uint64_t inc = 0;
+    std::uint64_t dec = 0;
+    for (std::size_t i = 0; i <= _stripe_mask; ++i) {
+      dec += _stripes[i].dec.load(std::memory_order_acquire);
+      inc += _stripes[i].inc.load(std::memory_order_acquire);
+    }
+    return {inc, dec};
+  }
+
+  stripe& local_stripe() const noexcept { return _stripes[thread_index() & _stripe_mask]; }
+
+  static std::size_t thread_index() noexcept {
+    // threads are assigned to stripes in a round-robin fashion
+    static std::atomic<std::size_t> next_index{0};
+    static thread_local const std::size_t index = next_index.fetch_add(1, std::memory_order_relaxed);
+    return index;
+  }
+
+  const std::size_t _stripe_mask;
+  std::unique_ptr<stripe[]> _stripes;
+};
+} // namespace xenium::detail
+
+#ifdef _MSC_VER
+  #pragma warning(pop)
+#endif
+
+#endif
@@ -0,0 +1,64 @@
+//
+// Copyright (c) 2018-2020 Manuel Pöter.
+// Licensed under the MIT License. See LICENSE file in the project root for full license information.
+//
+
+#ifndef XENIUM_DETAIL_THREAD_INDEX_REGISTRY_HPP
+#define XENIUM_DETAIL_THREAD_INDEX_REGISTRY_HPP
+
+#include <atomic>
+#include <cstddef>
+
+namespace xenium::detail {
+
+/**
+ * @brief Assigns each thread a unique index in the range `[0, MaxThreads)`.
+ *
+ * A thread acquires the lowest free index on its first call to `index` and releases it
+ * when it terminates, so indexes are reused by threads that are created later. If all
+ * indexes are in use, the thread is assigned `invalid_index` instead.
+ *
+ * Acquiring an index takes at most `MaxThreads` steps, so `index` is wait-free.
+ */
+template <std::size_t MaxThreads>
+class thread_index_registry {
+public:
+  static constexpr std::size_t invalid_index = MaxThreads;
+
+  static std::size_t index() noexcept {
+    // a function-local thread_local avoids a GCC issue with multiple inline thread_local
+    // members that require dynamic initialization in the same translation unit.
+    thread_local slot local_slot;
+    return local_slot.index;
+  }
+
+private:
+  struct slot {
+    slot() noexcept : index(invalid_index) {
+      for (std::size_t i = 0; i < MaxThreads; ++i) {
+        // (1) - this acquire-exchange synchronizes-with the release-store (2)
+        if (!used[i].load(std::memory_order_relaxed) && !used[i].exchange(true, std::memory_order_acquire)) {
+          index = i;
+          break;
+        }
+      }
+    }
+
+    ~slot() {
+      if (index != invalid_index) {
+        // (2) - this release-store synchronizes-with the acquire-exchange (1)
+        used[index].store(false, std::memory_order_release);
+      }
+    }
+
+    slot(const slot&) = delete;
+    slot& operator=(const slot&) = delete;
+
+    std::size_t index;
+  };
+
+  inline static std::atomic<bool> used[MaxThreads]{};
+};
+} // namespace xenium::detail
+
+#endif
@@ -0,0 +1,517 @@
+//
+// Copyright (c) 2018-2020 Manuel Pöter.
+// Licensed under the MIT License. See LICENSE file in the project root for full license information.
+//
+
+#ifndef XENIUM_FELDMAN_HASH_MAP_HPP
+#define XENIUM_FELDMAN_HASH_MAP_HPP
+
+#include <xenium/acquire_guard.hpp>
+#include <xenium/backoff.hpp>
+#include <xenium/hash.hpp>
+#include <xenium/parameter.hpp>
+#include <xenium/policy.hpp>
+
+#include <cassert>
+#include <cstdint>
+#include <iterator>
+#include <memory>
+#include <stdexcept>
+#include <utility>
+
+namespace xenium {
+
+namespace policy {
+  /**
+   * @brief Policy to configure the number of hash bits that are used to index the head array
+   * in `feldman_hash_map`.
+   * @tparam Value
+   */
+  template <unsigned Value>
+  struct head_bits;
+
+  /**
+   * @brief Policy to configure the number of hash bits that are used to index the arrays
+   * below the head in `feldman_hash_map`.
+   * @tparam Value
+   */
+  template <unsigned Value>
+  struct array_bits;
+} // namespace policy
+
+/**
+ * @brief A lock-free hash-map based on a multi-level array hash trie.
+ *
+ * This data structure is based on the wait-free hash-map proposed by Feldman et al.
+ * \[[FLD13](index.html#ref-feldman-2013)\]. The hash value of a key is split into chunks of bits,
+ * and every chunk is used as index into one level of the trie. The head array uses the lowest
+ * `head_bits` bits; every other array is indexed with the next `array_bits` bits. A slot in an
+ * array is either empty, contains a data node, or points to an array on the next level.
+ * When a new element is inserted into a slot that already contains a data node with a different
+ * hash value, the slot is expanded, i.e., it is replaced with a new array that contains the
+ * existing data node. Arrays are never removed, so the map grows without ever rehashing or moving
+ * existing elements; removed data nodes are retired via the configured reclaimer.
+ *
+ * Like in the original proposal, the hash value must uniquely identify the key, i.e., the hash
+ * function must be injective for the keys stored in the map. This is the case for the default
+ * hash function for integral keys. Inserting a key whose hash value equals the hash value of
+ * another key in the map throws a `std::invalid_argument` exception.
+ *
+ * Supported policies:
+ *  * `xenium::policy::reclaimer`<br>
+ *    Defines the reclamation scheme to be used for internal nodes. (**required**)
+ *  * `xenium::policy::hash`<br>
+ *    Defines the hash function. (*optional*; defaults to `xenium::hash<Key>`)
+ *  * `xenium::policy::backoff`<br>
+ *    Defines the backoff strategy. (*optional*; defaults to `xenium::no_backoff`)
+ *  * `xenium::policy::head_bits`<br>
+ *    Defines the number of hash bits used to index the head array. (*optional*; defaults to 8)
+ *  * `xenium::policy::array_bits`<br>
+ *    Defines the number of hash bits used to index all other arrays. (*optional*; defaults to 4)
+ *
+ * @tparam Key
+ * @tparam Value
+ * @tparam Policies list of policies to customize the behaviour
+ */
+template <class Key, class Value, class... Policies>
+class feldman_hash_map {
+public:
+  using value_type = std::pair<const Key, Value>;
+  using reclaimer = parameter::type_param_t<policy::reclaimer, parameter::nil, Policies...>;
+  using hash = parameter::type_param_t<policy::hash, xenium::hash<Key>, Policies...>;
+  using backoff = parameter::type_param_t<policy::backoff, no_backoff, Policies...>;
+  static constexpr unsigned head_bits = parameter::value_param_t<unsigned, policy::head_bits, 8, Policies...>::value;
+  static constexpr unsigned array_bits = parameter::value_param_t<unsigned, policy::array_bits, 4, Policies...>::value;
+
+  template <class... NewPolicies>
+  using with = feldman_hash_map<Key, Value, NewPolicies..., Policies...>;
+
+  static_assert(parameter::is_set<reclaimer>::value, "reclaimer policy must be specified");
+  static_assert(head_bits >= 1 && head_bits <= 24, "head_bits must be between 1 and 24");
+  static_assert(array_bits >= 1 && array_bits <= 16, "array_bits must be between 1 and 16");
+
+  class iterator;
+
+  feldman_hash_map() = default;
+  ~feldman_hash_map();
+
+  feldman_hash_map(const feldman_hash_map&) = delete;
+  feldman_hash_map& operator=(const feldman_hash_map&) = delete;
+
+  /**
+   * @brief Inserts a new element into the container if the container doesn't already contain an
+   * element with an equivalent key. The element is constructed in-place with the given `args`.
+   *
+   * The element is always constructed. If there already is an element with the key in the container,
+   * the newly constructed element will be destroyed immediately.
+   *
+   * No iterators or references are invalidated.
+   *
+   * Progress guarantees: lock-free
+   *
+   * @param args arguments to forward to the constructor of the element
+   * @return `true` if an element was inserted, otherwise `false`
+   */
+  template <class... Args>
+  bool emplace(Args&&... args);
+
+  /**
+   * @brief Inserts a new element into the container if the container doesn't already contain an
+   * element with an equivalent key. The element is constructed in-place with the given `args`.
+   *
+   * The element is always constructed. If there already is an element with the key in the container,
+   * the newly constructed element will be destroyed immediately.
+   *
+   * No iterators or references are invalidated.
+   *
+   * Progress guarantees: lock-free
+   *
+   * @param args arguments to forward to the constructor of the element
+   * @return a pair consisting of an iterator to the inserted element, or the already-existing element
+   * if no insertion happened, and a bool denoting whether the insertion took place;
+   * `true` if an element was inserted, otherwise `false`
+   */
+  template <class... Args>
+  std::pair<iterator, bool> emplace_or_get(Args&&... args);
+
+  /**
+   * @brief Removes the element with the key equivalent to key (if one exists).
+   *
+   * No iterators or references are invalidated.
+   *
+   * Progress guarantees: lock-free
+   *
+   * @param key key of the element to remove
+   * @return `true` if an element was removed, otherwise `false`
+   */
+  bool erase(const Key& key);
+
+  /**
+   * @brief Removes the specified element from the container.
+   *
+   * No iterators or references are invalidated.
+   *
+   * Progress guarantees: lock-free
+   *
+   * @param pos the iterator identifying the element to remove
+   * @return iterator following the removed element
+   */
+  iterator erase(iterator pos);
+
+  /**
+   * @brief Finds an element with key equivalent to key.
+   *
+   * Progress guarantees: wait-free
+   *
+   * @param key key of the element to search for
+   * @return iterator to an element with key equivalent to key if such element is found,
+   * otherwise past-the-end iterator
+   */
+  iterator find(const Key& key);
+
+  /**
+   * @brief Checks if there is an element with key equivalent to key in the container.
+   *
+   * Progress guarantees: wait-free
+   *
+   * @param key key of the element to search for
+   * @return `true` if there is such an element, otherwise `false`
+   */
+  bool contains(const Key& key);
+
+  /**
+   * @brief Returns an iterator to the first element of the container.
+   * @return iterator to the first element
+   */
+  iterator begin();
+
+  /**
+   * @brief Returns an iterator to the element following the last element of the container.
+   *
+   * This element acts as a placeholder; attempting to access it results in undefined behavior.
+   * @return iterator to the element following the last element.
+   */
+  iterator end();
+
+private:
+  using hash_t = std::size_t;
+
+  struct node;
+  struct data_node;
+  struct array_node;
+
+  using concurrent_ptr = typename reclaimer::template concurrent_ptr<node, 1>;
+  using marked_ptr = typename concurrent_ptr::marked_ptr;
+  using guard_ptr = typename concurrent_ptr::guard_ptr;
+
+  // slots that point to an array node are marked
+  static constexpr std::uintptr_t array_mark = 1;
+
+  static void destroy(array_node* array);
+
+  array_node head{head_bits, 0, nullptr, 0};
+};
+
+template <class Key, class Value, class... Policies>
+struct feldman_hash_map<Key, Value, Policies...>::node : reclaimer::template enable_concurrent_ptr<node, 1> {};
+
+template <class Key, class Value, class... Policies>
+struct feldman_hash_map<Key, Value, Policies...>::data_node : node {
+  template <class... Args>
+  explicit data_node(Args&&... args) : value(std::forward<Args>(args)...), hash_value(hash{}(value.first)) {}
+  value_type value;
+  const hash_t hash_value;
+};
+
+template <class Key, class Value, class... Policies>
+struct feldman_hash_map<Key, Value, Policies...>::array_node : node {
+  array_node(unsigned bits, unsigned shift, array_node* parent, std::size_t parent_index) :
+      size(std::size_t(1) << bits),
+      shift(shift),
+      bits(bits),
+      parent(parent),
+      parent_index(parent_index),
+      slots(new concurrent_ptr[size]) {}
+
+  [[nodiscard]] std::size_t index_of(hash_t hash_value) const { return (hash_value >> shift) & (size - 1); }
+
+  const std::size_t size;
+  const unsigned shift;
+  const unsigned bits;
+  array_node* const parent;
+  const std::size_t parent_index;
+  std::unique_ptr<concurrent_ptr[]> slots;
+};
+
+/**
+ * @brief A ForwardIterator to safely iterate the hash-map.
+ *
+ * Iterators hold a guard to the data node of the current element; arrays are never removed
+ * while the map exists, so the iterator can always continue from its current position, even if
+ * the current element has been removed in the meantime. Elements that are inserted or removed
+ * concurrently may or may not be visited.
+ *
+ * Iterators are not invalidated by concurrent update operations. However, iterators hold a
+ * guard, so it is recommended to use prefix increments and to not keep iterators around longer
+ * than necessary, especially for reclamation schemes that require per-instance resources like
+ * `hazard_pointer` or `hazard_eras`.
+ */
+template <class Key, class Value, class... Policies>
+class feldman_hash_map<Key, Value, Policies...>::iterator {
+public:
+  using iterator_category = std::forward_iterator_tag;
+  using value_type = feldman_hash_map::value_type;
+  using difference_type = std::ptrdiff_t;
+  using pointer = value_type*;
+  using reference = value_type&;
+
+  iterator() = default;
+  iterator(iterator&&) = default;
+  iterator(const iterator&) = default;
+
+  iterator& operator=(iterator&&) = default;
+  iterator& operator=(const iterator&) = default;
+
+  iterator& operator++() {
+    assert(current.get() != nullptr);
+    move_to_next_element(index + 1);
+    return *this;
+  }
+  iterator operator++(int) {
+    iterator retval = *this;
+    ++(*this);
+    return retval;
+  }
+  bool operator==(const iterator& other) const { return current.get() == other.current.get(); }
+  bool operator!=(const iterator& other) const { return !(*this == other); }
+  reference operator*() const noexcept { return static_cast<data_node*>(current.get())->value; }
+  pointer operator->() const noexcept { return &static_cast<data_node*>(current.get())->value; }
+
+  void reset() {
+    array = nullptr;
+    current.reset();
+  }
+
+private:
+  friend feldman_hash_map;
+
+  iterator(array_node* array, std::size_t index, guard_ptr&& current) :
+      array(array),
+      index(index),
+      current(std::move(current)) {}
+
+  void move_to_next_element(std::size_t idx) {
+    current.reset();
+    for (;;) {
+      if (idx == array->size) {
+        if (array->parent == nullptr) {
+          array = nullptr;
+          return;
+        }
+        idx = array->parent_index + 1;
+        array = array->parent;
+        continue;
+      }
+      // (1) - this acquire-load synchronizes-with the release-CAS (4, 5)
+      current.acquire(array->slots[idx], std::memory_order_acquire);
+      if (current.get() == nullptr) {
+        ++idx;
+      } else if (current.mark() == array_mark) {
+        array = static_cast<array_node*>(current.get());
+        current.reset();
+        idx = 0;
+      } else {
+        index = idx;
+        return;
+      }
+    }
+  }
+
+  array_node* array = nullptr;
+  std::size_t index = 0;
+  guard_ptr current;
+};
+
+template <class Key, class Value, class... Policies>
+feldman_hash_map<Key, Value, Policies...>::~feldman_hash_map() {
+  destroy(&head);
+}
+
+template <class Key, class Value, class... Policies>
+void feldman_hash_map<Key, Value, Policies...>::destroy(array_node* array) {
+  for (std::size_t i = 0; i < array->size; ++i) {
+    auto p = array->slots[i].load(std::memory_order_relaxed);
+    if (p.mark() == array_mark) {
+      auto* child = static_cast<array_node*>(p.get());
+      destroy(child);
+      delete child;
+    } else {
+      delete static_cast<data_node*>(p.get());
+    }
+  }
+}
+
+template <class Key, class Value, class... Policies>
+template <class... Args>
+bool feldman_hash_map<Key, Value, Policies...>::emplace(Args&&... args) {
+  auto result = emplace_or_get(std::forward<Args>(args)...);
+  return result.second;
+}
+
+template <class Key, class Value, class... Policies>
+template <class... Args>
+auto feldman_hash_map<Key, Value, Policies...>::emplace_or_get(Args&&... args) -> std::pair<iterator, bool> {
+  auto* n = new data_node(std::forward<Args>(args)...);
+  const hash_t h = n->hash_value;
+
+  array_node* array = &head;
+  backoff backoff;
+  guard_ptr cur;
+  for (;;) {
+    const std::size_t idx = array->index_of(h);
+    auto& slot = array->slots[idx];
+    // (2) - this acquire-load synchronizes-with the release-CAS (4, 5)
+    cur.acquire(slot, std::memory_order_acquire);
+    if (cur.get() == nullptr) {
+      marked_ptr expected = nullptr;
+      guard_ptr new_guard(n);
+      // (4) - this release-CAS synchronizes-with the acquire-load (1, 2, 3)
+      if (slot.compare_exchange_strong(expected, marked_ptr(n), std::memory_order_release, std::memory_order_relaxed)) {
+        return {iterator(array, idx, std::move(new_guard)), true};
+      }
+      backoff();
+      continue;
+    }
+
+    if (cur.mark() == array_mark) {
+      array = static_cast<array_node*>(cur.get());
+      continue;
+    }
+
+    auto* existing = static_cast<data_node*>(cur.get());
+    if (existing->hash_value == h) {
+      if (existing->value.first == n->value.first) {
+        delete n;
+        return {iterator(array, idx, std::move(cur)), false};
+      }
+      delete n;
+      throw std::invalid_argument("feldman_hash_map requires that different keys have different hash values");
+    }
+
+    // Both hash values map to the same slot -> replace the slot with a new array that contains
+    // the existing node. Since the hash values differ in at least one bit, they eventually end
+    // up in different slots, so the shift always remains below the width of the hash value.
+    assert(array->shift + array->bits < sizeof(hash_t) * 8);
+    auto* child = new array_node(array_bits, array->shift + array->bits, array, idx);
+    child->slots[child->index_of(existing->hash_value)].store(marked_ptr(existing), std::memory_order_relaxed);
+    marked_ptr expected(existing);
+    // (5) - this release-CAS synchronizes-with the acquire-load (1, 2, 3)
+    if (slot.compare_exchange_strong(
+          expected, marked_ptr(child, array_mark), std::memory_order_release, std::memory_order_relaxed)) {
+      array = child;
+    } else {
+      // the child array has never been published, so we can delete it right away
+      delete child;
+    }
+  }
+}
+
+template <class Key, class Value, class... Policies>
+auto feldman_hash_map<Key, Value, Policies...>::find(const Key& key) -> iterator {
+  const hash_t h = hash{}(key);
+  array_node* array = &head;
+  guard_ptr cur;
+  // every iteration descends one level, so this loop is bounded by the height of the trie
+  for (;;) {
+    const std::size_t idx = array->index_of(h);
+    // (3) - this acquire-load synchronizes-with the release-CAS (4, 5)
+    cur.acquire(array->slots[idx], std::memory_order_acquire);
+    if (cur.get() == nullptr) {
+      return end();
+    }
+    if (cur.mark() == array_mark) {
+      array = static_cast<array_node*>(cur.get());
+      continue;
+    }
+    auto* n = static_cast<data_node*>(cur.get());
+    if (n->hash_value == h && n->value.first == key) {
+      return iterator(array, idx, std::move(cur));
+    }
+    return end();
+  }
+}
+
+template <class Key, class Value, class... Policies>
+bool feldman_hash_map<Key, Value, Policies...>::contains(const Key& key) {
+  return find(key) != end();
+}
+
+template <class Key, class Value, class... Policies>
+bool feldman_hash_map<Key, Value, Policies...>::erase(const Key& key) {
+  auto it = find(key);
+  if (it == end()) {
+    return false;
+  }
+
+  // The node can only be moved to an array on the next level (when its slot is expanded), so we
+  // follow it until we either remove it or find that it has been removed by some other thread.
+  backoff backoff;
+  array_node* array = it.array;
+  std::size_t idx = it.index;
+  auto* n = static_cast<data_node*>(it.current.get());
+  for (;;) {
+    marked_ptr expected(n);
+    if (array->slots[idx].compare_exchange_strong(
+          expected, marked_ptr(), std::memory_order_relaxed, std::memory_order_relaxed)) {
+      it.current.reclaim();
+      return true;
+    }
+    if (expected.mark() != array_mark) {
+      return false;
+    }
+    array = static_cast<array_node*>(expected.get());
+    idx = array->index_of(n->hash_value);
+    backoff();
+  }
+}
+
+template <class Key, class Value, class... Policies>
+auto feldman_hash_map<Key, Value, Policies...>::erase(iterator pos) -> iterator {
+  guard_ptr victim = pos.current;
+  array_node* array = pos.array;
+  std::size_t idx = pos.index;
+  ++pos;
+
+  auto* n = static_cast<data_node*>(victim.get());
+  for (;;) {
+    marked_ptr expected(n);
+    if (array->slots[idx].compare_exchange_strong(
+          expected, marked_ptr(), std::memory_order_relaxed, std::memory_order_relaxed)) {
+      victim.reclaim();
+      break;
+    }
+    if (expected.mark() != array_mark) {
+      // the element has already been removed by some other thread
+      break;
+    }
+    array = static_cast<array_node*>(expected.get());
+    idx = array->index_of(n->hash_value);
+  }
+  return pos;
+}
+
+template <class Key, class Value, class... Policies>
+auto feldman_hash_map<Key, Value, Policies...>::begin() -> iterator {
+  iterator result;
+  result.array = &head;
+  result.move_to_next_element(0);
+  return result;
+}
+
+template <class Key, class Value, class... Policies>
+auto feldman_hash_map<Key, Value, Policies...>::end() -> iterator {
+  return iterator();
+}
+} // namespace xenium
+
+#endif
@@ -0,0 +1,632 @@
+//
+// Copyright (c) 2018-2020 Manuel Pöter.
+// Licensed under the MIT License. See LICENSE file in the project root for full license information.
+//
+
+#ifndef XENIUM_FRASER_SKIP_LIST_MAP_HPP
+#define XENIUM_FRASER_SKIP_LIST_MAP_HPP
+
+#include <xenium/acquire_guard.hpp>
+#include <xenium/backoff.hpp>
+#include <xenium/parameter.hpp>
+#include <xenium/policy.hpp>
+#include <xenium/utils.hpp>
+
+#include <atomic>
+#include <cassert>
+#include <cstdint>
+#include <functional>
+#include <new>
+#include <type_traits>
+#include <utility>
+
+namespace xenium {
+/**
+ * @brief A lock-free ordered map based on a skip list.
+ *
+ * This data structure is based on the lock-free skip list proposed by Fraser
+ * \[[Fra04](index.html#ref-fraser-2004)\]. The bottom level of the skip list is a sorted
+ * linked list of all entries, similar to `harris_michael_list_based_set`, and the upper levels
+ * are "express lanes" that contain a random subset of the nodes of the level below. Search,
+ * insert and erase operations therefore have an expected runtime complexity logarithmic in
+ * the size of the map (in the absence of conflicting operations).
+ *
+ * Nodes are removed by first marking the `next` pointers of all levels (top-down) using the
+ * mark bit of the `marked_ptr`. The thread that marks the bottom level has logically removed
+ * the node. Marked nodes are then unlinked by subsequent search operations. Since a node can
+ * still be linked into upper levels by a concurrent insert operation after it has been marked,
+ * every node tracks the number of levels in which it is (or may still become) linked; the node
+ * is reclaimed once this number drops to zero.
+ *
+ * The nodes have a variable height and are therefore allocated with a custom deleter. This is
+ * not supported by `lock_free_ref_count`, so this reclamation scheme cannot be used with this map.
+ *
+ * *Note:* Search operations internally hold `guard_ptr` instances to the predecessor and
+ * successor on every level, so reclamation schemes that require per-instance resources should
+ * use a dynamic allocation strategy (e.g., `hazard_pointer` with `hp_allocation::dynamic_strategy`).
+ *
+ * Supported policies:
+ *  * `xenium::policy::reclaimer`<br>
+ *    Defines the reclamation scheme to be used for internal nodes. (**required**)
+ *  * `xenium::policy::compare`<br>
+ *    Defines the comparison function that is used to order the keys. (*optional*; defaults to `std::less<Key>`)
+ *  * `xenium::policy::backoff`<br>
+ *    Defines the backoff strategy. (*optional*; defaults to `xenium::no_backoff`)
+ *
+ * @tparam Key
+ * @tparam Value
+ * @tparam Policies list of policies to customize the behaviour
+ */
+template <class Key, class Value, class... Policies>
+class fraser_skip_list_map {
+public:
+  using value_type = std::pair<const Key, Value>;
+  using reclaimer = parameter::type_param_t<policy::reclaimer, parameter::nil, Policies...>;
+  using backoff = parameter::type_param_t<policy::backoff, no_backoff, Policies...>;
+  using compare = parameter::type_param_t<policy::compare, std::less<Key>, Policies...>;
+
+  template <class... NewPolicies>
+  using with = fraser_skip_list_map<Key, Value, NewPolicies..., Policies...>;
+
+  static_assert(parameter::is_set<reclaimer>::value, "reclaimer policy must be specified");
+
+  /**
+   * @brief The maximum number of levels of the skip list.
+   *
+   * The height of each node is chosen randomly such that the number of nodes halves with
+   * every level, so the skip list works best for up to 2^max_height entries.
+   */
+  static constexpr unsigned max_height = 32;
+
+  fraser_skip_list_map() = default;
+  ~fraser_skip_list_map();
+
+  class iterator;
+
+  /**
+   * @brief Inserts a new element into the container if the container doesn't already contain an
+   * element with an equivalent key. The element is constructed in-place with the given `args`.
+   *
+   * The element is always constructed. If there already is an element with the key in the container,
+   * the newly constructed element will be destroyed immediately.
+   *
+   * No iterators or references are invalidated.
+   *
+   * Progress guarantees: lock-free
+   *
+   * @param args arguments to forward to the constructor of the element
+   * @return `true` if an element was inserted, otherwise `false`
+   */
+  template <class... Args>
+  bool emplace(Args&&... args);
+
+  /**
+   * @brief Inserts a new element into the container if the container doesn't already contain an
+   * element with an equivalent key. The element is constructed in-place with the given `args`.
+   *
+   * The element is always constructed. If there already is an element with the key in the container,
+   * the newly constructed element will be destroyed immediately.
+   *
+   * No iterators or references are invalidated.
+   *
+   * Progress guarantees: lock-free
+   *
+   * @param args arguments to forward to the constructor of the element
+   * @return a pair consisting of an iterator to the inserted element, or the already-existing element
+   * if no insertion happened, and a bool denoting whether the insertion took place;
+   * `true` if an element was inserted, otherwise `false`
+   */
+  template <class... Args>
+  std::pair<iterator, bool> emplace_or_get(Args&&... args);
+
+  /**
+   * @brief Removes the element with the key equivalent to key (if one exists).
+   *
+   * No iterators or references are invalidated.
+   *
+   * Progress guarantees: lock-free
+   *
+   * @param key key of the element to remove
+   * @return `true` if an element was removed, otherwise `false`
+   */
+  bool erase(const Key& key);
+
+  /**
+   * @brief Finds an element with key equivalent to key.
+   *
+   * Progress guarantees: lock-free
+   *
+   * @param key key of the element to search for
+   * @return iterator to an element with key equivalent to key if such element is found,
+   * otherwise past-the-end iterator
+   */
+  iterator find(const Key& key);
+
+  /**
+   * @brief Checks if there is an element with key equivalent to key in the container.
+   *
+   * Progress guarantees: lock-free
+   *
+   * @param key key of the element to search for
+   * @return `true` if there is such an element, otherwise `false`
+   */
+  bool contains(const Key& key);
+
+  /**
+   * @brief Returns an iterator to the first element with a key that is not less than key.
+   *
+   * Together with `end()` or a second `lower_bound` this can be used to iterate a range of keys.
+   *
+   * Progress guarantees: lock-free
+   *
+   * @param key key to compare the elements to
+   * @return iterator to the first element with a key not less than key, or past-the-end iterator
+   * if no such element is found
+   */
+  iterator lower_bound(const Key& key);
+
+  /**
+   * @brief Returns an iterator to the first element of the container.
+   * @return iterator to the first element
+   */
+  iterator begin();
+
+  /**
+   * @brief Returns an iterator to the element following the last element of the container.
+   *
+   * This element acts as a placeholder; attempting to access it results in undefined behavior.
+   * @return iterator to the element following the last element.
+   */
+  iterator end();
+
+private:
+  struct node;
+  struct node_deleter {
+    void operator()(node* n) const noexcept;
+  };
+
+  using concurrent_ptr = typename reclaimer::template concurrent_ptr<node, 1>;
+  using marked_ptr = typename concurrent_ptr::marked_ptr;
+  using guard_ptr = typename concurrent_ptr::guard_ptr;
+
+  struct find_info {
+    guard_ptr preds[max_height]; // an empty guard represents the head
+    guard_ptr succs[max_height];
+  };
+  bool find(const Key& key, find_info& info, backoff& backoff);
+  concurrent_ptr& link(const guard_ptr& pred, unsigned level) {
+    return pred ? pred->tower()[level] : head[level];
+  }
+  void release_levels(guard_ptr& n, unsigned levels);
+  void raise_height(unsigned height);
+  static unsigned random_height();
+
+  concurrent_ptr head[max_height];
+  // an upper bound of the height of all nodes that have been inserted so far;
+  // search operations start at this level.
+  std::atomic<unsigned> height{1};
+};
+
+/**
+ * @brief A ForwardIterator to safely iterate the skip list in ascending key order.
+ *
+ * Iterators are not invalidated by concurrent insert/erase operations. If the element an
+ * iterator points to is removed concurrently, advancing the iterator requires a search for
+ * the successor.
+ *
+ * *Note:* This iterator class does *not* provide multi-pass guarantee as `a == b` does not imply `++a == ++b`.
+ *
+ * *Note:* Each iterator internally holds a `guard_ptr` instance. This has to be considered when using
+ * a reclamation scheme that requires per-instance resources like `hazard_pointer` or `hazard_eras`.
+ * It is therefore highly recommended to use prefix increments wherever possible.
+ */
+template <class Key, class Value, class... Policies>
+class fraser_skip_list_map<Key, Value, Policies...>::iterator {
+public:
+  using iterator_category = std::forward_iterator_tag;
+  using value_type = fraser_skip_list_map::value_type;
+  using difference_type = std::ptrdiff_t;
+  using pointer = value_type*;
+  using reference = value_type&;
+
+  iterator(iterator&&) = default;
+  iterator(const iterator&) = default;
+
+  iterator& operator=(iterator&&) = default;
+  iterator& operator=(const iterator&) = default;
+
+  /**
+   * @brief Moves the iterator to the next element.
+   * In the absence of conflicting operations, this operation has constant runtime complexity.
+   * However, if the current element has been removed, we have to search for the next element.
+   *
+   * Progress guarantess: lock-free
+   */
+  iterator& operator++();
+  iterator operator++(int) {
+    iterator retval = *this;
+    ++(*this);
+    return retval;
+  }
+
+  bool operator==(const iterator& other) const { return cur.get() == other.cur.get(); }
+  bool operator!=(const iterator& other) const { return !(*this == other); }
+  reference operator*() const noexcept { return cur->value; }
+  pointer operator->() const noexcept { return &cur->value; }
+
+  /**
+   * @brief Resets the iterator; this is equivalent to assigning `end()` to it.
+   *
+   * This operation can be handy in situations where an iterator is no longer needed and you want
+   * to ensure that the internal `guard_ptr` instance is reset.
+   */
+  void reset() { cur.reset(); }
+
+private:
+  friend fraser_skip_list_map;
+
+  explicit iterator(fraser_skip_list_map& map, guard_ptr&& cur) : map(&map), cur(std::move(cur)) {}
+
+  fraser_skip_list_map* map;
+  guard_ptr cur;
+};
+
+template <class Key, class Value, class... Policies>
+struct fraser_skip_list_map<Key, Value, Policies...>::node :
+    reclaimer::template enable_concurrent_ptr<node, 1, node_deleter> {
+  value_type value;
+  const unsigned height;
+  // The number of levels in which this node is linked or may still become linked
+  // by the inserting thread. Once this drops to zero, the node can be reclaimed.
+  std::atomic<unsigned> link_count;
+
+  // The tower of next pointers is allocated directly after the node.
+  static constexpr std::size_t tower_offset() {
+    return ((sizeof(node) + alignof(concurrent_ptr) - 1) / alignof(concurrent_ptr)) * alignof(concurrent_ptr);
+  }
+
+  concurrent_ptr* tower() noexcept {
+    return std::launder(reinterpret_cast<concurrent_ptr*>(reinterpret_cast<char*>(this) + tower_offset()));
+  }
+
+  template <class... Args>
+  static node* create(unsigned height, Args&&... args) {
+    static_assert(alignof(node) <= __STDCPP_DEFAULT_NEW_ALIGNMENT__, "over-aligned types are not supported");
+    static_assert(std::is_trivially_destructible<concurrent_ptr>::value, "the tower is never destroyed");
+    void* mem = ::operator new(tower_offset() + height * sizeof(concurrent_ptr));
+    node* result;
+    try {
+      result = new (mem) node(height, std::forward<Args>(args)...);
+    } catch (...) {
+      ::operator delete(mem);
+      throw;
+    }
+    auto* tower = reinterpret_cast<concurrent_ptr*>(static_cast<char*>(mem) + tower_offset());
+    for (unsigned i = 0; i < height; ++i) {
+      new (tower + i) concurrent_ptr();
+    }
+    return result;
+  }
+
+private:
+  template <class... Args>
+  explicit node(unsigned height, Args&&... args) :
+      value(std::forward<Args>(args)...),
+      height(height),
+      link_count(height) {}
+};
+
+template <class Key, class Value, class... Policies>
+void fraser_skip_list_map<Key, Value, Policies...>::node_deleter::operator()(node* n) const noexcept {
+  n->~node();
+  ::operator delete(n);
+}
+
+template <class Key, class Value, class... Policies>
+fraser_skip_list_map<Key, Value, Policies...>::~fraser_skip_list_map() {
+  // Every node is linked in exactly link_count levels, so we can delete a node once we have
+  // encountered it in the last of these levels.
+  for (unsigned level = max_height; level-- > 0;) {
+    // (1) - this acquire-load synchronizes-with the release-CAS (5, 6, 7)
+    auto p = head[level].load(std::memory_order_acquire);
+    while (p) {
+      // (2) - this acquire-load synchronizes-with the release-CAS (5, 6, 7)
+      auto next = p->tower()[level].load(std::memory_order_acquire);
+      if (p->link_count.fetch_sub(1, std::memory_order_relaxed) == 1) {
+        node_deleter{}(p.get());
+      }
+      p = next.get();
+    }
+  }
+}
+
+template <class Key, class Value, class... Policies>
+unsigned fraser_skip_list_map<Key, Value, Policies...>::random_height() {
+  // xorshift64* - a cheap PRNG is sufficient to produce the geometric distribution of node heights.
+  static thread_local std::uint64_t state = (utils::random() << 1) | 1;
+  state ^= state >> 12;
+  state ^= state << 25;
+  state ^= state >> 27;
+  auto rnd = state * 0x2545F4914F6CDD1DULL;
+  unsigned result = 1;
+  while (result < max_height && (rnd & 1) != 0) {
+    ++result;
+    rnd >>= 1;
+  }
+  return result;
+}
+
+template <class Key, class Value, class... Policies>
+void fraser_skip_list_map<Key, Value, Policies...>::raise_height(unsigned new_height) {
+  // The height is only a hint where to start the search; all links are validated
+  // by the subsequent CAS operations, so relaxed operations are sufficient.
+  auto h = height.load(std::memory_order_relaxed);
+  while (h < new_height && !height.compare_exchange_weak(h, new_height, std::memory_order_relaxed)) {
+  }
+}
+
+template <class Key, class Value, class... Policies>
+void fraser_skip_list_map<Key, Value, Policies...>::release_levels(guard_ptr& n, unsigned levels) {
+  // Other threads can still hold guard_ptrs to this node, but the reclaimer takes care
+  // of that, so a relaxed decrement is sufficient.
+  if (n->link_count.fetch_sub(levels, std::memory_order_relaxed) == levels) {
+    n.reclaim(node_deleter{});
+  }
+}
+
+template <class Key, class Value, class... Policies>
+auto fraser_skip_list_map<Key, Value, Policies...>::iterator::operator++() -> iterator& {
+  assert(cur.get() != nullptr);
+  for (;;) {
+    auto next = cur->tower()[0].load(std::memory_order_relaxed);
+    if (next.mark() == 0) {
+      guard_ptr tmp_guard;
+      // (3) - this acquire-load synchronizes-with the release-CAS (5, 6, 7)
+      if (tmp_guard.acquire_if_equal(cur->tower()[0], next, std::memory_order_acquire)) {
+        cur = std::move(tmp_guard);
+        return *this;
+      }
+      continue;
+    }
+
+    // cur has been removed -> search for the first node with a key that is not less than cur's key.
+    // If this is a new node with an equivalent key, we have to advance once more.
+    Key key = cur->value.first;
+    find_info info;
+    backoff backoff;
+    bool found = map->find(key, info, backoff);
+    cur = std::move(info.succs[0]);
+    if (!found) {
+      return *this;
+    }
+  }
+}
+
+template <class Key, class Value, class... Policies>
+bool fraser_skip_list_map<Key, Value, Policies...>::find(const Key& key, find_info& info, backoff& backoff) {
+  compare compare;
+retry:
+  const unsigned top = height.load(std::memory_order_relaxed);
+  for (unsigned level = max_height; level-- > top;) {
+    info.preds[level].reset();
+    info.succs[level].reset();
+  }
+
+  guard_ptr pred;
+  for (unsigned level = top; level-- > 0;) {
+    concurrent_ptr* prev = &link(pred, level);
+    marked_ptr next = prev->load(std::memory_order_relaxed);
+    if (next.mark() != 0) {
+      // pred is being removed -> we have to restart from head
+      backoff();
+      goto retry;
+    }
+
+    guard_ptr cur;
+    for (;;) {
+      // (4) - this acquire-load synchronizes-with the release-CAS (5, 6, 7)
+      if (!cur.acquire_if_equal(*prev, next, std::memory_order_acquire)) {
+        goto retry;
+      }
+
+      if (!cur) {
+        break;
+      }
+
+      marked_ptr succ = cur->tower()[level].load(std::memory_order_relaxed);
+      if (succ.mark() != 0) {
+        // cur is marked for removal on this level -> try to unlink it
+        marked_ptr expected = cur.get();
+        // (5) - this release-CAS synchronizes-with the acquire-load (1, 2, 3, 4, 9)
+        //       and the acquire-CAS (8)
+        if (!prev->compare_exchange_weak(expected, succ.get(), std::memory_order_release, std::memory_order_relaxed)) {
+          backoff();
+          goto retry;
+        }
+        release_levels(cur, 1);
+        next = succ.get();
+        continue;
+      }
+
+      if (!compare(cur->value.first, key)) {
+        break;
+      }
+
+      pred = std::move(cur);
+      prev = &pred->tower()[level];
+      next = succ;
+    }
+    info.preds[level] = pred;
+    info.succs[level] = std::move(cur);
+  }
+
+  auto& result = info.succs[0];
+  return result && !compare(key, result->value.first);
+}
+
+template <class Key, class Value, class... Policies>
+bool fraser_skip_list_map<Key, Value, Policies...>::contains(const Key& key) {
+  find_info info;
+  backoff backoff;
+  return find(key, info, backoff);
+}
+
+template <class Key, class Value, class... Policies>
+auto fraser_skip_list_map<Key, Value, Policies...>::find(const Key& key) -> iterator {
+  find_info info;
+  backoff backoff;
+  if (find(key, info, backoff)) {
+    return iterator(*this, std::move(info.succs[0]));
+  }
+  return end();
+}
+
+template <class Key, class Value, class... Policies>
+auto fraser_skip_list_map<Key, Value, Policies...>::lower_bound(const Key& key) -> iterator {
+  find_info info;
+  backoff backoff;
+  find(key, info, backoff);
+  return iterator(*this, std::move(info.succs[0]));
+}
+
+template <class Key, class Value, class... Policies>
+template <class... Args>
+bool fraser_skip_list_map<Key, Value, Policies...>::emplace(Args&&... args) {
+  auto result = emplace_or_get(std::forward<Args>(args)...);
+  return result.second;
+}
+
+template <class Key, class Value, class... Policies>
+template <class... Args>
+auto fraser_skip_list_map<Key, Value, Policies...>::emplace_or_get(Args&&... args) -> std::pair<iterator, bool> {
+  const unsigned new_height = random_height();
+  node* n = node::create(new_height, std::forward<Args>(args)...);
+  const Key& key = n->value.first;
+  concurrent_ptr* tower = n->tower();
+  guard_ptr new_guard(n);
+
+  find_info info;
+  backoff backoff;
+  for (;;) {
+    if (find(key, info, backoff)) {
+      new_guard.reset();
+      node_deleter{}(n);
+      return {iterator(*this, std::move(info.succs[0])), false};
+    }
+
+    for (unsigned level = 0; level < new_height; ++level) {
+      tower[level].store(info.succs[level].get(), std::memory_order_relaxed);
+    }
+
+    // Try to install the new node in the bottom level
+    marked_ptr expected = info.succs[0].get();
+    // (6) - this release-CAS synchronizes-with the acquire-load (1, 2, 3, 4, 9)
+    //       and the acquire-CAS (8)
+    if (link(info.preds[0], 0).compare_exchange_weak(
+          expected, n, std::memory_order_release, std::memory_order_relaxed)) {
+      break;
+    }
+    backoff();
+  }
+
+  // The node is now part of the map; link it into the upper levels.
+  raise_height(new_height);
+  for (unsigned level = 1; level < new_height; ++level) {
+    for (;;) {
+      // Our tower must point to the successor we found in the last search, because otherwise the
+      // nodes in between would be dropped from this level. Nobody else modifies the tower of a level
+      // in which the node is not yet linked, except for marking it, so if the CAS fails or the tower
+      // is already marked, the node is being removed and we must not link it into any further levels.
+      marked_ptr old_next = tower[level].load(std::memory_order_relaxed);
+      marked_ptr new_next = info.succs[level].get();
+      if (old_next.mark() != 0 ||
+          (old_next != new_next &&
+           !tower[level].compare_exchange_strong(
+             old_next, new_next, std::memory_order_relaxed, std::memory_order_relaxed))) {
+        guard_ptr result = new_guard;
+        release_levels(new_guard, new_height - level);
+        return {iterator(*this, std::move(result)), true};
+      }
+
+      marked_ptr expected = new_next;
+      // (7) - this release-CAS synchronizes-with the acquire-load (1, 2, 3, 4, 9)
+      //       and the acquire-CAS (8)
+      if (link(info.preds[level], level)
+            .compare_exchange_weak(expected, n, std::memory_order_release, std::memory_order_relaxed)) {
+        break;
+      }
+
+      backoff();
+      find(key, info, backoff);
+      if (info.succs[0].get() != n) {
+        // the node has been removed concurrently
+        guard_ptr result = new_guard;
+        release_levels(new_guard, new_height - level);
+        return {iterator(*this, std::move(result)), true};
+      }
+    }
+  }
+
+  if (tower[0].load(std::memory_order_relaxed).mark() != 0) {
+    // The node has been removed while we were linking the upper levels. The removing thread might
+    // have already finished its cleanup, so we have to ensure that the node gets unlinked.
+    find(key, info, backoff);
+  }
+
+  return {iterator(*this, std::move(new_guard)), true};
+}
+
+template <class Key, class Value, class... Policies>
+bool fraser_skip_list_map<Key, Value, Policies...>::erase(const Key& key) {
+  backoff backoff;
+  find_info info;
+  for (;;) {
+    if (!find(key, info, backoff)) {
+      return false;
+    }
+
+    node* victim = info.succs[0].get();
+    concurrent_ptr* tower = victim->tower();
+    // mark the upper levels top-down to prevent new nodes from getting linked after the victim
+    for (unsigned level = victim->height; level-- > 1;) {
+      marked_ptr next = tower[level].load(std::memory_order_relaxed);
+      while (next.mark() == 0 && !tower[level].compare_exchange_weak(next,
+                                                                      marked_ptr(next.get(), 1),
+                                                                      std::memory_order_relaxed,
+                                                                      std::memory_order_relaxed)) {
+      }
+    }
+
+    // The thread that marks the bottom level has removed the node.
+    marked_ptr next = tower[0].load(std::memory_order_relaxed);
+    while (next.mark() == 0) {
+      // (8) - this acquire-CAS synchronizes-with the release-CAS (5, 6, 7)
+      if (tower[0].compare_exchange_weak(
+            next, marked_ptr(next.get(), 1), std::memory_order_acquire, std::memory_order_relaxed)) {
+        // unlink the node from all levels
+        find(key, info, backoff);
+        return true;
+      }
+    }
+
+    // Another thread removed the node -> search again, since a new node with an equivalent key might
+    // have been inserted in the meantime.
+    backoff();
+  }
+}
+
+template <class Key, class Value, class... Policies>
+auto fraser_skip_list_map<Key, Value, Policies...>::begin() -> iterator {
+  guard_ptr first;
+  // (9) - this acquire-load synchronizes-with the release-CAS (5, 6, 7)
+  first.acquire(head[0], std::memory_order_acquire);
+  return iterator(*this, std::move(first));
+}
+
+template <class Key, class Value, class... Policies>
+auto fraser_skip_list_map<Key, Value, Policies...>::end() -> iterator {
+  return iterator(*this, guard_ptr{});
+}
+} // namespace xenium
+
+#endif
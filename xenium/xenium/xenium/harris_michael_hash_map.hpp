@@ -8,13 +8,19 @@
 
 #include <xenium/acquire_guard.hpp>
 #include <xenium/backoff.hpp>
+#include <xenium/detail/parallel_for.hpp>
+#include <xenium/detail/striped_counter.hpp>
 #include <xenium/hash.hpp>
 #include <xenium/parameter.hpp>
 #include <xenium/policy.hpp>
 #include <xenium/utils.hpp>
 
+#include <algorithm>
 #include <atomic>
 #include <cassert>
+#include <memory>
+#include <stdexcept>
+#include <vector>
 
 namespace xenium {
 
@@ -48,15 +54,32 @@ namespace policy {
    */
   template <bool Value>
   struct memoize_hash;
+
+  /**
+   * @brief Policy to configure whether `harris_michael_hash_map` supports dynamic resizing
+   * based on split-ordered lists.
+   *
+   * @tparam Value
+   */
+  template <bool Value>
+  struct resizable;
 } // namespace policy
 
 /**
  * @brief A generic lock-free hash-map.
  *
- * This hash-map consists of a fixed number of buckets were each bucket is essentially
+ * By default, this hash-map consists of a fixed number of buckets were each bucket is essentially
  * a `harris_michael_list_based_set` instance. The number of buckets is fixed, so the
  * hash-map does not support dynamic resizing.
  *
+ * If the `resizable` policy is enabled, the hash-map instead uses the split-ordered list approach
+ * proposed by Shalev and Shavit \[[SS06](index.html#ref-shalev-2006)\]. All elements are stored in a
+ * single list that is sorted by the bit-reversed hash values, and the buckets are lazily initialized
+ * sentinel nodes in that list. The number of buckets is doubled once the load factor exceeds a
+ * certain threshold. Since existing elements never have to be moved, resizing is lock-free.
+ * The number of buckets specified via the `buckets` policy is then used as initial bucket count,
+ * and the `map_to_bucket` policy is ignored.
+ *
  * This hash-map is less efficient than many other available concurrent hash-maps, but it is
  * lock-free and fully generic, i.e., it supports arbitrary types for `Key` and `Value`.
  *
@@ -78,6 +101,8 @@ namespace policy {
  *  * `xenium::policy::memoize_hash`<br>
  *    Defines whether the hash should be stored and used during lookup operations.
  *    (*optional*; defaults to false for scalar `Key` types; otherwise true)
+ *  * `xenium::policy::resizable`<br>
+ *    Defines whether the number of buckets grows dynamically. (*optional*; defaults to false)
  *
  * @tparam Key
  * @tparam Value
@@ -95,16 +120,19 @@ public:
     parameter::value_param_t<std::size_t, policy::buckets, 512, Policies...>::value;
   static constexpr bool memoize_hash =
     parameter::value_param_t<bool, policy::memoize_hash, !std::is_scalar<Key>::value, Policies...>::value;
+  static constexpr bool resizable = parameter::value_param_t<bool, policy::resizable, false, Policies...>::value;
 
   template <class... NewPolicies>
   using with = harris_michael_hash_map<Key, Value, NewPolicies..., Policies...>;
 
   static_assert(parameter::is_set<reclaimer>::value, "reclaimer policy must be specified");
+  static_assert(!resizable || utils::is_power_of_two(num_buckets),
+                "the initial number of buckets must be a power of two");
 
   class iterator;
   class accessor;
 
-  harris_michael_hash_map() = default;
+  harris_michael_hash_map();
   ~harris_michael_hash_map();
 
   /**
@@ -230,6 +258,70 @@ public:
    */
   bool contains(const Key& key);
 
+  /**
+   * @brief Returns the number of elements in the container.
+   *
+   * Every thread updates its own cacheline-sized stripe of the element counter after it has
+   * successfully inserted or marked a node, and this method simply sums up the stripes.
+   * In the presence of concurrent modifications the result is therefore only an approximation.
+   *
+   * Progress guarantees: wait-free
+   *
+   * @return the approximate number of elements
+   */
+  [[nodiscard]] std::size_t approximate_size() const noexcept { return element_count.approximate_value(); }
+
+  /**
+   * @brief Returns the number of elements in the container.
+   *
+   * The stripes of the element counter are collected repeatedly until two subsequent
+   * collects are identical, so the result is a value the counter had at some point during
+   * the call. Since the counter is updated right after the linearization point of an insert
+   * or erase operation, the result can only deviate from the actual number of elements by
+   * the number of such operations that are in progress at that time.
+   * The number of collects is bounded; if other threads modify the container during
+   * each of them, the result is the same approximation that `approximate_size` returns.
+   *
+   * Progress guarantees: wait-free
+   *
+   * @return the number of elements
+   */
+  [[nodiscard]] std::size_t size() const { return element_count.value(); }
+
+  /**
+   * @brief Inserts all elements from the range `[first, last)` using the specified number of threads.
+   *
+   * This is considerably faster than inserting the elements one by one via `emplace`, since the
+   * lists are built without any CAS operations. The nodes are created and partitioned by their
+   * buckets in parallel; each thread then sorts the nodes of a disjoint range of buckets and links
+   * them. In resizable mode the number of buckets is increased upfront such that the map does not
+   * have to grow, and the sentinels of all buckets are initialized eagerly.
+   * If the range contains several elements with equivalent keys, only the first one is inserted.
+   *
+   * The container must be empty, and `bulk_build` must not be called concurrently with any other
+   * operation on the same container. Throws `std::logic_error` if the container is not empty.
+   *
+   * Progress guarantees: blocking
+   *
+   * @param first iterator to the first element; `value_type` must be constructible from the
+   * iterator's `value_type` (e.g., `std::pair<Key, Value>`)
+   * @param last iterator to the element following the last element
+   * @param num_threads the number of threads to use, including the calling thread
+   */
+  template <class RandomIt>
+  void bulk_build(RandomIt first, RandomIt last, std::size_t num_threads = 1);
+
+  /**
+   * @brief Returns the current number of buckets.
+   *
+   * Unless the `resizable` policy is enabled, this is always `num_buckets`.
+   *
+   * Progress guarantees: wait-free
+   *
+   * @return the number of buckets
+   */
+  [[nodiscard]] std::size_t bucket_count() const noexcept;
+
   /**
    * @brief
    *
@@ -290,11 +382,41 @@ private:
 
   using data_t = std::conditional_t<memoize_hash, data_with_hash, data_without_hash>;
 
-  struct node : reclaimer::template enable_concurrent_ptr<node, 1> {
-    data_t data;
+  struct sentinel_tag {};
+  struct split_order_key {
+    hash_t so_key;
+  };
+  struct no_split_order_key {};
+
+  // In resizable mode, every node stores its split-order key, i.e., the bit-reversed hash value.
+  // The bucket sentinels are nodes without data; their split-order keys are even, while the
+  // split-order keys of regular nodes are odd, so a sentinel always precedes the nodes of its bucket.
+  struct node :
+      reclaimer::template enable_concurrent_ptr<node, 1>,
+      std::conditional_t<resizable, split_order_key, no_split_order_key> {
+    union {
+      data_t data;
+    };
     concurrent_ptr next;
     template <class... Args>
-    explicit node(Args&&... args) : data(std::forward<Args>(args)...), next() {}
+    explicit node(Args&&... args) : data(std::forward<Args>(args)...), next() {
+      if constexpr (resizable) {
+        this->so_key = regular_key(data.get_hash());
+      }
+    }
+    node(sentinel_tag, hash_t so_key) : next() { this->so_key = so_key; }
+    ~node() {
+      if (!is_sentinel()) {
+        data.~data_t();
+      }
+    }
+    [[nodiscard]] bool is_sentinel() const noexcept {
+      if constexpr (resizable) {
+        return (this->so_key & 1) == 0;
+      } else {
+        return false;
+      }
+    }
   };
 
   struct find_info {
@@ -306,7 +428,45 @@ private:
 
   bool find(hash_t hash, const Key& key, std::size_t bucket, find_info& info, backoff& backoff);
 
-  concurrent_ptr buckets[num_buckets];
+  // Searches the list starting at info.prev for the first node that is not less than the searched
+  // element; compare returns a negative value if the node is less, zero if it is equal, and a
+  // positive value if it is greater than the searched element.
+  template <class Compare>
+  bool search(std::size_t bucket, find_info& info, backoff& backoff, Compare&& compare);
+
+  std::size_t bucket_index(hash_t hash) const;
+  concurrent_ptr& bucket_head(std::size_t bucket);
+
+  static hash_t regular_key(hash_t hash) { return utils::reverse_bits(hash) | 1; }
+  static hash_t sentinel_key(std::size_t bucket) { return utils::reverse_bits(static_cast<hash_t>(bucket)); }
+
+  struct fixed_buckets {
+    concurrent_ptr heads[num_buckets];
+  };
+
+  struct split_ordered_buckets {
+    // Segment 0 contains the initial num_buckets buckets; every further segment s
+    // contains the buckets [num_buckets << (s - 1), num_buckets << s).
+    static constexpr std::size_t max_segments = sizeof(hash_t) * 8 - utils::find_last_bit_set(num_buckets) + 1;
+    std::atomic<std::size_t> bucket_count{num_buckets};
+    std::atomic<std::atomic<node*>*> segments[max_segments]{};
+  };
+
+  // the number of buckets is doubled once the map contains more than max_load_factor elements per bucket
+  static constexpr std::size_t max_load_factor = 2;
+  // summing up the stripes of the element counter is relatively expensive, so the load factor
+  // is only checked on every grow_check_interval-th insert into a stripe of this map's counter.
+  static constexpr std::size_t grow_check_interval = 16;
+  static constexpr std::size_t max_bucket_count = static_cast<std::size_t>(1) << (sizeof(hash_t) * 8 - 1);
+
+  std::atomic<node*>& bucket_slot(std::size_t bucket);
+  node* get_sentinel(std::size_t bucket);
+  node* initialize_bucket(std::size_t bucket);
+  void grow_if_needed(std::uint64_t stripe_insertions);
+  void remove_all_nodes();
+
+  std::conditional_t<resizable, split_ordered_buckets, fixed_buckets> buckets;
+  detail::striped_counter element_count;
 };
 
 /**
@@ -339,29 +499,10 @@ public:
 
   iterator& operator++() {
     assert(info.cur.get() != nullptr);
-    auto next = info.cur->next.load(std::memory_order_relaxed);
-    guard_ptr tmp_guard;
-    // (1) - this acquire-load synchronizes-with the release-CAS (8, 9, 10, 12, 15)
-    if (next.mark() == 0 && tmp_guard.acquire_if_equal(info.cur->next, next, std::memory_order_acquire)) {
-      info.prev = &info.cur->next;
-      info.save = std::move(info.cur);
-      info.cur = std::move(tmp_guard);
-    } else {
-      // cur is marked for removal
-      // -> use find to remove it and get to the next node with a key >= cur->key
-      // Note: we have to copy key here!
-      Key key = info.cur->data.value.first;
-      hash_t h = info.cur->data.get_hash();
-      backoff backoff;
-      map->find(h, key, bucket, info, backoff);
-    }
-    assert(info.prev == &map->buckets[bucket] || info.cur.get() == nullptr ||
+    advance();
+    assert(info.prev == &map->bucket_head(bucket) || info.cur.get() == nullptr ||
            (info.save.get() != nullptr && &info.save->next == info.prev));
-
-    if (!info.cur) {
-      move_to_next_bucket();
-    }
-
+    move_to_next_element();
     return *this;
   }
   iterator operator++(int) {
@@ -387,13 +528,10 @@ private:
   explicit iterator(harris_michael_hash_map* map) : map(map), bucket(num_buckets) {}
 
   explicit iterator(harris_michael_hash_map* map, std::size_t bucket) : map(map), bucket(bucket) {
-    info.prev = &map->buckets[bucket];
-    // (2) - this acquire-load synchronizes-with the release-CAS (8, 9, 10, 12, 15)
+    info.prev = &map->bucket_head(bucket);
+    // (2) - this acquire-load synchronizes-with the release-CAS (8, 9, 10, 12, 15, 20)
     info.cur.acquire(*info.prev, std::memory_order_acquire);
-
-    if (!info.cur) {
-      move_to_next_bucket();
-    }
+    move_to_next_element();
   }
 
   explicit iterator(harris_michael_hash_map* map, std::size_t bucket, find_info&& info) :
@@ -401,11 +539,59 @@ private:
       bucket(bucket),
       info(std::move(info)) {}
 
+  void advance() {
+    for (;;) {
+      auto next = info.cur->next.load(std::memory_order_relaxed);
+      guard_ptr tmp_guard;
+      // (1) - this acquire-load synchronizes-with the release-CAS (8, 9, 10, 12, 15, 20)
+      if (next.mark() == 0 && tmp_guard.acquire_if_equal(info.cur->next, next, std::memory_order_acquire)) {
+        if constexpr (resizable) {
+          if (info.cur->is_sentinel()) {
+            // remember the sentinel's bucket so find does not have to restart from the beginning
+            bucket = utils::reverse_bits(info.cur->so_key);
+          }
+        }
+        info.prev = &info.cur->next;
+        info.save = std::move(info.cur);
+        info.cur = std::move(tmp_guard);
+        return;
+      }
+
+      if (info.cur->is_sentinel()) {
+        // sentinels are never removed, so the next pointer has just been changed -> retry
+        continue;
+      }
+
+      // cur is marked for removal
+      // -> use find to remove it and get to the next node with a key >= cur->key
+      // Note: we have to copy key here!
+      Key key = info.cur->data.value.first;
+      hash_t h = info.cur->data.get_hash();
+      backoff backoff;
+      map->find(h, key, bucket, info, backoff);
+      return;
+    }
+  }
+
+  void move_to_next_element() {
+    if constexpr (resizable) {
+      // all elements are stored in a single list, so we only have to skip the sentinels
+      while (info.cur && info.cur->is_sentinel()) {
+        advance();
+      }
+      if (!info.cur) {
+        info.save.reset();
+      }
+    } else if (!info.cur) {
+      move_to_next_bucket();
+    }
+  }
+
   void move_to_next_bucket() {
     info.save.reset();
     while (!info.cur && bucket < num_buckets - 1) {
       ++bucket;
-      info.prev = &map->buckets[bucket];
+      info.prev = &map->bucket_head(bucket);
       // (3) - this acquire-load synchronizes-with the release-CAS (8, 9, 10, 12, 15)
       info.cur.acquire(*info.prev, std::memory_order_acquire);
     }
@@ -438,27 +624,419 @@ private:
   friend harris_michael_hash_map;
 };
 
+template <class Key, class Value, class... Policies>
+harris_michael_hash_map<Key, Value, Policies...>::harris_michael_hash_map() {
+  if constexpr (resizable) {
+    // the sentinel of bucket 0 is the head of the split-ordered list, so we initialize it eagerly
+    bucket_slot(0).store(new node(sentinel_tag{}, sentinel_key(0)), std::memory_order_relaxed);
+  }
+}
+
 template <class Key, class Value, class... Policies>
 harris_michael_hash_map<Key, Value, Policies...>::~harris_michael_hash_map() {
-  for (std::size_t i = 0; i < num_buckets; ++i) {
-    // (4) - this acquire-load synchronizes-with the release-CAS (8, 9, 10, 12, 15)
-    auto p = buckets[i].load(std::memory_order_acquire);
+  if constexpr (resizable) {
+    // all nodes (including the sentinels) are part of the list that starts at bucket 0
+    node* p = bucket_slot(0).load(std::memory_order_relaxed);
     while (p) {
-      // (5) - this acquire-load synchronizes-with the release-CAS (8, 9, 10, 12, 15)
+      // (21) - this acquire-load synchronizes-with the release-CAS (8, 9, 10, 12, 15, 20)
       auto next = p->next.load(std::memory_order_acquire);
-      delete p.get();
+      delete p;
+      p = next.get();
+    }
+    for (auto& segment : buckets.segments) {
+      delete[] segment.load(std::memory_order_relaxed);
+    }
+  } else {
+    for (std::size_t i = 0; i < num_buckets; ++i) {
+      // (4) - this acquire-load synchronizes-with the release-CAS (8, 9, 10, 12, 15)
+      auto p = buckets.heads[i].load(std::memory_order_acquire);
+      while (p) {
+        // (5) - this acquire-load synchronizes-with the release-CAS (8, 9, 10, 12, 15)
+        auto next = p->next.load(std::memory_order_acquire);
+        delete p.get();
+        p = next;
+      }
+    }
+  }
+}
+
+template <class Key, class Value, class... Policies>
+std::size_t harris_michael_hash_map<Key, Value, Policies...>::bucket_count() const noexcept {
+  if constexpr (resizable) {
+    return buckets.bucket_count.load(std::memory_order_relaxed);
+  } else {
+    return num_buckets;
+  }
+}
+
+template <class Key, class Value, class... Policies>
+std::size_t harris_michael_hash_map<Key, Value, Policies...>::bucket_index(hash_t hash) const {
+  if constexpr (resizable) {
+    // Any bucket count that has been valid at some point would work here, since the sentinel
+    // of a bucket with a smaller bucket count precedes all nodes of the corresponding
+    // buckets with a larger bucket count.
+    return hash & (buckets.bucket_count.load(std::memory_order_relaxed) - 1);
+  } else {
+    return map_to_bucket{}(hash, num_buckets);
+  }
+}
+
+template <class Key, class Value, class... Policies>
+auto harris_michael_hash_map<Key, Value, Policies...>::bucket_head(std::size_t bucket) -> concurrent_ptr& {
+  if constexpr (resizable) {
+    return get_sentinel(bucket)->next;
+  } else {
+    return buckets.heads[bucket];
+  }
+}
+
+template <class Key, class Value, class... Policies>
+auto harris_michael_hash_map<Key, Value, Policies...>::bucket_slot(std::size_t bucket) -> std::atomic<node*>& {
+  static_assert(resizable);
+  constexpr unsigned initial_bits = utils::find_last_bit_set(num_buckets) - 1;
+  std::size_t segment_idx = 0;
+  std::size_t segment_size = num_buckets;
+  std::size_t idx = bucket;
+  if (bucket >= num_buckets) {
+    const unsigned msb = utils::find_last_bit_set(bucket) - 1;
+    segment_idx = msb - initial_bits + 1;
+    segment_size = static_cast<std::size_t>(1) << msb;
+    idx = bucket - segment_size;
+  }
+  assert(segment_idx < split_ordered_buckets::max_segments);
+
+  auto& segment = buckets.segments[segment_idx];
+  // (16) - this acquire-load synchronizes-with the release-CAS (17)
+  auto* slots = segment.load(std::memory_order_acquire);
+  if (slots == nullptr) {
+    auto* new_slots = new std::atomic<node*>[segment_size]();
+    // (17) - this release-CAS synchronizes-with the acquire-load (16)
+    if (segment.compare_exchange_strong(slots, new_slots, std::memory_order_release, std::memory_order_acquire)) {
+      slots = new_slots;
+    } else {
+      delete[] new_slots;
+    }
+  }
+  return slots[idx];
+}
+
+template <class Key, class Value, class... Policies>
+auto harris_michael_hash_map<Key, Value, Policies...>::get_sentinel(std::size_t bucket) -> node* {
+  // (18) - this acquire-load synchronizes-with the release-store (19)
+  node* sentinel = bucket_slot(bucket).load(std::memory_order_acquire);
+  if (sentinel == nullptr) {
+    sentinel = initialize_bucket(bucket);
+  }
+  return sentinel;
+}
+
+template <class Key, class Value, class... Policies>
+auto harris_michael_hash_map<Key, Value, Policies...>::initialize_bucket(std::size_t bucket) -> node* {
+  assert(bucket != 0);
+  // the parent bucket is obtained by clearing the most significant bit of the bucket index;
+  // the new sentinel is inserted into the list starting at the parent's sentinel.
+  const std::size_t parent = bucket & ~(static_cast<std::size_t>(1) << (utils::find_last_bit_set(bucket) - 1));
+  node* parent_sentinel = get_sentinel(parent);
+
+  const hash_t so_key = sentinel_key(bucket);
+  node* sentinel = new node(sentinel_tag{}, so_key);
+  find_info info{&parent_sentinel->next};
+  backoff backoff;
+  for (;;) {
+    auto compare = [so_key](const node& n) -> int {
+      if (n.so_key == so_key) {
+        return 0;
+      }
+      return n.so_key < so_key ? -1 : 1;
+    };
+    if (search(parent, info, backoff, compare)) {
+      // some other thread has already inserted the sentinel for this bucket
+      delete sentinel;
+      sentinel = info.cur.get();
+      break;
+    }
+
+    marked_ptr cur = info.cur.get();
+    sentinel->next.store(cur, std::memory_order_relaxed);
+    // (20) - this release-CAS synchronizes with the acquire-load (1, 2, 6, 7, 13, 21)
+    //        and the acquire-CAS (11, 14)
+    //        it is the head of a potential release sequence containing (11, 14)
+    if (info.prev->compare_exchange_weak(cur, sentinel, std::memory_order_release, std::memory_order_relaxed)) {
+      break;
+    }
+    backoff();
+  }
+
+  // other threads might concurrently store the same sentinel, but that does not matter
+  // (19) - this release-store synchronizes-with the acquire-load (18)
+  bucket_slot(bucket).store(sentinel, std::memory_order_release);
+  return sentinel;
+}
+
+template <class Key, class Value, class... Policies>
+void harris_michael_hash_map<Key, Value, Policies...>::grow_if_needed([[maybe_unused]] std::uint64_t stripe_insertions) {
+  if constexpr (resizable) {
+    if (stripe_insertions % grow_check_interval != 0) {
+      return;
+    }
+
+    auto count = buckets.bucket_count.load(std::memory_order_relaxed);
+    if (count < max_bucket_count && approximate_size() > count * max_load_factor) {
+      // the new buckets are initialized lazily, so all we have to do is to double the bucket count
+      buckets.bucket_count.compare_exchange_strong(count, count * 2, std::memory_order_relaxed);
+    }
+  }
+}
+
+template <class Key, class Value, class... Policies>
+void harris_michael_hash_map<Key, Value, Policies...>::remove_all_nodes() {
+  // There must not be any concurrent operations, so we can simply unlink all remaining nodes
+  // (which must all be marked for removal if the map is empty) and reclaim them.
+  if constexpr (resizable) {
+    node* last_sentinel = bucket_slot(0).load(std::memory_order_relaxed);
+    node* p = last_sentinel->next.load(std::memory_order_relaxed).get();
+    while (p) {
+      node* next = p->next.load(std::memory_order_relaxed).get();
+      if (p->is_sentinel()) {
+        last_sentinel->next.store(p, std::memory_order_relaxed);
+        last_sentinel = p;
+      } else {
+        guard_ptr g(p);
+        g.reclaim();
+      }
       p = next;
     }
+    last_sentinel->next.store(nullptr, std::memory_order_relaxed);
+  } else {
+    for (auto& head : buckets.heads) {
+      node* p = head.load(std::memory_order_relaxed).get();
+      head.store(nullptr, std::memory_order_relaxed);
+      while (p) {
+        node* next = p->next.load(std::memory_order_relaxed).get();
+        guard_ptr g(p);
+        g.reclaim();
+        p = next;
+      }
+    }
   }
 }
 
+template <class Key, class Value, class... Policies>
+template <class RandomIt>
+void harris_michael_hash_map<Key, Value, Policies...>::bulk_build(RandomIt first,
+                                                                  RandomIt last,
+                                                                  std::size_t num_threads) {
+  if (size() != 0) {
+    throw std::logic_error("harris_michael_hash_map::bulk_build can only be called on an empty map");
+  }
+
+  // it does not pay off to start a thread for only a handful of elements
+  constexpr std::size_t min_elements_per_thread = 1024;
+  const auto count = static_cast<std::size_t>(std::distance(first, last));
+  num_threads = std::max<std::size_t>(1, std::min(num_threads, count / min_elements_per_thread));
+
+  remove_all_nodes();
+
+  std::size_t bucket_count = num_buckets;
+  if constexpr (resizable) {
+    // new buckets are initialized lazily, so it is safe to increase the bucket count upfront
+    bucket_count = buckets.bucket_count.load(std::memory_order_relaxed);
+    while (bucket_count < max_bucket_count && count > bucket_count * max_load_factor) {
+      bucket_count *= 2;
+    }
+    buckets.bucket_count.store(bucket_count, std::memory_order_relaxed);
+  }
+
+  // every thread is responsible for a contiguous range of buckets
+  const std::size_t buckets_per_partition = (bucket_count + num_threads - 1) / num_threads;
+
+  struct entry {
+    std::size_t bucket;
+    node* n;
+  };
+  // nodes[t][p] contains the nodes created by thread t that belong to partition p; once the
+  // nodes of partition p have been sorted, they are moved to nodes[p][p].
+  std::vector<std::vector<std::vector<entry>>> nodes(num_threads, std::vector<std::vector<entry>>(num_threads));
+  // sentinels[p] contains the sentinels of all buckets in partition p (only used in resizable mode)
+  std::vector<std::vector<node*>> sentinels(num_threads);
+  std::vector<std::size_t> inserted(num_threads);
+  try {
+    // Phase 1: every thread creates the nodes for a contiguous chunk of the input.
+    detail::parallel_for(num_threads, [&](std::size_t t) {
+      const std::size_t begin = count * t / num_threads;
+      const std::size_t end = count * (t + 1) / num_threads;
+      auto& local = nodes[t];
+      for (auto& partition : local) {
+        partition.reserve((end - begin) / num_threads);
+      }
+      for (std::size_t i = begin; i != end; ++i) {
+        auto n = std::make_unique<node>(construct_without_hash{}, first[i]);
+        const std::size_t bucket = bucket_index(n->data.get_hash());
+        local[bucket / buckets_per_partition].push_back({bucket, n.get()});
+        n.release();
+      }
+    });
+
+    // Phase 2: every thread sorts the nodes of its partition in the order in which they would be
+    // stored in the bucket lists and removes duplicates. In resizable mode, it also creates the
+    // missing sentinels.
+    detail::parallel_for(num_threads, [&](std::size_t p) {
+      std::vector<entry> partition;
+      for (auto& local : nodes) {
+        partition.insert(partition.end(), local[p].begin(), local[p].end());
+        std::vector<entry>().swap(local[p]);
+      }
+      // from here on, the partition's nodes are owned by nodes[p][p]
+      nodes[p][p].swap(partition);
+      auto& sorted = nodes[p][p];
+
+      std::stable_sort(sorted.begin(), sorted.end(), [](const entry& l, const entry& r) {
+        if (l.bucket != r.bucket) {
+          return l.bucket < r.bucket;
+        }
+        if constexpr (resizable) {
+          if (l.n->so_key != r.n->so_key) {
+            return l.n->so_key < r.n->so_key;
+          }
+        }
+        return !(l.n->data.value.first >= r.n->data.value.first);
+      });
+
+      // stable_sort preserves the input order of equivalent keys, so we keep the first one
+      auto is_duplicate = [](const entry& l, const entry& r) {
+        return l.bucket == r.bucket && l.n->data.value.first == r.n->data.value.first;
+      };
+      auto out = sorted.begin();
+      for (auto it = sorted.begin(); it != sorted.end(); ++it) {
+        if (out != sorted.begin() && is_duplicate(*(out - 1), *it)) {
+          delete it->n;
+        } else {
+          *out++ = *it;
+        }
+      }
+      sorted.erase(out, sorted.end());
+      inserted[p] = sorted.size();
+
+      if constexpr (resizable) {
+        const std::size_t begin = std::min(p * buckets_per_partition, bucket_count);
+        const std::size_t end = std::min(begin + buckets_per_partition, bucket_count);
+        auto& local_sentinels = sentinels[p];
+        local_sentinels.reserve(end - begin);
+        for (std::size_t b = begin; b != end; ++b) {
+          // Note: bucket_slot also allocates the segment if necessary
+          node* sentinel = bucket_slot(b).load(std::memory_order_relaxed);
+          local_sentinels.push_back(sentinel ? sentinel : new node(sentinel_tag{}, sentinel_key(b)));
+        }
+      }
+    });
+  } catch (...) {
+    for (auto& local : nodes) {
+      for (auto& partition : local) {
+        for (auto& e : partition) {
+          delete e.n;
+        }
+      }
+    }
+    if constexpr (resizable) {
+      // delete the sentinels that have been created, but not yet stored in their bucket slots
+      for (std::size_t p = 0; p != sentinels.size(); ++p) {
+        for (std::size_t i = 0; i != sentinels[p].size(); ++i) {
+          if (bucket_slot(p * buckets_per_partition + i).load(std::memory_order_relaxed) != sentinels[p][i]) {
+            delete sentinels[p][i];
+          }
+        }
+      }
+    }
+    throw;
+  }
+
+  // Phase 3: every thread links the nodes of its partition. This cannot fail anymore.
+  // Relaxed stores are sufficient, since bulk_build must not run concurrently with other
+  // operations and the nodes are published to other threads by joining the worker threads.
+  auto sentinel_of = [&](std::size_t bucket) {
+    return sentinels[bucket / buckets_per_partition][bucket % buckets_per_partition];
+  };
+  // returns the sentinel that follows the given bucket's sentinel in the split-ordered list
+  auto next_sentinel = [&](std::size_t bucket) -> node* {
+    const unsigned shift = sizeof(hash_t) * 8 - (utils::find_last_bit_set(bucket_count) - 1);
+    if (bucket_count == 1 || utils::reverse_bits(static_cast<hash_t>(bucket)) >> shift == bucket_count - 1) {
+      return nullptr;
+    }
+    const hash_t next_position = (utils::reverse_bits(static_cast<hash_t>(bucket)) >> shift) + 1;
+    return sentinel_of(utils::reverse_bits(next_position) >> shift);
+  };
+  detail::parallel_for(num_threads, [&](std::size_t p) {
+    const auto& sorted = nodes[p][p];
+    const std::size_t begin = std::min(p * buckets_per_partition, bucket_count);
+    const std::size_t end = std::min(begin + buckets_per_partition, bucket_count);
+    auto it = sorted.begin();
+    for (std::size_t b = begin; b != end; ++b) {
+      node* tail = nullptr;
+      if constexpr (resizable) {
+        tail = next_sentinel(b);
+      }
+      // link the nodes of bucket b back to front
+      auto bucket_end = std::find_if(it, sorted.end(), [b](const entry& e) { return e.bucket != b; });
+      for (auto n = bucket_end; n != it;) {
+        --n;
+        n->n->next.store(tail, std::memory_order_relaxed);
+        tail = n->n;
+      }
+      it = bucket_end;
+
+      if constexpr (resizable) {
+        node* sentinel = sentinel_of(b);
+        sentinel->next.store(tail, std::memory_order_relaxed);
+        bucket_slot(b).store(sentinel, std::memory_order_relaxed);
+      } else {
+        buckets.heads[b].store(tail, std::memory_order_relaxed);
+      }
+    }
+  });
+
+  std::size_t total = 0;
+  for (auto cnt : inserted) {
+    total += cnt;
+  }
+  element_count.increment(total);
+}
+
 template <class Key, class Value, class... Policies>
 bool harris_michael_hash_map<Key, Value, Policies...>::find(hash_t hash,
                                                             const Key& key,
                                                             std::size_t bucket,
                                                             find_info& info,
                                                             backoff& backoff) {
-  auto& head = buckets[bucket];
+  if constexpr (resizable) {
+    const hash_t so_key = regular_key(hash);
+    return search(bucket, info, backoff, [so_key, &key](const node& n) -> int {
+      if (n.so_key != so_key) {
+        return n.so_key < so_key ? -1 : 1;
+      }
+      const Key& k = n.data.value.first;
+      if (k >= key) {
+        return k == key ? 0 : 1;
+      }
+      return -1;
+    });
+  } else {
+    return search(bucket, info, backoff, [hash, &key](const node& n) -> int {
+      const auto& data = n.data;
+      if (data.greater_or_equal(hash, key)) {
+        return data.value.first == key ? 0 : 1;
+      }
+      return -1;
+    });
+  }
+}
+
+template <class Key, class Value, class... Policies>
+template <class Compare>
+bool harris_michael_hash_map<Key, Value, Policies...>::search(std::size_t bucket,
+                                                              find_info& info,
+                                                              backoff& backoff,
+                                                              Compare&& compare) {
+  auto& head = bucket_head(bucket);
   assert((info.save == nullptr && info.prev == &head) || &info.save->next == info.prev);
   concurrent_ptr* start = info.prev;
   guard_ptr start_guard = info.save; // we have to keep a guard_ptr to prevent start's node from getting reclaimed.
@@ -474,7 +1052,7 @@ retry:
   }
 
   for (;;) {
-    // (6) - this acquire-load synchronizes-with the release-CAS (8, 9, 10, 12, 15)
+    // (6) - this acquire-load synchronizes-with the release-CAS (8, 9, 10, 12, 15, 20)
     if (!info.cur.acquire_if_equal(*info.prev, info.next, std::memory_order_acquire)) {
       goto retry;
     }
@@ -487,12 +1065,12 @@ retry:
     if (info.next.mark() != 0) {
       // Node *cur is marked for deletion -> update the link and retire the element
 
-      // (7) - this acquire-load synchronizes-with the release-CAS (8, 9, 10, 12, 15)
+      // (7) - this acquire-load synchronizes-with the release-CAS (8, 9, 10, 12, 15, 20)
       info.next = info.cur->next.load(std::memory_order_acquire).get();
 
       // Try to splice out node
       marked_ptr expected = info.cur.get();
-      // (8) - this release-CAS synchronizes with the acquire-load (1, 2, 3, 4, 5, 6, 7, 13)
+      // (8) - this release-CAS synchronizes with the acquire-load (1, 2, 3, 4, 5, 6, 7, 13, 21)
       //       and the acquire-CAS (11, 14)
       //       it is the head of a potential release sequence containing (11, 14)
       if (!info.prev->compare_exchange_weak(
@@ -506,9 +1084,9 @@ retry:
         goto retry; // cur might be cut from the hash_map.
       }
 
-      const auto& data = info.cur->data;
-      if (data.greater_or_equal(hash, key)) {
-        return data.value.first == key;
+      const int cmp = compare(*info.cur);
+      if (cmp >= 0) {
+        return cmp == 0;
       }
 
       info.prev = &info.cur->next;
@@ -520,8 +1098,8 @@ retry:
 template <class Key, class Value, class... Policies>
 bool harris_michael_hash_map<Key, Value, Policies...>::contains(const Key& key) {
   auto h = hash{}(key);
-  auto bucket = map_to_bucket{}(h, num_buckets);
-  find_info info{&buckets[bucket]};
+  auto bucket = bucket_index(h);
+  find_info info{&bucket_head(bucket)};
   backoff backoff;
   return find(h, key, bucket, info, backoff);
 }
@@ -529,8 +1107,8 @@ bool harris_michael_hash_map<Key, Value, Policies...>::contains(const Key& key)
 template <class Key, class Value, class... Policies>
 auto harris_michael_hash_map<Key, Value, Policies...>::find(const Key& key) -> iterator {
   auto h = hash{}(key);
-  auto bucket = map_to_bucket{}(h, num_buckets);
-  find_info info{&buckets[bucket]};
+  auto bucket = bucket_index(h);
+  find_info info{&bucket_head(bucket)};
   backoff backoff;
   if (find(h, key, bucket, info, backoff)) {
     return iterator(this, bucket, std::move(info));
@@ -571,10 +1149,10 @@ auto harris_michael_hash_map<Key, Value, Policies...>::do_get_or_emplace_lazy(Ke
   -> std::pair<iterator, bool> {
   node* n = nullptr;
   auto h = hash{}(key);
-  auto bucket = map_to_bucket{}(h, num_buckets);
+  auto bucket = bucket_index(h);
 
   const Key* pkey = &key;
-  find_info info{&buckets[bucket]};
+  find_info info{&bucket_head(bucket)};
   backoff backoff;
   for (;;) {
     if (find(h, *pkey, bucket, info, backoff)) {
@@ -592,10 +1170,11 @@ auto harris_michael_hash_map<Key, Value, Policies...>::do_get_or_emplace_lazy(Ke
     info.cur = guard_ptr(n);
     n->next.store(cur, std::memory_order_relaxed);
 
-    // (9) - this release-CAS synchronizes with the acquire-load (1, 2, 3, 4, 5, 6, 7, 13)
+    // (9) - this release-CAS synchronizes with the acquire-load (1, 2, 3, 4, 5, 6, 7, 13, 21)
     //       and the acquire-CAS (11, 14)
     //       it is the head of a potential release sequence containing (11, 14)
     if (info.prev->compare_exchange_weak(cur, n, std::memory_order_release, std::memory_order_relaxed)) {
+      grow_if_needed(element_count.increment());
       return {iterator(this, bucket, std::move(info)), true};
     }
 
@@ -609,9 +1188,9 @@ auto harris_michael_hash_map<Key, Value, Policies...>::emplace_or_get(Args&&...
   node* n = new node(construct_without_hash{}, std::forward<Args>(args)...);
 
   auto h = n->data.get_hash();
-  auto bucket = map_to_bucket{}(h, num_buckets);
+  auto bucket = bucket_index(h);
 
-  find_info info{&buckets[bucket]};
+  find_info info{&bucket_head(bucket)};
   backoff backoff;
   for (;;) {
     if (find(h, n->data.value.first, bucket, info, backoff)) {
@@ -623,10 +1202,11 @@ auto harris_michael_hash_map<Key, Value, Policies...>::emplace_or_get(Args&&...
     n->next.store(expected, std::memory_order_relaxed);
     guard_ptr new_guard(n);
 
-    // (10) - this release-CAS synchronizes with the acquire-load (1, 2, 3, 4, 5, 6, 7, 13)
+    // (10) - this release-CAS synchronizes with the acquire-load (1, 2, 3, 4, 5, 6, 7, 13, 21)
     //        and the acquire-CAS (11, 14)
     //        it is the head of a potential release sequence containing (11, 14)
     if (info.prev->compare_exchange_weak(expected, n, std::memory_order_release, std::memory_order_relaxed)) {
+      grow_if_needed(element_count.increment());
       info.cur = std::move(new_guard);
       return {iterator(this, bucket, std::move(info)), true};
     }
@@ -638,25 +1218,26 @@ auto harris_michael_hash_map<Key, Value, Policies...>::emplace_or_get(Args&&...
 template <class Key, class Value, class... Policies>
 bool harris_michael_hash_map<Key, Value, Policies...>::erase(const Key& key) {
   auto h = hash{}(key);
-  auto bucket = map_to_bucket{}(h, num_buckets);
+  auto bucket = bucket_index(h);
   backoff backoff;
-  find_info info{&buckets[bucket]};
+  find_info info{&bucket_head(bucket)};
   // Find node in hash_map with matching key and mark it for erasure.
   do {
     if (!find(h, key, bucket, info, backoff)) {
       return false; // No such node in the hash_map
     }
-    // (11) - this acquire-CAS synchronizes with the release-CAS (8, 9, 10, 12, 15)
+    // (11) - this acquire-CAS synchronizes with the release-CAS (8, 9, 10, 12, 15, 20)
     //        and is part of a release sequence headed by those operations
   } while (!info.cur->next.compare_exchange_weak(
     info.next, marked_ptr(info.next.get(), 1), std::memory_order_acquire, std::memory_order_relaxed));
 
   assert(info.next.mark() == 0);
   assert(info.cur.mark() == 0);
+  element_count.decrement();
 
   // Try to splice out node
   marked_ptr expected = info.cur;
-  // (12) - this release-CAS synchronizes with the acquire-load (1, 2, 3, 4, 5, 6, 7, 13)
+  // (12) - this release-CAS synchronizes with the acquire-load (1, 2, 3, 4, 5, 6, 7, 13, 21)
   //        and the acquire-CAS (11, 14)
   //        it is the head of a potential release sequence containing (11, 14)
   if (info.prev->compare_exchange_weak(
@@ -674,12 +1255,14 @@ bool harris_michael_hash_map<Key, Value, Policies...>::erase(const Key& key) {
 template <class Key, class Value, class... Policies>
 auto harris_michael_hash_map<Key, Value, Policies...>::erase(iterator pos) -> iterator {
   backoff backoff;
-  // (13) - this acquire-load synchronizes-with the release-CAS (8, 9, 10, 12, 15)
+  // (13) - this acquire-load synchronizes-with the release-CAS (8, 9, 10, 12, 15, 20)
   auto next = pos.info.cur->next.load(std::memory_order_acquire);
   while (next.mark() == 0) {
-    // (14) - this acquire-CAS synchronizes with the release-CAS (8, 9, 10, 12, 15)
+    // (14) - this acquire-CAS synchronizes with the release-CAS (8, 9, 10, 12, 15, 20)
     //        and is part of a release sequence headed by those operations
     if (pos.info.cur->next.compare_exchange_weak(next, marked_ptr(next.get(), 1), std::memory_order_acquire)) {
+      // only the thread that successfully marks the node accounts for its removal
+      element_count.decrement();
       break;
     }
 
@@ -691,7 +1274,7 @@ auto harris_michael_hash_map<Key, Value, Policies...>::erase(iterator pos) -> it
 
   // Try to splice out node
   marked_ptr expected = pos.info.cur;
-  // (15) - this release-CAS synchronizes with the acquire-load (1, 2, 3, 4, 5, 6, 7, 13)
+  // (15) - this release-CAS synchronizes with the acquire-load (1, 2, 3, 4, 5, 6, 7, 13, 21)
   //        and the acquire-CAS (11, 14)
   //        it is the head of a potential release sequence containing (11, 14)
   if (pos.info.prev->compare_exchange_weak(
@@ -707,10 +1290,7 @@ auto harris_michael_hash_map<Key, Value, Policies...>::erase(iterator pos) -> it
     find(h, key, pos.bucket, pos.info, backoff);
   }
 
-  if (!pos.info.cur) {
-    pos.move_to_next_bucket();
-  }
-
+  pos.move_to_next_element();
   return pos;
 }
 
@@ -20,7 +20,8 @@ namespace xenium {
  *
  * This container is implemented as a sorted singly linked list. All operations have
  * a runtime complexity linear in the size of the list (in the absence of conflicting
- * operations).
+ * operations). For access patterns with (mostly) increasing keys, a thread can use a
+ * `search_finger` to start operations from a recently visited node instead of the head.
  *
  * This data structure is based on the solution proposed by Michael \[[Mic02](index.html#ref-michael-2002)\]
  * which builds upon the original proposal by Harris \[[Har01](index.html#ref-harris-2001)\].
@@ -53,6 +54,7 @@ public:
   ~harris_michael_list_based_set();
 
   class iterator;
+  class search_finger;
 
   /**
    * @brief Inserts a new element into the container if the container doesn't already contain an
@@ -71,6 +73,21 @@ public:
   template <class... Args>
   bool emplace(Args&&... args);
 
+  /**
+   * @brief Same as `emplace`, but starts the search from the node remembered in the given
+   * finger if that node is still in the list and its key is less than the new element's key.
+   *
+   * Afterwards the finger refers to the predecessor of the new (or already existing) element.
+   *
+   * Progress guarantees: lock-free
+   *
+   * @param finger the calling thread's search finger
+   * @param args arguments to forward to the constructor of the element
+   * @return `true` if an element was inserted, otherwise `false`
+   */
+  template <class... Args>
+  bool emplace_hint(search_finger& finger, Args&&... args);
+
   /**
    * @brief Inserts a new element into the container if the container doesn't already contain an
    * element with an equivalent key. The element is constructed in-place with the given `args`.
@@ -102,6 +119,18 @@ public:
    */
   bool erase(const Key& key);
 
+  /**
+   * @brief Same as `erase(const Key&)`, but starts the search from the node remembered in
+   * the given finger if possible (see `emplace_hint`).
+   *
+   * Progress guarantees: lock-free
+   *
+   * @param key key of the element to remove
+   * @param finger the calling thread's search finger
+   * @return `true` if an element was removed, otherwise `false`
+   */
+  bool erase(const Key& key, search_finger& finger);
+
   /**
    * @brief Removes the specified element from the container.
    *
@@ -135,6 +164,61 @@ public:
    */
   bool contains(const Key& key);
 
+  /**
+   * @brief Same as `contains(const Key&)`, but starts the search from the node remembered in
+   * the given finger if possible (see `emplace_hint`).
+   *
+   * Progress guarantees: lock-free
+   *
+   * @param key key of the element to search for
+   * @param finger the calling thread's search finger
+   * @return `true` if there is such an element, otherwise `false`
+   */
+  bool contains(const Key& key, search_finger& finger);
+
+  /**
+   * @brief Returns an iterator to the first element that is not less than key.
+   *
+   * Progress guarantees: lock-free
+   *
+   * @param key key to compare the elements to
+   * @return iterator to the first element that is not less than key, or past-the-end iterator
+   * if no such element is found
+   */
+  iterator lower_bound(const Key& key);
+
+  /**
+   * @brief Returns an iterator to the first element that is greater than key.
+   *
+   * Progress guarantees: lock-free
+   *
+   * @param key key to compare the elements to
+   * @return iterator to the first element that is greater than key, or past-the-end iterator
+   * if no such element is found
+   */
+  iterator upper_bound(const Key& key);
+
+  /**
+   * @brief Calls `func` for each element in the range `[lo, hi)` in ascending order.
+   *
+   * The scan starts with a search for `lo` and then follows the `next` pointers. Instead of
+   * advancing an iterator (which requires a temporary third `guard_ptr` per step), the scan
+   * alternates between two `guard_ptr` instances. If the current element is removed concurrently,
+   * the scan searches for its successor, so every key is passed to `func` at most once and
+   * the keys are strictly increasing.
+   *
+   * `func` is called with a `const Key&` that is only valid for the duration of the call. It must
+   * not modify the container.
+   *
+   * Progress guarantees: lock-free
+   *
+   * @param lo lower bound (inclusive) of the range
+   * @param hi upper bound (exclusive) of the range
+   * @param func function to call for every element in the range
+   */
+  template <class Func>
+  void for_each_in_range(const Key& lo, const Key& hi, Func&& func);
+
   /**
    * @brief Returns an iterator to the first element of the container.
    * @return iterator to the first element
@@ -163,10 +247,52 @@ private:
     guard_ptr save{};
   };
   bool find(const Key& key, find_info& info, backoff& backoff);
+  void start_from_finger(const Key& key, find_info& info, search_finger& finger);
+  std::pair<iterator, bool> insert_node(find_info& info, node* n);
+  bool erase(const Key& key, find_info& info);
+  void advance(find_info& info, backoff& backoff);
 
   concurrent_ptr head;
 };
 
+/**
+ * @brief A per-thread hint that remembers a recently visited node of the list.
+ *
+ * Operations that take a finger start their search from the remembered node if its key is
+ * less than the searched key, and fall back to the head of the list if the node has been
+ * removed in the meantime. When keys are accessed in (mostly) increasing order, e.g., when
+ * the keys are timestamps, this reduces the search to a few steps.
+ *
+ * A finger must only be used by a single thread at a time. It can be used with different
+ * lists, but it only remembers a node of the list it was used with last.
+ *
+ * *Note:* A finger holds a `guard_ptr` to the remembered node, so this node cannot be
+ * reclaimed while it is referenced. For epoch-based reclamation schemes this also delays
+ * the reclamation of any other node, so a finger should be reset if the thread does not
+ * plan to use it for a while. Fingers must be reset or destroyed before the list is destroyed.
+ */
+template <class Key, class... Policies>
+class harris_michael_list_based_set<Key, Policies...>::search_finger {
+public:
+  search_finger() = default;
+  search_finger(search_finger&&) noexcept = default;
+  search_finger& operator=(search_finger&&) noexcept = default;
+
+  /**
+   * @brief Releases the remembered node.
+   */
+  void reset() noexcept {
+    list = nullptr;
+    node.reset();
+  }
+
+private:
+  friend harris_michael_list_based_set;
+
+  const harris_michael_list_based_set* list = nullptr;
+  guard_ptr node{};
+};
+
 /**
  * @brief A ForwardIterator to safely iterate the list.
  *
@@ -324,7 +450,7 @@ retry:
 
       // Try to splice out node
       marked_ptr expected = info.cur.get();
-      // (7) - this release-CAS synchronizes with the acquire-load (1, 2, 3, 4, 5, 6, 11)
+      // (7) - this release-CAS synchronizes with the acquire-load (1, 2, 3, 4, 5, 6, 11, 14)
       //       and the require-CAS (9, 12)
       //       it is the head of a potential release sequence containing (9, 12)
       if (!info.prev->compare_exchange_weak(
@@ -357,6 +483,35 @@ bool harris_michael_list_based_set<Key, Policies...>::contains(const Key& key) {
   return find(key, info, backoff);
 }
 
+template <class Key, class... Policies>
+bool harris_michael_list_based_set<Key, Policies...>::contains(const Key& key, search_finger& finger) {
+  find_info info{&head};
+  start_from_finger(key, info, finger);
+  backoff backoff;
+  bool result = find(key, info, backoff);
+  finger.node = std::move(info.save);
+  return result;
+}
+
+template <class Key, class... Policies>
+void harris_michael_list_based_set<Key, Policies...>::start_from_finger(const Key& key,
+                                                                         find_info& info,
+                                                                         search_finger& finger) {
+  if (finger.list == this && finger.node) {
+    compare compare;
+    if (compare(finger.node->key, key)) {
+      // The guard is moved rather than copied so that the search does not require an
+      // additional guard. If the node has been marked for removal in the meantime, find
+      // detects this and restarts from the head of the list.
+      info.prev = &finger.node->next;
+      info.save = std::move(finger.node);
+      return;
+    }
+  }
+  finger.list = this;
+  finger.node.reset();
+}
+
 template <class Key, class... Policies>
 auto harris_michael_list_based_set<Key, Policies...>::find(const Key& key) -> iterator {
   find_info info{&head};
@@ -367,6 +522,65 @@ auto harris_michael_list_based_set<Key, Policies...>::find(const Key& key) -> it
   return end();
 }
 
+template <class Key, class... Policies>
+void harris_michael_list_based_set<Key, Policies...>::advance(find_info& info, backoff& backoff) {
+  assert(info.cur.get() != nullptr);
+  for (;;) {
+    auto next = info.cur->next.load(std::memory_order_relaxed);
+    // We reuse the guard of our predecessor to protect the next node; once cur has been advanced,
+    // the old cur becomes the new predecessor, so two guards are sufficient.
+    // (14) - this acquire-load synchronizes-with the release-CAS (7, 8, 10, 13)
+    if (next.mark() == 0 && info.save.acquire_if_equal(info.cur->next, next, std::memory_order_acquire)) {
+      info.prev = &info.cur->next;
+      std::swap(info.save, info.cur);
+      return;
+    }
+
+    if (!info.save) {
+      // we have lost the guard for our predecessor -> search from head
+      info.prev = &head;
+    }
+    // cur is marked for removal or its next pointer has changed
+    // -> use find to get to the first node with a key that is not less than cur->key. If this is
+    //    not a new node with a key greater than cur->key, we have to advance once more.
+    Key key = info.cur->key;
+    if (!find(key, info, backoff)) {
+      return;
+    }
+  }
+}
+
+template <class Key, class... Policies>
+auto harris_michael_list_based_set<Key, Policies...>::lower_bound(const Key& key) -> iterator {
+  find_info info{&head};
+  backoff backoff;
+  find(key, info, backoff);
+  return iterator(*this, std::move(info));
+}
+
+template <class Key, class... Policies>
+auto harris_michael_list_based_set<Key, Policies...>::upper_bound(const Key& key) -> iterator {
+  find_info info{&head};
+  backoff backoff;
+  if (find(key, info, backoff)) {
+    advance(info, backoff);
+  }
+  return iterator(*this, std::move(info));
+}
+
+template <class Key, class... Policies>
+template <class Func>
+void harris_michael_list_based_set<Key, Policies...>::for_each_in_range(const Key& lo, const Key& hi, Func&& func) {
+  find_info info{&head};
+  backoff backoff;
+  find(lo, info, backoff);
+  compare compare;
+  while (info.cur && compare(info.cur->key, hi)) {
+    func(static_cast<const Key&>(info.cur->key));
+    advance(info, backoff);
+  }
+}
+
 template <class Key, class... Policies>
 template <class... Args>
 bool harris_michael_list_based_set<Key, Policies...>::emplace(Args&&... args) {
@@ -376,9 +590,25 @@ bool harris_michael_list_based_set<Key, Policies...>::emplace(Args&&... args) {
 
 template <class Key, class... Policies>
 template <class... Args>
-auto harris_michael_list_based_set<Key, Policies...>::emplace_or_get(Args&&... args) -> std::pair<iterator, bool> {
+bool harris_michael_list_based_set<Key, Policies...>::emplace_hint(search_finger& finger, Args&&... args) {
   node* n = new node(std::forward<Args>(args)...);
   find_info info{&head};
+  start_from_finger(n->key, info, finger);
+  auto result = insert_node(info, n);
+  finger.node = std::move(result.first.info.save);
+  return result.second;
+}
+
+template <class Key, class... Policies>
+template <class... Args>
+auto harris_michael_list_based_set<Key, Policies...>::emplace_or_get(Args&&... args) -> std::pair<iterator, bool> {
+  find_info info{&head};
+  return insert_node(info, new node(std::forward<Args>(args)...));
+}
+
+template <class Key, class... Policies>
+auto harris_michael_list_based_set<Key, Policies...>::insert_node(find_info& info, node* n)
+  -> std::pair<iterator, bool> {
   backoff backoff;
   for (;;) {
     if (find(n->key, info, backoff)) {
@@ -391,7 +621,7 @@ auto harris_michael_list_based_set<Key, Policies...>::emplace_or_get(Args&&... a
     n->next.store(expected, std::memory_order_relaxed);
     guard_ptr new_guard(n);
 
-    // (8) - this release-CAS synchronizes with the acquire-load (1, 2, 3, 4, 5, 6, 11)
+    // (8) - this release-CAS synchronizes with the acquire-load (1, 2, 3, 4, 5, 6, 11, 14)
     //       and the acquire-CAS (9, 12)
     //       it is the head of a potential release sequence containing (9, 12)
     if (info.prev->compare_exchange_weak(expected, n, std::memory_order_release, std::memory_order_relaxed)) {
@@ -405,8 +635,22 @@ auto harris_michael_list_based_set<Key, Policies...>::emplace_or_get(Args&&... a
 
 template <class Key, class... Policies>
 bool harris_michael_list_based_set<Key, Policies...>::erase(const Key& key) {
-  backoff backoff;
   find_info info{&head};
+  return erase(key, info);
+}
+
+template <class Key, class... Policies>
+bool harris_michael_list_based_set<Key, Policies...>::erase(const Key& key, search_finger& finger) {
+  find_info info{&head};
+  start_from_finger(key, info, finger);
+  bool result = erase(key, info);
+  finger.node = std::move(info.save);
+  return result;
+}
+
+template <class Key, class... Policies>
+bool harris_michael_list_based_set<Key, Policies...>::erase(const Key& key, find_info& info) {
+  backoff backoff;
   // Find node in list with matching key and mark it for reclamation.
   for (;;) {
     if (!find(key, info, backoff)) {
@@ -428,7 +672,7 @@ bool harris_michael_list_based_set<Key, Policies...>::erase(const Key& key) {
 
   // Try to splice out node
   marked_ptr expected = info.cur;
-  // (10) - this release-CAS synchronizes with the acquire-load (1, 2, 3, 4, 5, 6, 11)
+  // (10) - this release-CAS synchronizes with the acquire-load (1, 2, 3, 4, 5, 6, 11, 14)
   //        and the acquire-CAS (9, 12)
   //        it is the head of a potential release sequence containing (9, 12)
   if (info.prev->compare_exchange_weak(expected, info.next, std::memory_order_release, std::memory_order_relaxed)) {
@@ -461,7 +705,7 @@ auto harris_michael_list_based_set<Key, Policies...>::erase(iterator pos) -> ite
 
   // Try to splice out node
   marked_ptr expected = pos.info.cur;
-  // (13) - this release-CAS synchronizes with the acquire-load (1, 2, 3, 4, 5, 6, 11)
+  // (13) - this release-CAS synchronizes with the acquire-load (1, 2, 3, 4, 5, 6, 11, 14)
   //        and the acquire-CAS (9, 12)
   //        it is the head of a potential release sequence containing (9, 12)
   if (pos.info.prev->compare_exchange_weak(
@@ -12,9 +12,12 @@
 #include <xenium/parameter.hpp>
 #include <xenium/policy.hpp>
 
+#include <algorithm>
 #include <atomic>
 #include <cassert>
 #include <cstring>
+#include <fstream>
+#include <stdexcept>
 
 #ifdef _MSC_VER
   #pragma warning(push)
@@ -138,12 +141,33 @@ struct vyukov_hash_map<Key, Value, Policies...>::extension_bucket {
   }
 };
 
+template <class Key, class Value, class... Policies>
+struct alignas(64) vyukov_hash_map<Key, Value, Policies...>::extension_chunk {
+  extension_chunk* next;
+  std::uint32_t extension_bucket_count;
+  extension_bucket* extension_buckets;
+
+  void operator delete(void* p) { ::operator delete(p, cacheline_size); } // NOLINT (new-delete-overloads)
+};
+
 template <class Key, class Value, class... Policies>
 struct alignas(64) vyukov_hash_map<Key, Value, Policies...>::block : reclaimer::template enable_concurrent_ptr<block> {
   std::uint32_t mask;
   std::uint32_t bucket_count;
   std::uint32_t extension_bucket_count;
   extension_bucket* extension_buckets;
+  // additional extension buckets that are allocated on demand; new chunks are
+  // prepended, so the list is ordered from newest to oldest.
+  std::atomic<extension_chunk*> extension_chunks{nullptr};
+
+  ~block() {
+    auto chunk = extension_chunks.load(std::memory_order_relaxed);
+    while (chunk != nullptr) {
+      auto next = chunk->next;
+      delete chunk;
+      chunk = next;
+    }
+  }
 
   // TODO - adapt to be customizable via map_to_bucket policy
   [[nodiscard]] std::uint32_t index(const key_type& key) const { return static_cast<std::uint32_t>(key & mask); }
@@ -231,6 +255,54 @@ auto vyukov_hash_map<Key, Value, Policies...>::get_or_emplace_lazy(key_type key,
   return result;
 }
 
+template <class Key, class Value, class... Policies>
+template <class Func>
+bool vyukov_hash_map<Key, Value, Policies...>::update(const key_type& key, Func&& func) {
+  // find() returns an iterator that holds the lock on the bucket containing the element
+  iterator it = find(key);
+  if (it == end()) {
+    return false;
+  }
+
+  auto& value_cell = it.extension ? it.extension->value : it.current_bucket->value[it.index];
+  // (39) - this release-store synchronizes-with the acquire-load (24, 26, 47, 51)
+  traits::update_value(value_cell, std::forward<Func>(func), std::memory_order_release);
+  return true;
+}
+
+template <class Key, class Value, class... Policies>
+template <class Factory, class Func>
+bool vyukov_hash_map<Key, Value, Policies...>::upsert(key_type key, Factory&& factory, Func&& func) {
+  // the factory is only called if a new element gets inserted
+  bool inserted = false;
+  return do_get_or_emplace<false>(
+    std::move(key),
+    [&inserted, &factory]() {
+      inserted = true;
+      return factory();
+    },
+    [&inserted, &func](accessor&&, auto& value_cell) {
+      if (!inserted) {
+        // (40) - this release-store synchronizes-with the acquire-load (24, 26, 47, 51)
+        traits::update_value(value_cell, func, std::memory_order_release);
+      }
+    });
+}
+
+template <class Key, class Value, class... Policies>
+auto vyukov_hash_map<Key, Value, Policies...>::fetch_add(key_type key, value_type delta) -> value_type {
+  static_assert(std::is_integral<Value>::value, "fetch_add is only supported for trivial integral value types");
+  value_type result{};
+  upsert(
+    std::move(key),
+    [delta]() { return delta; },
+    [&result, delta](value_type& v) {
+      result = v;
+      v += delta;
+    });
+  return result;
+}
+
 template <class Key, class Value, class... Policies>
 template <bool AcquireAccessor, class Factory, class Callback>
 bool vyukov_hash_map<Key, Value, Policies...>::do_get_or_emplace(Key&& key, Factory&& factory, Callback&& callback) {
@@ -258,8 +330,9 @@ retry:
     traits::template store_item<AcquireAccessor>(
       bucket.key[item_count], bucket.value[item_count], h, std::move(key), factory(), std::memory_order_relaxed, acc);
     callback(std::move(acc), bucket.value[item_count]);
+    element_count.increment();
     // release the bucket lock and increment the item count
-    // (3) - this release-store synchronizes-with the acquire-CAS (7, 30, 34, 37) and the acquire-load (23)
+    // (3) - this release-store synchronizes-with the acquire-CAS (7, 30, 34, 37) and the acquire-load (23, 46)
     unlocker.unlock(state.inc_item_count(), std::memory_order_release);
     return true;
   }
@@ -277,7 +350,7 @@ retry:
   extension_item* extension = allocate_extension_item(b.get(), h);
   if (extension == nullptr) {
     unlocker.disable(); // bucket is unlocked in grow()
-    grow(bucket, state);
+    grow(bucket, state, b.get());
     goto retry;
   }
   try {
@@ -290,10 +363,11 @@ retry:
   callback(std::move(acc), extension->value);
   auto old_head = bucket.head.load(std::memory_order_relaxed);
   extension->next.store(old_head, std::memory_order_relaxed);
-  // (4) - this release-store synchronizes-with the acquire-load (25)
+  // (4) - this release-store synchronizes-with the acquire-load (25, 48)
   bucket.head.store(extension, std::memory_order_release);
+  element_count.increment();
   // release the bucket lock
-  // (5) - this release-store synchronizes-with the acquire-CAS (7, 30, 34, 37) and the acquire-load (23)
+  // (5) - this release-store synchronizes-with the acquire-CAS (7, 30, 34, 37) and the acquire-load (23, 46)
   unlocker.unlock(state, std::memory_order_release);
 
   return true;
@@ -302,16 +376,22 @@ retry:
 template <class Key, class Value, class... Policies>
 bool vyukov_hash_map<Key, Value, Policies...>::erase(const key_type& key) {
   accessor acc;
-  bool result = do_extract(key, acc);
+  // do_extract may leave the accessor empty (or pointing to a node with the same hash but a
+  // different key) if the key is not found, so we must only reclaim on success.
+  if (!do_extract(key, acc)) {
+    return false;
+  }
   traits::reclaim(acc);
-  return result;
+  return true;
 }
 
 template <class Key, class Value, class... Policies>
 bool vyukov_hash_map<Key, Value, Policies...>::extract(const key_type& key, accessor& acc) {
-  bool result = do_extract(key, acc);
+  if (!do_extract(key, acc)) {
+    return false;
+  }
   traits::reclaim_internal(acc);
-  return result;
+  return true;
 }
 
 template <class Key, class Value, class... Policies>
@@ -321,7 +401,7 @@ bool vyukov_hash_map<Key, Value, Policies...>::do_extract(const key_type& key, a
   guarded_block b;
 
 restart:
-  // (6) - this acquire-load synchronizes-with the release-store (31)
+  // (6) - this acquire-load synchronizes-with the release-store (31, 54)
   b.acquire(data_block, std::memory_order_acquire);
   const std::size_t bucket_idx = h & b->mask;
   bucket& bucket = b->buckets()[bucket_idx];
@@ -350,6 +430,7 @@ restart:
 
   for (std::uint32_t i = 0; i != item_count; ++i) {
     if (traits::template compare_key<true>(bucket.key[i], bucket.value[i], key, h, result)) {
+      element_count.decrement();
       extension_item* extension = bucket.head.load(std::memory_order_relaxed);
       if (extension) {
         // signal which item we are deleting
@@ -358,20 +439,20 @@ restart:
         auto k = extension->key.load(std::memory_order_relaxed);
         auto v = extension->value.load(std::memory_order_relaxed);
         bucket.key[i].store(k, std::memory_order_relaxed);
-        // (8)  - this release-store synchronizes-with the acquire-load (24)
+        // (8)  - this release-store synchronizes-with the acquire-load (24, 47)
         bucket.value[i].store(v, std::memory_order_release);
 
         // reset the delete marker
         locked_state = locked_state.new_version();
-        // (9) - this release-store synchronizes-with the acquire-load (23)
+        // (9) - this release-store synchronizes-with the acquire-load (23, 46)
         bucket.state.store(locked_state, std::memory_order_release);
 
         extension_item* extension_next = extension->next.load(std::memory_order_relaxed);
-        // (10) - this release-store synchronizes-with the acquire-load (25)
+        // (10) - this release-store synchronizes-with the acquire-load (25, 48)
         bucket.head.store(extension_next, std::memory_order_release);
 
         // release the bucket lock and increase the version
-        // (11) - this release-store synchronizes-with the acquire-CAS (7, 30, 34, 37) and the acquire-load (23)
+        // (11) - this release-store synchronizes-with the acquire-CAS (7, 30, 34, 37) and the acquire-load (23, 46)
         unlocker.unlock(locked_state.new_version().clear_lock(), std::memory_order_release);
 
         free_extension_item(extension);
@@ -383,13 +464,13 @@ restart:
           auto k = bucket.key[item_count - 1].load(std::memory_order_relaxed);
           auto v = bucket.value[item_count - 1].load(std::memory_order_relaxed);
           bucket.key[i].store(k, std::memory_order_relaxed);
-          // (12) - this release-store synchronizes-with the acquire-load (24)
+          // (12) - this release-store synchronizes-with the acquire-load (24, 47)
           bucket.value[i].store(v, std::memory_order_release);
         }
 
         // release the bucket lock, reset the delete marker (if it is set), increase the version
         // and decrement the item counter.
-        // (13) - this release-store synchronizes-with the acquire-CAS (7, 30, 34, 37) and the acquire-load (23)
+        // (13) - this release-store synchronizes-with the acquire-CAS (7, 30, 34, 37) and the acquire-load (23, 46)
         unlocker.unlock(state.new_version().dec_item_count(), std::memory_order_release);
       }
       return true;
@@ -402,9 +483,10 @@ restart:
     if (traits::template compare_key<true>(extension->key, extension->value, key, h, result)) {
       extension_item* extension_next = extension->next.load(std::memory_order_relaxed);
       extension_prev->store(extension_next, std::memory_order_relaxed);
+      element_count.decrement();
 
       // release the bucket lock and increase the version
-      // (14) - this release-store synchronizes-with the acquire-CAS (7, 30, 34, 37) and the acquire-load (23)
+      // (14) - this release-store synchronizes-with the acquire-CAS (7, 30, 34, 37) and the acquire-load (23, 46)
       unlocker.unlock(state.new_version(), std::memory_order_release);
 
       free_extension_item(extension);
@@ -424,12 +506,15 @@ restart:
 
 template <class Key, class Value, class... Policies>
 void vyukov_hash_map<Key, Value, Policies...>::erase(iterator& pos) {
+  // the iterator holds the lock on the current bucket
+  element_count.decrement();
+
   if (pos.extension) {
     // the item we are currently looking at is an extension item
     auto next = pos.extension->next.load(std::memory_order_relaxed);
     pos.prev->store(next, std::memory_order_relaxed);
     auto new_state = pos.current_bucket_state.locked().new_version();
-    // (15) - this release-store synchronizes-with the acquire-load (23)
+    // (15) - this release-store synchronizes-with the acquire-load (23, 46)
     pos.current_bucket->state.store(new_state, std::memory_order_release);
 
     free_extension_item(pos.extension);
@@ -452,21 +537,21 @@ void vyukov_hash_map<Key, Value, Policies...>::erase(iterator& pos) {
     auto k = extension->key.load(std::memory_order_relaxed);
     auto v = extension->value.load(std::memory_order_relaxed);
     pos.current_bucket->key[pos.index].store(k, std::memory_order_relaxed);
-    // (16) - this release-store synchronizes-with the acquire-load (24)
+    // (16) - this release-store synchronizes-with the acquire-load (24, 47)
     pos.current_bucket->value[pos.index].store(v, std::memory_order_release);
 
     // reset the delete marker
     locked_state = locked_state.new_version();
-    // (17) - this release-store synchronizes-with the acquire-load (23)
+    // (17) - this release-store synchronizes-with the acquire-load (23, 46)
     pos.current_bucket->state.store(locked_state, std::memory_order_release);
     assert(pos.current_bucket->state.load().is_locked());
 
     auto next = extension->next.load(std::memory_order_relaxed);
-    // (18) - this release-store synchronizes-with the acquire-load (25)
+    // (18) - this release-store synchronizes-with the acquire-load (25, 48)
     pos.current_bucket->head.store(next, std::memory_order_release);
 
     // increase the version but keep the lock
-    // (19) - this release-store synchronizes-with the acquire-load (23)
+    // (19) - this release-store synchronizes-with the acquire-load (23, 46)
     pos.current_bucket->state.store(locked_state.new_version(), std::memory_order_release);
     assert(pos.current_bucket->state.load().is_locked());
     free_extension_item(extension);
@@ -482,14 +567,14 @@ void vyukov_hash_map<Key, Value, Policies...>::erase(iterator& pos) {
       auto k = pos.current_bucket->key[max_index].load(std::memory_order_relaxed);
       auto v = pos.current_bucket->value[max_index].load(std::memory_order_relaxed);
       pos.current_bucket->key[pos.index].store(k, std::memory_order_relaxed);
-      // (20) - this release-store synchronizes-with the acquire-load  (24)
+      // (20) - this release-store synchronizes-with the acquire-load (24, 47)
       pos.current_bucket->value[pos.index].store(v, std::memory_order_release);
     }
 
     auto new_state = pos.current_bucket_state.new_version().dec_item_count();
     pos.current_bucket_state = new_state;
 
-    // (21) - this release store synchronizes-with the acquire-load (23)
+    // (21) - this release store synchronizes-with the acquire-load (23, 46)
     pos.current_bucket->state.store(new_state.locked(), std::memory_order_release);
     assert(pos.current_bucket->state.load().is_locked());
     if (pos.index == new_state.item_count()) {
@@ -506,7 +591,7 @@ template <class Key, class Value, class... Policies>
 bool vyukov_hash_map<Key, Value, Policies...>::try_get_value(const key_type& key, accessor& result) const {
   const hash_t h = hash{}(key);
 
-  // (22) - this acquire-load synchronizes-with the release-store (31)
+  // (22) - this acquire-load synchronizes-with the release-store (31, 54)
   guarded_block b = acquire_guard(data_block, std::memory_order_acquire);
   const std::size_t bucket_idx = h & b->mask;
   bucket& bucket = b->buckets()[bucket_idx];
@@ -525,7 +610,7 @@ retry:
       // use acquire semantic here - should synchronize-with the release store to value
       // in remove() to ensure that if we see the changed value here we also see the
       // changed state in the subsequent reload of state
-      // (24) - this acquire-load synchronizes-with the release-store (8, 12, 16, 20)
+      // (24) - this acquire-load synchronizes-with the release-store (8, 12, 16, 20, 39, 40)
       accessor acc = traits::acquire(bucket.value[i], std::memory_order_acquire);
 
       // ensure that we can use the value we just read
@@ -563,10 +648,7 @@ retry:
   extension_item* extension = bucket.head.load(std::memory_order_acquire);
   while (extension) {
     if (traits::compare_trivial_key(extension->key, key, h)) {
-      // TODO - this acquire does not synchronize with anything ATM.
-      // However, this is probably required when introducing an update-method that
-      // allows to store a new value.
-      // (26) - this acquire-load synchronizes-with <nothing>
+      // (26) - this acquire-load synchronizes-with the release-store (39, 40)
       accessor acc = traits::acquire(extension->value, std::memory_order_acquire);
 
       auto state2 = bucket.state.load(std::memory_order_relaxed);
@@ -606,7 +688,14 @@ retry:
 }
 
 template <class Key, class Value, class... Policies>
-void vyukov_hash_map<Key, Value, Policies...>::grow(bucket& bucket, bucket_state state) {
+std::size_t vyukov_hash_map<Key, Value, Policies...>::bucket_count() const {
+  guarded_block b;
+  b.acquire(data_block, std::memory_order_acquire);
+  return b->bucket_count;
+}
+
+template <class Key, class Value, class... Policies>
+void vyukov_hash_map<Key, Value, Policies...>::grow(bucket& bucket, bucket_state state, block* b) {
   // try to acquire the resizeLock
   const int already_resizing = resize_lock.exchange(1, std::memory_order_relaxed);
 
@@ -620,7 +709,7 @@ void vyukov_hash_map<Key, Value, Policies...>::grow(bucket& bucket, bucket_state
   if (already_resizing != 0) {
     backoff backoff;
     // another thread is already resizing -> wait for it to finish
-    // (28) - this acquire-load synchronizes-with the release-store (32)
+    // (28) - this acquire-load synchronizes-with the release-store (32, 44, 45)
     while (resize_lock.load(std::memory_order_acquire) != 0) {
       backoff();
     }
@@ -628,13 +717,43 @@ void vyukov_hash_map<Key, Value, Policies...>::grow(bucket& bucket, bucket_state
     return;
   }
 
+  // Note: since we hold the resize lock, nobody can replace the current block
+  // or add extension chunks to it.
+  // (43) - this acquire-load synchronizes-with the release-store (31, 54)
+  if (data_block.load(std::memory_order_acquire).get() != b) {
+    // some other thread has already replaced the block in the meantime
+    // (44) - this release-store synchronizes-with the acquire-load (28)
+    resize_lock.store(0, std::memory_order_release);
+    return;
+  }
+
+  if (!exceeds_max_load_factor(b)) {
+    // We ran out of extension items even though the load factor is still low, so
+    // the entries are concentrated in a few hot buckets. Doubling the number of buckets
+    // does not necessarily help in this case, so we simply add more extension items.
+    const bool added_chunk = add_extension_chunk(b);
+    // (45) - this release-store synchronizes-with the acquire-load (28)
+    resize_lock.store(0, std::memory_order_release);
+    if (!added_chunk) {
+      throw std::bad_alloc();
+    }
+    return;
+  }
+
   do_grow();
 }
 
+template <class Key, class Value, class... Policies>
+bool vyukov_hash_map<Key, Value, Policies...>::exceeds_max_load_factor(block* b) {
+  // The element counter is only approximate while other threads concurrently update the map,
+  // but this is sufficient to decide whether we should grow the table.
+  return approximate_size() * max_load_factor_den > static_cast<std::size_t>(b->bucket_count) * max_load_factor_num;
+}
+
 template <class Key, class Value, class... Policies>
 void vyukov_hash_map<Key, Value, Policies...>::do_grow() {
   // Note: since we hold the resize lock, nobody can replace the current block
-  // (29) - this acquire-load synchronizes-with the release-store (31)
+  // (29) - this acquire-load synchronizes-with the release-store (31, 54)
   auto old_block = data_block.load(std::memory_order_acquire);
   const auto bucket_count = old_block->bucket_count;
   block* new_block = allocate_block(bucket_count * 2);
@@ -645,6 +764,14 @@ void vyukov_hash_map<Key, Value, Policies...>::do_grow() {
 
   // lock all buckets
   auto old_buckets = old_block->buckets();
+  auto abort_grow = [&]() {
+    for (std::uint32_t i = 0; i != bucket_count; ++i) {
+      auto& bucket = old_buckets[i];
+      bucket.state.store(bucket.state.load(std::memory_order_relaxed).clear_lock(), std::memory_order_relaxed);
+    }
+    delete new_block;
+    resize_lock.store(0, std::memory_order_relaxed);
+  };
   for (std::uint32_t i = 0; i != bucket_count; ++i) {
     auto& bucket = old_buckets[i];
     backoff backoff;
@@ -663,20 +790,17 @@ void vyukov_hash_map<Key, Value, Policies...>::do_grow() {
     }
   }
 
-  auto new_buckets = new_block->buckets();
   for (std::uint32_t bucket_idx = 0; bucket_idx != bucket_count; ++bucket_idx) {
     auto& old_bucket = old_buckets[bucket_idx];
     const std::uint32_t item_count = old_bucket.state.load(std::memory_order_relaxed).item_count();
     for (std::uint32_t i = 0; i != item_count; ++i) {
       auto k = old_bucket.key[i].load(std::memory_order_relaxed);
       hash_t h = traits::template rehash<hash>(k);
-      auto& new_bucket = new_buckets[h & new_block->mask];
-      auto new_bucket_state = new_bucket.state.load(std::memory_order_relaxed);
-      auto new_bucket_count = new_bucket_state.item_count();
       auto v = old_bucket.value[i].load(std::memory_order_relaxed);
-      new_bucket.key[new_bucket_count].store(k, std::memory_order_relaxed);
-      new_bucket.value[new_bucket_count].store(v, std::memory_order_relaxed);
-      new_bucket.state.store(new_bucket_state.inc_item_count(), std::memory_order_relaxed);
+      // each new bucket receives the items of a single old bucket, so the
+      // items from the bucket array always fit into the new bucket array.
+      [[maybe_unused]] bool inserted = insert_into_unpublished_block(new_block, h, k, v);
+      assert(inserted);
     }
 
     // relaxed ordering is fine since we own the bucket lock
@@ -684,25 +808,14 @@ void vyukov_hash_map<Key, Value, Policies...>::do_grow() {
          extension = extension->next.load(std::memory_order_relaxed)) {
       auto k = extension->key.load(std::memory_order_relaxed);
       hash_t h = traits::template rehash<hash>(k);
-      auto& new_bucket = new_buckets[h & new_block->mask];
-      auto new_bucket_state = new_bucket.state.load(std::memory_order_relaxed);
-      auto new_bucket_count = new_bucket_state.item_count();
       auto v = extension->value.load(std::memory_order_relaxed);
-      if (new_bucket_count < bucket_item_count) {
-        new_bucket.key[new_bucket_count].store(k, std::memory_order_relaxed);
-        new_bucket.value[new_bucket_count].store(v, std::memory_order_relaxed);
-        new_bucket.state.store(new_bucket_state.inc_item_count(), std::memory_order_relaxed);
-      } else {
-        extension_item* new_extension = allocate_extension_item(new_block, h);
-        assert(new_extension);
-        new_extension->key.store(k, std::memory_order_relaxed);
-        new_extension->value.store(v, std::memory_order_relaxed);
-        new_extension->next.store(new_bucket.head, std::memory_order_relaxed);
-        new_bucket.head = new_extension;
+      if (!insert_into_unpublished_block(new_block, h, k, v)) {
+        abort_grow();
+        throw std::bad_alloc();
       }
     }
   }
-  // (31) - this release-store synchronizes-with (6, 22, 29, 33)
+  // (31) - this release-store synchronizes-with (6, 22, 29, 33, 43, 50, 52, 53)
   data_block.store(new_block, std::memory_order_release);
   // (32) - this release-store synchronizes-with the acquire-load (28)
   resize_lock.store(0, std::memory_order_release);
@@ -712,6 +825,39 @@ void vyukov_hash_map<Key, Value, Policies...>::do_grow() {
   g.reclaim();
 }
 
+template <class Key, class Value, class... Policies>
+template <class K, class V>
+bool vyukov_hash_map<Key, Value, Policies...>::insert_into_unpublished_block(block* b,
+                                                                            hash_t hash,
+                                                                            const K& key,
+                                                                            const V& value) {
+  // b is not yet published, so nobody else can access it and we do not have to lock the bucket.
+  auto& bucket = b->buckets()[hash & b->mask];
+  auto state = bucket.state.load(std::memory_order_relaxed);
+  auto item_count = state.item_count();
+  if (item_count < bucket_item_count) {
+    bucket.key[item_count].store(key, std::memory_order_relaxed);
+    bucket.value[item_count].store(value, std::memory_order_relaxed);
+    bucket.state.store(state.inc_item_count(), std::memory_order_relaxed);
+    return true;
+  }
+
+  extension_item* extension = allocate_extension_item(b, hash);
+  if (extension == nullptr) {
+    // since the block is not yet published, we can safely add more extension items
+    if (!add_extension_chunk(b)) {
+      return false;
+    }
+    extension = allocate_extension_item(b, hash);
+    assert(extension);
+  }
+  extension->key.store(key, std::memory_order_relaxed);
+  extension->value.store(value, std::memory_order_relaxed);
+  extension->next.store(bucket.head.load(std::memory_order_relaxed), std::memory_order_relaxed);
+  bucket.head.store(extension, std::memory_order_relaxed);
+  return true;
+}
+
 template <class Key, class Value, class... Policies>
 auto vyukov_hash_map<Key, Value, Policies...>::allocate_block(std::uint32_t bucket_count) -> block* {
   std::uint32_t extension_bucket_count = bucket_count / bucket_to_extension_ratio;
@@ -730,13 +876,46 @@ auto vyukov_hash_map<Key, Value, Policies...>::allocate_block(std::uint32_t buck
   b->extension_bucket_count = extension_bucket_count;
 
   std::size_t extension_bucket_addr = reinterpret_cast<std::size_t>(b) + sizeof(block) + sizeof(bucket) * bucket_count;
-  if (extension_bucket_addr % sizeof(extension_bucket) != 0) {
-    extension_bucket_addr += sizeof(extension_bucket) - (extension_bucket_addr % sizeof(extension_bucket));
+  b->extension_buckets = init_extension_buckets(extension_bucket_addr, extension_bucket_count);
+
+  return b;
+}
+
+template <class Key, class Value, class... Policies>
+bool vyukov_hash_map<Key, Value, Policies...>::add_extension_chunk(block* b) {
+  // the caller must either hold the resize_lock, or b must not yet be published.
+  const std::uint32_t extension_bucket_count = std::max(1u, b->bucket_count / bucket_to_extension_ratio);
+  std::size_t size =
+    sizeof(extension_chunk) + sizeof(extension_bucket) * (static_cast<size_t>(extension_bucket_count) + 1);
+
+  void* mem = ::operator new(size, cacheline_size, std::nothrow);
+  if (mem == nullptr) {
+    return false;
   }
-  b->extension_buckets = reinterpret_cast<extension_bucket*>(extension_bucket_addr);
 
-  for (std::uint32_t i = 0; i != extension_bucket_count; ++i) {
-    auto& bucket = b->extension_buckets[i];
+  std::memset(mem, 0, size);
+  auto* chunk = new (mem) extension_chunk;
+  chunk->extension_bucket_count = extension_bucket_count;
+  chunk->extension_buckets =
+    init_extension_buckets(reinterpret_cast<std::size_t>(chunk) + sizeof(extension_chunk), extension_bucket_count);
+  chunk->next = b->extension_chunks.load(std::memory_order_relaxed);
+  // (41) - this release-store synchronizes-with the acquire-load (42)
+  b->extension_chunks.store(chunk, std::memory_order_release);
+  return true;
+}
+
+template <class Key, class Value, class... Policies>
+auto vyukov_hash_map<Key, Value, Policies...>::init_extension_buckets(std::size_t addr, std::uint32_t count)
+  -> extension_bucket* {
+  // free_extension_item calculates the extension_bucket of an item based on its address,
+  // so extension buckets must be aligned to a multiple of their size.
+  if (addr % sizeof(extension_bucket) != 0) {
+    addr += sizeof(extension_bucket) - (addr % sizeof(extension_bucket));
+  }
+  auto extension_buckets = reinterpret_cast<extension_bucket*>(addr);
+
+  for (std::uint32_t i = 0; i != count; ++i) {
+    auto& bucket = extension_buckets[i];
     extension_item* head = nullptr;
     for (std::size_t j = 0; j != extension_item_count; ++j) {
       bucket.items[j].next.store(head, std::memory_order_relaxed);
@@ -744,8 +923,7 @@ auto vyukov_hash_map<Key, Value, Policies...>::allocate_block(std::uint32_t buck
     }
     bucket.head.store(head, std::memory_order_relaxed);
   }
-
-  return b;
+  return extension_buckets;
 }
 
 template <class Key, class Value, class... Policies>
@@ -787,12 +965,226 @@ auto vyukov_hash_map<Key, Value, Policies...>::begin() -> iterator {
   return result;
 }
 
+template <class Key, class Value, class... Policies>
+auto vyukov_hash_map<Key, Value, Policies...>::snapshot_begin() const -> snapshot_iterator {
+  static_assert(traits::supports_snapshot, "snapshot_iterator is not supported for managed_ptr values");
+  return snapshot_iterator(this);
+}
+
+template <class Key, class Value, class... Policies>
+void vyukov_hash_map<Key, Value, Policies...>::save(const std::string& path) const {
+  static_assert(traits::trivial_key_and_value, "save is only supported for trivial key/value types");
+
+  std::ofstream out;
+  out.exceptions(std::ios::failbit | std::ios::badbit);
+  out.open(path, std::ios::binary | std::ios::trunc);
+
+  file_header header{};
+  std::memcpy(header.magic, file_magic, sizeof(file_magic));
+  header.version = file_version;
+  header.key_size = sizeof(Key);
+  header.value_size = sizeof(Value);
+  // the count is only known at the end, so we write the header again once we are done
+  out.write(reinterpret_cast<const char*>(&header), sizeof(header));
+
+  char record[sizeof(Key) + sizeof(Value)];
+  for (auto it = snapshot_begin(); it != snapshot_end(); ++it) {
+    std::memcpy(record, &it->first, sizeof(Key));
+    std::memcpy(record + sizeof(Key), &it->second, sizeof(Value));
+    out.write(record, sizeof(record));
+    ++header.count;
+  }
+
+  out.seekp(0);
+  out.write(reinterpret_cast<const char*>(&header), sizeof(header));
+  out.close();
+}
+
+template <class Key, class Value, class... Policies>
+void vyukov_hash_map<Key, Value, Policies...>::load(const std::string& path) {
+  static_assert(traits::trivial_key_and_value, "load is only supported for trivial key/value types");
+  constexpr std::size_t record_size = sizeof(Key) + sizeof(Value);
+
+  detail::mapped_file file(path);
+  file_header header{};
+  if (file.size() >= sizeof(header)) {
+    std::memcpy(&header, file.data(), sizeof(header));
+  }
+  if (file.size() < sizeof(header) || std::memcmp(header.magic, file_magic, sizeof(file_magic)) != 0 ||
+      header.version != file_version || header.key_size != sizeof(Key) || header.value_size != sizeof(Value) ||
+      (file.size() - sizeof(header)) / record_size != header.count ||
+      (file.size() - sizeof(header)) % record_size != 0) {
+    throw std::runtime_error(path + " is not a valid vyukov_hash_map file for this key/value type");
+  }
+
+  if (size() != 0) {
+    throw std::logic_error("vyukov_hash_map::load can only be called on an empty map");
+  }
+
+  block* new_block = allocate_block_for(header.count);
+  const char* record = file.data() + sizeof(header);
+  for (std::uint64_t i = 0; i != header.count; ++i, record += record_size) {
+    Key k;
+    Value v;
+    std::memcpy(&k, record, sizeof(Key));
+    std::memcpy(&v, record + sizeof(Key), sizeof(Value));
+    if (!insert_into_unpublished_block(new_block, hash{}(k), k, v)) {
+      delete new_block;
+      throw std::bad_alloc();
+    }
+  }
+  element_count.increment(header.count);
+  publish_block(new_block);
+}
+
+template <class Key, class Value, class... Policies>
+template <class RandomIt>
+void vyukov_hash_map<Key, Value, Policies...>::bulk_build(RandomIt first, RandomIt last, std::size_t num_threads) {
+  static_assert(traits::trivial_key_and_value, "bulk_build is only supported for trivial key/value types");
+  if (size() != 0) {
+    throw std::logic_error("vyukov_hash_map::bulk_build can only be called on an empty map");
+  }
+
+  // it does not pay off to start a thread for only a handful of elements
+  constexpr std::size_t min_elements_per_thread = 1024;
+  const auto count = static_cast<std::size_t>(std::distance(first, last));
+  num_threads = std::max<std::size_t>(1, std::min(num_threads, count / min_elements_per_thread));
+
+  struct entry {
+    std::size_t index;
+    hash_t hash;
+  };
+
+  block* new_block = allocate_block_for(count);
+  try {
+    const std::uint64_t bucket_count = new_block->bucket_count;
+    auto* buckets = new_block->buckets();
+    auto contains = [](bucket& bucket, const Key& key) {
+      const auto item_count = bucket.state.load(std::memory_order_relaxed).item_count();
+      for (std::uint32_t i = 0; i != item_count; ++i) {
+        if (bucket.key[i].load(std::memory_order_relaxed) == key) {
+          return true;
+        }
+      }
+      for (auto extension = bucket.head.load(std::memory_order_relaxed); extension != nullptr;
+           extension = extension->next.load(std::memory_order_relaxed)) {
+        if (extension->key.load(std::memory_order_relaxed) == key) {
+          return true;
+        }
+      }
+      return false;
+    };
+
+    // Phase 1: every thread hashes a contiguous chunk of the input and distributes the entries
+    // over num_threads partitions, each covering a contiguous range of buckets.
+    // partitions[t][p] contains the entries from chunk t that belong to partition p.
+    std::vector<std::vector<std::vector<entry>>> partitions(num_threads, std::vector<std::vector<entry>>(num_threads));
+    detail::parallel_for(num_threads, [&](std::size_t t) {
+      const std::size_t begin = count * t / num_threads;
+      const std::size_t end = count * (t + 1) / num_threads;
+      auto& local = partitions[t];
+      for (auto& partition : local) {
+        partition.reserve((end - begin) / num_threads);
+      }
+      for (std::size_t i = begin; i != end; ++i) {
+        const hash_t h = hash{}(static_cast<Key>(first[i].first));
+        local[((h & new_block->mask) * num_threads) / bucket_count].push_back({i, h});
+      }
+    });
+
+    // Phase 2: every thread fills the buckets of its partition. The partitions are disjoint and the
+    // new block is not yet published, so this does not require any synchronization. Extension items
+    // are shared between all buckets though, so we collect the entries that do not fit into their
+    // bucket and insert them afterwards.
+    // Since the chunks are processed in order, the first of several equivalent keys is inserted.
+    std::vector<std::vector<entry>> overflow(num_threads);
+    std::vector<std::size_t> inserted(num_threads);
+    detail::parallel_for(num_threads, [&](std::size_t p) {
+      std::size_t cnt = 0;
+      for (auto& local : partitions) {
+        for (auto& e : local[p]) {
+          const Key key = first[e.index].first;
+          auto& bucket = buckets[e.hash & new_block->mask];
+          if (contains(bucket, key)) {
+            continue;
+          }
+          const auto state = bucket.state.load(std::memory_order_relaxed);
+          const auto item_count = state.item_count();
+          if (item_count == bucket_item_count) {
+            overflow[p].push_back(e);
+            continue;
+          }
+          bucket.key[item_count].store(key, std::memory_order_relaxed);
+          bucket.value[item_count].store(static_cast<Value>(first[e.index].second), std::memory_order_relaxed);
+          bucket.state.store(state.inc_item_count(), std::memory_order_relaxed);
+          ++cnt;
+        }
+        // release the memory as early as possible
+        std::vector<entry>().swap(local[p]);
+      }
+      inserted[p] = cnt;
+    });
+
+    // Phase 3: insert the remaining entries into extension items
+    std::size_t total = 0;
+    for (std::size_t p = 0; p != num_threads; ++p) {
+      total += inserted[p];
+      for (auto& e : overflow[p]) {
+        const Key key = first[e.index].first;
+        if (contains(buckets[e.hash & new_block->mask], key)) {
+          continue;
+        }
+        if (!insert_into_unpublished_block(new_block, e.hash, key, static_cast<Value>(first[e.index].second))) {
+          throw std::bad_alloc();
+        }
+        ++total;
+      }
+    }
+    element_count.increment(total);
+  } catch (...) {
+    delete new_block;
+    throw;
+  }
+
+  publish_block(new_block);
+}
+
+template <class Key, class Value, class... Policies>
+auto vyukov_hash_map<Key, Value, Policies...>::allocate_block_for(std::size_t count) -> block* {
+  // We choose a bucket count that keeps the load factor at or below one, so the new block can hold
+  // all elements without growing and only few elements end up in extension items.
+  constexpr std::size_t max_bucket_count = static_cast<std::size_t>(1) << 31;
+  if (count > max_bucket_count) {
+    throw std::length_error("vyukov_hash_map: too many elements");
+  }
+  // Note: since there must not be any concurrent update operations, nobody can replace the current block.
+  const auto current_bucket_count = data_block.load(std::memory_order_relaxed)->bucket_count;
+  const auto bucket_count =
+    static_cast<std::uint32_t>(std::max<std::size_t>(utils::next_power_of_two(count), current_bucket_count));
+  block* b = allocate_block(bucket_count);
+  if (b == nullptr) {
+    throw std::bad_alloc();
+  }
+  return b;
+}
+
+template <class Key, class Value, class... Policies>
+void vyukov_hash_map<Key, Value, Policies...>::publish_block(block* new_block) {
+  auto old_block = data_block.load(std::memory_order_relaxed);
+  // (54) - this release-store synchronizes-with (6, 22, 29, 33, 43, 50, 52, 53)
+  data_block.store(new_block, std::memory_order_release);
+
+  // reclaim the old data block
+  guarded_block g(old_block);
+  g.reclaim();
+}
+
 template <class Key, class Value, class... Policies>
 auto vyukov_hash_map<Key, Value, Policies...>::lock_bucket(hash_t hash, guarded_block& block, bucket_state& state)
   -> bucket& {
   backoff backoff;
   for (;;) {
-    // (33) - this acquire-load synchronizes-with the release-store (31)
+    // (33) - this acquire-load synchronizes-with the release-store (31, 54)
     block.acquire(data_block, std::memory_order_acquire);
     const std::size_t bucket_idx = hash & block->mask;
     auto& bucket = block->buckets()[bucket_idx];
@@ -812,12 +1204,28 @@ auto vyukov_hash_map<Key, Value, Policies...>::lock_bucket(hash_t hash, guarded_
 
 template <class Key, class Value, class... Policies>
 auto vyukov_hash_map<Key, Value, Policies...>::allocate_extension_item(block* b, hash_t hash) -> extension_item* {
-  const std::size_t extension_bucket_count = b->extension_bucket_count;
+  if (auto item = allocate_extension_item(b->extension_buckets, b->extension_bucket_count, hash)) {
+    return item;
+  }
+
+  // (42) - this acquire-load synchronizes-with the release-store (41)
+  for (auto chunk = b->extension_chunks.load(std::memory_order_acquire); chunk != nullptr; chunk = chunk->next) {
+    if (auto item = allocate_extension_item(chunk->extension_buckets, chunk->extension_bucket_count, hash)) {
+      return item;
+    }
+  }
+  return nullptr;
+}
+
+template <class Key, class Value, class... Policies>
+auto vyukov_hash_map<Key, Value, Policies...>::allocate_extension_item(extension_bucket* extension_buckets,
+                                                                       std::uint32_t extension_bucket_count,
+                                                                       hash_t hash) -> extension_item* {
   const std::size_t mod_mask = extension_bucket_count - 1;
   for (std::size_t iter = 0; iter != 2; ++iter) {
     for (std::size_t idx = 0; idx != extension_bucket_count; ++idx) {
       const std::size_t extension_bucket_idx = (hash + idx) & mod_mask;
-      extension_bucket& extension_bucket = b->extension_buckets[extension_bucket_idx];
+      extension_bucket& extension_bucket = extension_buckets[extension_bucket_idx];
 
       if (extension_bucket.head.load(std::memory_order_relaxed) == nullptr) {
         continue;
@@ -843,7 +1251,7 @@ void vyukov_hash_map<Key, Value, Policies...>::free_extension_item(extension_ite
 
   bucket->acquire_lock();
   auto head = bucket->head.load(std::memory_order_relaxed);
-  // (35) - this release-store synchronizes-with the acquire-load (27)
+  // (35) - this release-store synchronizes-with the acquire-load (27, 49)
   item->next.store(head, std::memory_order_release);
   // we need to use release semantic here to ensure that threads in try_get_value
   // that see the value written by this store also see the updated bucket_state.
@@ -896,7 +1304,7 @@ void vyukov_hash_map<Key, Value, Policies...>::iterator::reset() {
   // unlock the current bucket
   if (current_bucket) {
     assert(current_bucket->state.load().is_locked());
-    // (36) - this release-store synchronizes-with the acquire-CAS (7, 30, 34, 37) and the acquire-load (23)
+    // (36) - this release-store synchronizes-with the acquire-CAS (7, 30, 34, 37) and the acquire-load (23, 46)
     current_bucket->state.store(current_bucket_state, std::memory_order_release);
   }
 
@@ -989,7 +1397,7 @@ void vyukov_hash_map<Key, Value, Policies...>::iterator::move_to_next_bucket() {
     backoff();
   }
 
-  // (38) - this release-store synchronizes-with the acquire-CAS (7, 30, 34, 37) and the acquire-load (23)
+  // (38) - this release-store synchronizes-with the acquire-CAS (7, 30, 34, 37) and the acquire-load (23, 46)
   old_bucket->state.store(old_bucket_state, std::memory_order_release); // unlock the previous bucket
 
   index = 0;
@@ -1000,6 +1408,171 @@ void vyukov_hash_map<Key, Value, Policies...>::iterator::move_to_next_bucket() {
   }
 }
 
+template <class Key, class Value, class... Policies>
+vyukov_hash_map<Key, Value, Policies...>::snapshot_iterator::snapshot_iterator(const vyukov_hash_map* map) : map(map) {
+  // (50) - this acquire-load synchronizes-with the release-store (31, 54)
+  block.acquire(map->data_block, std::memory_order_acquire);
+  move_to_next_nonempty_bucket();
+}
+
+template <class Key, class Value, class... Policies>
+bool vyukov_hash_map<Key, Value, Policies...>::snapshot_iterator::operator==(const snapshot_iterator& r) const {
+  return block == r.block && position == r.position && index == r.index;
+}
+
+template <class Key, class Value, class... Policies>
+bool vyukov_hash_map<Key, Value, Policies...>::snapshot_iterator::operator!=(const snapshot_iterator& r) const {
+  return !(*this == r);
+}
+
+template <class Key, class Value, class... Policies>
+auto vyukov_hash_map<Key, Value, Policies...>::snapshot_iterator::operator++() -> snapshot_iterator& {
+  assert(block);
+  if (++index == items.size()) {
+    ++position;
+    move_to_next_nonempty_bucket();
+  }
+  return *this;
+}
+
+template <class Key, class Value, class... Policies>
+void vyukov_hash_map<Key, Value, Policies...>::snapshot_iterator::reset() {
+  map = nullptr;
+  block.reset();
+  position = 0;
+  index = 0;
+  items.clear();
+}
+
+template <class Key, class Value, class... Policies>
+void vyukov_hash_map<Key, Value, Policies...>::snapshot_iterator::move_to_next_nonempty_bucket() {
+  for (;;) {
+    if (position == block->bucket_count) {
+      // we reached the end of the container -> reset the iterator
+      reset();
+      return;
+    }
+
+    auto& bucket = block->buckets()[reverse_bits(position, block->bucket_count)];
+    if (!copy_bucket(bucket)) {
+      // the block has been replaced and position has been adjusted accordingly
+      continue;
+    }
+
+    if (!items.empty()) {
+      index = 0;
+      return;
+    }
+    ++position;
+  }
+}
+
+template <class Key, class Value, class... Policies>
+bool vyukov_hash_map<Key, Value, Policies...>::snapshot_iterator::copy_bucket(bucket& bucket) {
+  backoff backoff;
+
+retry:
+  items.clear();
+  // (46) - this acquire-load synchronizes-with the release-store (3, 5, 9, 11, 13, 14, 15, 17, 19, 21, 36, 38)
+  const bucket_state state = bucket.state.load(std::memory_order_acquire);
+
+  // The approach is similar to try_get_value - erase increments the bucket's version
+  // before the removed entry is reclaimed. So if the version is unchanged after we
+  // acquired an accessor, the accessor protects a value that was still part of the map.
+  // However, a value is only protected by the bucket version of the current block;
+  // once a grow operation has replaced the block, entries of the old block can be
+  // removed without changing the old bucket's version. We therefore also have to
+  // check that our block is still the current one before we can safely copy the value.
+  auto version_changed = [&]() {
+    return bucket.state.load(std::memory_order_relaxed).version() != state.version();
+  };
+
+  const std::uint32_t item_count = state.item_count();
+  for (std::uint32_t i = 0; i != item_count; ++i) {
+    auto k = bucket.key[i].load(std::memory_order_relaxed);
+    // (47) - this acquire-load synchronizes-with the release-store (8, 12, 16, 20, 39, 40)
+    accessor acc = traits::acquire(bucket.value[i], std::memory_order_acquire);
+
+    const auto state2 = bucket.state.load(std::memory_order_relaxed);
+    if (state2.version() != state.version()) {
+      // a deletion has occured in the meantime -> we have to retry
+      backoff();
+      goto retry;
+    }
+
+    if (state2.delete_marker() == i + 1) {
+      // Some other thread is currently deleting the entry at this index; the entry
+      // that replaces it is still stored in its original slot, so we simply skip it.
+      continue;
+    }
+
+    if (!block_is_current()) {
+      return false;
+    }
+    items.emplace_back(traits::snapshot_item(k, acc));
+  }
+
+  // (48) - this acquire-load synchronizes-with the release-store (4, 10, 18)
+  extension_item* extension = bucket.head.load(std::memory_order_acquire);
+  while (extension) {
+    auto k = extension->key.load(std::memory_order_relaxed);
+    // (51) - this acquire-load synchronizes-with the release-store (39, 40)
+    accessor acc = traits::acquire(extension->value, std::memory_order_acquire);
+
+    if (version_changed()) {
+      backoff();
+      goto retry;
+    }
+
+    if (!block_is_current()) {
+      return false;
+    }
+    items.emplace_back(traits::snapshot_item(k, acc));
+
+    // (49) - this acquire-load synchronizes-with the release-store (35)
+    extension = extension->next.load(std::memory_order_acquire);
+    if (version_changed()) {
+      backoff();
+      goto retry;
+    }
+  }
+
+  if (version_changed()) {
+    backoff();
+    goto retry;
+  }
+  return true;
+}
+
+template <class Key, class Value, class... Policies>
+bool vyukov_hash_map<Key, Value, Policies...>::snapshot_iterator::block_is_current() {
+  // (52) - this acquire-load synchronizes-with the release-store (31, 54)
+  if (map->data_block.load(std::memory_order_acquire).get() == block.get()) {
+    return true;
+  }
+
+  // The map has been grown in the meantime, so we have to continue in the new block.
+  // Since the buckets are visited in bit-reversed order, all entries of the buckets
+  // before position are stored in the buckets before the scaled position in the new block.
+  const auto old_bucket_count = block->bucket_count;
+  // (53) - this acquire-load synchronizes-with the release-store (31, 54)
+  block.acquire(map->data_block, std::memory_order_acquire);
+  position *= block->bucket_count / old_bucket_count;
+  items.clear();
+  return false;
+}
+
+template <class Key, class Value, class... Policies>
+std::uint32_t vyukov_hash_map<Key, Value, Policies...>::snapshot_iterator::reverse_bits(std::uint32_t position,
+                                                                                     std::uint32_t bucket_count) {
+  std::uint32_t result = 0;
+  for (std::uint32_t i = 1; i < bucket_count; i <<= 1) {
+    result = (result << 1) | (position & 1);
+    position >>= 1;
+  }
+  return result;
+}
+
 } // namespace xenium
 
 #ifdef _MSC_VER
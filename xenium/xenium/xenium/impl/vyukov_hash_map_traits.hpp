@@ -13,6 +13,14 @@ namespace bits {
   struct vyukov_hash_map_common {
     using key_type = Key;
 
+    // whether the map can be scanned with a snapshot_iterator, i.e.,
+    // whether we can create a copy of a key/value pair
+    static constexpr bool supports_snapshot = true;
+
+    // whether key and value are both trivial and stored directly in the bucket's atomics;
+    // this is required for operations that copy the key/value pairs as raw bytes (e.g., save/load).
+    static constexpr bool trivial_key_and_value = false;
+
     template <class Accessor>
     static void reset(Accessor&& acc) {
       acc.reset();
@@ -67,6 +75,8 @@ struct vyukov_hash_map_traits<Key, managed_ptr<Value, VReclaimer>, ValueReclaime
   using iterator_value_type = std::pair<const Key, Value*>;
   using iterator_reference = iterator_value_type;
 
+  static constexpr bool supports_snapshot = false;
+
   class accessor {
   public:
     accessor() = default;
@@ -117,6 +127,17 @@ struct vyukov_hash_map_traits<Key, managed_ptr<Value, VReclaimer>, ValueReclaime
     return {k.load(std::memory_order_relaxed), v.load(std::memory_order_relaxed).get()};
   }
 
+  template <class Func>
+  static void update_value(storage_value_type& value_cell, Func&& func, std::memory_order order) {
+    typename storage_value_type::guard_ptr old_value(value_cell.load(std::memory_order_relaxed));
+    Value* v = old_value.get();
+    func(v);
+    if (v != old_value.get()) {
+      value_cell.store(v, order);
+      old_value.reclaim();
+    }
+  }
+
   static void reclaim(accessor& a) { a.guard.reclaim(); }
   static void reclaim_internal(accessor&) {} // noop
 };
@@ -139,6 +160,8 @@ struct vyukov_hash_map_traits<Key, managed_ptr<Value, VReclaimer>, ValueReclaime
   using iterator_value_type = std::pair<const Key&, value_type>;
   using iterator_reference = iterator_value_type;
 
+  static constexpr bool supports_snapshot = false;
+
   class accessor {
   public:
     accessor() = default;
@@ -205,6 +228,19 @@ struct vyukov_hash_map_traits<Key, managed_ptr<Value, VReclaimer>, ValueReclaime
     return {node->key, node->value.load(std::memory_order_relaxed).get()};
   }
 
+  template <class Func>
+  static void update_value(storage_value_type& value_cell, Func&& func, std::memory_order order) {
+    auto node = value_cell.load(std::memory_order_relaxed);
+    typename VReclaimer::template concurrent_ptr<Value>::guard_ptr old_value(
+      node->value.load(std::memory_order_relaxed));
+    Value* v = old_value.get();
+    func(v);
+    if (v != old_value.get()) {
+      node->value.store(v, order);
+      old_value.reclaim();
+    }
+  }
+
   static void reclaim(accessor& a) {
     a.value_guard.reclaim();
     a.node_guard.reclaim();
@@ -230,6 +266,8 @@ struct vyukov_hash_map_traits<Key, Value, ValueReclaimer, Reclaimer, true, true>
   using iterator_value_type = std::pair<const Key, Value>;
   using iterator_reference = iterator_value_type;
 
+  static constexpr bool trivial_key_and_value = true;
+
   class accessor {
   public:
     accessor() = default;
@@ -278,6 +316,15 @@ struct vyukov_hash_map_traits<Key, Value, ValueReclaimer, Reclaimer, true, true>
     return {k.load(std::memory_order_relaxed), v.load(std::memory_order_relaxed)};
   }
 
+  static std::pair<const Key, Value> snapshot_item(Key k, const accessor& acc) { return {k, acc.v}; }
+
+  template <class Func>
+  static void update_value(storage_value_type& value_cell, Func&& func, std::memory_order order) {
+    Value v = value_cell.load(std::memory_order_relaxed);
+    func(v);
+    value_cell.store(v, order);
+  }
+
   static void reclaim(accessor&) {}          // noop
   static void reclaim_internal(accessor&) {} // noop
 };
@@ -349,6 +396,19 @@ struct vyukov_hash_map_traits<Key, Value, ValueReclaimer, Reclaimer, true, false
     return {k.load(std::memory_order_relaxed), node->value};
   }
 
+  static std::pair<const Key, Value> snapshot_item(Key k, const accessor& acc) { return {k, acc.guard->value}; }
+
+  template <class Func>
+  static void update_value(storage_value_type& value_cell, Func&& func, std::memory_order order) {
+    // concurrent readers may hold an accessor to the current node, so we have to
+    // apply func on a copy and replace the whole node.
+    typename storage_value_type::guard_ptr old_node(value_cell.load(std::memory_order_relaxed));
+    Value v(old_node->value);
+    func(v);
+    value_cell.store(new node(std::move(v)), order);
+    old_node.reclaim();
+  }
+
   static void reclaim(accessor& a) { a.guard.reclaim(); }
   static void reclaim_internal(accessor& a) {
     // copy guard to avoid resetting the accessor's guard_ptr.
@@ -427,6 +487,20 @@ struct vyukov_hash_map_traits<Key, Value, ValueReclaimer, Reclaimer, false, Triv
     return node->data;
   }
 
+  static std::pair<const Key, Value> snapshot_item(hash_t /*hash*/, const accessor& acc) { return acc.guard->data; }
+
+  template <class Func>
+  static void update_value(storage_value_type& value_cell, Func&& func, std::memory_order order) {
+    // concurrent readers may hold an accessor to the current node, so we have to
+    // apply func on a copy and replace the whole node.
+    typename storage_value_type::guard_ptr old_node(value_cell.load(std::memory_order_relaxed));
+    Value v(old_node->data.second);
+    func(v);
+    Key k(old_node->data.first);
+    value_cell.store(new node(std::move(k), std::move(v)), order);
+    old_node.reclaim();
+  }
+
   static void reclaim(accessor& a) { a.guard.reclaim(); }
   static void reclaim_internal(accessor& a) {
     // copy guard to avoid resetting the accessor's guard_ptr.
@@ -0,0 +1,240 @@
+//
+// Copyright (c) 2018-2020 Manuel Pöter.
+// Licensed under the MIT License. See LICENSE file in the project root for full license information.
+//
+
+#ifndef XENIUM_LCRQ_QUEUE_HPP
+#define XENIUM_LCRQ_QUEUE_HPP
+
+#include <xenium/acquire_guard.hpp>
+#include <xenium/backoff.hpp>
+#include <xenium/detail/lcrq_ring.hpp>
+#include <xenium/detail/pointer_queue_traits.hpp>
+#include <xenium/marked_ptr.hpp>
+#include <xenium/parameter.hpp>
+#include <xenium/policy.hpp>
+#include <xenium/utils.hpp>
+
+#include <atomic>
+#include <cstdint>
+#include <stdexcept>
+
+#ifdef _MSC_VER
+  #pragma warning(push)
+  #pragma warning(disable : 4324) // structure was padded due to alignment specifier
+#endif
+
+namespace xenium {
+
+/**
+ * @brief An unbounded lock-free multi-producer/multi-consumer FIFO queue.
+ *
+ * This is an implementation of the `LCRQ` (linked concurrent ring queue) by Morrison and Afek
+ * \[[MA13](index.html#ref-morrison-2013)\]. The queue is a linked list of ring segments (`CRQ`s).
+ * Push and pop operations on a ring segment acquire their slot with a single fetch-and-add on
+ * the ring's tail/head counter and then update the slot with a double-width CAS, so under high
+ * contention it usually outperforms CAS-loop based queues like `michael_scott_queue` by a large
+ * margin. Once a ring segment is full (or a push operation fails too often), the segment is closed
+ * and a new one is appended. Retired segments are reclaimed with the configured reclaimer.
+ *
+ * The queue requires a double-width CAS (`cmpxchg16b` on x86-64).
+ *
+ * Like `ramalhete_queue`, it can only handle pointers or trivially copyable types that are
+ * smaller than a pointer (i.e., `T` must be a raw pointer, a `std::unique_ptr` or a trivially
+ * copyable type like std::uint32_t). The value must not be `nullptr` (or zero for trivially
+ * copyable types).
+ *
+ * Supported policies:
+ *  * `xenium::policy::reclaimer`<br>
+ *    Defines the reclamation scheme to be used for the ring segments. (**required**)
+ *  * `xenium::policy::backoff`<br>
+ *    Defines the backoff strategy. (*optional*; defaults to `xenium::no_backoff`)
+ *  * `xenium::policy::entries_per_node`<br>
+ *    Defines the number of entries for each ring segment. This must be a power of two.
+ *    (*optional*; defaults to 1024)
+ *
+ * @tparam T
+ * @tparam Policies list of policies to customize the behaviour
+ */
+template <class T, class... Policies>
+class lcrq_queue {
+private:
+  using traits = detail::pointer_queue_traits_t<T, Policies...>;
+  using raw_value_type = typename traits::raw_type;
+
+public:
+  using value_type = T;
+  using reclaimer = parameter::type_param_t<policy::reclaimer, parameter::nil, Policies...>;
+  using backoff = parameter::type_param_t<policy::backoff, no_backoff, Policies...>;
+  static constexpr unsigned entries_per_node =
+    parameter::value_param_t<unsigned, policy::entries_per_node, 1024, Policies...>::value;
+
+  static_assert(utils::is_power_of_two(entries_per_node), "entries_per_node must be a power of two");
+  static_assert(parameter::is_set<reclaimer>::value, "reclaimer policy must be specified");
+  static_assert(sizeof(raw_value_type) <= sizeof(std::uint64_t), "raw values must fit into a 64 bit word");
+
+  template <class... NewPolicies>
+  using with = lcrq_queue<T, NewPolicies..., Policies...>;
+
+  lcrq_queue();
+  ~lcrq_queue();
+
+  lcrq_queue(const lcrq_queue&) = delete;
+  lcrq_queue(lcrq_queue&&) = delete;
+
+  lcrq_queue& operator=(const lcrq_queue&) = delete;
+  lcrq_queue& operator=(lcrq_queue&&) = delete;
+
+  /**
+   * @brief Pushes the given value to the queue.
+   *
+   * This operation might have to allocate a new ring segment.
+   * Progress guarantees: lock-free (may perform a memory allocation)
+   * @param value
+   */
+  void push(value_type value);
+
+  /**
+   * @brief Tries to pop an object from the queue.
+   *
+   * Progress guarantees: lock-free
+   * @param result
+   * @return `true` if the operation was successful, otherwise `false`
+   */
+  [[nodiscard]] bool try_pop(value_type& result);
+
+private:
+  struct node;
+
+  using concurrent_ptr = typename reclaimer::template concurrent_ptr<node, 0>;
+  using marked_ptr = typename concurrent_ptr::marked_ptr;
+  using guard_ptr = typename concurrent_ptr::guard_ptr;
+
+  using ring = detail::lcrq_ring<entries_per_node, backoff>;
+  static constexpr std::uint64_t empty_value = ring::empty_value;
+
+  static std::uint64_t to_word(raw_value_type value) { return reinterpret_cast<std::uintptr_t>(value); }
+  static raw_value_type to_raw(std::uint64_t word) {
+    return reinterpret_cast<raw_value_type>(static_cast<std::uintptr_t>(word));
+  }
+
+  struct node : reclaimer::template enable_concurrent_ptr<node>, ring {
+    concurrent_ptr next;
+
+    explicit node(std::uint64_t value) : ring(value), next{nullptr} {}
+
+    ~node() override {
+      for (auto& cell : this->cells) {
+        auto value = cell.second.load(std::memory_order_relaxed);
+        if (value != empty_value) {
+          traits::delete_value(to_raw(value));
+        }
+      }
+    }
+  };
+
+  alignas(64) concurrent_ptr _head;
+  alignas(64) concurrent_ptr _tail;
+};
+
+template <class T, class... Policies>
+lcrq_queue<T, Policies...>::lcrq_queue() {
+  auto n = new node(empty_value);
+  _head.store(n, std::memory_order_relaxed);
+  _tail.store(n, std::memory_order_relaxed);
+}
+
+template <class T, class... Policies>
+lcrq_queue<T, Policies...>::~lcrq_queue() {
+  // (1) - this acquire-load synchronizes-with the release-CAS (12)
+  auto n = _head.load(std::memory_order_acquire);
+  while (n) {
+    // (2) - this acquire-load synchronizes-with the release-CAS (8)
+    auto next = n->next.load(std::memory_order_acquire);
+    delete n.get();
+    n = next;
+  }
+}
+
+template <class T, class... Policies>
+void lcrq_queue<T, Policies...>::push(value_type value) {
+  raw_value_type raw_val = traits::get_raw(value);
+  if (raw_val == nullptr) {
+    throw std::invalid_argument("value can not be nullptr");
+  }
+  const auto word = to_word(raw_val);
+
+  guard_ptr t;
+  for (;;) {
+    // (5) - this acquire-load synchronizes-with the release-CAS (7, 9)
+    t.acquire(_tail, std::memory_order_acquire);
+    if (t->next.load(std::memory_order_relaxed) != nullptr) {
+      // (6) - this acquire-load synchronizes-with the release-CAS (8)
+      auto next = t->next.load(std::memory_order_acquire);
+      marked_ptr expected = t;
+      // (7) - this release-CAS synchronizes-with the acquire-load (5)
+      _tail.compare_exchange_strong(expected, next, std::memory_order_release, std::memory_order_relaxed);
+      continue;
+    }
+
+    if (t->try_push(word)) {
+      traits::release(value);
+      return;
+    }
+
+    // the ring segment has been closed -> append a new one
+    auto new_node = new node(word);
+    marked_ptr expected = nullptr;
+    // (8) - this release-CAS synchronizes-with the acquire-load (2, 6, 11)
+    if (t->next.compare_exchange_strong(expected, new_node, std::memory_order_release, std::memory_order_relaxed)) {
+      traits::release(value);
+      expected = t;
+      // (9) - this release-CAS synchronizes-with the acquire-load (5)
+      _tail.compare_exchange_strong(expected, new_node, std::memory_order_release, std::memory_order_relaxed);
+      return;
+    }
+    // some other thread already added a new node; prevent the pre-stored value from beeing deleted
+    new_node->cells[ring::remap_index(0)].second.store(empty_value, std::memory_order_relaxed);
+    delete new_node;
+  }
+}
+
+template <class T, class... Policies>
+bool lcrq_queue<T, Policies...>::try_pop(value_type& result) {
+  guard_ptr h;
+  std::uint64_t value;
+  for (;;) {
+    // (10) - this acquire-load synchronizes-with the release-CAS (12)
+    h.acquire(_head, std::memory_order_acquire);
+    if (h->try_pop(value)) {
+      traits::store(result, to_raw(value));
+      return true;
+    }
+
+    if (h->next.load(std::memory_order_relaxed) == nullptr) {
+      return false;
+    }
+
+    // A new segment is only appended after the current one has been closed, so no more values
+    // can be added to it. But the segment might have received some values before it was closed.
+    if (h->try_pop(value)) {
+      traits::store(result, to_raw(value));
+      return true;
+    }
+
+    // (11) - this acquire-load synchronizes-with the release-CAS (8)
+    auto next = h->next.load(std::memory_order_acquire);
+    marked_ptr expected = h;
+    // (12) - this release-CAS synchronizes-with the acquire-load (1, 10)
+    if (_head.compare_exchange_strong(expected, next, std::memory_order_release, std::memory_order_relaxed)) {
+      h.reclaim(); // The old segment has been unlinked -> reclaim it.
+    }
+  }
+}
+} // namespace xenium
+
+#ifdef _MSC_VER
+  #pragma warning(pop)
+#endif
+
+#endif
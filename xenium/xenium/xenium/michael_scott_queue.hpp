@@ -12,6 +12,8 @@
 #include <xenium/parameter.hpp>
 #include <xenium/policy.hpp>
 
+#include <cstddef>
+
 #ifdef _MSC_VER
   #pragma warning(push)
   #pragma warning(disable : 4324) // structure was padded due to alignment specifier
@@ -59,6 +61,21 @@ public:
    */
   void push(T value);
 
+  /**
+   * @brief Pushes the values from the range `[first, last)` to the queue.
+   *
+   * The nodes for all values are allocated and linked up front, and the whole chain
+   * is then appended with a single CAS, so the values are stored consecutively, i.e.,
+   * they are not interleaved with values pushed by other threads.
+   *
+   * Progress guarantees: lock-free (always performs a memory allocation per value)
+   *
+   * @param first
+   * @param last
+   */
+  template <class InputIt>
+  void push_range(InputIt first, InputIt last);
+
   /**
    * @brief Tries to pop an object from the queue. If the operation is
    * successful, the object will be moved to `result`.
@@ -70,6 +87,25 @@ public:
    */
   [[nodiscard]] bool try_pop(T& result);
 
+  /**
+   * @brief Tries to pop up to `max` objects from the queue and moves them to `out`.
+   *
+   * All popped objects are detached with a single CAS on the queue's head. The number
+   * of popped objects can be smaller than `max` even if the queue contains more objects,
+   * since the operation never moves the head past the current tail.
+   *
+   * This operation requires three guards (`try_pop` only requires two), which is relevant
+   * for reclamation schemes like `hazard_pointer` with a static allocation strategy.
+   *
+   * Progress guarantees: lock-free
+   *
+   * @param out the output iterator to which the popped objects are moved
+   * @param max the maximum number of objects to pop
+   * @return the number of popped objects
+   */
+  template <class OutputIt>
+  std::size_t try_pop_n(OutputIt out, std::size_t max);
+
 private:
   struct node;
 
@@ -85,6 +121,8 @@ private:
     concurrent_ptr _next;
   };
 
+  void append(node* first, node* last);
+
   alignas(64) concurrent_ptr _head;
   alignas(64) concurrent_ptr _tail;
 };
@@ -98,7 +136,7 @@ michael_scott_queue<T, Policies...>::michael_scott_queue() {
 
 template <class T, class... Policies>
 michael_scott_queue<T, Policies...>::~michael_scott_queue() {
-  // (1) - this acquire-load synchronizes-with the release-CAS (11)
+  // (1) - this acquire-load synchronizes-with the release-CAS (11, 16)
   auto n = _head.load(std::memory_order_acquire);
   while (n) {
     // (2) - this acquire-load synchronizes-with the release-CAS (6)
@@ -111,13 +149,45 @@ michael_scott_queue<T, Policies...>::~michael_scott_queue() {
 template <class T, class... Policies>
 void michael_scott_queue<T, Policies...>::push(T value) {
   node* n = new node(std::move(value));
+  append(n, n);
+}
+
+template <class T, class... Policies>
+template <class InputIt>
+void michael_scott_queue<T, Policies...>::push_range(InputIt first, InputIt last) {
+  if (first == last) {
+    return;
+  }
+
+  // Build a private chain of nodes; the links only become visible to other
+  // threads once the chain gets published by the release-CAS in append.
+  node* head = new node(T(*first));
+  node* tail = head;
+  try {
+    for (++first; first != last; ++first) {
+      node* n = new node(T(*first));
+      tail->_next.store(n, std::memory_order_relaxed);
+      tail = n;
+    }
+  } catch (...) {
+    while (head != nullptr) {
+      node* next = head->_next.load(std::memory_order_relaxed).get();
+      delete head;
+      head = next;
+    }
+    throw;
+  }
+  append(head, tail);
+}
 
+template <class T, class... Policies>
+void michael_scott_queue<T, Policies...>::append(node* first, node* last) {
   backoff backoff;
 
   guard_ptr t;
   for (;;) {
     // Get the old _tail pointer.
-    // (3) - this acquire-load synchronizes-with the release-CAS (5, 7, 10)
+    // (3) - this acquire-load synchronizes-with the release-CAS (5, 7, 10, 14)
     t.acquire(_tail, std::memory_order_acquire);
 
     // Help update the _tail pointer if needed.
@@ -130,20 +200,20 @@ void michael_scott_queue<T, Policies...>::push(T value) {
       continue;
     }
 
-    // Attempt to link in the new element.
+    // Attempt to link in the new element(s).
     marked_ptr null{};
-    // (6) - this release-CAS synchronizes-with the acquire-load (2, 4, 9).
-    if (t->_next.compare_exchange_weak(null, n, std::memory_order_release, std::memory_order_relaxed)) {
+    // (6) - this release-CAS synchronizes-with the acquire-load (2, 4, 9, 13, 15).
+    if (t->_next.compare_exchange_weak(null, first, std::memory_order_release, std::memory_order_relaxed)) {
       break;
     }
 
     backoff();
   }
 
-  // Swing the tail to the new element.
+  // Swing the tail to the last new element.
   marked_ptr expected = t.get();
   // (7) - this release-CAS synchronizes-with the acquire-load (3)
-  _tail.compare_exchange_strong(expected, n, std::memory_order_release, std::memory_order_relaxed);
+  _tail.compare_exchange_strong(expected, last, std::memory_order_release, std::memory_order_relaxed);
 }
 
 template <class T, class... Policies>
@@ -153,7 +223,7 @@ bool michael_scott_queue<T, Policies...>::try_pop(T& result) {
   guard_ptr h;
   for (;;) {
     // Get the old _head and _tail elements.
-    // (8) - this acquire-load synchronizes-with the release-CAS (11)
+    // (8) - this acquire-load synchronizes-with the release-CAS (11, 16)
     h.acquire(_head, std::memory_order_acquire);
 
     // Get the _head element's successor.
@@ -180,7 +250,7 @@ bool michael_scott_queue<T, Policies...>::try_pop(T& result) {
 
     // Attempt to update the _head pointer so that it points to the new dummy node.
     marked_ptr expected(h.get());
-    // (11) - this release-CAS synchronizes-with the acquire-load (1, 8)
+    // (11) - this release-CAS synchronizes-with the acquire-load (1, 8, 12)
     if (_head.compare_exchange_weak(expected, next, std::memory_order_release, std::memory_order_relaxed)) {
       // return the data of _head's successor; it is the new dummy node.
       result = std::move(next->_value);
@@ -195,6 +265,93 @@ bool michael_scott_queue<T, Policies...>::try_pop(T& result) {
 
   return true;
 }
+
+template <class T, class... Policies>
+template <class OutputIt>
+std::size_t michael_scott_queue<T, Policies...>::try_pop_n(OutputIt out, std::size_t max) {
+  if (max == 0) {
+    return 0;
+  }
+
+  backoff backoff;
+
+  guard_ptr h;
+  guard_ptr last;
+  std::size_t count;
+  for (;;) {
+    // (12) - this acquire-load synchronizes-with the release-CAS (11, 16)
+    h.acquire(_head, std::memory_order_acquire);
+
+    // (13) - this acquire-load synchronizes-with the release-CAS (6).
+    last.acquire(h->_next, std::memory_order_acquire);
+    if (_head.load(std::memory_order_relaxed).get() != h.get()) {
+      continue;
+    }
+
+    if (last.get() == nullptr) {
+      return 0;
+    }
+
+    marked_ptr t = _tail.load(std::memory_order_relaxed);
+    if (h.get() == t.get()) {
+      // (14) - this release-CAS synchronizes-with the acquire-load (3)
+      _tail.compare_exchange_weak(t, last, std::memory_order_release, std::memory_order_relaxed);
+      continue;
+    }
+
+    // Collect up to max nodes, but never move beyond the tail we have just read; since
+    // the tail only moves forward, this ensures that the _head never overtakes the _tail.
+    // As long as _head still points to h, none of the nodes following h can have been
+    // removed, so it is safe to walk the list hand over hand.
+    count = 1;
+    bool restart = false;
+    while (count < max && last.get() != t.get()) {
+      // (15) - this acquire-load synchronizes-with the release-CAS (6).
+      auto next = acquire_guard(last->_next, std::memory_order_acquire);
+      if (_head.load(std::memory_order_relaxed).get() != h.get()) {
+        restart = true;
+        break;
+      }
+      if (next.get() == nullptr) {
+        break;
+      }
+      last = std::move(next);
+      ++count;
+    }
+    if (restart) {
+      continue;
+    }
+
+    // Attempt to update the _head pointer so that it points to the last collected
+    // node, which becomes the new dummy node.
+    marked_ptr expected(h.get());
+    // (16) - this release-CAS synchronizes-with the acquire-load (1, 8, 12)
+    if (_head.compare_exchange_weak(expected, last, std::memory_order_release, std::memory_order_relaxed)) {
+      break;
+    }
+
+    backoff();
+  }
+
+  // All collected nodes are now exclusively owned by this thread, so we can move out
+  // their values and reclaim all of them except the new dummy node.
+  node* n = h.get();
+  do {
+    n = n->_next.load(std::memory_order_relaxed).get();
+    *out = std::move(n->_value);
+    ++out;
+  } while (n != last.get());
+
+  n = h->_next.load(std::memory_order_relaxed).get();
+  h.reclaim();
+  while (n != last.get()) {
+    node* next = n->_next.load(std::memory_order_relaxed).get();
+    guard_ptr(n).reclaim();
+    n = next;
+  }
+
+  return count;
+}
 } // namespace xenium
 
 #ifdef _MSC_VER
@@ -0,0 +1,679 @@
+//
+// Copyright (c) 2018-2020 Manuel Pöter.
+// Licensed under the MIT License. See LICENSE file in the project root for full license information.
+//
+
+#ifndef XENIUM_NATARAJAN_MITTAL_TREE_HPP
+#define XENIUM_NATARAJAN_MITTAL_TREE_HPP
+
+#include <xenium/acquire_guard.hpp>
+#include <xenium/backoff.hpp>
+#include <xenium/parameter.hpp>
+#include <xenium/policy.hpp>
+
+#include <cassert>
+#include <cstdint>
+#include <functional>
+#include <iterator>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace xenium {
+
+namespace detail {
+  template <class Key>
+  struct nm_tree_set_traits {
+    using key_type = Key;
+    using value_type = Key;
+    using reference = const Key&;
+    using pointer = const Key*;
+    static const Key& get_key(const value_type& v) noexcept { return v; }
+  };
+
+  template <class Key, class Value>
+  struct nm_tree_map_traits {
+    using key_type = Key;
+    using value_type = std::pair<const Key, Value>;
+    using reference = value_type&;
+    using pointer = value_type*;
+    static const Key& get_key(const value_type& v) noexcept { return v.first; }
+  };
+
+  // Region-based reclamation schemes define a region_guard with a user-provided destructor that
+  // leaves the critical region; all other schemes only define an empty dummy region_guard.
+  template <class Reclaimer, class = void>
+  struct is_region_based_reclaimer : std::false_type {};
+
+  template <class Reclaimer>
+  struct is_region_based_reclaimer<Reclaimer, std::void_t<typename Reclaimer::region_guard>> :
+      std::bool_constant<!std::is_trivially_destructible_v<typename Reclaimer::region_guard>> {};
+} // namespace detail
+
+/**
+ * @brief A lock-free external binary search tree.
+ *
+ * This data structure is based on the lock-free external binary search tree proposed by
+ * Natarajan and Mittal \[[NM14](index.html#ref-natarajan-2014)\]. All elements are stored in
+ * the leaves; the internal nodes only contain routing keys. The tree is not balanced, so the
+ * expected runtime complexity of all operations is logarithmic in the size of the tree only
+ * for keys that are inserted in random order.
+ *
+ * Instead of marking nodes, update operations mark the _edges_ between nodes, using the two mark
+ * bits of a `marked_ptr`: an edge to a leaf is _flagged_ when that leaf is being removed, and the
+ * edge to its sibling is _tagged_ to prevent any further changes to it. The removal is completed
+ * by a single CAS that replaces the parent with the sibling. Compared to a skip list, the tree
+ * requires only a single leaf and a single internal node per element.
+ *
+ * Search operations can traverse nodes that have already been removed from the tree. This is
+ * only safe with region-based reclamation schemes (`generic_epoch_based`, `quiescent_state_based`
+ * or `stamp_it`), where a `guard_ptr` protects all nodes that were reachable when the guard was
+ * acquired. `hazard_pointer`, `hazard_eras` and `lock_free_ref_count` are therefore not supported
+ * and are rejected at compile time.
+ *
+ * Usually this class is used via one of the aliases `natarajan_mittal_tree_set` or
+ * `natarajan_mittal_tree_map`.
+ *
+ * Supported policies:
+ *  * `xenium::policy::reclaimer`<br>
+ *    Defines the reclamation scheme to be used for internal nodes. (**required**)
+ *  * `xenium::policy::compare`<br>
+ *    Defines the comparison function that is used to order the keys. (*optional*; defaults to `std::less<Key>`)
+ *  * `xenium::policy::backoff`<br>
+ *    Defines the backoff strategy. (*optional*; defaults to `xenium::no_backoff`)
+ *
+ * @tparam Traits defines the key and value types
+ * @tparam Policies list of policies to customize the behaviour
+ */
+template <class Traits, class... Policies>
+class natarajan_mittal_tree {
+public:
+  using key_type = typename Traits::key_type;
+  using value_type = typename Traits::value_type;
+  using reclaimer = parameter::type_param_t<policy::reclaimer, parameter::nil, Policies...>;
+  using backoff = parameter::type_param_t<policy::backoff, no_backoff, Policies...>;
+  using compare = parameter::type_param_t<policy::compare, std::less<key_type>, Policies...>;
+
+  template <class... NewPolicies>
+  using with = natarajan_mittal_tree<Traits, NewPolicies..., Policies...>;
+
+  static_assert(parameter::is_set<reclaimer>::value, "reclaimer policy must be specified");
+  static_assert(!parameter::is_set<reclaimer>::value || detail::is_region_based_reclaimer<reclaimer>::value,
+                "natarajan_mittal_tree requires a region-based reclaimer (generic_epoch_based, "
+                "quiescent_state_based or stamp_it)");
+
+  natarajan_mittal_tree();
+  ~natarajan_mittal_tree();
+
+  natarajan_mittal_tree(const natarajan_mittal_tree&) = delete;
+  natarajan_mittal_tree& operator=(const natarajan_mittal_tree&) = delete;
+
+  class iterator;
+
+  /**
+   * @brief Inserts a new element into the container if the container doesn't already contain an
+   * element with an equivalent key. The element is constructed in-place with the given `args`.
+   *
+   * The element is always constructed. If there already is an element with the key in the container,
+   * the newly constructed element will be destroyed immediately.
+   *
+   * No iterators or references are invalidated.
+   *
+   * Progress guarantees: lock-free
+   *
+   * @param args arguments to forward to the constructor of the element
+   * @return `true` if an element was inserted, otherwise `false`
+   */
+  template <class... Args>
+  bool emplace(Args&&... args);
+
+  /**
+   * @brief Inserts a new element into the container if the container doesn't already contain an
+   * element with an equivalent key. The element is constructed in-place with the given `args`.
+   *
+   * The element is always constructed. If there already is an element with the key in the container,
+   * the newly constructed element will be destroyed immediately.
+   *
+   * No iterators or references are invalidated.
+   *
+   * Progress guarantees: lock-free
+   *
+   * @param args arguments to forward to the constructor of the element
+   * @return a pair consisting of an iterator to the inserted element, or the already-existing element
+   * if no insertion happened, and a bool denoting whether the insertion took place;
+   * `true` if an element was inserted, otherwise `false`
+   */
+  template <class... Args>
+  std::pair<iterator, bool> emplace_or_get(Args&&... args);
+
+  /**
+   * @brief Removes the element with the key equivalent to key (if one exists).
+   *
+   * No iterators or references are invalidated.
+   *
+   * Progress guarantees: lock-free
+   *
+   * @param key key of the element to remove
+   * @return `true` if an element was removed, otherwise `false`
+   */
+  bool erase(const key_type& key);
+
+  /**
+   * @brief Finds an element with key equivalent to key.
+   *
+   * Progress guarantees: lock-free
+   *
+   * @param key key of the element to search for
+   * @return iterator to an element with key equivalent to key if such element is found,
+   * otherwise past-the-end iterator
+   */
+  iterator find(const key_type& key);
+
+  /**
+   * @brief Checks if there is an element with key equivalent to key in the container.
+   *
+   * Progress guarantees: lock-free
+   *
+   * @param key key of the element to search for
+   * @return `true` if there is such an element, otherwise `false`
+   */
+  bool contains(const key_type& key);
+
+  /**
+   * @brief Returns an iterator to the first element with a key that is not less than key.
+   *
+   * Progress guarantees: lock-free
+   *
+   * @param key key to compare the elements to
+   * @return iterator to the first element with a key not less than key, or past-the-end iterator
+   * if no such element is found
+   */
+  iterator lower_bound(const key_type& key);
+
+  /**
+   * @brief Returns an iterator to the first element of the container.
+   * @return iterator to the first element
+   */
+  iterator begin();
+
+  /**
+   * @brief Returns an iterator to the element following the last element of the container.
+   *
+   * This element acts as a placeholder; attempting to access it results in undefined behavior.
+   * @return iterator to the element following the last element.
+   */
+  iterator end();
+
+private:
+  struct node;
+  struct routing_node;
+  struct internal_node;
+  struct leaf_node;
+
+  using concurrent_ptr = typename reclaimer::template concurrent_ptr<node, 2>;
+  using marked_ptr = typename concurrent_ptr::marked_ptr;
+  using guard_ptr = typename concurrent_ptr::guard_ptr;
+
+  // mark bits of an edge
+  static constexpr std::uintptr_t flag = 1; // the target leaf is being removed
+  static constexpr std::uintptr_t tag = 2;  // the edge must not be changed anymore
+
+  struct seek_record {
+    guard_ptr ancestor;
+    guard_ptr successor;
+    guard_ptr parent;
+    guard_ptr leaf;
+  };
+
+  void seek(const key_type& key, seek_record& record);
+  bool cleanup(const key_type& key, seek_record& record);
+  void retire_removed_nodes(node* successor, node* sibling);
+  guard_ptr find_next(const key_type& key, bool inclusive);
+  guard_ptr leftmost_leaf(guard_ptr start);
+
+  unsigned direction(const key_type& key, const routing_node* n) const;
+  bool is_equal(const key_type& key, const node* n) const;
+  bool is_less(const node* n, const key_type& key) const;
+  bool is_greater(const node* n, const key_type& key) const;
+  routing_node* create_internal_node(node* new_leaf, node* leaf) const;
+
+  // The root sentinel (R in the paper); its left child is the sentinel S and all real elements
+  // are stored in the left subtree of S.
+  routing_node* root;
+};
+
+/**
+ * @brief A set based on `natarajan_mittal_tree`.
+ * @tparam Key type of the stored elements
+ * @tparam Policies list of policies to customize the behaviour
+ */
+template <class Key, class... Policies>
+using natarajan_mittal_tree_set = natarajan_mittal_tree<detail::nm_tree_set_traits<Key>, Policies...>;
+
+/**
+ * @brief A map based on `natarajan_mittal_tree`.
+ * @tparam Key
+ * @tparam Value
+ * @tparam Policies list of policies to customize the behaviour
+ */
+template <class Key, class Value, class... Policies>
+using natarajan_mittal_tree_map = natarajan_mittal_tree<detail::nm_tree_map_traits<Key, Value>, Policies...>;
+
+/**
+ * @brief A ForwardIterator to safely iterate the tree in ascending key order.
+ *
+ * Iterators are not invalidated by concurrent insert/erase operations. Advancing an iterator
+ * performs a search for the next greater key, so the runtime complexity is that of a search.
+ * The iteration is only weakly consistent, i.e., elements that are inserted or removed
+ * concurrently may or may not be visited.
+ *
+ * *Note:* This iterator class does *not* provide multi-pass guarantee as `a == b` does not imply `++a == ++b`.
+ */
+template <class Traits, class... Policies>
+class natarajan_mittal_tree<Traits, Policies...>::iterator {
+public:
+  using iterator_category = std::forward_iterator_tag;
+  using value_type = natarajan_mittal_tree::value_type;
+  using difference_type = std::ptrdiff_t;
+  using pointer = typename Traits::pointer;
+  using reference = typename Traits::reference;
+
+  iterator(iterator&&) = default;
+  iterator(const iterator&) = default;
+
+  iterator& operator=(iterator&&) = default;
+  iterator& operator=(const iterator&) = default;
+
+  /**
+   * @brief Moves the iterator to the next element.
+   *
+   * Progress guarantess: lock-free
+   */
+  iterator& operator++() {
+    assert(cur.get() != nullptr);
+    cur = tree->find_next(Traits::get_key(leaf()->value), false);
+    return *this;
+  }
+  iterator operator++(int) {
+    iterator retval = *this;
+    ++(*this);
+    return retval;
+  }
+
+  bool operator==(const iterator& other) const { return cur.get() == other.cur.get(); }
+  bool operator!=(const iterator& other) const { return !(*this == other); }
+  reference operator*() const noexcept { return leaf()->value; }
+  pointer operator->() const noexcept { return &leaf()->value; }
+
+  /**
+   * @brief Resets the iterator; this is equivalent to assigning `end()` to it.
+   */
+  void reset() { cur.reset(); }
+
+private:
+  friend natarajan_mittal_tree;
+
+  explicit iterator(natarajan_mittal_tree& tree, guard_ptr&& cur) : tree(&tree), cur(std::move(cur)) {}
+
+  [[nodiscard]] leaf_node* leaf() const noexcept { return static_cast<leaf_node*>(cur.get()); }
+
+  natarajan_mittal_tree* tree;
+  guard_ptr cur;
+};
+
+template <class Traits, class... Policies>
+struct natarajan_mittal_tree<Traits, Policies...>::node : reclaimer::template enable_concurrent_ptr<node, 2> {
+  // Sentinel nodes use the keys inf0 < inf1 < inf2, which are greater than all real keys.
+  // A value of zero means that the node contains a real key.
+  const std::uint8_t inf;
+  const bool is_leaf;
+  node(std::uint8_t inf, bool is_leaf) : inf(inf), is_leaf(is_leaf) {}
+};
+
+template <class Traits, class... Policies>
+struct natarajan_mittal_tree<Traits, Policies...>::routing_node : node {
+  concurrent_ptr child[2];
+  routing_node(std::uint8_t inf, node* left, node* right) : node(inf, false) {
+    child[0].store(left, std::memory_order_relaxed);
+    child[1].store(right, std::memory_order_relaxed);
+  }
+};
+
+template <class Traits, class... Policies>
+struct natarajan_mittal_tree<Traits, Policies...>::internal_node : routing_node {
+  const key_type key;
+  internal_node(const key_type& key, node* left, node* right) : routing_node(0, left, right), key(key) {}
+};
+
+template <class Traits, class... Policies>
+struct natarajan_mittal_tree<Traits, Policies...>::leaf_node : node {
+  value_type value;
+  template <class... Args>
+  explicit leaf_node(Args&&... args) : node(0, true), value(std::forward<Args>(args)...) {}
+};
+
+template <class Traits, class... Policies>
+natarajan_mittal_tree<Traits, Policies...>::natarajan_mittal_tree() {
+  auto* s = new routing_node(2, new node(1, true), new node(2, true));
+  root = new routing_node(3, s, new node(3, true));
+}
+
+template <class Traits, class... Policies>
+natarajan_mittal_tree<Traits, Policies...>::~natarajan_mittal_tree() {
+  std::vector<node*> stack{root};
+  while (!stack.empty()) {
+    node* n = stack.back();
+    stack.pop_back();
+    if (!n->is_leaf) {
+      auto* r = static_cast<routing_node*>(n);
+      // (1) - this acquire-load synchronizes-with the release-CAS (6, 10)
+      stack.push_back(r->child[0].load(std::memory_order_acquire).get());
+      // (2) - this acquire-load synchronizes-with the release-CAS (6, 10)
+      stack.push_back(r->child[1].load(std::memory_order_acquire).get());
+    }
+    delete n;
+  }
+}
+
+template <class Traits, class... Policies>
+unsigned natarajan_mittal_tree<Traits, Policies...>::direction(const key_type& key, const routing_node* n) const {
+  if (n->inf != 0) {
+    return 0;
+  }
+  return compare{}(key, static_cast<const internal_node*>(n)->key) ? 0 : 1;
+}
+
+template <class Traits, class... Policies>
+bool natarajan_mittal_tree<Traits, Policies...>::is_equal(const key_type& key, const node* n) const {
+  if (n->inf != 0) {
+    return false;
+  }
+  const auto& leaf_key = Traits::get_key(static_cast<const leaf_node*>(n)->value);
+  compare compare;
+  return !compare(key, leaf_key) && !compare(leaf_key, key);
+}
+
+template <class Traits, class... Policies>
+bool natarajan_mittal_tree<Traits, Policies...>::is_less(const node* n, const key_type& key) const {
+  return n->inf == 0 && compare{}(Traits::get_key(static_cast<const leaf_node*>(n)->value), key);
+}
+
+template <class Traits, class... Policies>
+bool natarajan_mittal_tree<Traits, Policies...>::is_greater(const node* n, const key_type& key) const {
+  return n->inf == 0 && compare{}(key, Traits::get_key(static_cast<const leaf_node*>(n)->value));
+}
+
+template <class Traits, class... Policies>
+auto natarajan_mittal_tree<Traits, Policies...>::create_internal_node(node* new_leaf, node* leaf) const
+  -> routing_node* {
+  // the routing key of the new internal node is the greater one of the two leaf keys
+  if (leaf->inf != 0) {
+    return new routing_node(leaf->inf, new_leaf, leaf);
+  }
+  const auto& new_key = Traits::get_key(static_cast<leaf_node*>(new_leaf)->value);
+  const auto& leaf_key = Traits::get_key(static_cast<leaf_node*>(leaf)->value);
+  if (compare{}(new_key, leaf_key)) {
+    return new internal_node(leaf_key, new_leaf, leaf);
+  }
+  return new internal_node(new_key, leaf, new_leaf);
+}
+
+template <class Traits, class... Policies>
+void natarajan_mittal_tree<Traits, Policies...>::seek(const key_type& key, seek_record& record) {
+  // The sentinels R and S are never removed. ancestor is the last node on the access path
+  // whose edge to the next node (the successor) is not tagged.
+  auto* s = static_cast<routing_node*>(root->child[0].load(std::memory_order_relaxed).get());
+  record.ancestor = guard_ptr(root);
+  record.successor = guard_ptr(s);
+  record.parent = record.successor;
+  // (3) - this acquire-load synchronizes-with the release-CAS (6, 10)
+  record.leaf.acquire(s->child[0], std::memory_order_acquire);
+
+  guard_ptr current;
+  while (!record.leaf->is_leaf) {
+    auto* n = static_cast<routing_node*>(record.leaf.get());
+    // (4) - this acquire-load synchronizes-with the release-CAS (6, 10)
+    current.acquire(n->child[direction(key, n)], std::memory_order_acquire);
+    if ((record.leaf.mark() & tag) == 0) {
+      record.ancestor = record.parent;
+      record.successor = record.leaf;
+    }
+    record.parent = std::move(record.leaf);
+    record.leaf = std::move(current);
+  }
+}
+
+template <class Traits, class... Policies>
+bool natarajan_mittal_tree<Traits, Policies...>::cleanup(const key_type& key, seek_record& record) {
+  auto* ancestor = static_cast<routing_node*>(record.ancestor.get());
+  auto* parent = static_cast<routing_node*>(record.parent.get());
+  concurrent_ptr& successor_edge = ancestor->child[direction(key, ancestor)];
+
+  const unsigned dir = direction(key, parent);
+  concurrent_ptr* child_edge = &parent->child[dir];
+  concurrent_ptr* sibling_edge = &parent->child[1 - dir];
+  if ((child_edge->load(std::memory_order_relaxed).mark() & flag) == 0) {
+    // the leaf on our access path is not flagged, so the one that is being removed must be its sibling
+    sibling_edge = child_edge;
+  }
+
+  // tag the edge to the sibling so it cannot be changed anymore
+  // (5) - this acquire-load/CAS synchronizes-with the release-CAS (6, 10)
+  marked_ptr sibling = sibling_edge->load(std::memory_order_acquire);
+  while ((sibling.mark() & tag) == 0 &&
+         !sibling_edge->compare_exchange_weak(
+           sibling, marked_ptr(sibling.get(), sibling.mark() | tag), std::memory_order_acquire)) {
+  }
+
+  // Replace the successor with the sibling, preserving the sibling's flag. This removes
+  // the parent and the flagged leaf, together with all nodes between successor and parent.
+  marked_ptr expected(record.successor.get(), 0);
+  // (6) - this release-CAS synchronizes-with the acquire-load (1, 2, 3, 4, 7, 8, 9) and the
+  //       acquire-CAS (5, 11); the acquire part synchronizes-with the release-CAS (6, 10)
+  if (successor_edge.compare_exchange_strong(expected,
+                                             marked_ptr(sibling.get(), sibling.mark() & flag),
+                                             std::memory_order_acq_rel,
+                                             std::memory_order_relaxed)) {
+    retire_removed_nodes(record.successor.get(), sibling.get());
+    return true;
+  }
+  return false;
+}
+
+template <class Traits, class... Policies>
+void natarajan_mittal_tree<Traits, Policies...>::retire_removed_nodes(node* successor, node* sibling) {
+  // All edges between successor and parent are tagged, and the other child of each of these
+  // nodes is a flagged leaf. The removed part of the tree can no longer change, so we can walk
+  // down until we reach the node whose child is the sibling we have just moved up.
+  node* cur = successor;
+  while (cur != nullptr) {
+    auto* n = static_cast<routing_node*>(cur);
+    auto left = n->child[0].load(std::memory_order_relaxed);
+    auto right = n->child[1].load(std::memory_order_relaxed);
+    node* removed_leaf;
+    if (left.get() == sibling) {
+      removed_leaf = right.get();
+      cur = nullptr;
+    } else if (right.get() == sibling) {
+      removed_leaf = left.get();
+      cur = nullptr;
+    } else if ((left.mark() & flag) != 0) {
+      removed_leaf = left.get();
+      cur = right.get();
+    } else {
+      removed_leaf = right.get();
+      cur = left.get();
+    }
+    assert(removed_leaf->is_leaf && removed_leaf->inf == 0);
+    guard_ptr(removed_leaf).reclaim();
+    guard_ptr(n).reclaim();
+  }
+}
+
+template <class Traits, class... Policies>
+auto natarajan_mittal_tree<Traits, Policies...>::leftmost_leaf(guard_ptr start) -> guard_ptr {
+  guard_ptr next;
+  while (!start->is_leaf) {
+    // (7) - this acquire-load synchronizes-with the release-CAS (6, 10)
+    next.acquire(static_cast<routing_node*>(start.get())->child[0], std::memory_order_acquire);
+    start = std::move(next);
+  }
+  if (start->inf != 0) {
+    start.reset();
+  }
+  return start;
+}
+
+template <class Traits, class... Policies>
+auto natarajan_mittal_tree<Traits, Policies...>::find_next(const key_type& key, bool inclusive) -> guard_ptr {
+  auto qualifies = [&](const node* n) { return inclusive ? !is_less(n, key) : is_greater(n, key); };
+
+  // Search for the leaf of key and remember the last node where we went left. If the leaf does not
+  // qualify, the result is the leftmost leaf in the right subtree of that node.
+  for (;;) {
+    guard_ptr candidate;
+    guard_ptr cur(root);
+    guard_ptr next;
+    while (!cur->is_leaf) {
+      auto* n = static_cast<routing_node*>(cur.get());
+      const unsigned dir = direction(key, n);
+      // (8) - this acquire-load synchronizes-with the release-CAS (6, 10)
+      next.acquire(n->child[dir], std::memory_order_acquire);
+      if (dir == 0) {
+        candidate = std::move(cur);
+      }
+      cur = std::move(next);
+    }
+
+    if (cur->inf == 0 && qualifies(cur.get())) {
+      return cur;
+    }
+    cur.reset();
+    // (9) - this acquire-load synchronizes-with the release-CAS (6, 10)
+    next.acquire(static_cast<routing_node*>(candidate.get())->child[1], std::memory_order_acquire);
+    candidate.reset();
+    cur = leftmost_leaf(std::move(next));
+    // If the candidate has been removed in the meantime, its right subtree may have been moved
+    // further up, so it can now contain smaller keys. In this case we simply restart the search.
+    if (!cur || qualifies(cur.get())) {
+      return cur;
+    }
+  }
+}
+
+template <class Traits, class... Policies>
+template <class... Args>
+bool natarajan_mittal_tree<Traits, Policies...>::emplace(Args&&... args) {
+  auto result = emplace_or_get(std::forward<Args>(args)...);
+  return result.second;
+}
+
+template <class Traits, class... Policies>
+template <class... Args>
+auto natarajan_mittal_tree<Traits, Policies...>::emplace_or_get(Args&&... args) -> std::pair<iterator, bool> {
+  auto* new_leaf = new leaf_node(std::forward<Args>(args)...);
+  const key_type& key = Traits::get_key(new_leaf->value);
+  guard_ptr new_guard(new_leaf);
+  seek_record record;
+  backoff backoff;
+  for (;;) {
+    seek(key, record);
+    node* leaf = record.leaf.get();
+    if (is_equal(key, leaf)) {
+      new_guard.reset();
+      delete new_leaf;
+      return {iterator(*this, std::move(record.leaf)), false};
+    }
+
+    auto* parent = static_cast<routing_node*>(record.parent.get());
+    concurrent_ptr& child_edge = parent->child[direction(key, parent)];
+    routing_node* internal = create_internal_node(new_leaf, leaf);
+    marked_ptr expected(leaf, 0);
+    // (10) - this release-CAS synchronizes-with the acquire-load (1, 2, 3, 4, 7, 8, 9)
+    //        and the acquire-CAS (5, 6, 11)
+    if (child_edge.compare_exchange_strong(expected, internal, std::memory_order_release, std::memory_order_relaxed)) {
+      return {iterator(*this, std::move(new_guard)), true};
+    }
+
+    delete internal;
+    if (expected.get() == leaf && expected.mark() != 0) {
+      // the edge has been flagged or tagged -> help the pending removal
+      cleanup(key, record);
+    }
+    backoff();
+  }
+}
+
+template <class Traits, class... Policies>
+bool natarajan_mittal_tree<Traits, Policies...>::erase(const key_type& key) {
+  seek_record record;
+  backoff backoff;
+  guard_ptr victim;
+  for (;;) {
+    seek(key, record);
+    if (!victim) {
+      // injection mode: try to flag the edge to the leaf
+      if (!is_equal(key, record.leaf.get())) {
+        return false;
+      }
+
+      auto* parent = static_cast<routing_node*>(record.parent.get());
+      concurrent_ptr& child_edge = parent->child[direction(key, parent)];
+      marked_ptr expected(record.leaf.get(), 0);
+      // (11) - this acquire-CAS synchronizes-with the release-CAS (6, 10)
+      if (child_edge.compare_exchange_strong(expected,
+                                             marked_ptr(record.leaf.get(), flag),
+                                             std::memory_order_acquire,
+                                             std::memory_order_relaxed)) {
+        // The leaf is now logically removed; we are responsible to physically remove it.
+        victim = record.leaf;
+        if (cleanup(key, record)) {
+          return true;
+        }
+      } else if (expected.get() == record.leaf.get() && expected.mark() != 0) {
+        cleanup(key, record);
+      }
+    } else {
+      // cleanup mode: if the leaf is no longer in the tree, some other thread has removed it for us
+      if (record.leaf.get() != victim.get() || cleanup(key, record)) {
+        return true;
+      }
+    }
+    backoff();
+  }
+}
+
+template <class Traits, class... Policies>
+auto natarajan_mittal_tree<Traits, Policies...>::find(const key_type& key) -> iterator {
+  seek_record record;
+  seek(key, record);
+  if (is_equal(key, record.leaf.get())) {
+    return iterator(*this, std::move(record.leaf));
+  }
+  return end();
+}
+
+template <class Traits, class... Policies>
+bool natarajan_mittal_tree<Traits, Policies...>::contains(const key_type& key) {
+  seek_record record;
+  seek(key, record);
+  return is_equal(key, record.leaf.get());
+}
+
+template <class Traits, class... Policies>
+auto natarajan_mittal_tree<Traits, Policies...>::lower_bound(const key_type& key) -> iterator {
+  return iterator(*this, find_next(key, true));
+}
+
+template <class Traits, class... Policies>
+auto natarajan_mittal_tree<Traits, Policies...>::begin() -> iterator {
+  return iterator(*this, leftmost_leaf(guard_ptr(root)));
+}
+
+template <class Traits, class... Policies>
+auto natarajan_mittal_tree<Traits, Policies...>::end() -> iterator {
+  return iterator(*this, guard_ptr{});
+}
+} // namespace xenium
+
+#endif
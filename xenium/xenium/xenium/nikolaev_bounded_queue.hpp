@@ -10,7 +10,7 @@
 #include <xenium/policy.hpp>
 #include <xenium/utils.hpp>
 
-#include <xenium/detail/nikolaev_scq.hpp>
+#include <xenium/detail/nikolaev_ring.hpp>
 
 #include <atomic>
 #include <cassert>
@@ -27,7 +27,27 @@ namespace xenium {
  * The nikoleav_bounded_queue provides lock-free progress guarantee under the condition that
  *  the number of threads concurrently operating on the queue is less than the queue's capacity.
  *
+ * The internal rings can either use the lock-free SCQ algorithm (the default) or the wait-free
+ * wCQ algorithm proposed by Nikolaev and Ravindran \[[NR22](index.html#ref-nikolaev-2022)\]
+ * (see `ring` policy). With wCQ rings the progress guarantee is wait-free for up to
+ * `max_threads` threads that operate on the queue concurrently. Additional threads do not get
+ * a per-thread record and therefore only use the fast path, so their operations are only
+ * lock-free.
+ *
  * Supported policies:
+ *  * `xenium::policy::ring`<br>
+ *    Defines the ring algorithm of the internal queues; either `xenium::nikolaev_scq_ring`
+ *    or `xenium::nikolaev_wcq_ring`. (*optional*; defaults to `nikolaev_scq_ring`)
+ *  * `xenium::policy::max_threads`<br>
+ *    Defines the maximum number of threads that can use the wait-free slow path of the
+ *    `nikolaev_wcq_ring` at the same time. Each of the two internal rings reserves a 128 byte
+ *    record for each thread. (*optional*; defaults to 128; ignored for `nikolaev_scq_ring`)
+ *  * `xenium::policy::patience`<br>
+ *    Defines the number of fast path attempts of the `nikolaev_wcq_ring` before an operation
+ *    switches to the slow path. (*optional*; defaults to 16; ignored for `nikolaev_scq_ring`)
+ *  * `xenium::policy::help_delay`<br>
+ *    Defines the number of operations after which a thread checks whether some other thread
+ *    requires help. (*optional*; defaults to 8; ignored for `nikolaev_scq_ring`)
  *  * `xenium::policy::pop_retries`<br>
  *    Defines the number of iterations to spin on a queue entry while waiting for a pending
  *    push operation to finish. (*optional*; defaults to 1000)
@@ -42,9 +62,17 @@ template <class T, class... Policies>
 class nikolaev_bounded_queue {
 public:
   using value_type = T;
+  using ring_type = parameter::type_param_t<policy::ring, nikolaev_scq_ring, Policies...>;
+  static constexpr unsigned max_threads =
+    parameter::value_param_t<unsigned, policy::max_threads, 128, Policies...>::value;
+  static constexpr unsigned patience = parameter::value_param_t<unsigned, policy::patience, 16, Policies...>::value;
+  static constexpr unsigned help_delay = parameter::value_param_t<unsigned, policy::help_delay, 8, Policies...>::value;
   static constexpr unsigned pop_retries =
     parameter::value_param_t<unsigned, policy::pop_retries, 1000, Policies...>::value;
 
+  template <class... NewPolicies>
+  using with = nikolaev_bounded_queue<T, NewPolicies..., Policies...>;
+
   /**
    * @brief Constructs a new instance with the specified maximum size.
    * @param capacity max number of elements in the queue; If this is not a power of two,
@@ -62,7 +90,8 @@ public:
   /**
    * @brief Tries to push a new element to the queue.
    *
-   * Progress guarantees: lock-free
+   * Progress guarantees: lock-free (wait-free for up to `max_threads` threads with
+   * `nikolaev_wcq_ring`)
    *
    * @param value
    * @return `true` if the operation was successful, otherwise `false`
@@ -72,7 +101,8 @@ public:
   /**
    * @brief Tries to pop an element from the queue.
    *
-   * Progress guarantees: lock-free
+   * Progress guarantees: lock-free (wait-free for up to `max_threads` threads with
+   * `nikolaev_wcq_ring`)
    *
    * @param result
    * @return `true` if the operation was successful, otherwise `false`
@@ -85,28 +115,34 @@ public:
   [[nodiscard]] std::size_t capacity() const noexcept { return _capacity; }
 
 private:
+  struct ring_traits {
+    static constexpr std::size_t max_threads = nikolaev_bounded_queue::max_threads;
+    static constexpr unsigned patience = nikolaev_bounded_queue::patience;
+    static constexpr unsigned help_delay = nikolaev_bounded_queue::help_delay;
+    static constexpr unsigned pop_retries = nikolaev_bounded_queue::pop_retries;
+  };
+  using ring = detail::nikolaev_ring<ring_type, ring_traits>;
+
   using storage_t = typename std::aligned_storage<sizeof(T), alignof(T)>::type;
   const std::size_t _capacity;
-  const std::size_t _remap_shift;
   std::unique_ptr<storage_t[]> _storage;
-  detail::nikolaev_scq _allocated_queue;
-  detail::nikolaev_scq _free_queue;
+  ring _allocated_queue;
+  ring _free_queue;
 };
 
 template <class T, class... Policies>
 nikolaev_bounded_queue<T, Policies...>::nikolaev_bounded_queue(std::size_t capacity) :
     _capacity(utils::next_power_of_two(capacity)),
-    _remap_shift(detail::nikolaev_scq::calc_remap_shift(_capacity)),
     _storage(new storage_t[_capacity]),
-    _allocated_queue(_capacity, _remap_shift, detail::nikolaev_scq::empty_tag{}),
-    _free_queue(_capacity, _remap_shift, detail::nikolaev_scq::full_tag{}) {
+    _allocated_queue(_capacity, typename ring::empty_tag{}),
+    _free_queue(_capacity, typename ring::full_tag{}) {
   assert(capacity > 0);
 }
 
 template <class T, class... Policies>
 nikolaev_bounded_queue<T, Policies...>::~nikolaev_bounded_queue() {
   std::uint64_t eidx;
-  while (_allocated_queue.dequeue<false, pop_retries>(eidx, _capacity, _remap_shift)) {
+  while (_allocated_queue.dequeue(eidx)) {
     reinterpret_cast<T&>(_storage[eidx]).~T();
   }
 }
@@ -115,13 +151,13 @@ template <class T, class... Policies>
 bool nikolaev_bounded_queue<T, Policies...>::try_push(value_type value) {
   std::uint64_t eidx;
   // TODO - make nonempty checks configurable
-  if (!_free_queue.dequeue<false, pop_retries>(eidx, _capacity, _remap_shift)) {
+  if (!_free_queue.dequeue(eidx)) {
     return false;
   }
 
   assert(eidx < _capacity);
   new (&_storage[eidx]) T(std::move(value));
-  _allocated_queue.enqueue<false, false>(eidx, _capacity, _remap_shift);
+  _allocated_queue.template enqueue<false>(eidx);
   return true;
 }
 
@@ -129,7 +165,7 @@ template <class T, class... Policies>
 bool nikolaev_bounded_queue<T, Policies...>::try_pop(value_type& result) {
   std::uint64_t eidx;
   // TODO - make nonempty checks configurable
-  if (!_allocated_queue.dequeue<false, pop_retries>(eidx, _capacity, _remap_shift)) {
+  if (!_allocated_queue.dequeue(eidx)) {
     return false;
   }
 
@@ -137,7 +173,7 @@ bool nikolaev_bounded_queue<T, Policies...>::try_pop(value_type& result) {
   T& data = reinterpret_cast<T&>(_storage[eidx]);
   result = std::move(data);
   data.~T(); // NOLINT (use-after-move)
-  _free_queue.enqueue<false, false>(eidx, _capacity, _remap_shift);
+  _free_queue.template enqueue<false>(eidx);
   return true;
 }
 } // namespace xenium
@@ -10,7 +10,7 @@
 #include <xenium/policy.hpp>
 #include <xenium/utils.hpp>
 
-#include <xenium/detail/nikolaev_scq.hpp>
+#include <xenium/detail/nikolaev_ring.hpp>
 
 #include <atomic>
 #include <cassert>
@@ -28,12 +28,35 @@ namespace xenium {
  * number of threads concurrently operating on the queue is less than the capacity of a node
  * (see `entries_per_node` policy).
  *
+ * The internal rings of each node can either use the lock-free SCQ algorithm (the default)
+ * or the wait-free wCQ algorithm proposed by Nikolaev and Ravindran
+ * \[[NR22](index.html#ref-nikolaev-2022)\] (see `ring` policy). With wCQ rings the operations
+ * on the rings are wait-free, which avoids starvation of individual threads under high
+ * contention. However, appending a new node and advancing the head/tail pointers is still
+ * only lock-free, so `push` and `try_pop` are only lock-free as a whole.
+ *
  * Supported policies:
  *  * `xenium::policy::reclaimer`<br>
  *    Defines the reclamation scheme to be used for internal nodes. (**required**)
  *  * `xenium::policy::entries_per_node`<br>
  *    Defines the number of entries for each internal node. This must be a power of two.
- *    (*optional*; defaults to 512)
+ *    (*optional*; defaults to 512)<br>
+ *    Note: with `nikolaev_wcq_ring` each node additionally contains two rings with a
+ *    128 byte record for each of the `max_threads` threads, i.e., 2 × `max_threads` × 128 bytes
+ *    (32 KB with the default of 128 threads) per node, independent of `entries_per_node`.
+ *  * `xenium::policy::ring`<br>
+ *    Defines the ring algorithm of the internal queues; either `xenium::nikolaev_scq_ring`
+ *    or `xenium::nikolaev_wcq_ring`. (*optional*; defaults to `nikolaev_scq_ring`)
+ *  * `xenium::policy::max_threads`<br>
+ *    Defines the maximum number of threads that can use the wait-free slow path of the
+ *    `nikolaev_wcq_ring` at the same time; threads exceeding this limit only use the fast path.
+ *    (*optional*; defaults to 128; ignored for `nikolaev_scq_ring`)
+ *  * `xenium::policy::patience`<br>
+ *    Defines the number of fast path attempts of the `nikolaev_wcq_ring` before an operation
+ *    switches to the slow path. (*optional*; defaults to 16; ignored for `nikolaev_scq_ring`)
+ *  * `xenium::policy::help_delay`<br>
+ *    Defines the number of operations after which a thread checks whether some other thread
+ *    requires help. (*optional*; defaults to 8; ignored for `nikolaev_scq_ring`)
  *  * `xenium::policy::pop_retries`<br>
  *    Defines the number of iterations to spin on a queue entry while waiting for a pending
  *    push operation to finish. (*optional*; defaults to 1000)
@@ -49,10 +72,15 @@ class nikolaev_queue {
 public:
   using value_type = T;
   using reclaimer = parameter::type_param_t<policy::reclaimer, parameter::nil, Policies...>;
+  using ring_type = parameter::type_param_t<policy::ring, nikolaev_scq_ring, Policies...>;
   static constexpr unsigned pop_retries =
     parameter::value_param_t<unsigned, policy::pop_retries, 1000, Policies...>::value;
   static constexpr unsigned entries_per_node =
     parameter::value_param_t<unsigned, policy::entries_per_node, 512, Policies...>::value;
+  static constexpr unsigned max_threads =
+    parameter::value_param_t<unsigned, policy::max_threads, 128, Policies...>::value;
+  static constexpr unsigned patience = parameter::value_param_t<unsigned, policy::patience, 16, Policies...>::value;
+  static constexpr unsigned help_delay = parameter::value_param_t<unsigned, policy::help_delay, 8, Policies...>::value;
 
   static_assert(utils::is_power_of_two(entries_per_node), "entries_per_node must be a power of two");
   static_assert(parameter::is_set<reclaimer>::value, "reclaimer policy must be specified");
@@ -72,7 +100,8 @@ public:
   /**
    * @brief Pushes the given value.
    *
-   * Progress guarantees: lock-free
+   * Progress guarantees: lock-free (with `nikolaev_wcq_ring` the operations on the internal
+   * rings are wait-free)
    *
    * @param value
    */
@@ -81,7 +110,8 @@ public:
   /**
    * @brief Tries to pop an element from the queue.
    *
-   * Progress guarantees: lock-free
+   * Progress guarantees: lock-free (with `nikolaev_wcq_ring` the operations on the internal
+   * rings are wait-free)
    *
    * @param result
    * @return `true` if the operation was successful, otherwise `false`
@@ -91,31 +121,37 @@ public:
 private:
   struct node;
 
+  struct ring_traits {
+    static constexpr std::size_t max_threads = nikolaev_queue::max_threads;
+    static constexpr unsigned patience = nikolaev_queue::patience;
+    static constexpr unsigned help_delay = nikolaev_queue::help_delay;
+    static constexpr unsigned pop_retries = nikolaev_queue::pop_retries;
+  };
+  using ring = detail::nikolaev_ring<ring_type, ring_traits>;
+
   using concurrent_ptr = typename reclaimer::template concurrent_ptr<node, 0>;
   using marked_ptr = typename concurrent_ptr::marked_ptr;
   using guard_ptr = typename concurrent_ptr::guard_ptr;
 
   using storage_t = typename std::aligned_storage<sizeof(T), alignof(T)>::type;
 
-  static constexpr unsigned remap_shift = detail::nikolaev_scq::calc_remap_shift(entries_per_node);
-
   // TODO - preallocate memory for storage and queues together with node
   struct node : reclaimer::template enable_concurrent_ptr<node> {
     node() :
         _storage(new storage_t[entries_per_node]),
-        _allocated_queue(entries_per_node, remap_shift, detail::nikolaev_scq::empty_tag{}),
-        _free_queue(entries_per_node, remap_shift, detail::nikolaev_scq::full_tag{}) {}
+        _allocated_queue(entries_per_node, typename ring::empty_tag{}),
+        _free_queue(entries_per_node, typename ring::full_tag{}) {}
 
     explicit node(value_type&& value) :
         _storage(new storage_t[entries_per_node]),
-        _allocated_queue(entries_per_node, remap_shift, detail::nikolaev_scq::first_used_tag{}),
-        _free_queue(entries_per_node, remap_shift, detail::nikolaev_scq::first_empty_tag{}) {
+        _allocated_queue(entries_per_node, typename ring::first_used_tag{}),
+        _free_queue(entries_per_node, typename ring::first_empty_tag{}) {
       new (&_storage[0]) T(std::move(value));
     }
 
     ~node() override {
       std::uint64_t eidx;
-      while (_allocated_queue.dequeue<false, pop_retries>(eidx, entries_per_node, remap_shift)) {
+      while (_allocated_queue.dequeue(eidx)) {
         reinterpret_cast<T&>(_storage[eidx]).~T();
       }
     }
@@ -128,21 +164,21 @@ private:
 
     bool try_push(value_type&& value) {
       std::uint64_t eidx;
-      if (!_free_queue.dequeue<false, pop_retries>(eidx, entries_per_node, remap_shift)) {
+      if (!_free_queue.dequeue(eidx)) {
         _allocated_queue.finalize();
         return false;
       }
 
       assert(eidx < entries_per_node);
       new (&_storage[eidx]) T(std::move(value));
-      if (!_allocated_queue.enqueue<false, true>(eidx, entries_per_node, remap_shift)) {
+      if (!_allocated_queue.template enqueue<true>(eidx)) {
         // queue has been finalized
         // we have already moved the value, so we need to move it back and
         // destroy the created storage item.
         T& data = reinterpret_cast<T&>(_storage[eidx]);
         value = std::move(data);
         data.~T(); // NOLINT (use-after-move)
-        _free_queue.enqueue<false, false>(eidx, entries_per_node, remap_shift);
+        _free_queue.template enqueue<false>(eidx);
         return false;
       }
       return true;
@@ -150,7 +186,7 @@ private:
 
     bool try_pop(value_type& result) {
       std::uint64_t eidx;
-      if (!_allocated_queue.dequeue<false, pop_retries>(eidx, entries_per_node, remap_shift)) {
+      if (!_allocated_queue.dequeue(eidx)) {
         return false;
       }
 
@@ -158,13 +194,13 @@ private:
       T& data = reinterpret_cast<T&>(_storage[eidx]);
       result = std::move(data);
       data.~T(); // NOLINT (use-after-move)
-      _free_queue.enqueue<false, false>(eidx, entries_per_node, remap_shift);
+      _free_queue.template enqueue<false>(eidx);
       return true;
     }
 
     std::unique_ptr<storage_t[]> _storage;
-    detail::nikolaev_scq _allocated_queue;
-    detail::nikolaev_scq _free_queue;
+    ring _allocated_queue;
+    ring _free_queue;
 
     concurrent_ptr _next;
   };
@@ -0,0 +1,638 @@
+//
+// Copyright (c) 2018-2020 Manuel Pöter.
+// Licensed under the MIT License. See LICENSE file in the project root for full license information.
+//
+
+#ifndef XENIUM_OLC_BTREE_MAP_HPP
+#define XENIUM_OLC_BTREE_MAP_HPP
+
+#include <xenium/acquire_guard.hpp>
+#include <xenium/backoff.hpp>
+#include <xenium/detail/optimistic_lock.hpp>
+#include <xenium/parameter.hpp>
+#include <xenium/policy.hpp>
+
+#include <algorithm>
+#include <atomic>
+#include <functional>
+#include <optional>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace xenium {
+
+namespace policy {
+  /**
+   * @brief Policy to configure the maximum number of entries per node in `olc_btree_map`.
+   * @tparam Value
+   */
+  template <unsigned Value>
+  struct node_capacity;
+} // namespace policy
+
+/**
+ * @brief A concurrent B+-tree based on optimistic lock coupling.
+ *
+ * This data structure is based on the optimistic lock coupling (OLC) technique proposed by
+ * Leis et al. \[[LSL16](index.html#ref-leis-2016)\]. Every node carries a version lock that works
+ * like the sequence counter of a `seqlock`: read operations traverse the tree without acquiring
+ * any locks and validate afterwards that the versions of the nodes they have read did not change;
+ * if they did, the operation is restarted. Update operations lock only the nodes they modify;
+ * full nodes are split eagerly on the way down, so a split never has to propagate upwards.
+ *
+ * All elements are stored in sorted arrays in the leaf nodes, so range scans (`for_each_in_range`)
+ * read consecutive memory instead of chasing one pointer per element. Leaf nodes that become empty
+ * are removed from their parent and retired via the configured reclaimer; apart from that, nodes
+ * are not merged.
+ *
+ * Since readers may read keys and values while they are modified by a concurrent writer, Key and
+ * Value must be trivially copyable types for which `std::atomic` is always lock-free (e.g., integers
+ * or raw pointers). Read operations return copies of the values.
+ *
+ * Supported policies:
+ *  * `xenium::policy::reclaimer`<br>
+ *    Defines the reclamation scheme to be used for internal nodes. (**required**)
+ *  * `xenium::policy::compare`<br>
+ *    Defines the comparison function that is used to order the keys. (*optional*; defaults to `std::less<Key>`)
+ *  * `xenium::policy::backoff`<br>
+ *    Defines the backoff strategy that is used when an operation has to be restarted.
+ *    (*optional*; defaults to `xenium::no_backoff`)
+ *  * `xenium::policy::node_capacity`<br>
+ *    Defines the maximum number of entries per node. (*optional*; defaults to 64)
+ *
+ * @tparam Key
+ * @tparam Value
+ * @tparam Policies list of policies to customize the behaviour
+ */
+template <class Key, class Value, class... Policies>
+class olc_btree_map {
+public:
+  using key_type = Key;
+  using value_type = Value;
+  using reclaimer = parameter::type_param_t<policy::reclaimer, parameter::nil, Policies...>;
+  using backoff = parameter::type_param_t<policy::backoff, no_backoff, Policies...>;
+  using compare = parameter::type_param_t<policy::compare, std::less<Key>, Policies...>;
+  static constexpr unsigned node_capacity =
+    parameter::value_param_t<unsigned, policy::node_capacity, 64, Policies...>::value;
+
+  template <class... NewPolicies>
+  using with = olc_btree_map<Key, Value, NewPolicies..., Policies...>;
+
+  static_assert(parameter::is_set<reclaimer>::value, "reclaimer policy must be specified");
+  static_assert(node_capacity >= 4, "node_capacity must be >= 4");
+  static_assert(std::is_trivially_copyable_v<Key> && std::atomic<Key>::is_always_lock_free,
+                "Key must be trivially copyable and std::atomic<Key> must be lock-free");
+  static_assert(std::is_trivially_copyable_v<Value> && std::atomic<Value>::is_always_lock_free,
+                "Value must be trivially copyable and std::atomic<Value> must be lock-free");
+
+  olc_btree_map();
+  ~olc_btree_map();
+
+  olc_btree_map(const olc_btree_map&) = delete;
+  olc_btree_map& operator=(const olc_btree_map&) = delete;
+
+  /**
+   * @brief Inserts a new element into the container if the container doesn't already contain an
+   * element with an equivalent key.
+   *
+   * Progress guarantees: blocking
+   *
+   * @param key the key of the element to insert
+   * @param value the value of the element to insert
+   * @return `true` if an element was inserted, otherwise `false`
+   */
+  bool emplace(key_type key, value_type value);
+
+  /**
+   * @brief Removes the element with the key equivalent to key (if one exists).
+   *
+   * Progress guarantees: blocking
+   *
+   * @param key key of the element to remove
+   * @return `true` if an element was removed, otherwise `false`
+   */
+  bool erase(const key_type& key);
+
+  /**
+   * @brief Provides a copy of the value of the element with the key equivalent to key.
+   *
+   * Progress guarantees: blocking (read operations only wait for concurrent writers
+   * of the same nodes)
+   *
+   * @param key key of the element to search for
+   * @param result receives the value if the element is found
+   * @return `true` if an element was found, otherwise `false`
+   */
+  bool try_get_value(const key_type& key, value_type& result) const;
+
+  /**
+   * @brief Checks if there is an element with key equivalent to key in the container.
+   *
+   * Progress guarantees: blocking (read operations only wait for concurrent writers
+   * of the same nodes)
+   *
+   * @param key key of the element to search for
+   * @return `true` if there is such an element, otherwise `false`
+   */
+  bool contains(const key_type& key) const;
+
+  /**
+   * @brief Calls `func(key, value)` for all elements with a key in the half-open range [lo, hi),
+   * in ascending key order.
+   *
+   * The elements of each leaf node are copied and validated before `func` is called, so `func`
+   * always observes a consistent snapshot of a leaf, but not necessarily of the whole range.
+   * Elements that are inserted or removed concurrently may or may not be visited.
+   *
+   * Progress guarantees: blocking (read operations only wait for concurrent writers
+   * of the same nodes)
+   *
+   * @param lo the smallest key to visit
+   * @param hi the first key that is not visited anymore
+   * @param func the function to call for each element
+   */
+  template <class Func>
+  void for_each_in_range(const key_type& lo, const key_type& hi, Func&& func) const;
+
+private:
+  struct node;
+  struct leaf_node;
+  struct inner_node;
+
+  using concurrent_ptr = typename reclaimer::template concurrent_ptr<node, 0>;
+  using guard_ptr = typename concurrent_ptr::guard_ptr;
+  using version_t = detail::optimistic_lock::version_t;
+
+  bool find_leaf(const key_type& key,
+                 guard_ptr& parent,
+                 version_t& parent_version,
+                 guard_ptr& leaf,
+                 version_t& leaf_version,
+                 std::optional<key_type>* upper_fence) const;
+  bool try_emplace(key_type key, value_type value, bool& inserted);
+  bool try_erase(const key_type& key, bool& erased);
+
+  static unsigned load_count(const node* n);
+  static unsigned lower_bound(const node* n, unsigned count, const key_type& key);
+  static unsigned upper_bound(const node* n, unsigned count, const key_type& key);
+  static bool is_equal(const key_type& lhs, const key_type& rhs);
+
+  key_type split_leaf(leaf_node* leaf, leaf_node*& right);
+  key_type split_inner(inner_node* inner, inner_node*& right);
+  void insert_into_inner(inner_node* inner, const key_type& key, node* right);
+  void make_root(const key_type& key, node* left, node* right);
+
+  concurrent_ptr root;
+};
+
+template <class Key, class Value, class... Policies>
+struct olc_btree_map<Key, Value, Policies...>::node : reclaimer::template enable_concurrent_ptr<node> {
+  detail::optimistic_lock lock;
+  const bool is_leaf;
+  std::atomic<unsigned> count{0};
+  std::atomic<key_type> keys[node_capacity];
+  explicit node(bool is_leaf) : is_leaf(is_leaf) {}
+};
+
+template <class Key, class Value, class... Policies>
+struct olc_btree_map<Key, Value, Policies...>::leaf_node : node {
+  std::atomic<value_type> values[node_capacity];
+  leaf_node() : node(true) {}
+};
+
+template <class Key, class Value, class... Policies>
+struct olc_btree_map<Key, Value, Policies...>::inner_node : node {
+  // children[i] contains all keys k with keys[i - 1] <= k < keys[i]
+  concurrent_ptr children[node_capacity + 1];
+  inner_node() : node(false) {}
+};
+
+template <class Key, class Value, class... Policies>
+olc_btree_map<Key, Value, Policies...>::olc_btree_map() {
+  root.store(new leaf_node(), std::memory_order_relaxed);
+}
+
+template <class Key, class Value, class... Policies>
+olc_btree_map<Key, Value, Policies...>::~olc_btree_map() {
+  std::vector<node*> stack{root.load(std::memory_order_relaxed).get()};
+  while (!stack.empty()) {
+    node* n = stack.back();
+    stack.pop_back();
+    if (!n->is_leaf) {
+      auto* inner = static_cast<inner_node*>(n);
+      for (unsigned i = 0, count = load_count(n); i <= count; ++i) {
+        stack.push_back(inner->children[i].load(std::memory_order_relaxed).get());
+      }
+    }
+    delete n;
+  }
+}
+
+template <class Key, class Value, class... Policies>
+unsigned olc_btree_map<Key, Value, Policies...>::load_count(const node* n) {
+  // an optimistic reader may observe an intermediate count, but it must never exceed the capacity
+  return std::min(n->count.load(std::memory_order_relaxed), node_capacity);
+}
+
+template <class Key, class Value, class... Policies>
+unsigned olc_btree_map<Key, Value, Policies...>::lower_bound(const node* n, unsigned count, const key_type& key) {
+  unsigned lo = 0;
+  unsigned hi = count;
+  while (lo < hi) {
+    unsigned mid = (lo + hi) / 2;
+    if (compare{}(n->keys[mid].load(std::memory_order_relaxed), key)) {
+      lo = mid + 1;
+    } else {
+      hi = mid;
+    }
+  }
+  return lo;
+}
+
+template <class Key, class Value, class... Policies>
+unsigned olc_btree_map<Key, Value, Policies...>::upper_bound(const node* n, unsigned count, const key_type& key) {
+  unsigned lo = 0;
+  unsigned hi = count;
+  while (lo < hi) {
+    unsigned mid = (lo + hi) / 2;
+    if (compare{}(key, n->keys[mid].load(std::memory_order_relaxed))) {
+      hi = mid;
+    } else {
+      lo = mid + 1;
+    }
+  }
+  return lo;
+}
+
+template <class Key, class Value, class... Policies>
+bool olc_btree_map<Key, Value, Policies...>::is_equal(const key_type& lhs, const key_type& rhs) {
+  compare compare;
+  return !compare(lhs, rhs) && !compare(rhs, lhs);
+}
+
+template <class Key, class Value, class... Policies>
+bool olc_btree_map<Key, Value, Policies...>::find_leaf(const key_type& key,
+                                                       guard_ptr& parent,
+                                                       version_t& parent_version,
+                                                       guard_ptr& leaf,
+                                                       version_t& leaf_version,
+                                                       std::optional<key_type>* upper_fence) const {
+  parent.reset();
+  // (1) - this acquire-load synchronizes-with the release-store (5, 6, 7, 8)
+  leaf.acquire(root, std::memory_order_acquire);
+  if (!leaf->lock.read_lock(leaf_version) || root.load(std::memory_order_relaxed).get() != leaf.get()) {
+    // the root has been split in the meantime
+    return false;
+  }
+
+  guard_ptr child;
+  while (!leaf->is_leaf) {
+    auto* inner = static_cast<inner_node*>(leaf.get());
+    const unsigned count = load_count(inner);
+    const unsigned pos = upper_bound(inner, count, key);
+    if (upper_fence && pos < count) {
+      *upper_fence = inner->keys[pos].load(std::memory_order_relaxed);
+    }
+    // (2) - this acquire-load synchronizes-with the release-store (5, 6, 7, 8)
+    child.acquire(inner->children[pos], std::memory_order_acquire);
+    if (!inner->lock.validate(leaf_version)) {
+      return false;
+    }
+
+    version_t child_version;
+    if (!child->lock.read_lock(child_version) || !inner->lock.validate(leaf_version)) {
+      return false;
+    }
+    parent = std::move(leaf);
+    parent_version = leaf_version;
+    leaf = std::move(child);
+    leaf_version = child_version;
+  }
+  return true;
+}
+
+template <class Key, class Value, class... Policies>
+auto olc_btree_map<Key, Value, Policies...>::split_leaf(leaf_node* leaf, leaf_node*& right) -> key_type {
+  const unsigned count = load_count(leaf);
+  const unsigned mid = count / 2;
+  right = new leaf_node();
+  for (unsigned i = mid; i < count; ++i) {
+    right->keys[i - mid].store(leaf->keys[i].load(std::memory_order_relaxed), std::memory_order_relaxed);
+    right->values[i - mid].store(leaf->values[i].load(std::memory_order_relaxed), std::memory_order_relaxed);
+  }
+  right->count.store(count - mid, std::memory_order_relaxed);
+  leaf->count.store(mid, std::memory_order_relaxed);
+  return right->keys[0].load(std::memory_order_relaxed);
+}
+
+template <class Key, class Value, class... Policies>
+auto olc_btree_map<Key, Value, Policies...>::split_inner(inner_node* inner, inner_node*& right) -> key_type {
+  // the middle key moves up into the parent
+  const unsigned count = load_count(inner);
+  const unsigned mid = count / 2;
+  right = new inner_node();
+  for (unsigned i = mid + 1; i < count; ++i) {
+    right->keys[i - mid - 1].store(inner->keys[i].load(std::memory_order_relaxed), std::memory_order_relaxed);
+  }
+  for (unsigned i = mid + 1; i <= count; ++i) {
+    right->children[i - mid - 1].store(inner->children[i].load(std::memory_order_relaxed), std::memory_order_relaxed);
+  }
+  right->count.store(count - mid - 1, std::memory_order_relaxed);
+  inner->count.store(mid, std::memory_order_relaxed);
+  return inner->keys[mid].load(std::memory_order_relaxed);
+}
+
+template <class Key, class Value, class... Policies>
+void olc_btree_map<Key, Value, Policies...>::insert_into_inner(inner_node* inner, const key_type& key, node* right) {
+  const unsigned count = load_count(inner);
+  assert(count < node_capacity);
+  const unsigned pos = upper_bound(inner, count, key);
+  for (unsigned i = count; i > pos; --i) {
+    inner->keys[i].store(inner->keys[i - 1].load(std::memory_order_relaxed), std::memory_order_relaxed);
+    // (5) - this release-store synchronizes-with the acquire-load (1, 2, 3, 4)
+    inner->children[i + 1].store(inner->children[i].load(std::memory_order_relaxed), std::memory_order_release);
+  }
+  inner->keys[pos].store(key, std::memory_order_relaxed);
+  // (6) - this release-store synchronizes-with the acquire-load (1, 2, 3, 4)
+  inner->children[pos + 1].store(right, std::memory_order_release);
+  inner->count.store(count + 1, std::memory_order_relaxed);
+}
+
+template <class Key, class Value, class... Policies>
+void olc_btree_map<Key, Value, Policies...>::make_root(const key_type& key, node* left, node* right) {
+  auto* new_root = new inner_node();
+  new_root->keys[0].store(key, std::memory_order_relaxed);
+  new_root->children[0].store(left, std::memory_order_relaxed);
+  new_root->children[1].store(right, std::memory_order_relaxed);
+  new_root->count.store(1, std::memory_order_relaxed);
+  // (7) - this release-store synchronizes-with the acquire-load (1, 2, 3, 4)
+  root.store(new_root, std::memory_order_release);
+}
+
+template <class Key, class Value, class... Policies>
+bool olc_btree_map<Key, Value, Policies...>::emplace(key_type key, value_type value) {
+  backoff backoff;
+  bool inserted;
+  while (!try_emplace(key, value, inserted)) {
+    backoff();
+  }
+  return inserted;
+}
+
+template <class Key, class Value, class... Policies>
+bool olc_btree_map<Key, Value, Policies...>::try_emplace(key_type key, value_type value, bool& inserted) {
+  guard_ptr parent;
+  version_t parent_version = 0;
+  // (3) - this acquire-load synchronizes-with the release-store (5, 6, 7, 8)
+  guard_ptr cur = acquire_guard(root, std::memory_order_acquire);
+  version_t version;
+  if (!cur->lock.read_lock(version) || root.load(std::memory_order_relaxed).get() != cur.get()) {
+    return false;
+  }
+
+  auto lock_for_split = [&]() {
+    if (parent && !parent->lock.try_upgrade(parent_version)) {
+      return false;
+    }
+    if (!cur->lock.try_upgrade(version)) {
+      if (parent) {
+        parent->lock.write_unlock();
+      }
+      return false;
+    }
+    if (!parent && root.load(std::memory_order_relaxed).get() != cur.get()) {
+      cur->lock.write_unlock();
+      return false;
+    }
+    return true;
+  };
+  auto finish_split = [&](const key_type& separator, node* right) {
+    if (parent) {
+      insert_into_inner(static_cast<inner_node*>(parent.get()), separator, right);
+    } else {
+      make_root(separator, cur.get(), right);
+    }
+    cur->lock.write_unlock();
+    if (parent) {
+      parent->lock.write_unlock();
+    }
+  };
+
+  guard_ptr child;
+  while (!cur->is_leaf) {
+    auto* inner = static_cast<inner_node*>(cur.get());
+    const unsigned count = load_count(inner);
+    if (count == node_capacity) {
+      // split full inner nodes eagerly, so the parent always has room for a new separator
+      if (!lock_for_split()) {
+        return false;
+      }
+      inner_node* right;
+      auto separator = split_inner(inner, right);
+      finish_split(separator, right);
+      return false;
+    }
+
+    const unsigned pos = upper_bound(inner, count, key);
+    // (4) - this acquire-load synchronizes-with the release-store (5, 6, 7, 8)
+    child.acquire(inner->children[pos], std::memory_order_acquire);
+    if (!inner->lock.validate(version)) {
+      return false;
+    }
+    version_t child_version;
+    if (!child->lock.read_lock(child_version) || !inner->lock.validate(version)) {
+      return false;
+    }
+    parent = std::move(cur);
+    parent_version = version;
+    cur = std::move(child);
+    version = child_version;
+  }
+
+  auto* leaf = static_cast<leaf_node*>(cur.get());
+  const unsigned count = load_count(leaf);
+  const unsigned pos = lower_bound(leaf, count, key);
+  if (pos < count && is_equal(leaf->keys[pos].load(std::memory_order_relaxed), key)) {
+    inserted = false;
+    return leaf->lock.validate(version);
+  }
+
+  if (count == node_capacity) {
+    if (!lock_for_split()) {
+      return false;
+    }
+    leaf_node* right;
+    auto separator = split_leaf(leaf, right);
+    finish_split(separator, right);
+    return false;
+  }
+
+  if (!leaf->lock.try_upgrade(version)) {
+    return false;
+  }
+  if (parent && !parent->lock.validate(parent_version)) {
+    leaf->lock.write_unlock();
+    return false;
+  }
+  for (unsigned i = count; i > pos; --i) {
+    leaf->keys[i].store(leaf->keys[i - 1].load(std::memory_order_relaxed), std::memory_order_relaxed);
+    leaf->values[i].store(leaf->values[i - 1].load(std::memory_order_relaxed), std::memory_order_relaxed);
+  }
+  leaf->keys[pos].store(key, std::memory_order_relaxed);
+  leaf->values[pos].store(value, std::memory_order_relaxed);
+  leaf->count.store(count + 1, std::memory_order_relaxed);
+  leaf->lock.write_unlock();
+  inserted = true;
+  return true;
+}
+
+template <class Key, class Value, class... Policies>
+bool olc_btree_map<Key, Value, Policies...>::erase(const key_type& key) {
+  backoff backoff;
+  bool erased;
+  while (!try_erase(key, erased)) {
+    backoff();
+  }
+  return erased;
+}
+
+template <class Key, class Value, class... Policies>
+bool olc_btree_map<Key, Value, Policies...>::try_erase(const key_type& key, bool& erased) {
+  guard_ptr parent;
+  guard_ptr cur;
+  version_t parent_version = 0;
+  version_t version;
+  if (!find_leaf(key, parent, parent_version, cur, version, nullptr)) {
+    return false;
+  }
+
+  auto* leaf = static_cast<leaf_node*>(cur.get());
+  const unsigned count = load_count(leaf);
+  const unsigned pos = lower_bound(leaf, count, key);
+  if (pos == count || !is_equal(leaf->keys[pos].load(std::memory_order_relaxed), key)) {
+    erased = false;
+    return leaf->lock.validate(version);
+  }
+
+  if (count == 1 && parent && load_count(parent.get()) > 0) {
+    // the leaf becomes empty -> remove it from its parent
+    auto* inner = static_cast<inner_node*>(parent.get());
+    if (!inner->lock.try_upgrade(parent_version)) {
+      return false;
+    }
+    if (!leaf->lock.try_upgrade(version)) {
+      inner->lock.write_unlock();
+      return false;
+    }
+    const unsigned parent_count = load_count(inner);
+    unsigned child_pos = upper_bound(inner, parent_count, key);
+    assert(inner->children[child_pos].load(std::memory_order_relaxed).get() == leaf);
+    // The range of the removed leaf is merged into its left neighbor, or into its right
+    // neighbor if it is the leftmost child.
+    for (unsigned i = child_pos == 0 ? 0 : child_pos - 1; i + 1 < parent_count; ++i) {
+      inner->keys[i].store(inner->keys[i + 1].load(std::memory_order_relaxed), std::memory_order_relaxed);
+    }
+    for (unsigned i = child_pos; i < parent_count; ++i) {
+      // (8) - this release-store synchronizes-with the acquire-load (1, 2, 3, 4)
+      inner->children[i].store(inner->children[i + 1].load(std::memory_order_relaxed), std::memory_order_release);
+    }
+    inner->count.store(parent_count - 1, std::memory_order_relaxed);
+    leaf->lock.write_unlock_obsolete();
+    inner->lock.write_unlock();
+    cur.reclaim();
+    erased = true;
+    return true;
+  }
+
+  if (!leaf->lock.try_upgrade(version)) {
+    return false;
+  }
+  for (unsigned i = pos; i + 1 < count; ++i) {
+    leaf->keys[i].store(leaf->keys[i + 1].load(std::memory_order_relaxed), std::memory_order_relaxed);
+    leaf->values[i].store(leaf->values[i + 1].load(std::memory_order_relaxed), std::memory_order_relaxed);
+  }
+  leaf->count.store(count - 1, std::memory_order_relaxed);
+  leaf->lock.write_unlock();
+  erased = true;
+  return true;
+}
+
+template <class Key, class Value, class... Policies>
+bool olc_btree_map<Key, Value, Policies...>::try_get_value(const key_type& key, value_type& result) const {
+  backoff backoff;
+  for (;;) {
+    guard_ptr parent;
+    guard_ptr leaf;
+    version_t parent_version;
+    version_t version;
+    if (find_leaf(key, parent, parent_version, leaf, version, nullptr)) {
+      auto* l = static_cast<leaf_node*>(leaf.get());
+      const unsigned count = load_count(l);
+      const unsigned pos = lower_bound(l, count, key);
+      const bool found = pos < count && is_equal(l->keys[pos].load(std::memory_order_relaxed), key);
+      if (found) {
+        result = l->values[pos].load(std::memory_order_relaxed);
+      }
+      if (l->lock.validate(version)) {
+        return found;
+      }
+    }
+    backoff();
+  }
+}
+
+template <class Key, class Value, class... Policies>
+bool olc_btree_map<Key, Value, Policies...>::contains(const key_type& key) const {
+  value_type value;
+  return try_get_value(key, value);
+}
+
+template <class Key, class Value, class... Policies>
+template <class Func>
+void olc_btree_map<Key, Value, Policies...>::for_each_in_range(const key_type& lo,
+                                                               const key_type& hi,
+                                                               Func&& func) const {
+  std::vector<std::pair<key_type, value_type>> entries;
+  entries.reserve(node_capacity);
+  std::optional<key_type> from(lo);
+  backoff backoff;
+  while (from) {
+    guard_ptr parent;
+    guard_ptr leaf;
+    version_t parent_version;
+    version_t version;
+    // the upper fence is the smallest separator on the path that is greater than the search key
+    std::optional<key_type> upper_fence;
+    if (!find_leaf(*from, parent, parent_version, leaf, version, &upper_fence)) {
+      backoff();
+      continue;
+    }
+
+    entries.clear();
+    auto* l = static_cast<leaf_node*>(leaf.get());
+    const unsigned count = load_count(l);
+    for (unsigned i = lower_bound(l, count, *from); i < count; ++i) {
+      auto key = l->keys[i].load(std::memory_order_relaxed);
+      if (!compare{}(key, hi)) {
+        break;
+      }
+      entries.emplace_back(key, l->values[i].load(std::memory_order_relaxed));
+    }
+    if (!l->lock.validate(version)) {
+      backoff();
+      continue;
+    }
+
+    for (auto& entry : entries) {
+      func(entry.first, entry.second);
+    }
+    if (upper_fence && !compare{}(*upper_fence, hi)) {
+      upper_fence.reset();
+    }
+    from = upper_fence;
+  }
+}
+} // namespace xenium
+
+#endif
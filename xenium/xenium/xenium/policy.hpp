@@ -18,6 +18,12 @@ namespace xenium::policy {
  *   * `ramalhete_queue`
  *   * `harris_michael_list_based_set`
  *   * `harris_michael_hash_map`
+ *   * `fraser_skip_list_map`
+ *   * `natarajan_mittal_tree`
+ *   * `olc_btree_map`
+ *   * `art_map`
+ *   * `cuckoo_hash_map`
+ *   * `feldman_hash_map`
  *
  * @tparam Reclaimer
  */
@@ -32,6 +38,12 @@ struct reclaimer;
  *   * `ramalhete_queue`
  *   * `harris_michael_list_based_set`
  *   * `harris_michael_hash_map`
+ *   * `fraser_skip_list_map`
+ *   * `natarajan_mittal_tree`
+ *   * `olc_btree_map`
+ *   * `art_map`
+ *   * `cuckoo_hash_map`
+ *   * `feldman_hash_map`
  *
  * @tparam Backoff
  */
@@ -43,6 +55,9 @@ struct backoff;
  *
  * This policy is used by the following data structures:
  *   * `harris_michael_list_based_set`
+ *   * `fraser_skip_list_map`
+ *   * `natarajan_mittal_tree`
+ *   * `olc_btree_map`
  *
  * @tparam Compare
  */
@@ -78,6 +93,8 @@ struct container;
  * This policy is used by the following data structures:
  *   * `harris_michael_hash_map`
  *   * `vyukov_hash_map`
+ *   * `cuckoo_hash_map`
+ *   * `feldman_hash_map`
  *
  * @tparam T
  */
@@ -104,11 +121,12 @@ struct entries_per_node;
 
 /**
  * @brief Policy to configure the number of padding bytes to add to each entry in
- * `kirsch_kfifo_queue` and `kirsch_bounded_kfifo_queue` to reduce false sharing.
+ * `kirsch_kfifo_queue`, `kirsch_bounded_kfifo_queue` and `vyukov_bounded_queue` to
+ * reduce false sharing.
  *
  * Note that this number of bytes is a lower bound. Depending on the size of the
  * queue's `value_type` the compiler may add some additional padding. The effective
- * size of a queue entry is provided in `entry_size`.
+ * size of a queue entry is provided in `entry_size` (`cell_size` for `vyukov_bounded_queue`).
  *
  * @tparam Value
  */
@@ -122,5 +140,42 @@ struct padding_bytes;
  */
 template <unsigned Value>
 struct pop_retries;
+
+/**
+ * @brief Policy to configure the ring algorithm that is used for the internal queues of
+ * `nikolaev_queue` and `nikolaev_bounded_queue`.
+ *
+ * Supported rings are `xenium::nikolaev_scq_ring` (lock-free) and `xenium::nikolaev_wcq_ring`
+ * (wait-free).
+ * @tparam T
+ */
+template <class T>
+struct ring;
+
+/**
+ * @brief Policy to configure the maximum number of threads that can use the slow path
+ * of `xenium::nikolaev_wcq_ring` at the same time.
+ *
+ * Every internal ring reserves a record for each of these threads.
+ * @tparam Value
+ */
+template <unsigned Value>
+struct max_threads;
+
+/**
+ * @brief Policy to configure the number of fast path attempts of an operation on a
+ * `xenium::nikolaev_wcq_ring` before it switches to the wait-free slow path.
+ * @tparam Value
+ */
+template <unsigned Value>
+struct patience;
+
+/**
+ * @brief Policy to configure the number of operations on a `xenium::nikolaev_wcq_ring`
+ * after which a thread checks whether some other thread requires help.
+ * @tparam Value
+ */
+template <unsigned Value>
+struct help_delay;
 } // namespace xenium::policy
 #endif
@@ -0,0 +1,232 @@
+//
+// Copyright (c) 2018-2020 Manuel Pöter.
+// Licensed under the MIT License. See LICENSE file in the project root for full license information.
+//
+
+#ifndef XENIUM_SPSC_BOUNDED_QUEUE_HPP
+#define XENIUM_SPSC_BOUNDED_QUEUE_HPP
+
+#include <xenium/utils.hpp>
+
+#include <algorithm>
+#include <atomic>
+#include <cassert>
+#include <cstdint>
+#include <iterator>
+#include <memory>
+
+#ifdef _MSC_VER
+  #pragma warning(push)
+  #pragma warning(disable : 4324) // structure was padded due to alignment specifier
+#endif
+
+namespace xenium {
+/**
+ * @brief A bounded generic single-producer/single-consumer FIFO queue.
+ *
+ * This is a classic ring buffer with a head index that is only written by the consumer
+ * and a tail index that is only written by the producer. Both indexes are placed in
+ * separate cache lines. In addition, the producer keeps a private copy of the head
+ * index and the consumer a private copy of the tail index. The shared index of the other
+ * side is only reloaded when the private copy indicates that the queue is full (or empty,
+ * respectively), so in the common case an operation only touches its own cache line and
+ * the cell it writes or reads.
+ *
+ * `push_n` and `pop_n` transfer a whole batch of elements and publish it with a single
+ * release-store.
+ *
+ * At any time at most one thread may push to the queue and at most one thread may pop
+ * from it; the threads that play these roles may change over time, as long as the
+ * changes are properly synchronized.
+ *
+ * It is fully generic and can handle any type `T`, as long as it is default
+ * constructible and either copyable or movable.
+ *
+ * @tparam T type of the stored elements.
+ */
+template <class T>
+class spsc_bounded_queue {
+public:
+  using value_type = T;
+
+  /**
+   * @brief Constructs a new instance with the specified capacity.
+   * @param capacity max number of elements in the queue; must be a power of two greater one.
+   */
+  explicit spsc_bounded_queue(std::size_t capacity);
+
+  spsc_bounded_queue(const spsc_bounded_queue&) = delete;
+  spsc_bounded_queue(spsc_bounded_queue&&) = delete;
+
+  spsc_bounded_queue& operator=(const spsc_bounded_queue&) = delete;
+  spsc_bounded_queue& operator=(spsc_bounded_queue&&) = delete;
+
+  /**
+   * @brief Tries to push a new element to the queue.
+   *
+   * May only be called by the producer.
+   *
+   * Progress guarantees: wait-free
+   *
+   * @param value
+   * @return `true` if the operation was successful, otherwise `false` (i.e., the queue is full)
+   */
+  bool try_push(value_type value);
+
+  /**
+   * @brief Tries to pop an element from the queue.
+   *
+   * May only be called by the consumer.
+   *
+   * Progress guarantees: wait-free
+   *
+   * @param result the value popped from the queue if the operation was successful
+   * @return `true` if the operation was successful, otherwise `false` (i.e., the queue is empty)
+   */
+  [[nodiscard]] bool try_pop(value_type& result);
+
+  /**
+   * @brief Pushes as many elements from the range `[first, last)` as there is space in
+   * the queue.
+   *
+   * All pushed elements are published with a single release-store.
+   * May only be called by the producer.
+   *
+   * Progress guarantees: wait-free
+   *
+   * @param first
+   * @param last
+   * @return the number of elements that have been pushed, i.e., the elements in
+   * `[first, first + n)` have been pushed
+   */
+  template <class ForwardIt>
+  std::size_t push_n(ForwardIt first, ForwardIt last);
+
+  /**
+   * @brief Pops up to `max` elements from the queue and moves them to `out`.
+   *
+   * The cells of all popped elements are released with a single release-store.
+   * May only be called by the consumer.
+   *
+   * Progress guarantees: wait-free
+   *
+   * @param out the output iterator to which the popped elements are moved
+   * @param max the maximum number of elements to pop
+   * @return the number of popped elements
+   */
+  template <class OutputIt>
+  std::size_t pop_n(OutputIt out, std::size_t max);
+
+  /**
+   * @brief Returns the maximum number of elements the queue can hold.
+   */
+  [[nodiscard]] std::size_t capacity() const noexcept { return _index_mask + 1; }
+
+private:
+  static constexpr std::size_t cacheline_size = 64;
+
+  const std::size_t _index_mask;
+  const std::unique_ptr<T[]> _buffer;
+
+  // written only by the producer
+  alignas(cacheline_size) std::atomic<std::size_t> _tail{0};
+  std::size_t _cached_head = 0;
+
+  // written only by the consumer
+  alignas(cacheline_size) std::atomic<std::size_t> _head{0};
+  std::size_t _cached_tail = 0;
+};
+
+template <class T>
+spsc_bounded_queue<T>::spsc_bounded_queue(std::size_t capacity) :
+    _index_mask(capacity - 1),
+    _buffer(new T[capacity]) {
+  assert(capacity >= 2 && utils::is_power_of_two(capacity));
+}
+
+template <class T>
+bool spsc_bounded_queue<T>::try_push(value_type value) {
+  const std::size_t tail = _tail.load(std::memory_order_relaxed);
+  if (tail - _cached_head > _index_mask) {
+    // (1) - this acquire-load synchronizes-with the release-store (6, 8)
+    _cached_head = _head.load(std::memory_order_acquire);
+    if (tail - _cached_head > _index_mask) {
+      return false;
+    }
+  }
+  _buffer[tail & _index_mask] = std::move(value);
+  // (2) - this release-store synchronizes-with the acquire-load (5, 7)
+  _tail.store(tail + 1, std::memory_order_release);
+  return true;
+}
+
+template <class T>
+template <class ForwardIt>
+std::size_t spsc_bounded_queue<T>::push_n(ForwardIt first, ForwardIt last) {
+  const auto n = static_cast<std::size_t>(std::distance(first, last));
+  const std::size_t tail = _tail.load(std::memory_order_relaxed);
+  std::size_t free = capacity() - (tail - _cached_head);
+  if (free < n) {
+    // (3) - this acquire-load synchronizes-with the release-store (6, 8)
+    _cached_head = _head.load(std::memory_order_acquire);
+    free = capacity() - (tail - _cached_head);
+  }
+
+  const std::size_t count = std::min(n, free);
+  if (count == 0) {
+    return 0;
+  }
+  for (std::size_t i = 0; i < count; ++i, ++first) {
+    _buffer[(tail + i) & _index_mask] = *first;
+  }
+  // (4) - this release-store synchronizes-with the acquire-load (5, 7)
+  _tail.store(tail + count, std::memory_order_release);
+  return count;
+}
+
+template <class T>
+bool spsc_bounded_queue<T>::try_pop(value_type& result) {
+  const std::size_t head = _head.load(std::memory_order_relaxed);
+  if (head == _cached_tail) {
+    // (5) - this acquire-load synchronizes-with the release-store (2, 4)
+    _cached_tail = _tail.load(std::memory_order_acquire);
+    if (head == _cached_tail) {
+      return false;
+    }
+  }
+  result = std::move(_buffer[head & _index_mask]);
+  // (6) - this release-store synchronizes-with the acquire-load (1, 3)
+  _head.store(head + 1, std::memory_order_release);
+  return true;
+}
+
+template <class T>
+template <class OutputIt>
+std::size_t spsc_bounded_queue<T>::pop_n(OutputIt out, std::size_t max) {
+  const std::size_t head = _head.load(std::memory_order_relaxed);
+  std::size_t available = _cached_tail - head;
+  if (available < max) {
+    // (7) - this acquire-load synchronizes-with the release-store (2, 4)
+    _cached_tail = _tail.load(std::memory_order_acquire);
+    available = _cached_tail - head;
+  }
+
+  const std::size_t count = std::min(max, available);
+  if (count == 0) {
+    return 0;
+  }
+  for (std::size_t i = 0; i < count; ++i) {
+    *out = std::move(_buffer[(head + i) & _index_mask]);
+    ++out;
+  }
+  // (8) - this release-store synchronizes-with the acquire-load (1, 3)
+  _head.store(head + count, std::memory_order_release);
+  return count;
+}
+} // namespace xenium
+
+#ifdef _MSC_VER
+  #pragma warning(pop)
+#endif
+
+#endif
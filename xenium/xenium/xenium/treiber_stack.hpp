@@ -0,0 +1,281 @@
+//
+// Copyright (c) 2018-2020 Manuel Pöter.
+// Licensed under the MIT License. See LICENSE file in the project root for full license information.
+//
+
+#ifndef XENIUM_TREIBER_STACK_HPP
+#define XENIUM_TREIBER_STACK_HPP
+
+#include <xenium/acquire_guard.hpp>
+#include <xenium/backoff.hpp>
+#include <xenium/detail/hardware.hpp>
+#include <xenium/marked_ptr.hpp>
+#include <xenium/parameter.hpp>
+#include <xenium/policy.hpp>
+
+#include <array>
+#include <atomic>
+#include <cassert>
+#include <cstdint>
+
+#ifdef _MSC_VER
+  #pragma warning(push)
+  #pragma warning(disable : 4324) // structure was padded due to alignment specifier
+#endif
+
+namespace xenium {
+
+namespace policy {
+  /**
+   * @brief Policy to configure the number of slots in the elimination array of `treiber_stack`.
+   *
+   * A value of zero disables the elimination array.
+   * @tparam Value
+   */
+  template <unsigned Value>
+  struct elimination_slots;
+} // namespace policy
+
+/**
+ * @brief An unbounded generic lock-free multi-producer/multi-consumer LIFO stack.
+ *
+ * This is an implementation of the lock-free stack proposed by Treiber
+ * \[[Tre86](index.html#ref-treiber-1986)\].
+ * It is fully generic and can handle any type `T` that is copyable or movable.
+ *
+ * Optionally, the stack can use an elimination array as proposed by Hendler et al.
+ * \[[HSY04](index.html#ref-hendler-2004)\]. A push operation that fails to update the top
+ * pointer publishes its node in a randomly chosen slot of the elimination array and waits for
+ * a short time, while a pop operation that fails to update the top pointer tries to take a
+ * node from a randomly chosen slot. Such a colliding push/pop pair exchanges the value without
+ * touching the top pointer, which reduces the contention on the top pointer if push and pop
+ * operations are roughly symmetric.
+ *
+ * Supported policies:
+ *  * `xenium::policy::reclaimer`<br>
+ *    Defines the reclamation scheme to be used for internal nodes. (**required**)
+ *  * `xenium::policy::backoff`<br>
+ *    Defines the backoff strategy. (*optional*; defaults to `xenium::no_backoff`)
+ *  * `xenium::policy::elimination_slots`<br>
+ *    Defines the number of slots in the elimination array; zero disables the elimination
+ *    array. (*optional*; defaults to 0)
+ *
+ * @tparam T type of the stored elements.
+ * @tparam Policies list of policies to customize the behaviour
+ */
+template <class T, class... Policies>
+class treiber_stack {
+public:
+  using value_type = T;
+  using reclaimer = parameter::type_param_t<policy::reclaimer, parameter::nil, Policies...>;
+  using backoff = parameter::type_param_t<policy::backoff, no_backoff, Policies...>;
+  static constexpr unsigned elimination_slots =
+    parameter::value_param_t<unsigned, policy::elimination_slots, 0, Policies...>::value;
+
+  template <class... NewPolicies>
+  using with = treiber_stack<T, NewPolicies..., Policies...>;
+
+  static_assert(parameter::is_set<reclaimer>::value, "reclaimer policy must be specified");
+
+  treiber_stack() = default;
+  ~treiber_stack();
+
+  treiber_stack(const treiber_stack&) = delete;
+  treiber_stack(treiber_stack&&) = delete;
+
+  treiber_stack& operator=(const treiber_stack&) = delete;
+  treiber_stack& operator=(treiber_stack&&) = delete;
+
+  /**
+   * @brief Pushes the given value to the stack.
+   *
+   * This operation always allocates a new node.
+   * Progress guarantees: lock-free (always performs a memory allocation)
+   *
+   * @param value
+   */
+  void push(T value);
+
+  /**
+   * @brief Tries to pop an object from the stack. If the operation is
+   * successful, the object will be moved to `result`.
+   *
+   * Progress guarantees: lock-free
+   *
+   * @param result
+   * @return `true` if the operation was successful, otherwise `false`
+   */
+  [[nodiscard]] bool try_pop(T& result);
+
+private:
+  struct node;
+
+  using concurrent_ptr = typename reclaimer::template concurrent_ptr<node, 0>;
+  using marked_ptr = typename concurrent_ptr::marked_ptr;
+  using guard_ptr = typename concurrent_ptr::guard_ptr;
+
+  struct node : reclaimer::template enable_concurrent_ptr<node> {
+    explicit node(T&& v) : _value(std::move(v)) {}
+
+    T _value;
+    concurrent_ptr _next;
+  };
+
+  // A push operation waits this many iterations for a pop operation to take its node
+  // from the elimination array before it withdraws the node.
+  static constexpr unsigned elimination_spins = 128;
+
+  // A pop operation that takes a node from an elimination slot sets the mark bit, but the slot
+  // remains occupied until the push operation that has published the node clears it. Thus a
+  // slot can only be reused once the push operation knows that its node has been taken.
+  using slot_ptr = xenium::marked_ptr<node, 1>;
+
+  struct alignas(64) elimination_slot {
+    std::atomic<slot_ptr> value{slot_ptr{}};
+  };
+
+  static unsigned random_slot();
+  bool try_eliminate_push(node* n);
+  bool try_eliminate_pop(T& result);
+
+  alignas(64) concurrent_ptr _top;
+  std::array<elimination_slot, elimination_slots> _elimination;
+};
+
+template <class T, class... Policies>
+treiber_stack<T, Policies...>::~treiber_stack() {
+  // (1) - this acquire-load synchronizes-with the release-CAS (2)
+  auto n = _top.load(std::memory_order_acquire);
+  while (n) {
+    auto next = n->_next.load(std::memory_order_relaxed);
+    delete n.get();
+    n = next;
+  }
+}
+
+template <class T, class... Policies>
+void treiber_stack<T, Policies...>::push(T value) {
+  node* n = new node(std::move(value));
+  backoff backoff;
+
+  auto top = _top.load(std::memory_order_relaxed);
+  for (;;) {
+    n->_next.store(top, std::memory_order_relaxed);
+    // (2) - this release-CAS synchronizes-with the acquire-load (1, 3)
+    if (_top.compare_exchange_weak(top, n, std::memory_order_release, std::memory_order_relaxed)) {
+      return;
+    }
+
+    if constexpr (elimination_slots > 0) {
+      if (try_eliminate_push(n)) {
+        return;
+      }
+      top = _top.load(std::memory_order_relaxed);
+    }
+    backoff();
+  }
+}
+
+template <class T, class... Policies>
+bool treiber_stack<T, Policies...>::try_pop(T& result) {
+  backoff backoff;
+
+  guard_ptr top;
+  for (;;) {
+    // (3) - this acquire-load synchronizes-with the release-CAS (2)
+    top.acquire(_top, std::memory_order_acquire);
+    if (top.get() == nullptr) {
+      return false;
+    }
+
+    // All updates of _top are read-modify-write operations, so they are part of the release
+    // sequences headed by the release-CAS operations (2). Therefore the acquire-load (3) also
+    // synchronizes-with the push operation that has stored the next node, and the CAS below
+    // can be relaxed.
+    auto next = top->_next.load(std::memory_order_relaxed);
+    marked_ptr expected(top.get());
+    if (_top.compare_exchange_weak(expected, next, std::memory_order_relaxed, std::memory_order_relaxed)) {
+      result = std::move(top->_value);
+      top.reclaim();
+      return true;
+    }
+
+    if constexpr (elimination_slots > 0) {
+      if (try_eliminate_pop(result)) {
+        return true;
+      }
+    }
+    backoff();
+  }
+}
+
+template <class T, class... Policies>
+unsigned treiber_stack<T, Policies...>::random_slot() {
+  // xorshift32, seeded with the address of the thread-local state
+  thread_local std::uint32_t state = 0;
+  if (state == 0) {
+    state = static_cast<std::uint32_t>(reinterpret_cast<std::uintptr_t>(&state) >> 4) | 1;
+  }
+  state ^= state << 13;
+  state ^= state >> 17;
+  state ^= state << 5;
+  return state % elimination_slots;
+}
+
+template <class T, class... Policies>
+bool treiber_stack<T, Policies...>::try_eliminate_push(node* n) {
+  auto& slot = _elimination[random_slot()].value;
+  slot_ptr expected{};
+  // (4) - this release-CAS synchronizes-with the acquire-CAS (5)
+  if (!slot.compare_exchange_strong(expected, slot_ptr(n), std::memory_order_release, std::memory_order_relaxed)) {
+    return false; // the slot is occupied by some other push operation
+  }
+
+  const slot_ptr taken(n, 1);
+  for (unsigned i = 0; i < elimination_spins; ++i) {
+    // If the slot is marked, a pop operation has taken our node. In this case the pop
+    // operation owns the node, so we must not touch it anymore; we only release the slot.
+    if (slot.load(std::memory_order_relaxed) == taken) {
+      slot.store(slot_ptr{}, std::memory_order_relaxed);
+      return true;
+    }
+    detail::hardware_pause();
+  }
+
+  // Try to withdraw our node. Only pop operations can change the slot, and they only set
+  // the mark bit, so if this fails our node has been taken in the meantime.
+  expected = slot_ptr(n);
+  if (slot.compare_exchange_strong(expected, slot_ptr{}, std::memory_order_relaxed, std::memory_order_relaxed)) {
+    return false;
+  }
+  assert(expected == taken);
+  slot.store(slot_ptr{}, std::memory_order_relaxed);
+  return true;
+}
+
+template <class T, class... Policies>
+bool treiber_stack<T, Policies...>::try_eliminate_pop(T& result) {
+  auto& slot = _elimination[random_slot()].value;
+  slot_ptr n = slot.load(std::memory_order_relaxed);
+  if (n.get() == nullptr || n.mark() != 0) {
+    return false; // the slot is empty, or its node has already been taken
+  }
+  // (5) - this acquire-CAS synchronizes-with the release-CAS (4)
+  if (!slot.compare_exchange_strong(n, slot_ptr(n.get(), 1), std::memory_order_acquire, std::memory_order_relaxed)) {
+    return false;
+  }
+  // The node has never been part of the stack and the push operation does not access it
+  // once it has been taken, so we can delete it right away. The slot remains marked until
+  // the push operation has cleared it, so the address cannot be published in this slot again
+  // before that.
+  result = std::move(n->_value);
+  delete n.get();
+  return true;
+}
+} // namespace xenium
+
+#ifdef _MSC_VER
+  #pragma warning(pop)
+#endif
+
+#endif
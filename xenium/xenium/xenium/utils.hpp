@@ -35,6 +35,25 @@ constexpr T next_power_of_two(T val) {
   return static_cast<T>(1) << find_last_bit_set(val);
 }
 
+template <typename T>
+constexpr T reverse_bits(T val) {
+  if constexpr (sizeof(T) == 8) {
+    auto v = static_cast<std::uint64_t>(val);
+    v = ((v >> 1) & 0x5555555555555555ull) | ((v & 0x5555555555555555ull) << 1);
+    v = ((v >> 2) & 0x3333333333333333ull) | ((v & 0x3333333333333333ull) << 2);
+    v = ((v >> 4) & 0x0F0F0F0F0F0F0F0Full) | ((v & 0x0F0F0F0F0F0F0F0Full) << 4);
+    v = ((v >> 8) & 0x00FF00FF00FF00FFull) | ((v & 0x00FF00FF00FF00FFull) << 8);
+    v = ((v >> 16) & 0x0000FFFF0000FFFFull) | ((v & 0x0000FFFF0000FFFFull) << 16);
+    return static_cast<T>((v >> 32) | (v << 32));
+  } else {
+    T result = 0;
+    for (unsigned i = 0; i < sizeof(T) * 8; ++i, val >>= 1) {
+      result = static_cast<T>((result << 1) | (val & 1));
+    }
+    return result;
+  }
+}
+
 template <typename T>
 struct modulo {
   T operator()(T a, T b) { return a % b; }
@@ -7,12 +7,17 @@
 #define XENIUM_VYUKOV_BOUNDED_QUEUE_HPP
 
 #include <xenium/parameter.hpp>
+#include <xenium/policy.hpp>
 #include <xenium/utils.hpp>
 
+#include <algorithm>
 #include <atomic>
 #include <cassert>
 #include <cstdint>
+#include <iterator>
 #include <memory>
+#include <new>
+#include <type_traits>
 
 #ifdef _MSC_VER
   #pragma warning(push)
@@ -30,6 +35,14 @@ namespace policy {
   template <bool Value>
   struct default_to_weak;
 
+  /**
+   * @brief Policy to configure whether `vyukov_bounded_queue` should map consecutive
+   * positions to cells in different cache lines.
+   * @tparam Value
+   */
+  template <bool Value>
+  struct remap_index;
+
 } // namespace policy
 /**
  * @brief A bounded generic multi-producer/multi-consumer FIFO queue.
@@ -53,7 +66,25 @@ namespace policy {
  * would keep spinning until T1 has finished, while `try_pop_weak` would immediately
  * return false, even though the queue is not empty.
  *
+ * By default the cells are stored contiguously, so for small types `T` several consecutive
+ * cells share a cache line, which can result in false sharing between threads that operate
+ * on neighbouring cells. This can be addressed in two ways. `padding_bytes` increases the size
+ * of each cell (and therefore the memory footprint of the queue), while `remap_index` maps
+ * consecutive positions to cells in different cache lines without using additional memory,
+ * similar to the index remapping used in `nikolaev_bounded_queue`. Remapping is only applied
+ * if the queue is large enough to span multiple cache lines. The cells are allocated cacheline
+ * aligned, and if the cell size is not a power of two the remapping stride is rounded up.
+ *
+ * Supported policies:
+ *  * `xenium::policy::default_to_weak`<br>
+ *    Defines whether `try_push`/`try_pop` default to the weak versions. (*optional*; defaults to `false`)
+ *  * `xenium::policy::padding_bytes`<br>
+ *    Defines the number of padding bytes for each cell. (*optional*; defaults to 0)
+ *  * `xenium::policy::remap_index`<br>
+ *    Defines whether consecutive positions are mapped to different cache lines. (*optional*; defaults to `false`)
+ *
  * @tparam T type of the stored elements.
+ * @tparam Policies list of policies to customize the behaviour
  */
 template <class T, class... Policies>
 struct vyukov_bounded_queue {
@@ -62,16 +93,68 @@ public:
 
   static constexpr bool default_to_weak =
     parameter::value_param_t<bool, policy::default_to_weak, false, Policies...>::value;
-  ;
+  static constexpr unsigned padding_bytes =
+    parameter::value_param_t<unsigned, policy::padding_bytes, 0, Policies...>::value;
+  static constexpr bool remap_index = parameter::value_param_t<bool, policy::remap_index, false, Policies...>::value;
+
+private:
+  struct unpadded_cell {
+    std::atomic<std::size_t> sequence;
+    T value;
+  };
+
+  struct padded_cell {
+    std::atomic<std::size_t> sequence;
+    T value;
+    // we use max here to avoid arrays of size zero which are not allowed by Visual C++
+    char padding[std::max(padding_bytes, 1u)];
+  };
+  using cell = std::conditional_t<padding_bytes == 0, unpadded_cell, padded_cell>;
+
+  static constexpr std::size_t cacheline_size = 64;
+  static constexpr std::align_val_t cacheline_alignment{cacheline_size};
+  // The smallest power of two number of cells that covers at least a whole cache line.
+  // The cells are allocated cacheline aligned, so cells whose indexes differ by at least
+  // this number never share a cache line, even if the cell size is not a power of two.
+  static constexpr std::size_t cells_per_cacheline =
+    sizeof(cell) >= cacheline_size ? 1 : utils::next_power_of_two((cacheline_size + sizeof(cell) - 1) / sizeof(cell));
+
+  struct cell_deleter {
+    std::size_t size;
+    void operator()(cell* cells) const {
+      std::destroy_n(cells, size);
+      ::operator delete(cells, cacheline_alignment);
+    }
+  };
+
+  static cell* allocate_cells(std::size_t size) {
+    auto* result = static_cast<cell*>(::operator new(sizeof(cell) * size, cacheline_alignment));
+    try {
+      std::uninitialized_default_construct_n(result, size);
+    } catch (...) {
+      ::operator delete(result, cacheline_alignment);
+      throw;
+    }
+    return result;
+  }
+
+public:
+  /**
+   * @brief Provides the effective size of a single cell (including padding).
+   */
+  static constexpr std::size_t cell_size = sizeof(cell);
 
   /**
    * @brief Constructs a new instance with the specified maximum size.
    * @param size max number of elements in the queue; must be a power of two greater one.
    */
-  explicit vyukov_bounded_queue(std::size_t size) : cells(new cell[size]), index_mask(size - 1) {
+  explicit vyukov_bounded_queue(std::size_t size) :
+      cells(allocate_cells(size), cell_deleter{size}),
+      index_mask(size - 1),
+      remap_shift(calc_remap_shift(size)) {
     assert(size >= 2 && utils::is_power_of_two(size));
     for (std::size_t i = 0; i < size; ++i) {
-      cells[i].sequence.store(i, std::memory_order_relaxed);
+      cell_at(i).sequence.store(i, std::memory_order_relaxed);
     }
     enqueue_pos.store(0, std::memory_order_relaxed);
     dequeue_pos.store(0, std::memory_order_relaxed);
@@ -183,14 +266,54 @@ public:
    */
   [[nodiscard]] bool try_pop_weak(T& result) { return do_try_pop<true>(result); }
 
+  /**
+   * @brief Tries to push the elements from the range `[first, last)` to the queue.
+   *
+   * Reserves a run of consecutive free cells with a single CAS on the shared enqueue
+   * position and then fills them. The run ends at the first cell that is not yet free,
+   * so the operation can succeed partially; the pushed elements are always a prefix of
+   * the given range and are stored consecutively in the queue.
+   *
+   * If `policy::default_to_weak` has been specified to be true, this method has the same
+   * progress guarantees as `try_push_weak`, otherwise as `try_push_strong`.
+   *
+   * @param first
+   * @param last
+   * @return the number of elements that have been pushed, i.e., the elements in
+   * `[first, first + n)` have been pushed
+   */
+  template <class ForwardIt>
+  std::size_t try_push_n(ForwardIt first, ForwardIt last) {
+    return do_try_push_n<default_to_weak>(first, static_cast<std::size_t>(std::distance(first, last)));
+  }
+
+  /**
+   * @brief Tries to pop up to `max` elements from the queue and moves them to `out`.
+   *
+   * Reserves a run of consecutive cells with a single CAS on the shared dequeue position
+   * and then drains them. The run ends at the first cell whose element has not been
+   * pushed yet, so the operation may pop fewer than `max` elements.
+   *
+   * If `policy::default_to_weak` has been specified to be true, this method has the same
+   * progress guarantees as `try_pop_weak`, otherwise as `try_pop_strong`.
+   *
+   * @param out the output iterator to which the popped elements are moved
+   * @param max the maximum number of elements to pop
+   * @return the number of popped elements
+   */
+  template <class OutputIt>
+  std::size_t try_pop_n(OutputIt out, std::size_t max) {
+    return do_try_pop_n<default_to_weak>(out, max);
+  }
+
 private:
   template <bool Weak, class... Args>
   bool do_try_push(Args&&... args) {
     cell* c;
     std::size_t pos = enqueue_pos.load(std::memory_order_relaxed);
     for (;;) {
-      c = &cells[pos & index_mask];
-      // (3) - this acquire-load synchronizes-with the release-store (2)
+      c = &cell_at(pos);
+      // (3) - this acquire-load synchronizes-with the release-store (2, 8)
       std::size_t seq = c->sequence.load(std::memory_order_acquire);
       if (seq == pos) {
         if (enqueue_pos.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
@@ -212,7 +335,7 @@ private:
       }
     }
     assign_value(c->value, std::forward<Args>(args)...);
-    // (4) - this release-store synchronizes-with the acquire-load (1)
+    // (4) - this release-store synchronizes-with the acquire-load (1, 7)
     c->sequence.store(pos + 1, std::memory_order_release);
     return true;
   }
@@ -222,8 +345,8 @@ private:
     cell* c;
     std::size_t pos = dequeue_pos.load(std::memory_order_relaxed);
     for (;;) {
-      c = &cells[pos & index_mask];
-      // (1) - this acquire-load synchronizes-with the release-store (4)
+      c = &cell_at(pos);
+      // (1) - this acquire-load synchronizes-with the release-store (4, 6)
       std::size_t seq = c->sequence.load(std::memory_order_acquire);
       auto new_pos = pos + 1;
       if (seq == new_pos) {
@@ -246,11 +369,126 @@ private:
       }
     }
     result = std::move(c->value);
-    // (2) - this release-store synchronizes-with the acquire-load (3)
+    // (2) - this release-store synchronizes-with the acquire-load (3, 5)
     c->sequence.store(pos + index_mask + 1, std::memory_order_release);
     return true;
   }
 
+  template <bool Weak, class ForwardIt>
+  std::size_t do_try_push_n(ForwardIt first, std::size_t n) {
+    if (n == 0) {
+      return 0;
+    }
+
+    std::size_t pos = enqueue_pos.load(std::memory_order_relaxed);
+    std::size_t count;
+    for (;;) {
+      // Count the consecutive free cells starting at pos. A cell can only become occupied
+      // by a producer that has reserved it, which requires enqueue_pos to move beyond pos,
+      // so if the CAS below succeeds, all counted cells are still free.
+      count = 0;
+      std::size_t seq;
+      do {
+        // (5) - this acquire-load synchronizes-with the release-store (2, 8)
+        seq = cell_at(pos + count).sequence.load(std::memory_order_acquire);
+      } while (seq == pos + count && ++count < n);
+
+      if (count > 0) {
+        if (enqueue_pos.compare_exchange_weak(pos, pos + count, std::memory_order_relaxed)) {
+          break;
+        }
+      } else {
+        if (Weak) {
+          if (seq < pos) {
+            return 0;
+          }
+          pos = enqueue_pos.load(std::memory_order_relaxed);
+        } else {
+          auto pos2 = enqueue_pos.load(std::memory_order_relaxed);
+          if (pos2 == pos && dequeue_pos.load(std::memory_order_relaxed) + index_mask + 1 == pos) {
+            return 0;
+          }
+          pos = pos2;
+        }
+      }
+    }
+
+    for (std::size_t i = 0; i < count; ++i, ++first) {
+      cell& c = cell_at(pos + i);
+      assign_value(c.value, *first);
+      // (6) - this release-store synchronizes-with the acquire-load (1, 7)
+      c.sequence.store(pos + i + 1, std::memory_order_release);
+    }
+    return count;
+  }
+
+  template <bool Weak, class OutputIt>
+  std::size_t do_try_pop_n(OutputIt out, std::size_t max) {
+    if (max == 0) {
+      return 0;
+    }
+
+    std::size_t pos = dequeue_pos.load(std::memory_order_relaxed);
+    std::size_t count;
+    for (;;) {
+      // Count the consecutive cells starting at pos that contain a pushed element;
+      // like in do_try_push_n, a successful CAS guarantees that they are still occupied.
+      count = 0;
+      std::size_t seq;
+      do {
+        // (7) - this acquire-load synchronizes-with the release-store (4, 6)
+        seq = cell_at(pos + count).sequence.load(std::memory_order_acquire);
+      } while (seq == pos + count + 1 && ++count < max);
+
+      if (count > 0) {
+        if (dequeue_pos.compare_exchange_weak(pos, pos + count, std::memory_order_relaxed)) {
+          break;
+        }
+      } else {
+        if (Weak) {
+          if (seq < pos + 1) {
+            return 0;
+          }
+          pos = dequeue_pos.load(std::memory_order_relaxed);
+        } else {
+          auto pos2 = dequeue_pos.load(std::memory_order_relaxed);
+          if (pos2 == pos && enqueue_pos.load(std::memory_order_relaxed) == pos) {
+            return 0;
+          }
+          pos = pos2;
+        }
+      }
+    }
+
+    for (std::size_t i = 0; i < count; ++i) {
+      cell& c = cell_at(pos + i);
+      *out = std::move(c.value);
+      ++out;
+      // (8) - this release-store synchronizes-with the acquire-load (3, 5)
+      c.sequence.store(pos + i + index_mask + 1, std::memory_order_release);
+    }
+    return count;
+  }
+
+  static std::size_t calc_remap_shift(std::size_t size) {
+    if (!remap_index || size <= cells_per_cacheline) {
+      return 0;
+    }
+    return utils::find_last_bit_set(size / cells_per_cacheline) - 1;
+  }
+
+  cell& cell_at(std::size_t pos) {
+    std::size_t idx = pos & index_mask;
+    if constexpr (remap_index) {
+      if (remap_shift != 0) {
+        // Transpose the (cells_per_cacheline x size/cells_per_cacheline) matrix of positions,
+        // so that consecutive positions end up in different cache lines.
+        idx = (idx >> remap_shift) | ((idx * cells_per_cacheline) & index_mask);
+      }
+    }
+    return cells[idx];
+  }
+
   void assign_value(T& v, const T& source) { v = source; }
   void assign_value(T& v, T&& source) { v = std::move(source); }
   template <class... Args>
@@ -258,14 +496,9 @@ private:
     v = T{std::forward<Args>(args)...};
   }
 
-  // TODO - add optional padding via policy
-  struct cell {
-    std::atomic<std::size_t> sequence;
-    T value;
-  };
-
-  std::unique_ptr<cell[]> cells;
+  std::unique_ptr<cell[], cell_deleter> cells;
   const std::size_t index_mask;
+  const std::size_t remap_shift;
   alignas(64) std::atomic<size_t> enqueue_pos;
   alignas(64) std::atomic<size_t> dequeue_pos;
 };
@@ -8,6 +8,9 @@
 
 #include <xenium/acquire_guard.hpp>
 #include <xenium/backoff.hpp>
+#include <xenium/detail/mapped_file.hpp>
+#include <xenium/detail/parallel_for.hpp>
+#include <xenium/detail/striped_counter.hpp>
 #include <xenium/hash.hpp>
 #include <xenium/parameter.hpp>
 #include <xenium/policy.hpp>
@@ -15,6 +18,8 @@
 
 #include <atomic>
 #include <cstdint>
+#include <string>
+#include <vector>
 
 namespace xenium {
 
@@ -77,6 +82,9 @@ namespace detail {
  * In contrast, an `accessor` provides safe access to a _single_ value, but without holding
  * any lock. The entry can safely be removed from the map even though some other thread
  * may have an `accessor` to its value.
+ * For read-only scans that should not interfere with concurrent updates there is also a
+ * `snapshot_iterator` that does not acquire any bucket locks, but instead operates on
+ * copies of the key/value pairs (see `snapshot_begin`).
  *
  * Some parts of the interface depend on whether the key/value types are trivially copyable
  * and have a size of 4 or 8 bytes (e.g., raw pointers, integers); such types are further
@@ -156,6 +164,7 @@ public:
   ~vyukov_hash_map();
 
   class iterator;
+  class snapshot_iterator;
   using accessor = typename traits::accessor;
 
   using key_type = typename traits::key_type;
@@ -215,6 +224,67 @@ public:
   template <class Factory>
   std::pair<accessor, bool> get_or_emplace_lazy(key_type key, Factory&& factory);
 
+  /**
+   * @brief Updates the value of the element with the key equivalent to key (if one exists).
+   *
+   * `func` is called with a reference to a copy of the element's current value while
+   * the bucket lock is held; the modified copy is then published as the new value.
+   * For non-trivial value types this allocates a new internal node and retires the old
+   * one, so accessors to the previous value remain valid. For `managed_ptr` values the
+   * previous object is reclaimed if `func` replaces the pointer.
+   *
+   * No iterators or accessors are invalidated.
+   *
+   * Progress guarantees: blocking
+   *
+   * @tparam Func
+   * @param key key of the element to update
+   * @param func a functor with the signature `void(value_type&)`
+   * @return `true` if an element was updated, otherwise `false`
+   */
+  template <class Func>
+  bool update(const key_type& key, Func&& func);
+
+  /**
+   * @brief Updates the value of the element with the key equivalent to key, or inserts a
+   * new element with a value created by calling `factory` if no such element exists.
+   *
+   * The lookup, the update and the insertion are all performed while holding a single
+   * bucket lock. `func` has the same semantics as in `update` and is not called if a new
+   * element is inserted.
+   *
+   * No iterators or accessors are invalidated.
+   *
+   * Progress guarantees: blocking
+   *
+   * @tparam Factory
+   * @tparam Func
+   * @param key the key of the element to update or insert
+   * @param factory a functor that is used to create the `Value` instance when inserting a new element
+   * @param func a functor with the signature `void(value_type&)`
+   * @return `true` if an element was inserted, `false` if an existing element was updated
+   */
+  template <class Factory, class Func>
+  bool upsert(key_type key, Factory&& factory, Func&& func);
+
+  /**
+   * @brief Atomically adds `delta` to the value of the element with the key equivalent to key,
+   * or inserts a new element with value `delta` if no such element exists.
+   *
+   * This operation is only available for trivial integral value types. Since `erase` relocates
+   * entries within a bucket, the value cannot be modified without holding the bucket lock;
+   * the whole operation therefore requires only a single lock acquisition, but no node
+   * allocation.
+   *
+   * Progress guarantees: blocking
+   *
+   * @param key the key of the element to update or insert
+   * @param delta the value to add
+   * @return the value of the element before the addition, or `value_type{}` if a new element
+   * was inserted
+   */
+  value_type fetch_add(key_type key, value_type delta);
+
   /**
    * @brief Removes the element with the key equivalent to key (if one exists), and provides an
    * accessor to the removed value.
@@ -270,6 +340,48 @@ public:
   // TODO - implement contains
   // bool contains(const key_type& key) const;
 
+  /**
+   * @brief Returns the number of elements in the container.
+   *
+   * The element counter is distributed over several cacheline-sized stripes, so
+   * insert and erase operations of different threads usually do not contend on it.
+   * This method simply sums up the stripes without any further synchronization, so
+   * in the presence of concurrent modifications the result is only an approximation.
+   *
+   * Progress guarantees: wait-free
+   *
+   * @return the approximate number of elements
+   */
+  [[nodiscard]] std::size_t approximate_size() const noexcept { return element_count.approximate_value(); }
+
+  /**
+   * @brief Returns the number of elements in the container.
+   *
+   * The counter is updated while the corresponding bucket is locked, and the stripes
+   * are collected repeatedly until two subsequent collects are identical, so the result
+   * is the number of elements the container held at some point during the call.
+   * The number of collects is bounded; if other threads modify the container during
+   * each of them, the result is the same approximation that `approximate_size` returns.
+   *
+   * Progress guarantees: wait-free
+   *
+   * @return the number of elements
+   */
+  [[nodiscard]] std::size_t size() const { return element_count.value(); }
+
+  /**
+   * @brief Returns the current number of buckets.
+   *
+   * Buckets that run out of extension items only cause the table to grow if the map exceeds
+   * its maximum load factor; otherwise additional extension items are allocated, so the
+   * bucket count stays the same.
+   *
+   * Progress guarantees: lock-free
+   *
+   * @return the number of buckets
+   */
+  [[nodiscard]] std::size_t bucket_count() const;
+
   /**
    * @brief Finds an element with key equivalent to key.
    *
@@ -300,6 +412,100 @@ public:
    */
   iterator end() { return iterator(); }
 
+  /**
+   * @brief Returns a `snapshot_iterator` to the first element of the container.
+   *
+   * In contrast to `iterator`, a `snapshot_iterator` does not lock any buckets and therefore
+   * does not block concurrent update operations. This is not supported if the value type
+   * is a `managed_ptr`.
+   *
+   * Progress guarantees: lock-free
+   *
+   * @return snapshot_iterator to the first element
+   */
+  snapshot_iterator snapshot_begin() const;
+
+  /**
+   * @brief Returns a `snapshot_iterator` to the element following the last element of the container.
+   *
+   * Progress guarantees: wait-free
+   *
+   * @return snapshot_iterator to the element following the last element.
+   */
+  snapshot_iterator snapshot_end() const { return snapshot_iterator(); }
+
+  /**
+   * @brief Writes all elements of the container to the specified file.
+   *
+   * The elements are written as a compact sequence of raw key/value pairs, preceded by a
+   * small header that identifies the format and the size of the key and value types.
+   * The file can later be loaded via `load`. Since the keys and values are stored as raw
+   * bytes, the file is only portable between platforms with the same byte order.
+   * This is only supported if both key and value are trivial.
+   *
+   * The elements are collected using a `snapshot_iterator`, so `save` does not block
+   * concurrent update operations. In the presence of such concurrent updates the file
+   * contains all elements that were in the map during the whole operation, while
+   * concurrently inserted or removed elements may or may not be contained.
+   *
+   * Throws `std::ios_base::failure` if the file cannot be written.
+   *
+   * Progress guarantees: blocking (file I/O)
+   *
+   * @param path the path of the file to write
+   */
+  void save(const std::string& path) const;
+
+  /**
+   * @brief Loads all elements from the specified file that has been written by `save`.
+   *
+   * The file is mapped into memory (if supported by the platform) and the elements are
+   * written directly into a new data block that is sized such that it can hold all elements
+   * without having to grow. Since the new block is not yet visible to other threads, the
+   * buckets can be populated without acquiring any bucket locks. Once the block is fully
+   * populated, it replaces the current data block.
+   * This is only supported if both key and value are trivial.
+   *
+   * The container must be empty, and `load` must not be called concurrently with any update
+   * operations on the same container; concurrent read operations are safe, but may not
+   * observe the loaded elements.
+   *
+   * Throws `std::system_error` if the file cannot be opened, `std::runtime_error` if the file
+   * has an invalid format and `std::logic_error` if the container is not empty.
+   *
+   * Progress guarantees: blocking
+   *
+   * @param path the path of the file to load
+   */
+  void load(const std::string& path);
+
+  /**
+   * @brief Inserts all elements from the range `[first, last)` using the specified number of threads.
+   *
+   * This is considerably faster than inserting the elements one by one via `emplace`, since it
+   * neither has to acquire any bucket locks, nor grow the map repeatedly. Instead, a new data block
+   * is allocated that is sized such that it can hold all elements without having to grow.
+   * The elements are first hashed and partitioned by their buckets, and each thread then fills
+   * a disjoint range of buckets in the new block. Since the new block is not yet visible to other
+   * threads, this does not require any synchronization. Once the block is fully populated, it
+   * replaces the current data block.
+   * If the range contains several elements with equivalent keys, only the first one is inserted.
+   * This is only supported if both key and value are trivial.
+   *
+   * The container must be empty, and `bulk_build` must not be called concurrently with any update
+   * operations on the same container; concurrent read operations are safe, but may not observe
+   * the new elements. Throws `std::logic_error` if the container is not empty.
+   *
+   * Progress guarantees: blocking
+   *
+   * @param first iterator to the first element; the iterator's `value_type` must provide the
+   * key and value via `first` and `second` (e.g., `std::pair<Key, Value>`)
+   * @param last iterator to the element following the last element
+   * @param num_threads the number of threads to use, including the calling thread
+   */
+  template <class RandomIt>
+  void bulk_build(RandomIt first, RandomIt last, std::size_t num_threads = 1);
+
 private:
   struct unlocker;
 
@@ -307,6 +513,7 @@ private:
   struct bucket;
   struct extension_item;
   struct extension_bucket;
+  struct extension_chunk;
   struct block;
   using block_ptr = typename reclaimer::template concurrent_ptr<block, 0>;
   using guarded_block = typename block_ptr::guard_ptr;
@@ -315,6 +522,11 @@ private:
   static constexpr std::uint32_t bucket_item_count = 3;
   static constexpr std::uint32_t extension_item_count = 10;
 
+  // the table is only grown if it contains more than max_load_factor_num / max_load_factor_den
+  // entries per bucket; otherwise additional extension items are allocated on demand.
+  static constexpr std::size_t max_load_factor_num = 3;
+  static constexpr std::size_t max_load_factor_den = 2;
+
   static constexpr std::size_t item_counter_bits = utils::find_last_bit_set(bucket_item_count);
   static constexpr std::size_t lock_bit = 2 * item_counter_bits + 1;
   static constexpr std::size_t version_shift = lock_bit;
@@ -327,21 +539,44 @@ private:
 
   static constexpr std::align_val_t cacheline_size{64};
 
+  // the header of files written by save
+  struct file_header {
+    char magic[8];
+    std::uint32_t version;
+    std::uint32_t key_size;
+    std::uint32_t value_size;
+    std::uint32_t reserved;
+    std::uint64_t count;
+  };
+  static constexpr char file_magic[8] = {'X', 'E', 'N', 'V', 'Y', 'H', 'M', '\0'};
+  static constexpr std::uint32_t file_version = 1;
+
   block_ptr data_block;
   std::atomic<int> resize_lock;
+  detail::striped_counter element_count;
 
   block* allocate_block(std::uint32_t bucket_count);
 
   bucket& lock_bucket(hash_t hash, guarded_block& block, bucket_state& state);
-  void grow(bucket& bucket, bucket_state state);
+  void grow(bucket& bucket, bucket_state state, block* b);
   void do_grow();
+  template <class K, class V>
+  bool insert_into_unpublished_block(block* b, hash_t hash, const K& key, const V& value);
+  block* allocate_block_for(std::size_t count);
+  void publish_block(block* new_block);
+  bool exceeds_max_load_factor(block* b);
+  bool add_extension_chunk(block* b);
 
   template <bool AcquireAccessor, class Factory, class Callback>
   bool do_get_or_emplace(Key&& key, Factory&& factory, Callback&& callback);
 
   bool do_extract(const key_type& key, accessor& result);
 
+  static extension_bucket* init_extension_buckets(std::size_t addr, std::uint32_t count);
   static extension_item* allocate_extension_item(block* b, hash_t hash);
+  static extension_item* allocate_extension_item(extension_bucket* extension_buckets,
+                                                 std::uint32_t extension_bucket_count,
+                                                 hash_t hash);
   static void free_extension_item(extension_item* item);
 };
 
@@ -408,6 +643,68 @@ private:
   Value* erase_current();
 };
 
+/**
+ * @brief An InputIterator to scan a `vyukov_hash_map` without acquiring any bucket locks.
+ *
+ * The iterator only holds a guard on the map's current data block. The entries of
+ * each bucket are copied optimistically and the copy is discarded and retried if the
+ * bucket's version changed in the meantime, so a `snapshot_iterator` never blocks
+ * concurrent update operations.
+ * The copies of each individual bucket are consistent, but the iteration as a whole
+ * is only weakly consistent: every element that is contained in the map during the
+ * whole iteration is visited exactly once, while elements that are concurrently
+ * inserted or removed may or may not be visited.
+ *
+ * Buckets are visited in bit-reversed order of their index. Since a grow operation
+ * doubles the number of buckets, the buckets that have already been visited map to
+ * a prefix of the buckets in the new block in that same order, so the iteration can
+ * simply continue in the new block if the map is grown concurrently.
+ *
+ * The iterator dereferences to a `std::pair<const Key, Value>` that is a copy of the
+ * entry; modifications of the entry after it has been copied are not reflected.
+ */
+template <class Key, class Value, class... Policies>
+class vyukov_hash_map<Key, Value, Policies...>::snapshot_iterator {
+public:
+  using iterator_category = std::input_iterator_tag;
+  using difference_type = std::ptrdiff_t;
+  using value_type = std::pair<const Key, Value>;
+  using reference = const value_type&;
+  using pointer = const value_type*;
+
+  snapshot_iterator() = default;
+
+  bool operator==(const snapshot_iterator& r) const;
+  bool operator!=(const snapshot_iterator& r) const;
+  snapshot_iterator& operator++();
+
+  reference operator*() const { return items[index]; }
+  pointer operator->() const { return &items[index]; }
+
+  /**
+   * @brief Releases the guard on the data block and resets the iterator.
+   *
+   * After calling `reset` the iterator equals `snapshot_end()`.
+   */
+  void reset();
+
+private:
+  explicit snapshot_iterator(const vyukov_hash_map* map);
+
+  const vyukov_hash_map* map{};
+  guarded_block block{};
+  // the position of the current bucket in bit-reversed order
+  std::uint32_t position{};
+  std::size_t index{};
+  std::vector<value_type> items{};
+  friend struct vyukov_hash_map;
+
+  void move_to_next_nonempty_bucket();
+  bool copy_bucket(bucket& bucket);
+  bool block_is_current();
+  static std::uint32_t reverse_bits(std::uint32_t position, std::uint32_t bucket_count);
+};
+
 } // namespace xenium
 
 #define XENIUM_VYUKOV_HASH_MAP_IMPL
@@ -0,0 +1,189 @@
+//
+// Copyright (c) 2018-2020 Manuel Pöter.
+// Licensed under the MIT License. See LICENSE file in the project root for full license information.
+//
+
+#ifndef XENIUM_VYUKOV_MPSC_QUEUE_HPP
+#define XENIUM_VYUKOV_MPSC_QUEUE_HPP
+
+#include <atomic>
+#include <cassert>
+#include <cstddef>
+#include <type_traits>
+
+#ifdef _MSC_VER
+  #pragma warning(push)
+  #pragma warning(disable : 4324) // structure was padded due to alignment specifier
+#endif
+
+namespace xenium {
+
+template <class T, class... Policies>
+class vyukov_mpsc_queue;
+
+/**
+ * @brief The link that has to be embedded in every element of a `vyukov_mpsc_queue`.
+ *
+ * Elements have to derive (publicly) from this class. An element can be part of
+ * at most one queue at a time.
+ */
+class vyukov_mpsc_queue_hook {
+public:
+  vyukov_mpsc_queue_hook() noexcept = default;
+  // the link is tied to the object's address, so it must not be copied
+  vyukov_mpsc_queue_hook(const vyukov_mpsc_queue_hook&) noexcept {}
+  vyukov_mpsc_queue_hook& operator=(const vyukov_mpsc_queue_hook&) noexcept { return *this; }
+
+private:
+  template <class, class...>
+  friend class vyukov_mpsc_queue;
+
+  std::atomic<vyukov_mpsc_queue_hook*> _next{nullptr};
+};
+
+/**
+ * @brief An intrusive unbounded multi-producer/single-consumer FIFO queue.
+ *
+ * This is an implementation of the intrusive MPSC queue proposed by Vyukov
+ * \[[Vyu10b](index.html#ref-vyukov-2010b)\].
+ *
+ * The queue stores pointers to elements of type `T`, which has to derive from
+ * `vyukov_mpsc_queue_hook`. The link is embedded in the element itself, so neither
+ * `push` nor `try_pop` perform any allocations. The queue does not take ownership
+ * of the elements - the caller is responsible for keeping an element alive until it
+ * has been popped, and for releasing it afterwards.
+ *
+ * `push` can be called concurrently by any number of threads and consists of a
+ * single atomic exchange followed by a store that links the element to its
+ * predecessor. `try_pop` must only be called by a single consumer thread at a time
+ * and does not use any CAS operations.
+ *
+ * Note that the queue is not linearizable: a producer that is preempted between the
+ * exchange and the subsequent store temporarily hides its own element and all
+ * elements pushed after it. In this case `try_pop` returns `false`, even though the
+ * queue is not empty. Once the producer has completed its `push`, the elements become
+ * visible again.
+ *
+ * @tparam T type of the stored elements; must derive from `vyukov_mpsc_queue_hook`.
+ * @tparam Policies list of policies to customize the behaviour (currently unused)
+ */
+template <class T, class... Policies>
+class vyukov_mpsc_queue {
+public:
+  using value_type = T*;
+
+  vyukov_mpsc_queue() noexcept;
+  ~vyukov_mpsc_queue() = default;
+
+  vyukov_mpsc_queue(const vyukov_mpsc_queue&) = delete;
+  vyukov_mpsc_queue(vyukov_mpsc_queue&&) = delete;
+
+  vyukov_mpsc_queue& operator=(const vyukov_mpsc_queue&) = delete;
+  vyukov_mpsc_queue& operator=(vyukov_mpsc_queue&&) = delete;
+
+  /**
+   * @brief Pushes the given element to the queue.
+   *
+   * May be called concurrently by any number of threads.
+   *
+   * Progress guarantees: wait-free
+   *
+   * @param value the element to push; must not be null and must not be part of any
+   * queue at the moment.
+   */
+  void push(T* value) noexcept;
+
+  /**
+   * @brief Tries to pop an element from the queue.
+   *
+   * May only be called by the (single) consumer.
+   *
+   * Progress guarantees: wait-free (but see the note about linearizability in the class
+   * description)
+   *
+   * @param result the element popped from the queue if the operation was successful
+   * @return `true` if the operation was successful, otherwise `false`
+   */
+  [[nodiscard]] bool try_pop(T*& result) noexcept;
+
+private:
+  using hook = vyukov_mpsc_queue_hook;
+
+  void push_hook(hook* h) noexcept;
+
+  static constexpr std::size_t cacheline_size = 64;
+
+  // written by the producers
+  alignas(cacheline_size) std::atomic<hook*> _tail;
+  // only accessed by the consumer
+  alignas(cacheline_size) hook* _head;
+  hook _stub;
+};
+
+template <class T, class... Policies>
+vyukov_mpsc_queue<T, Policies...>::vyukov_mpsc_queue() noexcept : _tail(&_stub), _head(&_stub) {}
+
+template <class T, class... Policies>
+void vyukov_mpsc_queue<T, Policies...>::push(T* value) noexcept {
+  static_assert(std::is_base_of<vyukov_mpsc_queue_hook, T>::value, "T must derive from vyukov_mpsc_queue_hook");
+  assert(value != nullptr);
+  push_hook(value);
+}
+
+template <class T, class... Policies>
+void vyukov_mpsc_queue<T, Policies...>::push_hook(hook* h) noexcept {
+  h->_next.store(nullptr, std::memory_order_relaxed);
+  // (1) - this acq_rel-exchange synchronizes-with the acq_rel-exchange (1) and the acquire-load (5);
+  //       the release part publishes the initialization of h->_next to the next producer.
+  hook* prev = _tail.exchange(h, std::memory_order_acq_rel);
+  // (2) - this release-store synchronizes-with the acquire-load (3, 4, 6)
+  prev->_next.store(h, std::memory_order_release);
+}
+
+template <class T, class... Policies>
+bool vyukov_mpsc_queue<T, Policies...>::try_pop(T*& result) noexcept {
+  hook* head = _head;
+  // (3) - this acquire-load synchronizes-with the release-store (2)
+  hook* next = head->_next.load(std::memory_order_acquire);
+  if (head == &_stub) {
+    if (next == nullptr) {
+      return false;
+    }
+    // skip the stub
+    _head = next;
+    head = next;
+    // (4) - this acquire-load synchronizes-with the release-store (2)
+    next = next->_next.load(std::memory_order_acquire);
+  }
+
+  if (next == nullptr) {
+    // head is either the last element in the queue, or some producer has already
+    // exchanged the tail but not yet linked its element to head.
+    // (5) - this acquire-load synchronizes-with the acq_rel-exchange (1)
+    if (_tail.load(std::memory_order_acquire) != head) {
+      // a push is in progress - head cannot be removed until it is linked
+      return false;
+    }
+
+    // head is the last element - push the stub so that head gets a successor
+    push_hook(&_stub);
+    // (6) - this acquire-load synchronizes-with the release-store (2)
+    next = head->_next.load(std::memory_order_acquire);
+    if (next == nullptr) {
+      // another producer has pushed its element between head and the stub,
+      // but has not linked it yet
+      return false;
+    }
+  }
+
+  _head = next;
+  result = static_cast<T*>(head);
+  return true;
+}
+} // namespace xenium
+
+#ifdef _MSC_VER
+  #pragma warning(pop)
+#endif
+
+#endif